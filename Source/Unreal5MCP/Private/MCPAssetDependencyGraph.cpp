@@ -0,0 +1,222 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPAssetDependencyGraph.h"
+#include "Unreal5MCP.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+
+FMCPAssetDependencyGraph::FMCPAssetDependencyGraph()
+    : bInitialized(false)
+{
+}
+
+FMCPAssetDependencyGraph::~FMCPAssetDependencyGraph()
+{
+    Shutdown();
+}
+
+void FMCPAssetDependencyGraph::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    bInitialized = true;
+
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FMCPAssetDependencyGraph::HandleAssetAdded);
+    AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FMCPAssetDependencyGraph::HandleAssetRemoved);
+    AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FMCPAssetDependencyGraph::HandleAssetRenamed);
+    AssetUpdatedHandle = AssetRegistry.OnAssetUpdated().AddRaw(this, &FMCPAssetDependencyGraph::HandleAssetUpdated);
+}
+
+void FMCPAssetDependencyGraph::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    if (FAssetRegistryModule *AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+    {
+        IAssetRegistry &AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+        AssetRegistry.OnAssetUpdated().Remove(AssetUpdatedHandle);
+    }
+
+    AssetAddedHandle.Reset();
+    AssetRemovedHandle.Reset();
+    AssetRenamedHandle.Reset();
+    AssetUpdatedHandle.Reset();
+
+    InvalidateCache();
+    bInitialized = false;
+}
+
+void FMCPAssetDependencyGraph::Traverse(FName RootPackage, const FQuery &Query, FResult &OutResult)
+{
+    OutResult = FResult();
+
+    TSet<FName> Visited;
+    Visited.Add(RootPackage);
+
+    // 按层遍历,同一层内的邻居保持注册表返回的顺序
+    TArray<FName> CurrentLevel;
+    TArray<FName> NextLevel;
+    CurrentLevel.Add(RootPackage);
+
+    for (int32 Depth = 1; Depth <= Query.MaxDepth && CurrentLevel.Num() > 0 && !OutResult.bTruncated; ++Depth)
+    {
+        NextLevel.Reset();
+
+        for (const FName &PackageName : CurrentLevel)
+        {
+            for (const FName &Neighbor : GetNeighbors(PackageName, Query))
+            {
+                if (Visited.Contains(Neighbor))
+                {
+                    continue;
+                }
+
+                if (!Query.bIncludeScriptPackages && FPackageName::IsScriptPackage(Neighbor.ToString()))
+                {
+                    continue;
+                }
+
+                Visited.Add(Neighbor);
+                NextLevel.Add(Neighbor);
+
+                const FTopLevelAssetPath &AssetClass = GetPackageClass(Neighbor);
+                if (!MatchesClassFilter(AssetClass, Query))
+                {
+                    continue;
+                }
+
+                if (OutResult.Nodes.Num() >= Query.MaxResults)
+                {
+                    OutResult.bTruncated = true;
+                    break;
+                }
+
+                FNode &Node = OutResult.Nodes.AddDefaulted_GetRef();
+                Node.PackageName = Neighbor;
+                Node.AssetClass = AssetClass;
+                Node.Depth = Depth;
+                Node.Via = PackageName == RootPackage ? NAME_None : PackageName;
+            }
+
+            if (OutResult.bTruncated)
+            {
+                break;
+            }
+        }
+
+        Swap(CurrentLevel, NextLevel);
+    }
+
+    OutResult.VisitedCount = Visited.Num() - 1;
+}
+
+const TArray<FName> &FMCPAssetDependencyGraph::GetNeighbors(FName PackageName, const FQuery &Query)
+{
+    FAdjacencyKey Key;
+    Key.PackageName = PackageName;
+    Key.Direction = static_cast<uint8>(Query.Direction);
+    Key.Category = static_cast<uint8>(Query.Category);
+    Key.Flags = static_cast<uint32>(Query.Flags);
+
+    if (const TArray<FName> *Cached = Adjacency.Find(Key))
+    {
+        return *Cached;
+    }
+
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+    TArray<FName> Neighbors;
+    if (Query.Direction == EDirection::Dependencies)
+    {
+        AssetRegistry.GetDependencies(PackageName, Neighbors, Query.Category, Query.Flags);
+    }
+    else
+    {
+        AssetRegistry.GetReferencers(PackageName, Neighbors, Query.Category, Query.Flags);
+    }
+
+    return Adjacency.Add(Key, MoveTemp(Neighbors));
+}
+
+const FTopLevelAssetPath &FMCPAssetDependencyGraph::GetPackageClass(FName PackageName)
+{
+    if (const FTopLevelAssetPath *Cached = PackageClasses.Find(PackageName))
+    {
+        return *Cached;
+    }
+
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+    TArray<FAssetData> Assets;
+    AssetRegistry.GetAssetsByPackageName(PackageName, Assets, true);
+
+    // 优先使用包的主资源
+    FTopLevelAssetPath AssetClass;
+    for (const FAssetData &Asset : Assets)
+    {
+        if (Asset.IsUAsset() || AssetClass.IsNull())
+        {
+            AssetClass = Asset.AssetClassPath;
+        }
+    }
+
+    return PackageClasses.Add(PackageName, AssetClass);
+}
+
+bool FMCPAssetDependencyGraph::MatchesClassFilter(const FTopLevelAssetPath &AssetClass, const FQuery &Query) const
+{
+    return Query.ClassFilter.Num() == 0 || Query.ClassFilter.Contains(AssetClass);
+}
+
+void FMCPAssetDependencyGraph::InvalidateCache()
+{
+    Adjacency.Reset();
+    PackageClasses.Reset();
+}
+
+// ============================================================================
+// 资源注册表回调
+// ============================================================================
+
+// 单个包的变化可能影响任意包的引用者列表,因此整体清空
+
+void FMCPAssetDependencyGraph::HandleAssetAdded(const FAssetData &AssetData)
+{
+    if (Adjacency.Num() > 0 || PackageClasses.Num() > 0)
+    {
+        InvalidateCache();
+    }
+}
+
+void FMCPAssetDependencyGraph::HandleAssetRemoved(const FAssetData &AssetData)
+{
+    if (Adjacency.Num() > 0 || PackageClasses.Num() > 0)
+    {
+        InvalidateCache();
+    }
+}
+
+void FMCPAssetDependencyGraph::HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath)
+{
+    if (Adjacency.Num() > 0 || PackageClasses.Num() > 0)
+    {
+        InvalidateCache();
+    }
+}
+
+void FMCPAssetDependencyGraph::HandleAssetUpdated(const FAssetData &AssetData)
+{
+    if (Adjacency.Num() > 0 || PackageClasses.Num() > 0)
+    {
+        InvalidateCache();
+    }
+}
@@ -0,0 +1,502 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPAssetSearchIndex.h"
+#include "MCPSettings.h"
+#include "Unreal5MCP.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "AssetRegistry/IAssetRegistry.h"
+#include "Async/Async.h"
+
+FMCPAssetSearchIndex::FMCPAssetSearchIndex()
+    : bBuilding(false), bInitialized(false)
+{
+}
+
+FMCPAssetSearchIndex::~FMCPAssetSearchIndex()
+{
+    Shutdown();
+}
+
+void FMCPAssetSearchIndex::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    bInitialized = true;
+
+    if (const UMCPSettings *Settings = GetDefault<UMCPSettings>())
+    {
+        IndexedTags = Settings->SearchIndexedTags;
+    }
+
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    if (AssetRegistry.IsLoadingAssets())
+    {
+        // 等待资源注册表扫描完成,避免在扫描期间处理大量 OnAssetAdded 事件
+        FilesLoadedHandle = AssetRegistry.OnFilesLoaded().AddRaw(this, &FMCPAssetSearchIndex::HandleFilesLoaded);
+        MCP_LOG_INFO("Asset search index waiting for asset registry scan to complete");
+    }
+    else
+    {
+        HandleFilesLoaded();
+    }
+}
+
+void FMCPAssetSearchIndex::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    if (FAssetRegistryModule *AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+    {
+        IAssetRegistry &AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+        AssetRegistry.OnAssetAdded().Remove(AssetAddedHandle);
+        AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+    }
+
+    FilesLoadedHandle.Reset();
+    AssetAddedHandle.Reset();
+    AssetRemovedHandle.Reset();
+    AssetRenamedHandle.Reset();
+
+    Data.Reset();
+    PendingUpdates.Empty();
+    bBuilding = false;
+    bInitialized = false;
+}
+
+int32 FMCPAssetSearchIndex::GetNumEntries() const
+{
+    return Data.IsValid() ? Data->PathToEntry.Num() : 0;
+}
+
+// ============================================================================
+// 构建
+// ============================================================================
+
+void FMCPAssetSearchIndex::HandleFilesLoaded()
+{
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    AssetRegistry.OnFilesLoaded().Remove(FilesLoadedHandle);
+    FilesLoadedHandle.Reset();
+
+    // 从现在开始跟踪增量变化,构建期间的变化会排队并在构建完成后重放
+    AssetAddedHandle = AssetRegistry.OnAssetAdded().AddRaw(this, &FMCPAssetSearchIndex::HandleAssetAdded);
+    AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FMCPAssetSearchIndex::HandleAssetRemoved);
+    AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FMCPAssetSearchIndex::HandleAssetRenamed);
+
+    StartBackgroundBuild();
+}
+
+void FMCPAssetSearchIndex::StartBackgroundBuild()
+{
+    if (bBuilding)
+    {
+        return;
+    }
+
+    bBuilding = true;
+    const double StartTime = FPlatformTime::Seconds();
+
+    // 游戏线程只复制资源数据(FName 和共享标签视图),分词和倒排表在后台完成
+    TArray<FAssetData> Snapshot;
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    AssetRegistry.EnumerateAllAssets([&Snapshot](const FAssetData &AssetData)
+                                     {
+        Snapshot.Add(AssetData);
+        return true; });
+
+    MCP_LOG_INFO("Asset search index: building from %d assets in background", Snapshot.Num());
+
+    TWeakPtr<FMCPAssetSearchIndex> WeakThis = AsShared();
+    TArray<FName> Tags = IndexedTags;
+
+    Async(EAsyncExecution::ThreadPool, [WeakThis, Snapshot = MoveTemp(Snapshot), Tags = MoveTemp(Tags), StartTime]()
+          {
+        TUniquePtr<FIndexData> NewData = MakeUnique<FIndexData>();
+        NewData->Entries.Reserve(Snapshot.Num());
+        NewData->PathToEntry.Reserve(Snapshot.Num());
+
+        for (const FAssetData &AssetData : Snapshot)
+        {
+            NewData->AddEntry(MakeEntry(AssetData, Tags));
+        }
+
+        const double BuildSeconds = FPlatformTime::Seconds() - StartTime;
+
+        AsyncTask(ENamedThreads::GameThread, [WeakThis, NewData = MoveTemp(NewData), BuildSeconds]() mutable
+                  {
+            if (TSharedPtr<FMCPAssetSearchIndex> PinnedThis = WeakThis.Pin())
+            {
+                PinnedThis->FinishBackgroundBuild(MoveTemp(NewData));
+                MCP_LOG_INFO("Asset search index ready: %d assets indexed in %.2f s",
+                             PinnedThis->GetNumEntries(), BuildSeconds);
+            } }); });
+}
+
+void FMCPAssetSearchIndex::FinishBackgroundBuild(TUniquePtr<FIndexData> NewData)
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    Data = MoveTemp(NewData);
+    bBuilding = false;
+
+    // 重放构建期间的增量更新
+    for (FPendingUpdate &Update : PendingUpdates)
+    {
+        if (!Update.RemovedPath.IsEmpty())
+        {
+            Data->RemoveEntry(Update.RemovedPath);
+        }
+        if (Update.AddedAsset.IsValid())
+        {
+            Data->AddEntry(MakeEntry(Update.AddedAsset, IndexedTags));
+        }
+    }
+    PendingUpdates.Empty();
+
+    Data->CompactIfNeeded();
+}
+
+// ============================================================================
+// 增量更新
+// ============================================================================
+
+void FMCPAssetSearchIndex::HandleAssetAdded(const FAssetData &AssetData)
+{
+    if (bBuilding)
+    {
+        FPendingUpdate &Update = PendingUpdates.AddDefaulted_GetRef();
+        Update.AddedAsset = AssetData;
+        return;
+    }
+
+    if (Data.IsValid())
+    {
+        Data->AddEntry(MakeEntry(AssetData, IndexedTags));
+    }
+}
+
+void FMCPAssetSearchIndex::HandleAssetRemoved(const FAssetData &AssetData)
+{
+    if (bBuilding)
+    {
+        FPendingUpdate &Update = PendingUpdates.AddDefaulted_GetRef();
+        Update.RemovedPath = AssetData.GetObjectPathString();
+        return;
+    }
+
+    if (Data.IsValid())
+    {
+        Data->RemoveEntry(AssetData.GetObjectPathString());
+        Data->CompactIfNeeded();
+    }
+}
+
+void FMCPAssetSearchIndex::HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath)
+{
+    if (bBuilding)
+    {
+        FPendingUpdate &Update = PendingUpdates.AddDefaulted_GetRef();
+        Update.RemovedPath = OldObjectPath;
+        Update.AddedAsset = AssetData;
+        return;
+    }
+
+    if (Data.IsValid())
+    {
+        Data->RemoveEntry(OldObjectPath);
+        Data->AddEntry(MakeEntry(AssetData, IndexedTags));
+    }
+}
+
+// ============================================================================
+// 索引数据
+// ============================================================================
+
+void FMCPAssetSearchIndex::FIndexData::AddEntry(FEntry &&Entry)
+{
+    // 同一路径重复添加时先移除旧条目
+    RemoveEntry(Entry.ObjectPath);
+
+    const int32 EntryIndex = Entries.Num();
+
+    TArray<uint64, TInlineAllocator<128>> Trigrams;
+    ForEachTrigram(Entry.SearchText, [&Trigrams](uint64 Trigram)
+                   { Trigrams.Add(Trigram); });
+    Trigrams.Sort();
+
+    uint64 LastTrigram = 0;
+    for (int32 i = 0; i < Trigrams.Num(); ++i)
+    {
+        if (i > 0 && Trigrams[i] == LastTrigram)
+        {
+            continue;
+        }
+        LastTrigram = Trigrams[i];
+        Postings.FindOrAdd(LastTrigram).Add(EntryIndex);
+    }
+
+    PathToEntry.Add(Entry.ObjectPath, EntryIndex);
+    Entries.Add(MoveTemp(Entry));
+}
+
+void FMCPAssetSearchIndex::FIndexData::RemoveEntry(const FString &ObjectPath)
+{
+    int32 EntryIndex = INDEX_NONE;
+    if (PathToEntry.RemoveAndCopyValue(ObjectPath, EntryIndex))
+    {
+        // 倒排表中保留旧索引,查询时跳过已删除条目,由压缩统一清理
+        Entries[EntryIndex].bAlive = false;
+        Entries[EntryIndex].SearchText.Empty();
+        NumDead++;
+    }
+}
+
+void FMCPAssetSearchIndex::FIndexData::CompactIfNeeded()
+{
+    if (NumDead < 1024 || NumDead * 4 < Entries.Num())
+    {
+        return;
+    }
+
+    TArray<FEntry> OldEntries = MoveTemp(Entries);
+    Entries.Reset();
+    PathToEntry.Reset();
+    Postings.Reset();
+    NumDead = 0;
+
+    for (FEntry &Entry : OldEntries)
+    {
+        if (Entry.bAlive)
+        {
+            AddEntry(MoveTemp(Entry));
+        }
+    }
+}
+
+// ============================================================================
+// 分词
+// ============================================================================
+
+FMCPAssetSearchIndex::FEntry FMCPAssetSearchIndex::MakeEntry(const FAssetData &AssetData, const TArray<FName> &IndexedTags)
+{
+    FEntry Entry;
+    Entry.ObjectPath = AssetData.GetObjectPathString();
+    Entry.AssetName = AssetData.AssetName.ToString();
+    Entry.ClassName = AssetData.AssetClassPath.GetAssetName().ToString();
+    Entry.NormalizedName = NormalizeText(Entry.AssetName);
+
+    FString RawText = Entry.AssetName;
+    RawText += TEXT(' ');
+    RawText += AssetData.PackagePath.ToString();
+
+    for (const FName &Tag : IndexedTags)
+    {
+        FString TagValue;
+        if (AssetData.GetTagValue(Tag, TagValue) && !TagValue.IsEmpty())
+        {
+            RawText += TEXT(' ');
+            RawText += TagValue;
+        }
+    }
+
+    Entry.SearchText = NormalizeText(RawText);
+    return Entry;
+}
+
+FString FMCPAssetSearchIndex::NormalizeText(const FString &Text)
+{
+    FString Result;
+    Result.Reserve(Text.Len() * 2 + 1);
+
+    TCHAR Previous = TEXT(' ');
+    for (const TCHAR Char : Text)
+    {
+        const bool bSeparator = FChar::IsWhitespace(Char) || Char == TEXT('_') || Char == TEXT('-') ||
+                                Char == TEXT('/') || Char == TEXT('.') || Char == TEXT(',');
+        if (bSeparator)
+        {
+            if (Previous != TEXT(' '))
+            {
+                Result.AppendChar(TEXT(' '));
+                Previous = TEXT(' ');
+            }
+            continue;
+        }
+
+        // 驼峰边界: RustyMetal -> rusty metal
+        if (FChar::IsUpper(Char) && FChar::IsLower(Previous))
+        {
+            Result.AppendChar(TEXT(' '));
+        }
+
+        Result.AppendChar(FChar::ToLower(Char));
+        Previous = Char;
+    }
+
+    // 词首补空格,使两个字符的词也能产生三元组
+    Result.InsertAt(0, TEXT(' '));
+    Result.TrimEndInline();
+    return Result;
+}
+
+void FMCPAssetSearchIndex::ForEachTrigram(const FString &NormalizedText, TFunctionRef<void(uint64)> Callback)
+{
+    const int32 Len = NormalizedText.Len();
+    const TCHAR *Chars = *NormalizedText;
+
+    for (int32 i = 0; i + 2 < Len; ++i)
+    {
+        // 跳过跨词的三元组(中间字符为空格)
+        if (Chars[i + 1] == TEXT(' ') || Chars[i + 2] == TEXT(' '))
+        {
+            continue;
+        }
+
+        const uint64 Trigram = (static_cast<uint64>(static_cast<uint16>(Chars[i])) << 32) |
+                               (static_cast<uint64>(static_cast<uint16>(Chars[i + 1])) << 16) |
+                               static_cast<uint64>(static_cast<uint16>(Chars[i + 2]));
+        Callback(Trigram);
+    }
+}
+
+// ============================================================================
+// 查询
+// ============================================================================
+
+void FMCPAssetSearchIndex::Search(const FString &Query, int32 MaxResults, const FString &ClassFilter, TArray<FSearchResult> &OutResults) const
+{
+    OutResults.Reset();
+
+    if (!Data.IsValid() || MaxResults <= 0)
+    {
+        return;
+    }
+
+    const FString NormalizedQuery = NormalizeText(Query);
+
+    TArray<FString> Tokens;
+    NormalizedQuery.ParseIntoArrayWS(Tokens);
+    if (Tokens.Num() == 0)
+    {
+        return;
+    }
+
+    TArray<uint64> QueryTrigrams;
+    ForEachTrigram(NormalizedQuery, [&QueryTrigrams](uint64 Trigram)
+                   { QueryTrigrams.AddUnique(Trigram); });
+
+    const TArray<FEntry> &Entries = Data->Entries;
+    TArray<int32> Candidates;
+    TArray<uint16> MatchCounts;
+
+    if (QueryTrigrams.Num() > 0)
+    {
+        // 累加每个条目命中的三元组数量
+        MatchCounts.SetNumZeroed(Entries.Num());
+        for (const uint64 Trigram : QueryTrigrams)
+        {
+            if (const TArray<int32> *Posting = Data->Postings.Find(Trigram))
+            {
+                for (const int32 EntryIndex : *Posting)
+                {
+                    if (MatchCounts[EntryIndex]++ == 0)
+                    {
+                        Candidates.Add(EntryIndex);
+                    }
+                }
+            }
+        }
+    }
+    else
+    {
+        // 查询只包含单字符词,退化为线性扫描
+        for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+        {
+            if (Entries[EntryIndex].bAlive && Entries[EntryIndex].SearchText.Contains(NormalizedQuery.TrimStart()))
+            {
+                Candidates.Add(EntryIndex);
+            }
+        }
+    }
+
+    // 模糊匹配: 至少命中一半的查询三元组
+    const int32 MinMatches = FMath::Max(1, (QueryTrigrams.Num() + 1) / 2);
+    const float TokenWeight = 1.0f / Tokens.Num();
+
+    auto ScoreLess = [](const FSearchResult &A, const FSearchResult &B)
+    { return A.Score < B.Score; };
+
+    // 维护最小堆,只保留得分最高的 MaxResults 个结果
+    TArray<FSearchResult> Heap;
+    Heap.Reserve(MaxResults + 1);
+
+    for (const int32 EntryIndex : Candidates)
+    {
+        const FEntry &Entry = Entries[EntryIndex];
+        if (!Entry.bAlive)
+        {
+            continue;
+        }
+
+        if (QueryTrigrams.Num() > 0 && MatchCounts[EntryIndex] < MinMatches)
+        {
+            continue;
+        }
+
+        if (!ClassFilter.IsEmpty() && Entry.ClassName != ClassFilter)
+        {
+            continue;
+        }
+
+        float Score = QueryTrigrams.Num() > 0 ? static_cast<float>(MatchCounts[EntryIndex]) / QueryTrigrams.Num() : 1.0f;
+
+        // 名称匹配加分: 包含完整词,词首匹配额外加分
+        for (const FString &Token : Tokens)
+        {
+            const int32 Found = Entry.NormalizedName.Find(Token, ESearchCase::CaseSensitive);
+            if (Found != INDEX_NONE)
+            {
+                Score += 0.5f * TokenWeight;
+                if (Found > 0 && Entry.NormalizedName[Found - 1] == TEXT(' '))
+                {
+                    Score += 0.25f * TokenWeight;
+                }
+            }
+        }
+
+        // 名称越短越精确
+        Score += 0.1f / (1.0f + Entry.AssetName.Len());
+
+        if (Heap.Num() >= MaxResults && Score <= Heap.HeapTop().Score)
+        {
+            continue;
+        }
+
+        if (Heap.Num() >= MaxResults)
+        {
+            Heap.HeapPopDiscard(ScoreLess, EAllowShrinking::No);
+        }
+
+        FSearchResult Result;
+        Result.ObjectPath = Entry.ObjectPath;
+        Result.AssetName = Entry.AssetName;
+        Result.ClassName = Entry.ClassName;
+        Result.Score = Score;
+        Heap.HeapPush(MoveTemp(Result), ScoreLess);
+    }
+
+    Heap.Sort([](const FSearchResult &A, const FSearchResult &B)
+              { return A.Score > B.Score; });
+    OutResults = MoveTemp(Heap);
+}
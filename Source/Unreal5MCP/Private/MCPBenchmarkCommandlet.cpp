@@ -0,0 +1,1005 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPBenchmarkCommandlet.h"
+#include "MCPTCPServer.h"
+#include "MCPServerMetrics.h"
+#include "MCPSettings.h"
+#include "MCPConstants.h"
+#include "Unreal5MCP.h"
+#include "Editor.h"
+#include "FileHelpers.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Engine/PointLight.h"
+#include "Components/StaticMeshComponent.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Containers/Ticker.h"
+#include "HAL/Runnable.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/PlatformProcess.h"
+#include "Math/RandomStream.h"
+#include "Misc/App.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include <atomic>
+
+namespace
+{
+    /**
+     * 一个待发送的请求
+     */
+    struct FMCPBenchmarkRequest
+    {
+        /** 工具名,JSON-RPC 方法不是 tools/call 时为方法名 */
+        FString Tool;
+
+        /** 完整的 HTTP 请求 */
+        TArray<uint8> Data;
+    };
+
+    /**
+     * 一个已完成的请求
+     */
+    struct FMCPBenchmarkSample
+    {
+        FString Tool;
+        double LatencySeconds = 0.0;
+        bool bError = false;
+    };
+
+    /**
+     * 命令行参数
+     */
+    struct FMCPBenchmarkOptions
+    {
+        FString TraceFile;
+        FString OutputBase;
+        int32 Connections = MCPConstants::DEFAULT_BENCHMARK_CONNECTIONS;
+        int32 Concurrency = MCPConstants::DEFAULT_BENCHMARK_CONCURRENCY;
+
+        /** 请求总数,回放时默认为日志中的请求数 */
+        int32 Requests = 0;
+
+        int32 Actors = MCPConstants::DEFAULT_BENCHMARK_ACTORS;
+        float MaxFPS = MCPConstants::DEFAULT_BENCHMARK_MAX_FPS;
+        int32 Seed = 0;
+
+        /** 门限,小于 0 时不检查 */
+        float MaxP99Ms = -1.0f;
+        float MaxErrorRate = -1.0f;
+
+        bool bJournal = false;
+    };
+
+    /**
+     * 一组延迟的统计值(毫秒)
+     */
+    struct FMCPLatencyStats
+    {
+        int32 Count = 0;
+        int32 Errors = 0;
+        double P50 = 0.0;
+        double P90 = 0.0;
+        double P99 = 0.0;
+        double Max = 0.0;
+        double Mean = 0.0;
+    };
+
+    /**
+     * 合成负载中的工具和权重
+     * 以只读查询为主,另有选择和移动生成的 Actor
+     */
+    struct FMCPSyntheticTool
+    {
+        const TCHAR *Name;
+        int32 Weight;
+    };
+
+    const FMCPSyntheticTool SYNTHETIC_MIX[] = {
+        {TEXT("get_scene_info"), 20},
+        {TEXT("get_camera"), 15},
+        {TEXT("get_selected_actors"), 10},
+        {TEXT("select_actor"), 10},
+        {TEXT("modify_object"), 20},
+        {TEXT("list_assets"), 10},
+        {TEXT("search_assets"), 10},
+        {TEXT("tools/list"), 5},
+    };
+
+    FString SerializeCondensed(const TSharedRef<FJsonObject> &Object)
+    {
+        FString Output;
+        TSharedRef<TJsonWriter<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>> Writer =
+            TJsonWriterFactory<TCHAR, TCondensedJsonPrintPolicy<TCHAR>>::Create(&Output);
+        FJsonSerializer::Serialize(Object, Writer);
+        return Output;
+    }
+
+    FMCPBenchmarkRequest MakeRequest(const FString &Tool, const FString &Body)
+    {
+        FTCHARToUTF8 BodyConverter(*Body);
+        const FString Header = FString::Printf(TEXT("POST / HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\nContent-Length: %d\r\n\r\n"),
+                                               BodyConverter.Length());
+        FTCHARToUTF8 HeaderConverter(*Header);
+
+        FMCPBenchmarkRequest Request;
+        Request.Tool = Tool;
+        Request.Data.Reserve(HeaderConverter.Length() + BodyConverter.Length());
+        Request.Data.Append(reinterpret_cast<const uint8 *>(HeaderConverter.Get()), HeaderConverter.Length());
+        Request.Data.Append(reinterpret_cast<const uint8 *>(BodyConverter.Get()), BodyConverter.Length());
+        return Request;
+    }
+
+    /** 合成一个请求的 JSON-RPC 请求体 */
+    FString MakeSyntheticBody(const FString &Tool, int32 Id, FRandomStream &Random, const TArray<FString> &ActorNames)
+    {
+        TSharedRef<FJsonObject> Request = MakeShared<FJsonObject>();
+        Request->SetStringField("jsonrpc", TEXT("2.0"));
+        Request->SetNumberField("id", Id);
+
+        if (Tool == TEXT("tools/list"))
+        {
+            Request->SetStringField("method", Tool);
+            return SerializeCondensed(Request);
+        }
+
+        TSharedPtr<FJsonObject> Arguments = MakeShared<FJsonObject>();
+        const FString ActorName = ActorNames.Num() > 0 ? ActorNames[Random.RandRange(0, ActorNames.Num() - 1)] : FString();
+        if (Tool == TEXT("get_scene_info"))
+        {
+            Arguments->SetBoolField("include_details", true);
+            Arguments->SetNumberField("max_actors", 100);
+        }
+        else if (Tool == TEXT("select_actor"))
+        {
+            Arguments->SetStringField("actor_name", ActorName);
+        }
+        else if (Tool == TEXT("modify_object"))
+        {
+            TSharedPtr<FJsonObject> Location = MakeShared<FJsonObject>();
+            Location->SetNumberField("x", Random.FRandRange(-5000.0f, 5000.0f));
+            Location->SetNumberField("y", Random.FRandRange(-5000.0f, 5000.0f));
+            Location->SetNumberField("z", 0.0);
+            Arguments->SetStringField("actor_name", ActorName);
+            Arguments->SetObjectField("location", Location);
+        }
+        else if (Tool == TEXT("list_assets"))
+        {
+            Arguments->SetStringField("path", TEXT("/Engine/BasicShapes"));
+            Arguments->SetNumberField("max_results", 50);
+        }
+        else if (Tool == TEXT("search_assets"))
+        {
+            Arguments->SetStringField("query", TEXT("cube"));
+        }
+
+        TSharedPtr<FJsonObject> CallParams = MakeShared<FJsonObject>();
+        CallParams->SetStringField("name", Tool);
+        CallParams->SetObjectField("arguments", Arguments);
+
+        Request->SetStringField("method", TEXT("tools/call"));
+        Request->SetObjectField("params", CallParams);
+        return SerializeCondensed(Request);
+    }
+
+    void BuildSyntheticRequests(int32 Count, int32 Seed, const TArray<FString> &ActorNames, TArray<FMCPBenchmarkRequest> &OutRequests)
+    {
+        int32 TotalWeight = 0;
+        for (const FMCPSyntheticTool &Entry : SYNTHETIC_MIX)
+        {
+            TotalWeight += Entry.Weight;
+        }
+
+        FRandomStream Random(Seed);
+        OutRequests.Reset(Count);
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            int32 Pick = Random.RandRange(0, TotalWeight - 1);
+            const FMCPSyntheticTool *Chosen = &SYNTHETIC_MIX[0];
+            for (const FMCPSyntheticTool &Entry : SYNTHETIC_MIX)
+            {
+                if (Pick < Entry.Weight)
+                {
+                    Chosen = &Entry;
+                    break;
+                }
+                Pick -= Entry.Weight;
+            }
+            OutRequests.Add(MakeRequest(Chosen->Name, MakeSyntheticBody(Chosen->Name, Index + 1, Random, ActorNames)));
+        }
+    }
+
+    /**
+     * 读取请求日志 (mcp_journal.jsonl) 中的请求
+     * 带完整 payload 的 request 条目按原样回放;每行也可以直接是一个 JSON-RPC 请求。
+     * 没有记录 payload 或 payload 被截断的条目无法回放,计入 OutSkipped
+     */
+    bool LoadTraceRequests(const FString &Path, TArray<FMCPBenchmarkRequest> &OutRequests, int32 &OutSkipped)
+    {
+        TArray<FString> Lines;
+        if (!FFileHelper::LoadFileToStringArray(Lines, *Path))
+        {
+            MCP_LOG_ERROR("Failed to read trace: %s", *Path);
+            return false;
+        }
+
+        OutSkipped = 0;
+        for (const FString &Line : Lines)
+        {
+            if (Line.TrimStartAndEnd().IsEmpty())
+            {
+                continue;
+            }
+
+            TSharedPtr<FJsonObject> Entry;
+            TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Line);
+            if (!FJsonSerializer::Deserialize(Reader, Entry) || !Entry.IsValid())
+            {
+                ++OutSkipped;
+                continue;
+            }
+
+            FString Method;
+            if (Entry->TryGetStringField(TEXT("method"), Method))
+            {
+                FString Tool = Method;
+                const TSharedPtr<FJsonObject> *CallParams = nullptr;
+                if (Method == TEXT("tools/call") && Entry->TryGetObjectField(TEXT("params"), CallParams))
+                {
+                    (*CallParams)->TryGetStringField(TEXT("name"), Tool);
+                }
+                OutRequests.Add(MakeRequest(Tool, Line));
+                continue;
+            }
+
+            FString Type;
+            FString Tool;
+            FString Payload;
+            bool bTruncated = false;
+            Entry->TryGetBoolField(TEXT("payload_truncated"), bTruncated);
+            if (Entry->TryGetStringField(TEXT("type"), Type) && Type == TEXT("request") &&
+                Entry->TryGetStringField(TEXT("tool"), Tool) && Entry->TryGetStringField(TEXT("payload"), Payload) && !bTruncated)
+            {
+                OutRequests.Add(MakeRequest(Tool, Payload));
+            }
+            else if (Type != TEXT("response") && Type != TEXT("dropped"))
+            {
+                ++OutSkipped;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * 新建空白关卡并按网格放置静态网格体和点光源
+     */
+    UWorld *CreateTestLevel(int32 ActorCount, TArray<FString> &OutActorNames)
+    {
+        UWorld *World = UEditorLoadingAndSavingUtils::NewBlankMap(false);
+        if (!World)
+        {
+            MCP_LOG_ERROR("Failed to create the benchmark level");
+            return nullptr;
+        }
+
+        UStaticMesh *CubeMesh = LoadObject<UStaticMesh>(nullptr, TEXT("/Engine/BasicShapes/Cube.Cube"));
+        const int32 GridSize = FMath::Max(FMath::CeilToInt(FMath::Sqrt(static_cast<float>(ActorCount))), 1);
+
+        for (int32 Index = 0; Index < ActorCount; ++Index)
+        {
+            const FVector Location((Index % GridSize) * 200.0, (Index / GridSize) * 200.0, 0.0);
+
+            FActorSpawnParameters SpawnParams;
+            SpawnParams.Name = FName(*FString::Printf(TEXT("MCPBench_%d"), Index));
+            SpawnParams.NameMode = FActorSpawnParameters::ESpawnActorNameMode::Requested;
+
+            AActor *Actor = nullptr;
+            if (Index % 10 == 9)
+            {
+                Actor = World->SpawnActor<APointLight>(Location + FVector(0.0, 0.0, 300.0), FRotator::ZeroRotator, SpawnParams);
+            }
+            else if (AStaticMeshActor *MeshActor = World->SpawnActor<AStaticMeshActor>(Location, FRotator::ZeroRotator, SpawnParams))
+            {
+                MeshActor->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+                Actor = MeshActor;
+            }
+
+            if (Actor)
+            {
+                OutActorNames.Add(Actor->GetName());
+            }
+        }
+
+        MCP_LOG_INFO("Benchmark level created with %d actors", OutActorNames.Num());
+        return World;
+    }
+
+    /** 响应是否表示失败: JSON-RPC error、tools/call 的 isError 或旧格式的 status:error */
+    bool IsErrorResponse(const TArray<uint8> &Body)
+    {
+        FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR *>(Body.GetData()), Body.Num());
+        TSharedPtr<FJsonObject> Response;
+        TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(FString(Converter.Length(), Converter.Get()));
+        if (!FJsonSerializer::Deserialize(Reader, Response) || !Response.IsValid())
+        {
+            return true;
+        }
+
+        if (Response->HasField(TEXT("error")))
+        {
+            return true;
+        }
+
+        bool bIsError = false;
+        const TSharedPtr<FJsonObject> *Result = nullptr;
+        if (Response->TryGetObjectField(TEXT("result"), Result) && (*Result)->TryGetBoolField(TEXT("isError"), bIsError))
+        {
+            return bIsError;
+        }
+
+        FString Status;
+        return Response->TryGetStringField(TEXT("status"), Status) && Status == TEXT("error");
+    }
+
+    /**
+     * FMCPBenchmarkClient - 一个压测连接
+     *
+     * 在独立线程中用非阻塞 Socket 依次发送分配的请求,最多 Concurrency 个请求同时未完成(HTTP 流水线),
+     * 按顺序读取响应并记录从发送到收到完整响应的延迟;收发都以 100 ms 为间隔检查停止请求
+     */
+    class FMCPBenchmarkClient : public FRunnable
+    {
+    public:
+        FMCPBenchmarkClient(int32 InIndex, int32 InPort, int32 InConcurrency)
+            : Index(InIndex), Port(InPort), Concurrency(FMath::Max(InConcurrency, 1)), Socket(nullptr), Thread(nullptr),
+              bStopRequested(false), bDone(false)
+        {
+        }
+
+        virtual ~FMCPBenchmarkClient() override
+        {
+            if (Thread)
+            {
+                Stop();
+                Thread->WaitForCompletion();
+                delete Thread;
+            }
+            if (Socket)
+            {
+                Socket->Close();
+                ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+            }
+        }
+
+        void AddRequest(const FMCPBenchmarkRequest &Request) { Requests.Add(Request); }
+
+        bool Launch()
+        {
+            // Socket 在启动线程前创建,Abort 可以在主线程上安全访问
+            Socket = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->CreateSocket(NAME_Stream, TEXT("MCP benchmark client"), false);
+            Thread = FRunnableThread::Create(this, *FString::Printf(TEXT("MCPBenchmarkClient%d"), Index));
+            return Thread != nullptr;
+        }
+
+        /**
+         * 强制结束未响应停止请求的线程
+         * 关闭 Socket 的收发使阻塞中的连接、收发立即出错返回,再等待线程退出
+         */
+        void Abort()
+        {
+            Stop();
+            if (Socket)
+            {
+                Socket->Shutdown(ESocketShutdownMode::ReadWrite);
+            }
+            if (Thread)
+            {
+                Thread->WaitForCompletion();
+            }
+        }
+
+        bool IsDone() const { return bDone.load(std::memory_order_acquire); }
+
+        /** 分配的请求数,启动后不再变化 */
+        int32 GetRequestCount() const { return Requests.Num(); }
+
+        /** 以下只在 IsDone() 之后读取 */
+        const TArray<FMCPBenchmarkSample> &GetSamples() const { return Samples; }
+        int32 GetFailedCount() const { return Requests.Num() - Samples.Num(); }
+
+        //~ Begin FRunnable Interface
+        virtual uint32 Run() override
+        {
+            RunRequests();
+            bDone.store(true, std::memory_order_release);
+            return 0;
+        }
+
+        virtual void Stop() override { bStopRequested.store(true, std::memory_order_relaxed); }
+        //~ End FRunnable Interface
+
+    private:
+        void RunRequests()
+        {
+            ISocketSubsystem *SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+            bool bValidAddress = false;
+            TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+            Address->SetIp(TEXT("127.0.0.1"), bValidAddress);
+            Address->SetPort(Port);
+            if (!Socket || !bValidAddress || !Socket->Connect(*Address))
+            {
+                MCP_LOG_ERROR("Benchmark client %d could not connect to port %d", Index, Port);
+                return;
+            }
+
+            // 服务器停止读取时阻塞的 Send 无法响应 Stop,连接后改为非阻塞
+            Socket->SetNonBlocking(true);
+
+            TArray<double> SendTimes;
+            SendTimes.SetNumZeroed(Requests.Num());
+            int32 NextToSend = 0;
+
+            while (Samples.Num() < Requests.Num() && !bStopRequested.load(std::memory_order_relaxed))
+            {
+                while (NextToSend < Requests.Num() && NextToSend - Samples.Num() < Concurrency)
+                {
+                    SendTimes[NextToSend] = FPlatformTime::Seconds();
+                    if (!SendAll(Requests[NextToSend].Data))
+                    {
+                        MCP_LOG_ERROR("Benchmark client %d failed to send request %d", Index, NextToSend);
+                        return;
+                    }
+                    ++NextToSend;
+                }
+
+                TArray<uint8> Body;
+                if (!ReceiveResponse(Body))
+                {
+                    MCP_LOG_ERROR("Benchmark client %d did not receive a response to request %d", Index, Samples.Num());
+                    return;
+                }
+
+                const int32 Completed = Samples.Num();
+                FMCPBenchmarkSample &Sample = Samples.AddDefaulted_GetRef();
+                Sample.Tool = Requests[Completed].Tool;
+                Sample.LatencySeconds = FPlatformTime::Seconds() - SendTimes[Completed];
+                Sample.bError = IsErrorResponse(Body);
+            }
+        }
+
+        /** 写出整个请求,停止请求或超时时返回 false */
+        bool SendAll(const TArray<uint8> &Data)
+        {
+            const double Deadline = FPlatformTime::Seconds() + MCPConstants::BENCHMARK_RESPONSE_TIMEOUT_SECONDS;
+            int32 Offset = 0;
+            while (Offset < Data.Num())
+            {
+                if (bStopRequested.load(std::memory_order_relaxed) || FPlatformTime::Seconds() > Deadline)
+                {
+                    return false;
+                }
+
+                if (!Socket->Wait(ESocketWaitConditions::WaitForWrite, FTimespan::FromMilliseconds(100)))
+                {
+                    continue;
+                }
+
+                int32 BytesSent = 0;
+                if (!Socket->Send(Data.GetData() + Offset, Data.Num() - Offset, BytesSent))
+                {
+                    if (ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                Offset += BytesSent;
+            }
+            return true;
+        }
+
+        /** 读取一个完整的 HTTP 响应体,连接关闭或超时时返回 false */
+        bool ReceiveResponse(TArray<uint8> &OutBody)
+        {
+            const double Deadline = FPlatformTime::Seconds() + MCPConstants::BENCHMARK_RESPONSE_TIMEOUT_SECONDS;
+            while (!bStopRequested.load(std::memory_order_relaxed))
+            {
+                if (TryPopResponse(OutBody))
+                {
+                    return true;
+                }
+
+                if (FPlatformTime::Seconds() > Deadline)
+                {
+                    return false;
+                }
+
+                if (!Socket->Wait(ESocketWaitConditions::WaitForRead, FTimespan::FromMilliseconds(100)))
+                {
+                    continue;
+                }
+
+                uint8 Chunk[65536];
+                int32 BytesRead = 0;
+                if (!Socket->Recv(Chunk, sizeof(Chunk), BytesRead))
+                {
+                    if (ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode() == SE_EWOULDBLOCK)
+                    {
+                        continue;
+                    }
+                    return false;
+                }
+                if (BytesRead == 0)
+                {
+                    return false;
+                }
+                Incoming.Append(Chunk, BytesRead);
+            }
+            return false;
+        }
+
+        bool TryPopResponse(TArray<uint8> &OutBody)
+        {
+            const FUtf8StringView Data(reinterpret_cast<const UTF8CHAR *>(Incoming.GetData()), Incoming.Num());
+            const int32 HeaderEnd = Data.Find(UTF8TEXT("\r\n\r\n"));
+            if (HeaderEnd == INDEX_NONE)
+            {
+                return false;
+            }
+
+            const FUtf8StringView Headers = Data.Left(HeaderEnd);
+            const int32 LengthStart = Headers.Find(UTF8TEXT("Content-Length:"), 0, ESearchCase::IgnoreCase);
+            if (LengthStart == INDEX_NONE)
+            {
+                return false;
+            }
+
+            FUTF8ToTCHAR LengthConverter(reinterpret_cast<const ANSICHAR *>(Headers.GetData() + LengthStart + 15),
+                                         Headers.Len() - LengthStart - 15);
+            const int32 BodyLength = FCString::Atoi(*FString(LengthConverter.Length(), LengthConverter.Get()));
+            const int32 BodyStart = HeaderEnd + 4;
+            if (Incoming.Num() - BodyStart < BodyLength)
+            {
+                return false;
+            }
+
+            OutBody = TArray<uint8>(Incoming.GetData() + BodyStart, BodyLength);
+            Incoming.RemoveAt(0, BodyStart + BodyLength, EAllowShrinking::No);
+            return true;
+        }
+
+        int32 Index;
+        int32 Port;
+        int32 Concurrency;
+        FSocket *Socket;
+        FRunnableThread *Thread;
+
+        TArray<FMCPBenchmarkRequest> Requests;
+        TArray<FMCPBenchmarkSample> Samples;
+        TArray<uint8> Incoming;
+
+        std::atomic<bool> bStopRequested;
+        std::atomic<bool> bDone;
+    };
+
+    /** 排序后按最近秩取分位数 */
+    double Percentile(const TArray<double> &Sorted, double Fraction)
+    {
+        if (Sorted.Num() == 0)
+        {
+            return 0.0;
+        }
+        const int32 Rank = FMath::CeilToInt(Fraction * Sorted.Num()) - 1;
+        return Sorted[FMath::Clamp(Rank, 0, Sorted.Num() - 1)];
+    }
+
+    FMCPLatencyStats ComputeStats(TArray<double> &Values, int32 Errors)
+    {
+        FMCPLatencyStats Stats;
+        Stats.Count = Values.Num();
+        Stats.Errors = Errors;
+        if (Values.Num() == 0)
+        {
+            return Stats;
+        }
+
+        Values.Sort();
+        double Sum = 0.0;
+        for (double Value : Values)
+        {
+            Sum += Value;
+        }
+        Stats.P50 = Percentile(Values, 0.50);
+        Stats.P90 = Percentile(Values, 0.90);
+        Stats.P99 = Percentile(Values, 0.99);
+        Stats.Max = Values.Last();
+        Stats.Mean = Sum / Values.Num();
+        return Stats;
+    }
+
+    TSharedPtr<FJsonObject> StatsToJson(const FMCPLatencyStats &Stats)
+    {
+        TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+        Object->SetNumberField("count", Stats.Count);
+        Object->SetNumberField("p50_ms", Stats.P50);
+        Object->SetNumberField("p90_ms", Stats.P90);
+        Object->SetNumberField("p99_ms", Stats.P99);
+        Object->SetNumberField("max_ms", Stats.Max);
+        Object->SetNumberField("mean_ms", Stats.Mean);
+        return Object;
+    }
+
+    FString StatsToCsvRow(const FString &Scope, const FMCPLatencyStats &Stats, double Throughput)
+    {
+        return FString::Printf(TEXT("%s,%d,%d,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f\n"), *Scope, Stats.Count, Stats.Errors, Throughput,
+                               Stats.P50, Stats.P90, Stats.P99, Stats.Max, Stats.Mean);
+    }
+
+    /**
+     * 驱动一帧: 游戏线程任务、FTSTicker(服务器 Tick)和引擎 Tick
+     */
+    void TickEditorFrame(float DeltaSeconds)
+    {
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+        FTSTicker::GetCoreTicker().Tick(DeltaSeconds);
+        if (GEngine)
+        {
+            GEngine->Tick(DeltaSeconds, false);
+        }
+        ++GFrameCounter;
+    }
+}
+
+UMCPBenchmarkCommandlet::UMCPBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = true;
+    LogToConsole = true;
+    ShowErrorCount = true;
+
+    HelpDescription = TEXT("Replays recorded or synthetic MCP traffic against an in-process server and reports throughput, latency and frame time.");
+    HelpUsage = TEXT("UnrealEditor-Cmd <Project> -run=MCPBenchmark -nullrhi [-Trace=<jsonl>] [-Connections=N] [-Concurrency=N] [-Requests=N] "
+                     "[-Actors=N] [-MaxFPS=N] [-Seed=N] [-Output=<path without extension>] [-MaxP99Ms=N] [-MaxErrorRate=F] [-Journal]");
+}
+
+int32 UMCPBenchmarkCommandlet::Main(const FString &Params)
+{
+    FMCPBenchmarkOptions Options;
+    FParse::Value(*Params, TEXT("Trace="), Options.TraceFile);
+    FParse::Value(*Params, TEXT("Output="), Options.OutputBase);
+    FParse::Value(*Params, TEXT("Connections="), Options.Connections);
+    FParse::Value(*Params, TEXT("Concurrency="), Options.Concurrency);
+    FParse::Value(*Params, TEXT("Requests="), Options.Requests);
+    FParse::Value(*Params, TEXT("Actors="), Options.Actors);
+    FParse::Value(*Params, TEXT("MaxFPS="), Options.MaxFPS);
+    FParse::Value(*Params, TEXT("Seed="), Options.Seed);
+    FParse::Value(*Params, TEXT("MaxP99Ms="), Options.MaxP99Ms);
+    FParse::Value(*Params, TEXT("MaxErrorRate="), Options.MaxErrorRate);
+    Options.bJournal = FParse::Param(*Params, TEXT("Journal"));
+    Options.Connections = FMath::Max(Options.Connections, 1);
+    Options.Concurrency = FMath::Max(Options.Concurrency, 1);
+    Options.Actors = FMath::Max(Options.Actors, 0);
+
+    if (Options.OutputBase.IsEmpty())
+    {
+        Options.OutputBase = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MCPBenchmark"),
+                                             FString::Printf(TEXT("MCPBenchmark-%s"), *FDateTime::Now().ToString()));
+    }
+
+    // ============================================================================
+    // 准备关卡和请求
+    // ============================================================================
+
+    TArray<FString> ActorNames;
+    if (!CreateTestLevel(Options.Actors, ActorNames))
+    {
+        return 1;
+    }
+
+    TArray<FMCPBenchmarkRequest> Requests;
+    if (!Options.TraceFile.IsEmpty())
+    {
+        TArray<FMCPBenchmarkRequest> Trace;
+        int32 Skipped = 0;
+        if (!LoadTraceRequests(Options.TraceFile, Trace, Skipped))
+        {
+            return 1;
+        }
+        if (Trace.Num() == 0)
+        {
+            MCP_LOG_ERROR("Trace contains no replayable requests (record it with a payload sample rate of 1)");
+            return 1;
+        }
+        if (Skipped > 0)
+        {
+            MCP_LOG_WARNING("Skipped %d trace entries without a complete payload", Skipped);
+        }
+
+        // 请求数多于日志时循环回放
+        const int32 Count = Options.Requests > 0 ? Options.Requests : Trace.Num();
+        Requests.Reserve(Count);
+        for (int32 Index = 0; Index < Count; ++Index)
+        {
+            Requests.Add(Trace[Index % Trace.Num()]);
+        }
+    }
+    else
+    {
+        BuildSyntheticRequests(Options.Requests > 0 ? Options.Requests : MCPConstants::DEFAULT_BENCHMARK_REQUESTS, Options.Seed,
+                               ActorNames, Requests);
+    }
+
+    // ============================================================================
+    // 启动服务器和客户端
+    // ============================================================================
+
+    FMCPTCPServerConfig Config = FMCPTCPServerConfig::FromSettings(GetDefault<UMCPSettings>());
+    Config.Port = 0;
+    Config.bEnableRequestJournal = Options.bJournal;
+    Config.MaxConcurrentClients = FMath::Max(Config.MaxConcurrentClients, Options.Connections);
+
+    TUniquePtr<FMCPTCPServer> Server = MakeUnique<FMCPTCPServer>(Config);
+    if (!Server->Start())
+    {
+        MCP_LOG_ERROR("Failed to start the MCP server for benchmarking");
+        return 1;
+    }
+    const TSharedPtr<FMCPServerMetrics> &Metrics = Server->GetMetrics();
+
+    // 请求按轮转分配到各连接
+    TArray<TUniquePtr<FMCPBenchmarkClient>> Clients;
+    for (int32 Index = 0; Index < Options.Connections; ++Index)
+    {
+        Clients.Add(MakeUnique<FMCPBenchmarkClient>(Index, Server->GetListenPort(), Options.Concurrency));
+    }
+    for (int32 Index = 0; Index < Requests.Num(); ++Index)
+    {
+        Clients[Index % Clients.Num()]->AddRequest(Requests[Index]);
+    }
+
+    MCP_LOG_INFO("Benchmark: %d requests (%s) over %d connections, concurrency %d, max %.0f FPS",
+                 Requests.Num(), Options.TraceFile.IsEmpty() ? TEXT("synthetic") : *Options.TraceFile,
+                 Options.Connections, Options.Concurrency, Options.MaxFPS);
+
+    const double StartTime = FPlatformTime::Seconds();
+    for (const TUniquePtr<FMCPBenchmarkClient> &Client : Clients)
+    {
+        if (!Client->Launch())
+        {
+            MCP_LOG_ERROR("Failed to create a benchmark client thread");
+            return 1;
+        }
+    }
+
+    // ============================================================================
+    // 帧循环: 以 MaxFPS 为上限驱动编辑器,直到所有连接完成
+    // ============================================================================
+
+    const double TargetFrameSeconds = Options.MaxFPS > 0.0f ? 1.0 / Options.MaxFPS : 0.0;
+    const double Deadline = StartTime + MCPConstants::BENCHMARK_TIMEOUT_SECONDS;
+    float DeltaSeconds = TargetFrameSeconds > 0.0 ? static_cast<float>(TargetFrameSeconds) : 1.0f / 60.0f;
+
+    TArray<double> FrameMilliseconds;
+    TArray<double> BusyMilliseconds;
+    TArray<double> MCPMilliseconds;
+    bool bTimedOut = false;
+
+    while (true)
+    {
+        const bool bAllDone = Clients.FindByPredicate([](const TUniquePtr<FMCPBenchmarkClient> &Client)
+                                                      { return !Client->IsDone(); }) == nullptr;
+        if (bAllDone)
+        {
+            break;
+        }
+        if (FPlatformTime::Seconds() > Deadline)
+        {
+            bTimedOut = true;
+            break;
+        }
+
+        const double FrameStart = FPlatformTime::Seconds();
+        TickEditorFrame(DeltaSeconds);
+        const double BusySeconds = FPlatformTime::Seconds() - FrameStart;
+
+        if (BusySeconds < TargetFrameSeconds)
+        {
+            FPlatformProcess::Sleep(static_cast<float>(TargetFrameSeconds - BusySeconds));
+        }
+        const double FrameSeconds = FPlatformTime::Seconds() - FrameStart;
+
+        // 服务器在帧结束时记录本帧的 MCP 游戏线程时间
+        const double MCPSecondsBefore = Metrics->GetGameThreadSecondsTotal();
+        FApp::SetDeltaTime(FrameSeconds);
+        FCoreDelegates::OnEndFrame.Broadcast();
+
+        FrameMilliseconds.Add(FrameSeconds * 1000.0);
+        BusyMilliseconds.Add(BusySeconds * 1000.0);
+        MCPMilliseconds.Add((Metrics->GetGameThreadSecondsTotal() - MCPSecondsBefore) * 1000.0);
+        DeltaSeconds = static_cast<float>(FrameSeconds);
+    }
+
+    const double DurationSeconds = FPlatformTime::Seconds() - StartTime;
+    if (bTimedOut)
+    {
+        MCP_LOG_ERROR("Benchmark timed out after %.0f seconds", DurationSeconds);
+        for (const TUniquePtr<FMCPBenchmarkClient> &Client : Clients)
+        {
+            Client->Stop();
+        }
+    }
+
+    // 等待线程退出后再读取样本;线程每 100 ms 检查一次停止请求,等待有时限
+    const double StopDeadline = FPlatformTime::Seconds() + MCPConstants::BENCHMARK_STOP_TIMEOUT_SECONDS;
+    for (const TUniquePtr<FMCPBenchmarkClient> &Client : Clients)
+    {
+        while (!Client->IsDone() && FPlatformTime::Seconds() < StopDeadline)
+        {
+            FPlatformProcess::Sleep(0.01f);
+        }
+    }
+
+    // 仍未退出的线程强制结束;它的样本不完整,全部请求计为失败
+    int32 AbortedRequests = 0;
+    for (int32 Index = Clients.Num() - 1; Index >= 0; --Index)
+    {
+        if (!Clients[Index]->IsDone())
+        {
+            MCP_LOG_ERROR("Benchmark client thread %d did not stop, closing its socket", Index);
+            Clients[Index]->Abort();
+            AbortedRequests += Clients[Index]->GetRequestCount();
+            Clients.RemoveAt(Index);
+        }
+    }
+
+    // ============================================================================
+    // 统计
+    // ============================================================================
+
+    TMap<FString, TArray<double>> ToolLatencies;
+    TMap<FString, int32> ToolErrors;
+    TArray<double> AllLatencies;
+    int32 TotalErrors = 0;
+    int32 TotalFailed = AbortedRequests;
+
+    for (const TUniquePtr<FMCPBenchmarkClient> &Client : Clients)
+    {
+        TotalFailed += Client->GetFailedCount();
+        for (const FMCPBenchmarkSample &Sample : Client->GetSamples())
+        {
+            const double Milliseconds = Sample.LatencySeconds * 1000.0;
+            ToolLatencies.FindOrAdd(Sample.Tool).Add(Milliseconds);
+            AllLatencies.Add(Milliseconds);
+            if (Sample.bError)
+            {
+                ToolErrors.FindOrAdd(Sample.Tool)++;
+                ++TotalErrors;
+            }
+        }
+    }
+
+    Clients.Reset();
+    Server->Stop();
+    Server.Reset();
+
+    const int32 Completed = AllLatencies.Num();
+    const double Throughput = DurationSeconds > 0.0 ? Completed / DurationSeconds : 0.0;
+    const FMCPLatencyStats Overall = ComputeStats(AllLatencies, TotalErrors);
+    const FMCPLatencyStats FrameStats = ComputeStats(FrameMilliseconds, 0);
+    const FMCPLatencyStats BusyStats = ComputeStats(BusyMilliseconds, 0);
+    const FMCPLatencyStats MCPFrameStats = ComputeStats(MCPMilliseconds, 0);
+    const double MCPFrameShare = FrameStats.Mean > 0.0 ? MCPFrameStats.Mean / FrameStats.Mean : 0.0;
+
+    ToolLatencies.KeySort(TLess<FString>());
+    TArray<TPair<FString, FMCPLatencyStats>> ToolStats;
+    for (TPair<FString, TArray<double>> &Pair : ToolLatencies)
+    {
+        ToolStats.Emplace(Pair.Key, ComputeStats(Pair.Value, ToolErrors.FindRef(Pair.Key)));
+    }
+
+    // ============================================================================
+    // 报告
+    // ============================================================================
+
+    TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+    Report->SetStringField("mode", Options.TraceFile.IsEmpty() ? TEXT("synthetic") : TEXT("trace"));
+    if (!Options.TraceFile.IsEmpty())
+    {
+        Report->SetStringField("trace", Options.TraceFile);
+    }
+    Report->SetNumberField("connections", Options.Connections);
+    Report->SetNumberField("concurrency", Options.Concurrency);
+    Report->SetNumberField("actors", ActorNames.Num());
+    Report->SetNumberField("max_fps", Options.MaxFPS);
+    Report->SetNumberField("requests", Requests.Num());
+    Report->SetNumberField("completed", Completed);
+    Report->SetNumberField("errors", TotalErrors);
+    Report->SetNumberField("failed", TotalFailed);
+    Report->SetBoolField("timed_out", bTimedOut);
+    Report->SetNumberField("duration_s", DurationSeconds);
+    Report->SetNumberField("throughput_rps", Throughput);
+    Report->SetObjectField("latency", StatsToJson(Overall));
+
+    TArray<TSharedPtr<FJsonValue>> ToolsArray;
+    for (const TPair<FString, FMCPLatencyStats> &Pair : ToolStats)
+    {
+        TSharedPtr<FJsonObject> ToolObject = StatsToJson(Pair.Value);
+        ToolObject->SetStringField("tool", Pair.Key);
+        ToolObject->SetNumberField("errors", Pair.Value.Errors);
+        ToolsArray.Add(MakeShared<FJsonValueObject>(ToolObject));
+    }
+    Report->SetArrayField("tools", ToolsArray);
+
+    TSharedPtr<FJsonObject> Frames = MakeShared<FJsonObject>();
+    Frames->SetObjectField("frame", StatsToJson(FrameStats));
+    Frames->SetObjectField("busy", StatsToJson(BusyStats));
+    Frames->SetObjectField("mcp", StatsToJson(MCPFrameStats));
+    Frames->SetNumberField("mcp_share", MCPFrameShare);
+    Report->SetObjectField("frames", Frames);
+
+    FString JsonText;
+    TSharedRef<TJsonWriter<>> JsonWriter = TJsonWriterFactory<>::Create(&JsonText);
+    FJsonSerializer::Serialize(Report, JsonWriter);
+
+    // CSV 每行一个范围: all、各工具,以及帧时间 (frame)、帧中非等待部分 (frame_busy) 和 MCP 占用 (frame_mcp)
+    FString CsvText = TEXT("scope,count,errors,throughput_rps,p50_ms,p90_ms,p99_ms,max_ms,mean_ms\n");
+    CsvText += StatsToCsvRow(TEXT("all"), Overall, Throughput);
+    for (const TPair<FString, FMCPLatencyStats> &Pair : ToolStats)
+    {
+        CsvText += StatsToCsvRow(Pair.Key, Pair.Value, DurationSeconds > 0.0 ? Pair.Value.Count / DurationSeconds : 0.0);
+    }
+    CsvText += StatsToCsvRow(TEXT("frame"), FrameStats, 0.0);
+    CsvText += StatsToCsvRow(TEXT("frame_busy"), BusyStats, 0.0);
+    CsvText += StatsToCsvRow(TEXT("frame_mcp"), MCPFrameStats, 0.0);
+
+    const FString JsonPath = Options.OutputBase + TEXT(".json");
+    const FString CsvPath = Options.OutputBase + TEXT(".csv");
+    if (!FFileHelper::SaveStringToFile(JsonText, *JsonPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM) ||
+        !FFileHelper::SaveStringToFile(CsvText, *CsvPath, FFileHelper::EEncodingOptions::ForceUTF8WithoutBOM))
+    {
+        MCP_LOG_ERROR("Failed to write benchmark report to %s", *Options.OutputBase);
+        return 1;
+    }
+
+    MCP_LOG_INFO("Benchmark: %d/%d completed in %.2f s (%.1f req/s), %d errors, p50 %.2f ms, p99 %.2f ms",
+                 Completed, Requests.Num(), DurationSeconds, Throughput, TotalErrors, Overall.P50, Overall.P99);
+    MCP_LOG_INFO("Benchmark frames: avg %.2f ms, p99 %.2f ms, MCP avg %.3f ms (%.1f%%)",
+                 FrameStats.Mean, FrameStats.P99, MCPFrameStats.Mean, MCPFrameShare * 100.0);
+    MCP_LOG_INFO("Benchmark report: %s", *JsonPath);
+
+    // ============================================================================
+    // 门限
+    // ============================================================================
+
+    int32 ReturnCode = 0;
+    if (TotalFailed > 0 || bTimedOut)
+    {
+        MCP_LOG_ERROR("%d requests did not complete", TotalFailed);
+        ReturnCode = 1;
+    }
+    if (Options.MaxErrorRate >= 0.0f && Completed > 0 && static_cast<double>(TotalErrors) / Completed > Options.MaxErrorRate)
+    {
+        MCP_LOG_ERROR("Error rate %.3f exceeds -MaxErrorRate=%.3f", static_cast<double>(TotalErrors) / Completed, Options.MaxErrorRate);
+        ReturnCode = 1;
+    }
+    if (Options.MaxP99Ms >= 0.0f)
+    {
+        for (const TPair<FString, FMCPLatencyStats> &Pair : ToolStats)
+        {
+            if (Pair.Value.P99 > Options.MaxP99Ms)
+            {
+                MCP_LOG_ERROR("%s p99 %.2f ms exceeds -MaxP99Ms=%.2f", *Pair.Key, Pair.Value.P99, Options.MaxP99Ms);
+                ReturnCode = 1;
+            }
+        }
+    }
+    return ReturnCode;
+}
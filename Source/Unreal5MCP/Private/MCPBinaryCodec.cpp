@@ -0,0 +1,786 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPBinaryCodec.h"
+#include "MCPJsonPullParser.h"
+#include "MCPConstants.h"
+#include "Dom/JsonObject.h"
+#include "Math/Float16.h"
+
+namespace
+{
+    /** 容器头的最大长度: MessagePack 的 array32/map32 和 CBOR 的 32 位长度都是 5 字节 */
+    constexpr int32 MAX_CONTAINER_HEADER_SIZE = 5;
+
+    /** 按大端序写入 Bytes 个字节,返回写入的字节数 */
+    int32 WriteBigEndian(uint64 Value, int32 Bytes, uint8 *Out)
+    {
+        for (int32 Index = Bytes - 1; Index >= 0; --Index)
+        {
+            Out[Index] = static_cast<uint8>(Value & 0xFF);
+            Value >>= 8;
+        }
+        return Bytes;
+    }
+
+    /** CBOR 的初始字节和参数,返回写入的字节数 */
+    int32 WriteCborHead(uint8 MajorType, uint64 Argument, uint8 *Out)
+    {
+        const uint8 Major = static_cast<uint8>(MajorType << 5);
+        if (Argument < 24)
+        {
+            Out[0] = Major | static_cast<uint8>(Argument);
+            return 1;
+        }
+        if (Argument <= 0xFF)
+        {
+            Out[0] = Major | 24;
+            return 1 + WriteBigEndian(Argument, 1, Out + 1);
+        }
+        if (Argument <= 0xFFFF)
+        {
+            Out[0] = Major | 25;
+            return 1 + WriteBigEndian(Argument, 2, Out + 1);
+        }
+        if (Argument <= 0xFFFFFFFF)
+        {
+            Out[0] = Major | 26;
+            return 1 + WriteBigEndian(Argument, 4, Out + 1);
+        }
+        Out[0] = Major | 27;
+        return 1 + WriteBigEndian(Argument, 8, Out + 1);
+    }
+
+    /**
+     * 二进制编码器
+     * 容器开始时元素个数未知,先预留最大长度的容器头,结束时写入实际的头并把内容前移
+     */
+    class FEncoder
+    {
+    public:
+        FEncoder(EMCPWireFormat InFormat, TArray<uint8> &InData)
+            : Format(InFormat), Data(InData)
+        {
+        }
+
+        void BeginContainer(bool bIsMap)
+        {
+            CountElement();
+            Containers.Add({Data.Num(), 0, bIsMap});
+            Data.AddUninitialized(MAX_CONTAINER_HEADER_SIZE);
+        }
+
+        void EndContainer()
+        {
+            const FContainer Container = Containers.Pop(EAllowShrinking::No);
+
+            uint8 Header[MAX_CONTAINER_HEADER_SIZE];
+            int32 HeaderSize = 0;
+            if (Format == EMCPWireFormat::Cbor)
+            {
+                HeaderSize = WriteCborHead(Container.bIsMap ? 5 : 4, Container.Count, Header);
+            }
+            else if (Container.Count < 16)
+            {
+                Header[0] = static_cast<uint8>((Container.bIsMap ? 0x80 : 0x90) | Container.Count);
+                HeaderSize = 1;
+            }
+            else if (Container.Count <= 0xFFFF)
+            {
+                Header[0] = Container.bIsMap ? 0xDE : 0xDC;
+                HeaderSize = 1 + WriteBigEndian(Container.Count, 2, Header + 1);
+            }
+            else
+            {
+                Header[0] = Container.bIsMap ? 0xDF : 0xDD;
+                HeaderSize = 1 + WriteBigEndian(Container.Count, 4, Header + 1);
+            }
+
+            const int32 ContentStart = Container.HeaderOffset + MAX_CONTAINER_HEADER_SIZE;
+            const int32 Shift = MAX_CONTAINER_HEADER_SIZE - HeaderSize;
+            if (Shift > 0)
+            {
+                FMemory::Memmove(Data.GetData() + ContentStart - Shift, Data.GetData() + ContentStart, Data.Num() - ContentStart);
+                Data.SetNum(Data.Num() - Shift, EAllowShrinking::No);
+            }
+            FMemory::Memcpy(Data.GetData() + Container.HeaderOffset, Header, HeaderSize);
+        }
+
+        void WriteKey(const FString &Key)
+        {
+            // map 的元素个数按键计数
+            ++Containers.Last().Count;
+            AppendString(Key);
+        }
+
+        void WriteString(const FString &Value)
+        {
+            CountElement();
+            AppendString(Value);
+        }
+
+        void WriteNumber(double Value)
+        {
+            if (FMath::IsFinite(Value) && FMath::Abs(Value) < 9223372036854775808.0 && FMath::RoundToDouble(Value) == Value)
+            {
+                WriteInteger(static_cast<int64>(Value));
+                return;
+            }
+
+            CountElement();
+
+            // float32 能精确表示时用 4 字节,坐标等数据大多如此
+            const float SingleValue = static_cast<float>(Value);
+            if (static_cast<double>(SingleValue) == Value)
+            {
+                uint32 Bits = 0;
+                FMemory::Memcpy(&Bits, &SingleValue, sizeof(Bits));
+                AppendHeadAndValue(Format == EMCPWireFormat::Cbor ? 0xFA : 0xCA, Bits, 4);
+            }
+            else
+            {
+                uint64 Bits = 0;
+                FMemory::Memcpy(&Bits, &Value, sizeof(Bits));
+                AppendHeadAndValue(Format == EMCPWireFormat::Cbor ? 0xFB : 0xCB, Bits, 8);
+            }
+        }
+
+        void WriteInteger(int64 Value)
+        {
+            CountElement();
+
+            if (Format == EMCPWireFormat::Cbor)
+            {
+                uint8 Head[9];
+                const int32 HeadSize = Value >= 0 ? WriteCborHead(0, static_cast<uint64>(Value), Head)
+                                                  : WriteCborHead(1, static_cast<uint64>(-1 - Value), Head);
+                Data.Append(Head, HeadSize);
+                return;
+            }
+
+            if (Value >= 0)
+            {
+                if (Value < 128)
+                {
+                    Data.Add(static_cast<uint8>(Value));
+                }
+                else if (Value <= 0xFF)
+                {
+                    AppendHeadAndValue(0xCC, Value, 1);
+                }
+                else if (Value <= 0xFFFF)
+                {
+                    AppendHeadAndValue(0xCD, Value, 2);
+                }
+                else if (Value <= 0xFFFFFFFF)
+                {
+                    AppendHeadAndValue(0xCE, Value, 4);
+                }
+                else
+                {
+                    AppendHeadAndValue(0xCF, Value, 8);
+                }
+            }
+            else if (Value >= -32)
+            {
+                Data.Add(static_cast<uint8>(Value));
+            }
+            else if (Value >= MIN_int8)
+            {
+                AppendHeadAndValue(0xD0, static_cast<uint8>(Value), 1);
+            }
+            else if (Value >= MIN_int16)
+            {
+                AppendHeadAndValue(0xD1, static_cast<uint16>(Value), 2);
+            }
+            else if (Value >= MIN_int32)
+            {
+                AppendHeadAndValue(0xD2, static_cast<uint32>(Value), 4);
+            }
+            else
+            {
+                AppendHeadAndValue(0xD3, static_cast<uint64>(Value), 8);
+            }
+        }
+
+        void WriteBool(bool Value)
+        {
+            CountElement();
+            if (Format == EMCPWireFormat::Cbor)
+            {
+                Data.Add(Value ? 0xF5 : 0xF4);
+            }
+            else
+            {
+                Data.Add(Value ? 0xC3 : 0xC2);
+            }
+        }
+
+        void WriteNull()
+        {
+            CountElement();
+            Data.Add(Format == EMCPWireFormat::Cbor ? 0xF6 : 0xC0);
+        }
+
+    private:
+        /** 一层 map 或数组 */
+        struct FContainer
+        {
+            int32 HeaderOffset;
+            int32 Count;
+            bool bIsMap;
+        };
+
+        /** 数组中的每个值计为一个元素;map 中的值不计数 */
+        void CountElement()
+        {
+            if (Containers.Num() > 0 && !Containers.Last().bIsMap)
+            {
+                ++Containers.Last().Count;
+            }
+        }
+
+        void AppendHeadAndValue(uint8 Head, uint64 Value, int32 Bytes)
+        {
+            uint8 Buffer[9];
+            Buffer[0] = Head;
+            Data.Append(Buffer, 1 + WriteBigEndian(Value, Bytes, Buffer + 1));
+        }
+
+        void AppendString(const FString &Value)
+        {
+            FTCHARToUTF8 Converter(*Value, Value.Len());
+            const uint64 Length = static_cast<uint64>(Converter.Length());
+
+            uint8 Head[9];
+            int32 HeadSize = 0;
+            if (Format == EMCPWireFormat::Cbor)
+            {
+                HeadSize = WriteCborHead(3, Length, Head);
+            }
+            else if (Length < 32)
+            {
+                Head[0] = static_cast<uint8>(0xA0 | Length);
+                HeadSize = 1;
+            }
+            else if (Length <= 0xFF)
+            {
+                Head[0] = 0xD9;
+                HeadSize = 1 + WriteBigEndian(Length, 1, Head + 1);
+            }
+            else if (Length <= 0xFFFF)
+            {
+                Head[0] = 0xDA;
+                HeadSize = 1 + WriteBigEndian(Length, 2, Head + 1);
+            }
+            else
+            {
+                Head[0] = 0xDB;
+                HeadSize = 1 + WriteBigEndian(Length, 4, Head + 1);
+            }
+
+            Data.Append(Head, HeadSize);
+            Data.Append(reinterpret_cast<const uint8 *>(Converter.Get()), Converter.Length());
+        }
+
+        EMCPWireFormat Format;
+        TArray<uint8> &Data;
+        TArray<FContainer, TInlineAllocator<16>> Containers;
+    };
+
+    /**
+     * 二进制解码器
+     * 递归构建 FJsonValue,嵌套深度受 MAX_JSON_NESTING_DEPTH 限制
+     */
+    class FDecoder
+    {
+    public:
+        FDecoder(EMCPWireFormat InFormat, const uint8 *InData, int32 InLength)
+            : Format(InFormat), Data(InData), Length(InData ? InLength : 0), Position(0)
+        {
+        }
+
+        TSharedPtr<FJsonValue> DecodeRoot()
+        {
+            TSharedPtr<FJsonValue> Value = DecodeValue(0);
+            if (Value.IsValid() && Position < Length)
+            {
+                Fail(TEXT("Unexpected data after root value"));
+                return nullptr;
+            }
+            return Value;
+        }
+
+        const FString &GetError() const { return ErrorMessage; }
+
+    private:
+        TSharedPtr<FJsonValue> DecodeValue(int32 Depth)
+        {
+            return Format == EMCPWireFormat::Cbor ? DecodeCbor(Depth) : DecodeMessagePack(Depth);
+        }
+
+        TSharedPtr<FJsonValue> DecodeMessagePack(int32 Depth)
+        {
+            uint8 Head = 0;
+            if (!ReadByte(Head))
+            {
+                return nullptr;
+            }
+
+            if (Head <= 0x7F)
+            {
+                return MakeShared<FJsonValueNumber>(Head);
+            }
+            if (Head >= 0xE0)
+            {
+                return MakeShared<FJsonValueNumber>(static_cast<int8>(Head));
+            }
+            if (Head >= 0x80 && Head <= 0x8F)
+            {
+                return DecodeMap(Head & 0x0F, false, Depth);
+            }
+            if (Head >= 0x90 && Head <= 0x9F)
+            {
+                return DecodeArray(Head & 0x0F, false, Depth);
+            }
+            if (Head >= 0xA0 && Head <= 0xBF)
+            {
+                return DecodeString(Head & 0x1F);
+            }
+
+            uint64 Value = 0;
+            switch (Head)
+            {
+            case 0xC0:
+                return MakeShared<FJsonValueNull>();
+            case 0xC2:
+                return MakeShared<FJsonValueBoolean>(false);
+            case 0xC3:
+                return MakeShared<FJsonValueBoolean>(true);
+            case 0xCA:
+                return ReadBigEndian(4, Value) ? MakeShared<FJsonValueNumber>(BitsToFloat(static_cast<uint32>(Value))) : nullptr;
+            case 0xCB:
+                return ReadBigEndian(8, Value) ? MakeShared<FJsonValueNumber>(BitsToDouble(Value)) : nullptr;
+            case 0xCC:
+            case 0xCD:
+            case 0xCE:
+            case 0xCF:
+                return ReadBigEndian(1 << (Head - 0xCC), Value) ? MakeShared<FJsonValueNumber>(static_cast<double>(Value)) : nullptr;
+            case 0xD0:
+                return ReadBigEndian(1, Value) ? MakeShared<FJsonValueNumber>(static_cast<int8>(Value)) : nullptr;
+            case 0xD1:
+                return ReadBigEndian(2, Value) ? MakeShared<FJsonValueNumber>(static_cast<int16>(Value)) : nullptr;
+            case 0xD2:
+                return ReadBigEndian(4, Value) ? MakeShared<FJsonValueNumber>(static_cast<int32>(Value)) : nullptr;
+            case 0xD3:
+                return ReadBigEndian(8, Value) ? MakeShared<FJsonValueNumber>(static_cast<double>(static_cast<int64>(Value))) : nullptr;
+            case 0xD9:
+            case 0xDA:
+            case 0xDB:
+                return ReadBigEndian(1 << (Head - 0xD9), Value) ? DecodeString(Value) : nullptr;
+            case 0xDC:
+            case 0xDD:
+                return ReadBigEndian(Head == 0xDC ? 2 : 4, Value) ? DecodeArray(Value, false, Depth) : nullptr;
+            case 0xDE:
+            case 0xDF:
+                return ReadBigEndian(Head == 0xDE ? 2 : 4, Value) ? DecodeMap(Value, false, Depth) : nullptr;
+            default:
+                // bin / ext / fixext 以及保留的 0xC1
+                Fail(TEXT("Unsupported MessagePack type"));
+                return nullptr;
+            }
+        }
+
+        TSharedPtr<FJsonValue> DecodeCbor(int32 Depth)
+        {
+            // 标签(主类型 6)不影响数据模型: 连续的标签头在循环中跳过,
+            // 不能递归解码,否则由大量 0xC6 组成的请求体会耗尽栈
+            uint8 Head = 0;
+            while (true)
+            {
+                if (!ReadByte(Head))
+                {
+                    return nullptr;
+                }
+                if ((Head >> 5) != 6)
+                {
+                    break;
+                }
+
+                uint64 Tag = 0;
+                if (!ReadCborArgument(Head & 0x1F, Tag))
+                {
+                    return nullptr;
+                }
+            }
+
+            const uint8 MajorType = Head >> 5;
+            const uint8 Info = Head & 0x1F;
+
+            // 数组和 map 允许不定长(以 0xFF 结束)
+            if ((MajorType == 4 || MajorType == 5) && Info == 31)
+            {
+                return MajorType == 4 ? DecodeArray(0, true, Depth) : DecodeMap(0, true, Depth);
+            }
+
+            if (MajorType == 7)
+            {
+                uint64 Value = 0;
+                switch (Info)
+                {
+                case 20:
+                    return MakeShared<FJsonValueBoolean>(false);
+                case 21:
+                    return MakeShared<FJsonValueBoolean>(true);
+                case 22:
+                case 23:
+                    return MakeShared<FJsonValueNull>();
+                case 25:
+                {
+                    if (!ReadBigEndian(2, Value))
+                    {
+                        return nullptr;
+                    }
+                    FFloat16 Half;
+                    Half.Encoded = static_cast<uint16>(Value);
+                    return MakeShared<FJsonValueNumber>(Half.GetFloat());
+                }
+                case 26:
+                    return ReadBigEndian(4, Value) ? MakeShared<FJsonValueNumber>(BitsToFloat(static_cast<uint32>(Value))) : nullptr;
+                case 27:
+                    return ReadBigEndian(8, Value) ? MakeShared<FJsonValueNumber>(BitsToDouble(Value)) : nullptr;
+                default:
+                    Fail(TEXT("Unsupported CBOR simple value"));
+                    return nullptr;
+                }
+            }
+
+            uint64 Argument = 0;
+            if (!ReadCborArgument(Info, Argument))
+            {
+                return nullptr;
+            }
+
+            switch (MajorType)
+            {
+            case 0:
+                return MakeShared<FJsonValueNumber>(static_cast<double>(Argument));
+            case 1:
+                return MakeShared<FJsonValueNumber>(-1.0 - static_cast<double>(Argument));
+            case 3:
+                return DecodeString(Argument);
+            case 4:
+                return DecodeArray(Argument, false, Depth);
+            case 5:
+                return DecodeMap(Argument, false, Depth);
+            default:
+                Fail(TEXT("Unsupported CBOR type"));
+                return nullptr;
+            }
+        }
+
+        bool ReadCborArgument(uint8 Info, uint64 &OutArgument)
+        {
+            if (Info < 24)
+            {
+                OutArgument = Info;
+                return true;
+            }
+            if (Info <= 27)
+            {
+                return ReadBigEndian(1 << (Info - 24), OutArgument);
+            }
+            Fail(Info == 31 ? TEXT("Indefinite-length strings are not supported") : TEXT("Invalid CBOR argument"));
+            return false;
+        }
+
+        TSharedPtr<FJsonValue> DecodeString(uint64 StringLength)
+        {
+            if (StringLength > static_cast<uint64>(Length - Position))
+            {
+                Fail(TEXT("Unexpected end of data"));
+                return nullptr;
+            }
+
+            FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR *>(Data + Position), static_cast<int32>(StringLength));
+            Position += static_cast<int32>(StringLength);
+            return MakeShared<FJsonValueString>(FString(Converter.Length(), Converter.Get()));
+        }
+
+        TSharedPtr<FJsonValue> DecodeArray(uint64 Count, bool bIndefinite, int32 Depth)
+        {
+            if (!EnterContainer(Count, Depth))
+            {
+                return nullptr;
+            }
+
+            TArray<TSharedPtr<FJsonValue>> Elements;
+            Elements.Reserve(static_cast<int32>(Count));
+            for (uint64 Index = 0; bIndefinite ? !ReadBreak() : Index < Count; ++Index)
+            {
+                TSharedPtr<FJsonValue> Element = DecodeValue(Depth + 1);
+                if (!Element.IsValid())
+                {
+                    return nullptr;
+                }
+                Elements.Add(Element);
+            }
+            return ErrorMessage.IsEmpty() ? MakeShared<FJsonValueArray>(Elements) : nullptr;
+        }
+
+        TSharedPtr<FJsonValue> DecodeMap(uint64 Count, bool bIndefinite, int32 Depth)
+        {
+            if (!EnterContainer(Count, Depth))
+            {
+                return nullptr;
+            }
+
+            TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+            for (uint64 Index = 0; bIndefinite ? !ReadBreak() : Index < Count; ++Index)
+            {
+                TSharedPtr<FJsonValue> Key = DecodeValue(Depth + 1);
+                if (!Key.IsValid())
+                {
+                    return nullptr;
+                }
+                if (Key->Type != EJson::String)
+                {
+                    Fail(TEXT("Map keys must be strings"));
+                    return nullptr;
+                }
+
+                TSharedPtr<FJsonValue> Value = DecodeValue(Depth + 1);
+                if (!Value.IsValid())
+                {
+                    return nullptr;
+                }
+                Object->SetField(Key->AsString(), Value);
+            }
+            return ErrorMessage.IsEmpty() ? MakeShared<FJsonValueObject>(Object) : nullptr;
+        }
+
+        /** 检查嵌套深度和元素个数(每个元素至少 1 字节,避免按伪造的个数预分配) */
+        bool EnterContainer(uint64 Count, int32 Depth)
+        {
+            if (Depth >= MCPConstants::MAX_JSON_NESTING_DEPTH)
+            {
+                Fail(TEXT("Nesting too deep"));
+                return false;
+            }
+            if (Count > static_cast<uint64>(Length - Position))
+            {
+                Fail(TEXT("Unexpected end of data"));
+                return false;
+            }
+            return true;
+        }
+
+        /** 不定长容器: 读到结束标记 0xFF 时返回 true */
+        bool ReadBreak()
+        {
+            if (Position >= Length)
+            {
+                Fail(TEXT("Unexpected end of data"));
+                return true;
+            }
+            if (Data[Position] == 0xFF)
+            {
+                ++Position;
+                return true;
+            }
+            return false;
+        }
+
+        bool ReadByte(uint8 &OutByte)
+        {
+            if (Position >= Length)
+            {
+                Fail(TEXT("Unexpected end of data"));
+                return false;
+            }
+            OutByte = Data[Position++];
+            return true;
+        }
+
+        bool ReadBigEndian(int32 Bytes, uint64 &OutValue)
+        {
+            if (Position + Bytes > Length)
+            {
+                Fail(TEXT("Unexpected end of data"));
+                return false;
+            }
+
+            OutValue = 0;
+            for (int32 Index = 0; Index < Bytes; ++Index)
+            {
+                OutValue = (OutValue << 8) | Data[Position + Index];
+            }
+            Position += Bytes;
+            return true;
+        }
+
+        static double BitsToFloat(uint32 Bits)
+        {
+            float Value = 0.0f;
+            FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+            return Value;
+        }
+
+        static double BitsToDouble(uint64 Bits)
+        {
+            double Value = 0.0;
+            FMemory::Memcpy(&Value, &Bits, sizeof(Value));
+            return Value;
+        }
+
+        void Fail(const TCHAR *Message)
+        {
+            if (ErrorMessage.IsEmpty())
+            {
+                ErrorMessage = FString::Printf(TEXT("%s at offset %d"), Message, Position);
+            }
+        }
+
+        EMCPWireFormat Format;
+        const uint8 *Data;
+        int32 Length;
+        int32 Position;
+        FString ErrorMessage;
+    };
+}
+
+EMCPWireFormat FMCPBinaryCodec::FromMimeType(FUtf8StringView MimeType)
+{
+    // 去掉 ";charset=..." 等参数
+    int32 Semicolon = INDEX_NONE;
+    if (MimeType.FindChar(';', Semicolon))
+    {
+        MimeType.LeftInline(Semicolon);
+    }
+    MimeType.TrimStartAndEndInline();
+
+    if (MimeType.Equals(UTF8TEXT("application/vnd.msgpack"), ESearchCase::IgnoreCase) ||
+        MimeType.Equals(UTF8TEXT("application/msgpack"), ESearchCase::IgnoreCase) ||
+        MimeType.Equals(UTF8TEXT("application/x-msgpack"), ESearchCase::IgnoreCase))
+    {
+        return EMCPWireFormat::MessagePack;
+    }
+    if (MimeType.Equals(UTF8TEXT("application/cbor"), ESearchCase::IgnoreCase))
+    {
+        return EMCPWireFormat::Cbor;
+    }
+    return EMCPWireFormat::Json;
+}
+
+bool FMCPBinaryCodec::FindAcceptedFormat(FUtf8StringView Accept, EMCPWireFormat &OutFormat)
+{
+    while (!Accept.IsEmpty())
+    {
+        int32 Comma = INDEX_NONE;
+        FUtf8StringView Item = Accept;
+        if (Accept.FindChar(',', Comma))
+        {
+            Item = Accept.Left(Comma);
+            Accept.RightChopInline(Comma + 1);
+        }
+        else
+        {
+            Accept.Reset();
+        }
+
+        const EMCPWireFormat Format = FromMimeType(Item);
+        if (Format != EMCPWireFormat::Json)
+        {
+            OutFormat = Format;
+            return true;
+        }
+    }
+    return false;
+}
+
+const TCHAR *FMCPBinaryCodec::GetMimeType(EMCPWireFormat Format)
+{
+    switch (Format)
+    {
+    case EMCPWireFormat::MessagePack:
+        return TEXT("application/vnd.msgpack");
+    case EMCPWireFormat::Cbor:
+        return TEXT("application/cbor");
+    default:
+        return TEXT("application/json");
+    }
+}
+
+const TCHAR *FMCPBinaryCodec::GetFormatName(EMCPWireFormat Format)
+{
+    switch (Format)
+    {
+    case EMCPWireFormat::MessagePack:
+        return TEXT("MessagePack");
+    case EMCPWireFormat::Cbor:
+        return TEXT("CBOR");
+    default:
+        return TEXT("JSON");
+    }
+}
+
+TSharedPtr<FJsonValue> FMCPBinaryCodec::Decode(EMCPWireFormat Format, const uint8 *Data, int32 Length, FString &OutError)
+{
+    if (Format == EMCPWireFormat::Json)
+    {
+        OutError = TEXT("Not a binary format");
+        return nullptr;
+    }
+
+    FDecoder Decoder(Format, Data, Length);
+    TSharedPtr<FJsonValue> Value = Decoder.DecodeRoot();
+    if (!Value.IsValid())
+    {
+        OutError = Decoder.GetError();
+    }
+    return Value;
+}
+
+bool FMCPBinaryCodec::TranscodeJson(EMCPWireFormat Format, const ANSICHAR *Json, int32 Length, TArray<uint8> &OutData, FString &OutError)
+{
+    const int32 StartSize = OutData.Num();
+    FMCPJsonPullParser Parser(reinterpret_cast<const UTF8CHAR *>(Json), Length);
+    FEncoder Encoder(Format, OutData);
+
+    for (;;)
+    {
+        switch (Parser.Next())
+        {
+        case EMCPJsonToken::BeginObject:
+            Encoder.BeginContainer(true);
+            break;
+        case EMCPJsonToken::BeginArray:
+            Encoder.BeginContainer(false);
+            break;
+        case EMCPJsonToken::EndObject:
+        case EMCPJsonToken::EndArray:
+            Encoder.EndContainer();
+            break;
+        case EMCPJsonToken::Key:
+            Encoder.WriteKey(Parser.GetString());
+            break;
+        case EMCPJsonToken::String:
+            Encoder.WriteString(Parser.GetString());
+            break;
+        case EMCPJsonToken::Number:
+            Encoder.WriteNumber(Parser.GetNumber());
+            break;
+        case EMCPJsonToken::Boolean:
+            Encoder.WriteBool(Parser.GetBool());
+            break;
+        case EMCPJsonToken::Null:
+            Encoder.WriteNull();
+            break;
+        case EMCPJsonToken::End:
+            return true;
+        default:
+            OutError = Parser.GetError();
+            OutData.SetNum(StartSize);
+            return false;
+        }
+    }
+}
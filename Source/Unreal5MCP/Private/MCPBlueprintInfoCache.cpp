@@ -0,0 +1,175 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPBlueprintInfoCache.h"
+#include "MCPConstants.h"
+#include "Unreal5MCP.h"
+#include "AssetRegistry/AssetRegistryModule.h"
+#include "Engine/Blueprint.h"
+#include "Editor.h"
+#include "UObject/Package.h"
+#include "UObject/UObjectGlobals.h"
+
+FMCPBlueprintInfoCache::FMCPBlueprintInfoCache()
+    : bInitialized(false)
+{
+}
+
+FMCPBlueprintInfoCache::~FMCPBlueprintInfoCache()
+{
+    Shutdown();
+}
+
+void FMCPBlueprintInfoCache::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    bInitialized = true;
+
+    ObjectModifiedHandle = FCoreUObjectDelegates::OnObjectModified.AddRaw(this, &FMCPBlueprintInfoCache::HandleObjectModified);
+    PackageSavedHandle = UPackage::PackageSavedWithContextEvent.AddRaw(this, &FMCPBlueprintInfoCache::HandlePackageSaved);
+    ReloadCompleteHandle = FCoreUObjectDelegates::ReloadCompleteDelegate.AddLambda([this](EReloadCompleteReason)
+                                                                                   { InvalidateAll(); });
+
+    if (GEditor)
+    {
+        BlueprintPreCompileHandle = GEditor->OnBlueprintPreCompile().AddRaw(this, &FMCPBlueprintInfoCache::HandleBlueprintPreCompile);
+    }
+
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    AssetRemovedHandle = AssetRegistry.OnAssetRemoved().AddRaw(this, &FMCPBlueprintInfoCache::HandleAssetRemoved);
+    AssetRenamedHandle = AssetRegistry.OnAssetRenamed().AddRaw(this, &FMCPBlueprintInfoCache::HandleAssetRenamed);
+}
+
+void FMCPBlueprintInfoCache::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    FCoreUObjectDelegates::OnObjectModified.Remove(ObjectModifiedHandle);
+    UPackage::PackageSavedWithContextEvent.Remove(PackageSavedHandle);
+    FCoreUObjectDelegates::ReloadCompleteDelegate.Remove(ReloadCompleteHandle);
+
+    if (GEditor)
+    {
+        GEditor->OnBlueprintPreCompile().Remove(BlueprintPreCompileHandle);
+    }
+
+    if (FAssetRegistryModule *AssetRegistryModule = FModuleManager::GetModulePtr<FAssetRegistryModule>("AssetRegistry"))
+    {
+        IAssetRegistry &AssetRegistry = AssetRegistryModule->Get();
+        AssetRegistry.OnAssetRemoved().Remove(AssetRemovedHandle);
+        AssetRegistry.OnAssetRenamed().Remove(AssetRenamedHandle);
+    }
+
+    ObjectModifiedHandle.Reset();
+    PackageSavedHandle.Reset();
+    ReloadCompleteHandle.Reset();
+    BlueprintPreCompileHandle.Reset();
+    AssetRemovedHandle.Reset();
+    AssetRenamedHandle.Reset();
+
+    Entries.Empty();
+    bInitialized = false;
+}
+
+TSharedPtr<FJsonObject> FMCPBlueprintInfoCache::Find(FName PackageName) const
+{
+    const FEntry *Entry = Entries.Find(PackageName);
+    if (!Entry)
+    {
+        return nullptr;
+    }
+
+    // 包在磁盘上被替换时保存哈希会变化
+    if (Entry->SavedHash != GetPackageSavedHash(PackageName))
+    {
+        return nullptr;
+    }
+
+    return Entry->Info;
+}
+
+void FMCPBlueprintInfoCache::Add(FName PackageName, const TSharedPtr<FJsonObject> &Info)
+{
+    if (!Info.IsValid())
+    {
+        return;
+    }
+
+    // 超出上限时整体清空,避免无限增长
+    if (Entries.Num() >= MCPConstants::MAX_BLUEPRINT_INFO_CACHE_ENTRIES && !Entries.Contains(PackageName))
+    {
+        Entries.Reset();
+    }
+
+    FEntry &Entry = Entries.FindOrAdd(PackageName);
+    Entry.SavedHash = GetPackageSavedHash(PackageName);
+    Entry.Info = Info;
+}
+
+void FMCPBlueprintInfoCache::Invalidate(FName PackageName)
+{
+    Entries.Remove(PackageName);
+}
+
+void FMCPBlueprintInfoCache::InvalidateAll()
+{
+    Entries.Reset();
+}
+
+FIoHash FMCPBlueprintInfoCache::GetPackageSavedHash(FName PackageName)
+{
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+    TOptional<FAssetPackageData> PackageData = AssetRegistry.GetAssetPackageDataCopy(PackageName);
+    return PackageData.IsSet() ? PackageData->GetPackageSavedHash() : FIoHash::Zero;
+}
+
+// ============================================================================
+// 失效回调
+// ============================================================================
+
+void FMCPBlueprintInfoCache::HandleObjectModified(UObject *Object)
+{
+    // 编辑器中每次修改都会触发,缓存为空时直接返回
+    if (Entries.Num() == 0 || !Object)
+    {
+        return;
+    }
+
+    if (UPackage *Package = Object->GetPackage())
+    {
+        Entries.Remove(Package->GetFName());
+    }
+}
+
+void FMCPBlueprintInfoCache::HandlePackageSaved(const FString &PackageFileName, UPackage *Package, FObjectPostSaveContext SaveContext)
+{
+    if (Package)
+    {
+        Entries.Remove(Package->GetFName());
+    }
+}
+
+void FMCPBlueprintInfoCache::HandleBlueprintPreCompile(UBlueprint *Blueprint)
+{
+    if (Blueprint)
+    {
+        Entries.Remove(Blueprint->GetPackage()->GetFName());
+    }
+}
+
+void FMCPBlueprintInfoCache::HandleAssetRemoved(const FAssetData &AssetData)
+{
+    Entries.Remove(AssetData.PackageName);
+}
+
+void FMCPBlueprintInfoCache::HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath)
+{
+    Entries.Remove(FName(*FPackageName::ObjectPathToPackageName(OldObjectPath)));
+    Entries.Remove(AssetData.PackageName);
+}
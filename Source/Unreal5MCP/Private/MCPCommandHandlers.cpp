@@ -3,6 +3,11 @@
 #include "MCPCommandHandlers.h"
 #include "Unreal5MCP.h"
 #include "MCPConstants.h"
+#include "MCPAssetSearchIndex.h"
+#include "MCPImportJobManager.h"
+#include "MCPSaveQueue.h"
+#include "MCPServerMetrics.h"
+#include "MCPBlueprintInfoCache.h"
 #include "Engine/World.h"
 #include "Engine/StaticMeshActor.h"
 #include "Engine/DirectionalLight.h"
@@ -25,8 +30,15 @@
 #include "UnrealEdGlobals.h"
 #include "Kismet2/KismetEditorUtilities.h"
 #include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/CompilerResultsLog.h"
+#include "BlueprintCompilationManager.h"
+#include "Kismet2/Kismet2NameValidators.h"
+#include "EdGraphSchema_K2.h"
+#include "ScopedTransaction.h"
+#include "JsonObjectConverter.h"
 #include "Engine/Blueprint.h"
 #include "Engine/SimpleConstructionScript.h"
+#include "Engine/SCS_Node.h"
 #include "AssetRegistry/AssetRegistryModule.h"
 #include "AssetToolsModule.h"
 #include "IAssetTools.h"
@@ -37,6 +49,9 @@
 #include "PackageTools.h"
 #include "FileHelpers.h"
 #include "ObjectTools.h"
+#include "Misc/Base64.h"
+#include "Engine/AssetManager.h"
+#include "Engine/StreamableManager.h"
 
 // ============================================================================
 // 基类实现
@@ -197,17 +212,205 @@ AActor *FMCPCommandHandlerBase::FindActorByName(UWorld *World,
     return nullptr;
 }
 
+UClass *FMCPCommandHandlerBase::FindClassByName(const FString &ClassName) const
+{
+    if (ClassName.IsEmpty())
+    {
+        return nullptr;
+    }
+
+    UClass *Class = FindObject<UClass>(nullptr, *ClassName);
+    if (!Class)
+    {
+        Class = FindFirstObject<UClass>(*ClassName, EFindFirstObjectOptions::NativeFirst);
+    }
+    return Class;
+}
+
+FSoftObjectPath FMCPCommandHandlerBase::MakeAssetObjectPath(const FString &AssetPath)
+{
+    if (AssetPath.Contains(TEXT(".")))
+    {
+        return FSoftObjectPath(AssetPath);
+    }
+    return FSoftObjectPath(AssetPath + TEXT(".") + FPackageName::GetShortName(AssetPath));
+}
+
+void FMCPCommandHandlerBase::LoadBlueprints(const TArray<FString> &BlueprintPaths, bool bAsync, FOnBlueprintsLoaded OnLoaded)
+{
+    TArray<FSoftObjectPath> ObjectPaths;
+    TArray<FSoftObjectPath> PathsToStream;
+    ObjectPaths.Reserve(BlueprintPaths.Num());
+
+    for (const FString &BlueprintPath : BlueprintPaths)
+    {
+        FSoftObjectPath ObjectPath = MakeAssetObjectPath(BlueprintPath);
+        if (bAsync && !ObjectPath.IsNull() && !ObjectPath.ResolveObject())
+        {
+            PathsToStream.AddUnique(ObjectPath);
+        }
+        ObjectPaths.Add(MoveTemp(ObjectPath));
+    }
+
+    // 异步模式下所有路径都已加载时,直接在内存中解析
+    if (!bAsync || PathsToStream.Num() == 0 || !UAssetManager::IsInitialized())
+    {
+        TArray<UBlueprint *> Blueprints;
+        Blueprints.Reserve(ObjectPaths.Num());
+        for (const FSoftObjectPath &ObjectPath : ObjectPaths)
+        {
+            Blueprints.Add(Cast<UBlueprint>(ObjectPath.TryLoad()));
+        }
+        OnLoaded(Blueprints);
+        return;
+    }
+
+    // 防止流式请求失败时回调被调用两次
+    TSharedRef<bool> bCompleted = MakeShared<bool>(false);
+    auto ResolveLoaded = [ObjectPaths, OnLoaded, bCompleted]()
+    {
+        if (*bCompleted)
+        {
+            return;
+        }
+        *bCompleted = true;
+
+        TArray<UBlueprint *> Blueprints;
+        Blueprints.Reserve(ObjectPaths.Num());
+        for (const FSoftObjectPath &ObjectPath : ObjectPaths)
+        {
+            Blueprints.Add(Cast<UBlueprint>(ObjectPath.ResolveObject()));
+        }
+        OnLoaded(Blueprints);
+    };
+
+    MCP_LOG_VERBOSE("Streaming %d blueprint packages asynchronously", PathsToStream.Num());
+
+    TSharedPtr<FStreamableHandle> Handle = UAssetManager::GetStreamableManager().RequestAsyncLoad(
+        PathsToStream,
+        FStreamableDelegate::CreateLambda(ResolveLoaded),
+        FStreamableManager::AsyncLoadHighPriority);
+
+    if (!Handle.IsValid())
+    {
+        ResolveLoaded();
+    }
+}
+
+// ============================================================================
+// 蓝图命令处理器基类实现
+// ============================================================================
+
+TSharedPtr<FJsonObject> FMCPBlueprintHandlerBase::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    // 阻塞加载时 Run 会立即回调
+    TSharedPtr<FJsonObject> Response;
+    Run(Params, false, [&Response](const TSharedPtr<FJsonObject> &Result)
+        { Response = Result; });
+    return Response;
+}
+
+void FMCPBlueprintHandlerBase::ExecuteAsync(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPCommandCallback OnComplete)
+{
+    Run(Params, true, MoveTemp(OnComplete));
+}
+
+bool FMCPBlueprintHandlerBase::ResolveBlueprintPaths(const TSharedPtr<FJsonObject> &Params, TArray<FString> &OutPaths, FString &OutError)
+{
+    const TArray<TSharedPtr<FJsonValue>> *PathsArray = nullptr;
+    if (SupportsMultiplePaths() && Params.IsValid() && Params->TryGetArrayField(TEXT("paths"), PathsArray))
+    {
+        for (const TSharedPtr<FJsonValue> &PathValue : *PathsArray)
+        {
+            FString Path;
+            if (PathValue.IsValid() && PathValue->TryGetString(Path) && !Path.IsEmpty())
+            {
+                OutPaths.Add(Path);
+            }
+        }
+    }
+    else
+    {
+        FString BlueprintPath = GetStringParam(Params, TEXT("path"));
+        if (!BlueprintPath.IsEmpty())
+        {
+            OutPaths.Add(BlueprintPath);
+        }
+    }
+
+    if (OutPaths.Num() == 0)
+    {
+        OutError = TEXT("Missing required parameter: path");
+        return false;
+    }
+    return true;
+}
+
+void FMCPBlueprintHandlerBase::Run(const TSharedPtr<FJsonObject> &Params, bool bAsyncLoad, FMCPCommandCallback OnComplete)
+{
+    TArray<FString> BlueprintPaths;
+    FString PathError;
+    if (!ResolveBlueprintPaths(Params, BlueprintPaths, PathError))
+    {
+        OnComplete(CreateErrorResponse(PathError));
+        return;
+    }
+
+    if (TSharedPtr<FJsonObject> Response = TryExecuteWithoutLoading(Params, BlueprintPaths))
+    {
+        OnComplete(Response);
+        return;
+    }
+
+    TWeakPtr<FMCPCommandHandlerBase> WeakThis = AsShared();
+    LoadBlueprints(BlueprintPaths, bAsyncLoad, [WeakThis, Params, BlueprintPaths, OnComplete](const TArray<UBlueprint *> &Blueprints)
+                   {
+        TSharedPtr<FMCPCommandHandlerBase> PinnedThis = WeakThis.Pin();
+        if (!PinnedThis.IsValid())
+        {
+            // 处理器已注销(服务器已停止)
+            OnComplete(nullptr);
+            return;
+        }
+
+        FMCPBlueprintHandlerBase *Handler = static_cast<FMCPBlueprintHandlerBase *>(PinnedThis.Get());
+        OnComplete(Handler->ExecuteWithBlueprints(Params, BlueprintPaths, Blueprints)); });
+}
+
 // ============================================================================
 // 获取场景信息命令处理器
 // ============================================================================
 
+FString FMCPGetSceneInfoHandler::GetDescription() const
+{
+    return TEXT("Get information about all actors in the current scene.");
+}
+
 TSharedPtr<FJsonObject> FMCPGetSceneInfoHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    // 需要 JSON 对象的调用方: 复用流式输出后解析
+    TArray<ANSICHAR> Buffer;
+    FMCPJsonStreamWriter Writer(Buffer);
+    ExecuteStreaming(Params, ClientSocket, Writer);
+
+    FUTF8ToTCHAR Converter(Buffer.GetData(), Buffer.Num());
+    TSharedPtr<FJsonObject> Response;
+    TSharedRef<TJsonReader<TCHAR>> Reader = TJsonReaderFactory<TCHAR>::Create(FString(Converter.Length(), Converter.Get()));
+    if (!FJsonSerializer::Deserialize(Reader, Response) || !Response.IsValid())
+    {
+        return CreateErrorResponse(TEXT("Failed to build scene info"));
+    }
+    return Response;
+}
+
+void FMCPGetSceneInfoHandler::ExecuteStreaming(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPJsonStreamWriter &Writer)
 {
     TSharedPtr<FJsonObject> ErrorResponse;
     UWorld *World = GetEditorWorld(ErrorResponse);
     if (!World)
     {
-        return ErrorResponse;
+        Writer.WriteJsonObject(ErrorResponse);
+        return;
     }
 
     // 获取可选参数
@@ -216,17 +419,25 @@ TSharedPtr<FJsonObject> FMCPGetSceneInfoHandler::Execute(const TSharedPtr<FJsonO
     int32 MaxActors = static_cast<int32>(GetNumberParam(Params, TEXT("max_actors"),
                                                         MCPConstants::MAX_ACTORS_IN_SCENE_INFO));
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Writer.BeginObject();
+    Writer.WriteField(TEXT("status"), TEXT("success"));
+    Writer.WriteKey(TEXT("result"));
+    Writer.BeginObject();
 
     // 获取关卡信息
-    FString LevelName = World->GetMapName();
-    Result->SetStringField("level", LevelName);
-    Result->SetStringField("level_path", World->GetCurrentLevel() ? World->GetCurrentLevel()->GetPathName() : TEXT("Unknown"));
+    Writer.WriteField(TEXT("level"), World->GetMapName());
+    Writer.WriteField(TEXT("level_path"), World->GetCurrentLevel() ? World->GetCurrentLevel()->GetPathName() : TEXT("Unknown"));
 
-    // 统计 Actor 数量
+    // 统计 Actor 数量,Actor 列表边遍历边写出
     int32 ActorCount = 0;
     int32 VisibleActorCount = 0;
-    TArray<TSharedPtr<FJsonValue>> ActorsArray;
+    int32 WrittenActorCount = 0;
+
+    if (bIncludeActors)
+    {
+        Writer.WriteKey(TEXT("actors"));
+        Writer.BeginArray();
+    }
 
     for (TActorIterator<AActor> It(World); It; ++It)
     {
@@ -240,49 +451,60 @@ TSharedPtr<FJsonObject> FMCPGetSceneInfoHandler::Execute(const TSharedPtr<FJsonO
             }
 
             // 如果需要详细信息且未超过最大数量
-            if (bIncludeActors && ActorsArray.Num() < MaxActors)
+            if (bIncludeActors && WrittenActorCount < MaxActors)
             {
-                TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
-                ActorInfo->SetStringField("name", Actor->GetName());
-                ActorInfo->SetStringField("class", Actor->GetClass()->GetName());
-                ActorInfo->SetStringField("label", Actor->GetActorLabel());
-                ActorInfo->SetBoolField("hidden", Actor->IsHidden());
-                ActorInfo->SetBoolField("selected", Actor->IsSelected());
+                Writer.BeginObject();
+                Writer.WriteField(TEXT("name"), Actor->GetName());
+                Writer.WriteField(TEXT("class"), Actor->GetClass()->GetName());
+                Writer.WriteField(TEXT("label"), Actor->GetActorLabel());
+                Writer.WriteField(TEXT("hidden"), Actor->IsHidden());
+                Writer.WriteField(TEXT("selected"), Actor->IsSelected());
 
                 if (bIncludeDetails)
                 {
-                    ActorInfo->SetObjectField("location", VectorToJson(Actor->GetActorLocation()));
-                    ActorInfo->SetObjectField("rotation", RotatorToJson(Actor->GetActorRotation()));
-                    ActorInfo->SetObjectField("scale", VectorToJson(Actor->GetActorScale3D()));
+                    Writer.WriteKey(TEXT("location"));
+                    Writer.WriteVector(Actor->GetActorLocation());
+                    Writer.WriteKey(TEXT("rotation"));
+                    Writer.WriteRotator(Actor->GetActorRotation());
+                    Writer.WriteKey(TEXT("scale"));
+                    Writer.WriteVector(Actor->GetActorScale3D());
                 }
 
-                ActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+                Writer.EndObject();
+                WrittenActorCount++;
             }
         }
     }
 
-    Result->SetNumberField("actor_count", ActorCount);
-    Result->SetNumberField("visible_actor_count", VisibleActorCount);
-
     if (bIncludeActors)
     {
-        Result->SetArrayField("actors", ActorsArray);
+        Writer.EndArray();
         if (ActorCount > MaxActors)
         {
-            Result->SetStringField("warning",
-                                   FString::Printf(TEXT("Only showing %d out of %d actors"), MaxActors, ActorCount));
+            Writer.WriteField(TEXT("warning"),
+                              FString::Printf(TEXT("Only showing %d out of %d actors"), MaxActors, ActorCount));
         }
     }
 
+    Writer.WriteField(TEXT("actor_count"), ActorCount);
+    Writer.WriteField(TEXT("visible_actor_count"), VisibleActorCount);
+
+    Writer.EndObject();
+    Writer.EndObject();
+
     MCP_LOG_INFO("Scene info retrieved: %d actors total, %d visible", ActorCount, VisibleActorCount);
-    return CreateSuccessResponse(Result);
 }
 
 // ============================================================================
 // 创庺对象命令处理器
 // ============================================================================
 
-TSharedPtr<FJsonObject> FMCPCreateObjectHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+FString FMCPCreateObjectHandler::GetDescription() const
+{
+    return TEXT("Create a single actor in the scene. Requires 'class_name' (e.g., 'ASkyAtmosphere', 'ASkyLight', 'AStaticMeshActor'). Optional: 'name', 'location' ({x,y,z}), 'rotation' ({pitch,yaw,roll}), 'scale' ({x,y,z}), 'asset_path'.");
+}
+
+TSharedPtr<FJsonObject> FMCPCreateObjectHandler::ExecuteTyped(const FMCPCreateObjectParams &Params, FSocket *ClientSocket)
 {
     TSharedPtr<FJsonObject> ErrorResponse;
     UWorld *World = GetEditorWorld(ErrorResponse);
@@ -291,94 +513,42 @@ TSharedPtr<FJsonObject> FMCPCreateObjectHandler::Execute(const TSharedPtr<FJsonO
         return ErrorResponse;
     }
 
-    // 验证必需参数
-    if (!ValidateRequiredField(Params, TEXT("class_name"), ErrorResponse))
-    {
-        return ErrorResponse;
-    }
-
-    FString ClassName = GetStringParam(Params, TEXT("class_name"));
-
-    // 获取位置
-    FVector Location = FVector::ZeroVector;
-    if (Params->HasField(TEXT("location")))
-    {
-        const TSharedPtr<FJsonObject> *LocationObj;
-        if (Params->TryGetObjectField(TEXT("location"), LocationObj))
-        {
-            (*LocationObj)->TryGetNumberField(TEXT("x"), Location.X);
-            (*LocationObj)->TryGetNumberField(TEXT("y"), Location.Y);
-            (*LocationObj)->TryGetNumberField(TEXT("z"), Location.Z);
-        }
-    }
-
-    // 获取旋转
-    FRotator Rotation = FRotator::ZeroRotator;
-    if (Params->HasField(TEXT("rotation")))
-    {
-        const TSharedPtr<FJsonObject> *RotationObj;
-        if (Params->TryGetObjectField(TEXT("rotation"), RotationObj))
-        {
-            (*RotationObj)->TryGetNumberField(TEXT("pitch"), Rotation.Pitch);
-            (*RotationObj)->TryGetNumberField(TEXT("yaw"), Rotation.Yaw);
-            (*RotationObj)->TryGetNumberField(TEXT("roll"), Rotation.Roll);
-        }
-    }
-
-    // 获取缩放
-    FVector Scale = FVector::OneVector;
-    if (Params->HasField(TEXT("scale")))
-    {
-        const TSharedPtr<FJsonObject> *ScaleObj;
-        if (Params->TryGetObjectField(TEXT("scale"), ScaleObj))
-        {
-            (*ScaleObj)->TryGetNumberField(TEXT("x"), Scale.X);
-            (*ScaleObj)->TryGetNumberField(TEXT("y"), Scale.Y);
-            (*ScaleObj)->TryGetNumberField(TEXT("z"), Scale.Z);
-        }
-    }
-
-    // 获取名称
-    FString ActorName;
-    Params->TryGetStringField(TEXT("name"), ActorName);
-
     // 创建 Actor
     FActorSpawnParameters SpawnParams;
-    if (!ActorName.IsEmpty())
+    if (!Params.Name.IsEmpty())
     {
-        SpawnParams.Name = FName(*ActorName);
+        SpawnParams.Name = FName(*Params.Name);
     }
 
     // 查找类
-    UClass *ActorClass = FindObject<UClass>(nullptr, *ClassName);
+    UClass *ActorClass = FindObject<UClass>(nullptr, *Params.ClassName);
     if (!ActorClass)
     {
         // 尝试查找 StaticMeshActor
-        if (ClassName.Contains(TEXT("StaticMesh")))
+        if (Params.ClassName.Contains(TEXT("StaticMesh")))
         {
             ActorClass = AStaticMeshActor::StaticClass();
         }
         else
         {
-            return CreateErrorResponse(FString::Printf(TEXT("Class not found: %s"), *ClassName));
+            return CreateErrorResponse(FString::Printf(TEXT("Class not found: %s"), *Params.ClassName));
         }
     }
 
-    AActor *NewActor = World->SpawnActor<AActor>(ActorClass, Location, Rotation, SpawnParams);
+    AActor *NewActor = World->SpawnActor<AActor>(ActorClass, Params.Location, Params.Rotation, SpawnParams);
     if (!NewActor)
     {
         return CreateErrorResponse(TEXT("Failed to spawn actor"));
     }
 
-    NewActor->SetActorScale3D(Scale);
+    NewActor->SetActorScale3D(Params.Scale);
 
     // 如果有资产路径，加载并设置
-    FString AssetPath;
-    if (Params->TryGetStringField(TEXT("asset_path"), AssetPath))
+    if (!Params.AssetPath.IsEmpty())
     {
         if (AStaticMeshActor *MeshActor = Cast<AStaticMeshActor>(NewActor))
         {
-            UStaticMesh *Mesh = LoadObject<UStaticMesh>(nullptr, *AssetPath);
+            UStaticMesh *Mesh = LoadObject<UStaticMesh>(nullptr, *Params.AssetPath);
             if (Mesh)
             {
                 MeshActor->GetStaticMeshComponent()->SetStaticMesh(Mesh);
@@ -397,6 +567,11 @@ TSharedPtr<FJsonObject> FMCPCreateObjectHandler::Execute(const TSharedPtr<FJsonO
 // 修改对象命令处理器
 // ============================================================================
 
+FString FMCPModifyObjectHandler::GetDescription() const
+{
+    return TEXT("Modify an existing actor. Requires 'actor_name'. Can update 'location' ({x,y,z}), 'rotation' ({pitch,yaw,roll}), 'scale' ({x,y,z}), and other properties.");
+}
+
 TSharedPtr<FJsonObject> FMCPModifyObjectHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
 {
     TSharedPtr<FJsonObject> ErrorResponse;
@@ -474,6 +649,11 @@ TSharedPtr<FJsonObject> FMCPModifyObjectHandler::Execute(const TSharedPtr<FJsonO
 // 删除对象命令处理器
 // ============================================================================
 
+FString FMCPDeleteObjectHandler::GetDescription() const
+{
+    return TEXT("Delete an actor from the scene. Requires 'actor_name'.");
+}
+
 TSharedPtr<FJsonObject> FMCPDeleteObjectHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
 {
     TSharedPtr<FJsonObject> ErrorResponse;
@@ -511,6 +691,47 @@ TSharedPtr<FJsonObject> FMCPDeleteObjectHandler::Execute(const TSharedPtr<FJsonO
 // 蓝图相关命令处理器实现
 // ============================================================================
 
+FString FMCPCreateBlueprintHandler::GetDescription() const
+{
+    return TEXT("Create a new Blueprint class. Requires 'path' (package path). Optional: 'name', 'parent_class' (default: 'Character'), 'save' (default true, queued for a batched save). Components and variables are added afterwards with 'edit_blueprint'.");
+}
+
+TSharedPtr<FJsonObject> FMCPCreateBlueprintHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
+    PathSchema->SetStringField("type", TEXT("string"));
+    PathSchema->SetStringField("description", TEXT("Blueprint package path (e.g., '/Game/Blueprints/BP_MyActor')"));
+    Props->SetObjectField("path", PathSchema);
+
+    TSharedPtr<FJsonObject> NameSchema = MakeShared<FJsonObject>();
+    NameSchema->SetStringField("type", TEXT("string"));
+    NameSchema->SetStringField("description", TEXT("Blueprint name (optional, extracted from path if not provided)"));
+    Props->SetObjectField("name", NameSchema);
+
+    TSharedPtr<FJsonObject> ParentClassSchema = MakeShared<FJsonObject>();
+    ParentClassSchema->SetStringField("type", TEXT("string"));
+    ParentClassSchema->SetStringField("description", TEXT("Parent class name (e.g., 'Actor', 'Character', 'Pawn'). Default: 'Character'"));
+    Props->SetObjectField("parent_class", ParentClassSchema);
+
+    TSharedPtr<FJsonObject> SaveSchema = MakeShared<FJsonObject>();
+    SaveSchema->SetStringField("type", TEXT("boolean"));
+    SaveSchema->SetStringField("description", TEXT("Queue the package for the next batched save (default true)"));
+    Props->SetObjectField("save", SaveSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> Required;
+    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
+    Schema->SetArrayField("required", Required);
+
+    return Schema;
+}
+
 TSharedPtr<FJsonObject> FMCPCreateBlueprintHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
 {
     TSharedPtr<FJsonObject> ErrorResponse;
@@ -573,488 +794,2682 @@ TSharedPtr<FJsonObject> FMCPCreateBlueprintHandler::Execute(const TSharedPtr<FJs
     // 编译蓝图
     FKismetEditorUtilities::CompileBlueprint(NewBlueprint);
 
-    // 保存包
-    FEditorFileUtils::PromptForCheckoutAndSave({Package}, false, false);
+    // 加入保存队列,与其他修改合并为一次保存
+    const bool bSave = GetBoolParam(Params, TEXT("save"), true);
+    if (bSave && SaveQueue.IsValid())
+    {
+        SaveQueue->Enqueue(Package);
+    }
 
     TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
     Result->SetStringField("blueprint_name", BlueprintName);
     Result->SetStringField("blueprint_path", BlueprintPath);
     Result->SetStringField("parent_class", ParentClass);
     Result->SetBoolField("compiled", true);
+    Result->SetBoolField("save_queued", bSave && SaveQueue.IsValid());
 
     MCP_LOG_INFO("Blueprint created: %s at %s", *BlueprintName, *BlueprintPath);
     return CreateSuccessResponse(Result);
 }
 
-TSharedPtr<FJsonObject> FMCPGetBlueprintInfoHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+/**
+ * 生成参数列表 [{name, type}]
+ */
+static TArray<TSharedPtr<FJsonValue>> MakeParameterArray(const TArray<FProperty *> &Parameters)
 {
-    TSharedPtr<FJsonObject> ErrorResponse;
-
-    FString BlueprintPath = GetStringParam(Params, TEXT("path"));
-    if (BlueprintPath.IsEmpty())
-    {
-        return CreateErrorResponse(TEXT("Missing required parameter: path"));
-    }
-
-    UBlueprint *Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
-    if (!Blueprint)
+    TArray<TSharedPtr<FJsonValue>> ParameterArray;
+    for (const FProperty *Parameter : Parameters)
     {
-        return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPath));
+        TSharedPtr<FJsonObject> ParameterObject = MakeShared<FJsonObject>();
+        ParameterObject->SetStringField("name", Parameter->GetName());
+        ParameterObject->SetStringField("type", Parameter->GetCPPType());
+        ParameterArray.Add(MakeShared<FJsonValueObject>(ParameterObject));
     }
+    return ParameterArray;
+}
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("name", Blueprint->GetName());
-    Result->SetStringField("path", BlueprintPath);
+/**
+ * 生成单个蓝图的信息对象(不含请求路径,可缓存)
+ * 类型信息取自骨架类,蓝图未编译时也与编辑器中的定义一致
+ */
+static TSharedPtr<FJsonObject> MakeBlueprintInfo(UBlueprint *Blueprint)
+{
+    TSharedPtr<FJsonObject> Info = MakeShared<FJsonObject>();
+    Info->SetStringField("name", Blueprint->GetName());
+    Info->SetStringField("object_path", Blueprint->GetPathName());
 
     if (Blueprint->ParentClass)
     {
-        Result->SetStringField("parent_class", Blueprint->ParentClass->GetName());
+        Info->SetStringField("parent_class", Blueprint->ParentClass->GetName());
+        Info->SetStringField("parent_class_path", Blueprint->ParentClass->GetPathName());
     }
 
-    Result->SetBoolField("is_compiled", Blueprint->IsUpToDate());
-    Result->SetNumberField("variable_count", Blueprint->NewVariables.Num());
-    Result->SetNumberField("function_count",
-                           Blueprint->FunctionGraphs.Num() + Blueprint->DelegateSignatureGraphs.Num());
-
-    MCP_LOG_INFO("Blueprint info retrieved: %s", *BlueprintPath);
-    return CreateSuccessResponse(Result);
-}
+    Info->SetBoolField("is_compiled", Blueprint->IsUpToDate());
+    Info->SetBoolField("has_errors", Blueprint->Status == BS_Error);
+    Info->SetNumberField("variable_count", Blueprint->NewVariables.Num());
+    Info->SetNumberField("function_count",
+                         Blueprint->FunctionGraphs.Num() + Blueprint->DelegateSignatureGraphs.Num());
 
-TSharedPtr<FJsonObject> FMCPModifyBlueprintHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
-{
-    TSharedPtr<FJsonObject> ErrorResponse;
+    UClass *SkeletonClass = Blueprint->SkeletonGeneratedClass;
 
-    FString BlueprintPath = GetStringParam(Params, TEXT("path"));
-    if (BlueprintPath.IsEmpty())
+    // 成员变量
+    TArray<TSharedPtr<FJsonValue>> VariablesArray;
+    for (const FBPVariableDescription &Variable : Blueprint->NewVariables)
     {
-        return CreateErrorResponse(TEXT("Missing required parameter: path"));
+        TSharedPtr<FJsonObject> VariableObject = MakeShared<FJsonObject>();
+        VariableObject->SetStringField("name", Variable.VarName.ToString());
+
+        const FProperty *Property = SkeletonClass ? SkeletonClass->FindPropertyByName(Variable.VarName) : nullptr;
+        VariableObject->SetStringField("type", Property ? Property->GetCPPType() : Variable.VarType.PinCategory.ToString());
+        VariableObject->SetStringField("category", Variable.Category.ToString());
+        VariableObject->SetBoolField("instance_editable", (Variable.PropertyFlags & CPF_DisableEditOnInstance) == 0);
+        VariableObject->SetBoolField("replicated", (Variable.PropertyFlags & CPF_Net) != 0);
+        if (!Variable.DefaultValue.IsEmpty())
+        {
+            VariableObject->SetStringField("default_value", Variable.DefaultValue);
+        }
+        VariablesArray.Add(MakeShared<FJsonValueObject>(VariableObject));
     }
+    Info->SetArrayField("variables", VariablesArray);
 
-    UBlueprint *Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
-    if (!Blueprint)
+    // 函数和事件
+    TSet<FName> FunctionGraphNames;
+    for (const UEdGraph *Graph : Blueprint->FunctionGraphs)
     {
-        return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPath));
+        if (Graph)
+        {
+            FunctionGraphNames.Add(Graph->GetFName());
+        }
     }
 
-    // 获取修改参数
-    if (Params->HasField(TEXT("description")))
+    TArray<TSharedPtr<FJsonValue>> FunctionsArray;
+    if (SkeletonClass)
     {
-        FString Description = GetStringParam(Params, TEXT("description"));
-        // 描述字段可用于将来的扩展
+        for (TFieldIterator<UFunction> FunctionIt(SkeletonClass, EFieldIteratorFlags::ExcludeSuper); FunctionIt; ++FunctionIt)
+        {
+            UFunction *Function = *FunctionIt;
+            const FString FunctionName = Function->GetName();
+
+            // 跳过编译器生成的函数
+            if (FunctionName.StartsWith(TEXT("ExecuteUbergraph")) || FunctionName.EndsWith(TEXT("__DelegateSignature")))
+            {
+                continue;
+            }
+
+            TArray<FProperty *> Inputs;
+            TArray<FProperty *> Outputs;
+            for (TFieldIterator<FProperty> ParamIt(Function); ParamIt && ParamIt->HasAnyPropertyFlags(CPF_Parm); ++ParamIt)
+            {
+                const bool bIsOutput = ParamIt->HasAnyPropertyFlags(CPF_ReturnParm) ||
+                                       (ParamIt->HasAnyPropertyFlags(CPF_OutParm) && !ParamIt->HasAnyPropertyFlags(CPF_ReferenceParm));
+                (bIsOutput ? Outputs : Inputs).Add(*ParamIt);
+            }
+
+            TSharedPtr<FJsonObject> FunctionObject = MakeShared<FJsonObject>();
+            FunctionObject->SetStringField("name", FunctionName);
+            FunctionObject->SetStringField("kind", FunctionGraphNames.Contains(Function->GetFName()) ? TEXT("function") : TEXT("event"));
+            FunctionObject->SetStringField("access", Function->HasAnyFunctionFlags(FUNC_Private)     ? TEXT("private")
+                                                     : Function->HasAnyFunctionFlags(FUNC_Protected) ? TEXT("protected")
+                                                                                                     : TEXT("public"));
+            FunctionObject->SetBoolField("pure", Function->HasAnyFunctionFlags(FUNC_BlueprintPure));
+            FunctionObject->SetBoolField("const", Function->HasAnyFunctionFlags(FUNC_Const));
+            FunctionObject->SetArrayField("inputs", MakeParameterArray(Inputs));
+            FunctionObject->SetArrayField("outputs", MakeParameterArray(Outputs));
+            FunctionsArray.Add(MakeShared<FJsonValueObject>(FunctionObject));
+        }
     }
+    Info->SetArrayField("functions", FunctionsArray);
 
-    // 标记为已修改
-    Blueprint->MarkPackageDirty();
-    Blueprint->Modify();
+    // 构造脚本中的组件
+    TArray<TSharedPtr<FJsonValue>> ComponentsArray;
+    if (Blueprint->SimpleConstructionScript)
+    {
+        TFunction<void(USCS_Node *, const FString &)> AddComponent = [&ComponentsArray, &AddComponent](USCS_Node *Node, const FString &ParentName)
+        {
+            if (!Node)
+            {
+                return;
+            }
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("blueprint_name", Blueprint->GetName());
-    Result->SetStringField("message", TEXT("Blueprint modified successfully"));
+            TSharedPtr<FJsonObject> ComponentObject = MakeShared<FJsonObject>();
+            ComponentObject->SetStringField("name", Node->GetVariableName().ToString());
+            ComponentObject->SetStringField("class", Node->ComponentClass ? Node->ComponentClass->GetName() : TEXT("None"));
 
-    MCP_LOG_INFO("Blueprint modified: %s", *BlueprintPath);
-    return CreateSuccessResponse(Result);
-}
+            FString AttachParent = ParentName;
+            if (AttachParent.IsEmpty() && Node->ParentComponentOrVariableName != NAME_None)
+            {
+                // 附加到父类中定义的组件
+                AttachParent = Node->ParentComponentOrVariableName.ToString();
+            }
+            if (!AttachParent.IsEmpty())
+            {
+                ComponentObject->SetStringField("attach_to", AttachParent);
+            }
+            ComponentsArray.Add(MakeShared<FJsonValueObject>(ComponentObject));
 
-TSharedPtr<FJsonObject> FMCPCompileBlueprintHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
-{
-    TSharedPtr<FJsonObject> ErrorResponse;
+            const FString NodeName = Node->GetVariableName().ToString();
+            for (USCS_Node *ChildNode : Node->GetChildNodes())
+            {
+                AddComponent(ChildNode, NodeName);
+            }
+        };
 
-    FString BlueprintPath = GetStringParam(Params, TEXT("path"));
-    if (BlueprintPath.IsEmpty())
-    {
-        return CreateErrorResponse(TEXT("Missing required parameter: path"));
+        for (USCS_Node *RootNode : Blueprint->SimpleConstructionScript->GetRootNodes())
+        {
+            AddComponent(RootNode, FString());
+        }
     }
+    Info->SetArrayField("components", ComponentsArray);
 
-    UBlueprint *Blueprint = LoadObject<UBlueprint>(nullptr, *BlueprintPath);
-    if (!Blueprint)
+    // 实现的接口
+    TArray<TSharedPtr<FJsonValue>> InterfacesArray;
+    for (const FBPInterfaceDescription &Interface : Blueprint->ImplementedInterfaces)
     {
-        return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPath));
+        if (Interface.Interface)
+        {
+            TSharedPtr<FJsonObject> InterfaceObject = MakeShared<FJsonObject>();
+            InterfaceObject->SetStringField("name", Interface.Interface->GetName());
+            InterfaceObject->SetStringField("path", Interface.Interface->GetPathName());
+            InterfacesArray.Add(MakeShared<FJsonValueObject>(InterfaceObject));
+        }
     }
+    Info->SetArrayField("interfaces", InterfacesArray);
 
-    // 编译蓝图
-    FKismetEditorUtilities::CompileBlueprint(Blueprint);
+    return Info;
+}
 
-    bool bCompileSuccess = Blueprint->IsUpToDate();
+FString FMCPGetBlueprintInfoHandler::GetDescription() const
+{
+    return TEXT("Get detailed information about a Blueprint: parent class, variables with types, functions and events with signatures, construction script components and implemented interfaces. Requires 'path' (asset path), or 'paths' (array) to load many blueprints in one batched async request. Results are cached per package until it is modified, saved or recompiled; 'refresh' bypasses the cache.");
+}
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("blueprint_name", Blueprint->GetName());
-    Result->SetBoolField("compile_success", bCompileSuccess);
+TSharedPtr<FJsonObject> FMCPGetBlueprintInfoHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
 
-    MCP_LOG_INFO("Blueprint compiled: %s (Success: %s)", *BlueprintPath, bCompileSuccess ? TEXT("true") : TEXT("false"));
-    return CreateSuccessResponse(Result);
-}
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
 
-// ============================================================================
-// 场景编辑命令处理器实现
-// ============================================================================
+    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
+    PathSchema->SetStringField("type", TEXT("string"));
+    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
+    Props->SetObjectField("path", PathSchema);
+
+    TSharedPtr<FJsonObject> PathsSchema = MakeShared<FJsonObject>();
+    PathsSchema->SetStringField("type", TEXT("array"));
+    PathsSchema->SetStringField("description", TEXT("Multiple blueprint asset paths, loaded together (optional, replaces 'path')"));
+    TSharedPtr<FJsonObject> PathItemSchema = MakeShared<FJsonObject>();
+    PathItemSchema->SetStringField("type", TEXT("string"));
+    PathsSchema->SetObjectField("items", PathItemSchema);
+    Props->SetObjectField("paths", PathsSchema);
+
+    TSharedPtr<FJsonObject> RefreshSchema = MakeShared<FJsonObject>();
+    RefreshSchema->SetStringField("type", TEXT("boolean"));
+    RefreshSchema->SetStringField("description", TEXT("Ignore cached results and rebuild them (default false)"));
+    Props->SetObjectField("refresh", RefreshSchema);
 
-TSharedPtr<FJsonObject> FMCPSetCameraHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+    Schema->SetObjectField("properties", Props);
+
+    return Schema;
+}
+
+FMCPGetBlueprintInfoHandler::FMCPGetBlueprintInfoHandler()
+    : InfoCache(MakeShared<FMCPBlueprintInfoCache>())
 {
-    TSharedPtr<FJsonObject> ErrorResponse;
-    UWorld *World = GetEditorWorld(ErrorResponse);
-    if (!World)
+    InfoCache->Initialize();
+}
+
+FMCPGetBlueprintInfoHandler::~FMCPGetBlueprintInfoHandler()
+{
+    InfoCache->Shutdown();
+}
+
+TSharedPtr<FJsonObject> FMCPGetBlueprintInfoHandler::TryExecuteWithoutLoading(const TSharedPtr<FJsonObject> &Params, const TArray<FString> &BlueprintPaths)
+{
+    if (GetBoolParam(Params, TEXT("refresh"), false))
     {
-        return ErrorResponse;
+        return nullptr;
     }
 
-    FVector Location = FVector::ZeroVector;
-    if (Params->HasField(TEXT("location")))
+    // 全部命中缓存时无需加载
+    TArray<TSharedPtr<FJsonObject>> Infos;
+    Infos.Reserve(BlueprintPaths.Num());
+    for (const FString &BlueprintPath : BlueprintPaths)
     {
-        const TSharedPtr<FJsonObject> *LocationObj;
-        if (Params->TryGetObjectField(TEXT("location"), LocationObj))
+        TSharedPtr<FJsonObject> CachedInfo = InfoCache->Find(FName(*FPackageName::ObjectPathToPackageName(BlueprintPath)));
+        if (!CachedInfo.IsValid())
         {
-            Location = GetVectorFromJson(*LocationObj);
+            return nullptr;
         }
+        Infos.Add(CachedInfo);
     }
 
-    FRotator Rotation = FRotator::ZeroRotator;
-    if (Params->HasField(TEXT("rotation")))
+    return MakeInfoResponse(Params, BlueprintPaths, Infos, Infos.Num());
+}
+
+TSharedPtr<FJsonObject> FMCPGetBlueprintInfoHandler::ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                                           const TArray<FString> &BlueprintPaths,
+                                                                           const TArray<UBlueprint *> &Blueprints)
+{
+    const bool bRefresh = GetBoolParam(Params, TEXT("refresh"), false);
+
+    TArray<TSharedPtr<FJsonObject>> Infos;
+    Infos.Reserve(BlueprintPaths.Num());
+    int32 CachedCount = 0;
+
+    for (int32 i = 0; i < BlueprintPaths.Num(); ++i)
     {
-        const TSharedPtr<FJsonObject> *RotationObj;
-        if (Params->TryGetObjectField(TEXT("rotation"), RotationObj))
+        UBlueprint *Blueprint = Blueprints[i];
+        if (!Blueprint)
+        {
+            Infos.Add(nullptr);
+            continue;
+        }
+
+        const FName PackageName = Blueprint->GetPackage()->GetFName();
+        TSharedPtr<FJsonObject> Info = bRefresh ? nullptr : InfoCache->Find(PackageName);
+        if (Info.IsValid())
+        {
+            CachedCount++;
+        }
+        else
         {
-            Rotation = GetRotatorFromJson(*RotationObj);
+            Info = MakeBlueprintInfo(Blueprint);
+            InfoCache->Add(PackageName, Info);
         }
+        Infos.Add(Info);
     }
 
-    // 设置所有编辑器视口的摄像机
-    if (GEditor && GEditor->GetActiveViewport())
+    return MakeInfoResponse(Params, BlueprintPaths, Infos, CachedCount);
+}
+
+TSharedPtr<FJsonObject> FMCPGetBlueprintInfoHandler::MakeInfoResponse(const TSharedPtr<FJsonObject> &Params,
+                                                                      const TArray<FString> &BlueprintPaths,
+                                                                      const TArray<TSharedPtr<FJsonObject>> &Infos,
+                                                                      int32 CachedCount)
+{
+    // 缓存的信息对象共享,复制顶层字段后再写入请求路径
+    auto MakeResponseInfo = [](const TSharedPtr<FJsonObject> &Info, const FString &BlueprintPath)
     {
-        FLevelEditorViewportClient *ViewportClient =
-            static_cast<FLevelEditorViewportClient *>(GEditor->GetActiveViewport()->GetClient());
+        TSharedPtr<FJsonObject> ResponseInfo = MakeShared<FJsonObject>(*Info);
+        ResponseInfo->SetStringField("path", BlueprintPath);
+        return ResponseInfo;
+    };
 
-        if (ViewportClient)
+    // 单个路径保持原有的响应格式
+    if (!Params->HasField(TEXT("paths")))
+    {
+        if (!Infos[0].IsValid())
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPaths[0]));
+        }
+
+        TSharedPtr<FJsonObject> Result = MakeResponseInfo(Infos[0], BlueprintPaths[0]);
+        Result->SetBoolField("cached", CachedCount > 0);
+
+        MCP_LOG_VERBOSE("Blueprint info retrieved: %s (cached: %s)", *BlueprintPaths[0], CachedCount > 0 ? TEXT("true") : TEXT("false"));
+        return CreateSuccessResponse(Result);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> BlueprintsArray;
+    int32 FailureCount = 0;
+
+    for (int32 i = 0; i < BlueprintPaths.Num(); ++i)
+    {
+        if (Infos[i].IsValid())
         {
-            ViewportClient->SetViewLocation(Location);
-            ViewportClient->SetViewRotation(Rotation);
+            BlueprintsArray.Add(MakeShared<FJsonValueObject>(MakeResponseInfo(Infos[i], BlueprintPaths[i])));
+        }
+        else
+        {
+            TSharedPtr<FJsonObject> ErrorInfo = MakeShared<FJsonObject>();
+            ErrorInfo->SetStringField("path", BlueprintPaths[i]);
+            ErrorInfo->SetStringField("error", TEXT("Blueprint not found"));
+            BlueprintsArray.Add(MakeShared<FJsonValueObject>(ErrorInfo));
+            FailureCount++;
         }
     }
 
     TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetObjectField("location", VectorToJson(Location));
-    Result->SetObjectField("rotation", RotatorToJson(Rotation));
+    Result->SetArrayField("blueprints", BlueprintsArray);
+    Result->SetNumberField("count", BlueprintsArray.Num() - FailureCount);
+    Result->SetNumberField("failed_count", FailureCount);
+    Result->SetNumberField("cached_count", CachedCount);
 
-    MCP_LOG_INFO("Camera set to location: (%.1f, %.1f, %.1f)", Location.X, Location.Y, Location.Z);
+    MCP_LOG_INFO("Blueprint info retrieved for %d blueprints (%d failed, %d cached)", BlueprintPaths.Num(), FailureCount, CachedCount);
     return CreateSuccessResponse(Result);
 }
 
-TSharedPtr<FJsonObject> FMCPGetCameraHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+FString FMCPModifyBlueprintHandler::GetDescription() const
 {
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    return TEXT("Modify a Blueprint. Requires 'path'. Optional: 'description', 'save' (default true, queued for a batched save).");
+}
 
-    if (GEditor && GEditor->GetActiveViewport())
+TSharedPtr<FJsonObject> FMCPModifyBlueprintHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
+    PathSchema->SetStringField("type", TEXT("string"));
+    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
+    Props->SetObjectField("path", PathSchema);
+
+    TSharedPtr<FJsonObject> DescSchema = MakeShared<FJsonObject>();
+    DescSchema->SetStringField("type", TEXT("string"));
+    DescSchema->SetStringField("description", TEXT("Blueprint description (optional)"));
+    Props->SetObjectField("description", DescSchema);
+
+    TSharedPtr<FJsonObject> SaveSchema = MakeShared<FJsonObject>();
+    SaveSchema->SetStringField("type", TEXT("boolean"));
+    SaveSchema->SetStringField("description", TEXT("Queue the package for the next batched save (default true)"));
+    Props->SetObjectField("save", SaveSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> Required;
+    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
+    Schema->SetArrayField("required", Required);
+
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPModifyBlueprintHandler::ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                                          const TArray<FString> &BlueprintPaths,
+                                                                          const TArray<UBlueprint *> &Blueprints)
+{
+    const FString &BlueprintPath = BlueprintPaths[0];
+    UBlueprint *Blueprint = Blueprints[0];
+    if (!Blueprint)
     {
-        FLevelEditorViewportClient *ViewportClient =
-            static_cast<FLevelEditorViewportClient *>(GEditor->GetActiveViewport()->GetClient());
+        return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPath));
+    }
 
-        if (ViewportClient)
-        {
-            FVector Location = ViewportClient->GetViewLocation();
-            FRotator Rotation = ViewportClient->GetViewRotation();
+    // 获取修改参数
+    if (Params->HasField(TEXT("description")))
+    {
+        FString Description = GetStringParam(Params, TEXT("description"));
+        // 描述字段可用于将来的扩展
+    }
 
-            Result->SetObjectField("location", VectorToJson(Location));
-            Result->SetObjectField("rotation", RotatorToJson(Rotation));
-            Result->SetNumberField("fov", ViewportClient->FOVAngle);
-        }
+    // 标记为已修改
+    Blueprint->MarkPackageDirty();
+    Blueprint->Modify();
+
+    const bool bSave = GetBoolParam(Params, TEXT("save"), true);
+    if (bSave && SaveQueue.IsValid())
+    {
+        SaveQueue->Enqueue(Blueprint->GetPackage());
     }
 
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("blueprint_name", Blueprint->GetName());
+    Result->SetStringField("message", TEXT("Blueprint modified successfully"));
+    Result->SetBoolField("save_queued", bSave && SaveQueue.IsValid());
+
+    MCP_LOG_INFO("Blueprint modified: %s", *BlueprintPath);
     return CreateSuccessResponse(Result);
 }
 
-TSharedPtr<FJsonObject> FMCPCreateLightHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+FString FMCPEditBlueprintHandler::GetDescription() const
 {
-    TSharedPtr<FJsonObject> ErrorResponse;
-    UWorld *World = GetEditorWorld(ErrorResponse);
-    if (!World)
+    return TEXT("Apply a list of edits to a Blueprint with a single recompile: add construction script components, add member variables, set component template properties and set class defaults. Requires 'path' and 'operations'. Optional: 'compile' (default true), 'save' (default true). Returns per-operation results.");
+}
+
+TSharedPtr<FJsonObject> FMCPEditBlueprintHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
+    PathSchema->SetStringField("type", TEXT("string"));
+    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
+    Props->SetObjectField("path", PathSchema);
+
+    TSharedPtr<FJsonObject> OperationProps = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> OpSchema = MakeShared<FJsonObject>();
+    OpSchema->SetStringField("type", TEXT("string"));
+    TArray<TSharedPtr<FJsonValue>> OpEnum;
+    OpEnum.Add(MakeShared<FJsonValueString>(TEXT("add_component")));
+    OpEnum.Add(MakeShared<FJsonValueString>(TEXT("add_variable")));
+    OpEnum.Add(MakeShared<FJsonValueString>(TEXT("set_component_property")));
+    OpEnum.Add(MakeShared<FJsonValueString>(TEXT("set_default")));
+    OpSchema->SetArrayField("enum", OpEnum);
+    OperationProps->SetObjectField("op", OpSchema);
+
+    TSharedPtr<FJsonObject> OperationSchema = MakeShared<FJsonObject>();
+    OperationSchema->SetStringField("type", TEXT("object"));
+    OperationSchema->SetObjectField("properties", OperationProps);
+    TArray<TSharedPtr<FJsonValue>> OperationRequired;
+    OperationRequired.Add(MakeShared<FJsonValueString>(TEXT("op")));
+    OperationSchema->SetArrayField("required", OperationRequired);
+
+    TSharedPtr<FJsonObject> OperationsSchema = MakeShared<FJsonObject>();
+    OperationsSchema->SetStringField("type", TEXT("array"));
+    OperationsSchema->SetStringField("description", TEXT("Operations applied in order. add_component: {name, class, attach_to?, properties?}; add_variable: {name, type (bool/int/float/double/string/name/text/vector/rotator/transform/color/struct or class name, '[]' suffix for arrays), default_value?, category?, instance_editable?}; set_component_property: {component, property, value}; set_default: {property, value} (applied after compile)"));
+    OperationsSchema->SetObjectField("items", OperationSchema);
+    Props->SetObjectField("operations", OperationsSchema);
+
+    TSharedPtr<FJsonObject> CompileSchema = MakeShared<FJsonObject>();
+    CompileSchema->SetStringField("type", TEXT("boolean"));
+    CompileSchema->SetStringField("description", TEXT("Compile once after all operations (default true)"));
+    Props->SetObjectField("compile", CompileSchema);
+
+    TSharedPtr<FJsonObject> SaveSchema = MakeShared<FJsonObject>();
+    SaveSchema->SetStringField("type", TEXT("boolean"));
+    SaveSchema->SetStringField("description", TEXT("Queue the package for the next batched save (default true)"));
+    Props->SetObjectField("save", SaveSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> Required;
+    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
+    Required.Add(MakeShared<FJsonValueString>(TEXT("operations")));
+    Schema->SetArrayField("required", Required);
+
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPEditBlueprintHandler::ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                                        const TArray<FString> &BlueprintPaths,
+                                                                        const TArray<UBlueprint *> &Blueprints)
+{
+    const FString &BlueprintPath = BlueprintPaths[0];
+    UBlueprint *Blueprint = Blueprints[0];
+    if (!Blueprint)
     {
-        return ErrorResponse;
+        return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPath));
     }
 
-    FString LightType = GetStringParam(Params, TEXT("type"), TEXT("point"));
-    FVector Location = FVector::ZeroVector;
-    if (Params->HasField(TEXT("location")))
+    const TArray<TSharedPtr<FJsonValue>> *OperationsArray = nullptr;
+    if (!Params->TryGetArrayField(TEXT("operations"), OperationsArray) || OperationsArray->Num() == 0)
     {
-        const TSharedPtr<FJsonObject> *LocationObj;
-        if (Params->TryGetObjectField(TEXT("location"), LocationObj))
-        {
-            Location = GetVectorFromJson(*LocationObj);
-        }
+        return CreateErrorResponse(TEXT("Missing required parameter: operations"));
     }
 
-    float Intensity = static_cast<float>(GetNumberParam(Params, TEXT("intensity"), 1000.0));
-    float Temperature = static_cast<float>(GetNumberParam(Params, TEXT("temperature"), 6500.0));
-    FString LightName = GetStringParam(Params, TEXT("name"), TEXT("NewLight"));
+    if (OperationsArray->Num() > MCPConstants::MAX_BLUEPRINT_EDIT_OPERATIONS)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Too many operations (max %d)"), MCPConstants::MAX_BLUEPRINT_EDIT_OPERATIONS));
+    }
 
-    AActor *NewLight = nullptr;
+    const bool bCompile = GetBoolParam(Params, TEXT("compile"), true);
+    const bool bSave = GetBoolParam(Params, TEXT("save"), true);
 
-    if (LightType == TEXT("directional"))
+    TArray<TSharedPtr<FJsonValue>> ResultsArray;
+    ResultsArray.SetNum(OperationsArray->Num());
+    TArray<int32> DeferredDefaultOperations;
+    int32 SucceededCount = 0;
+    int32 FailedCount = 0;
+    bool bStructurallyModified = false;
+
+    auto RecordResult = [&ResultsArray, &SucceededCount, &FailedCount](int32 Index, const FString &OpName, bool bSuccess, const FString &Error)
     {
-        NewLight = World->SpawnActor<ADirectionalLight>(ADirectionalLight::StaticClass(), Location, FRotator::ZeroRotator);
-        if (ADirectionalLight *DirLight = Cast<ADirectionalLight>(NewLight))
+        TSharedPtr<FJsonObject> OperationResult = MakeShared<FJsonObject>();
+        OperationResult->SetNumberField("index", Index);
+        OperationResult->SetStringField("op", OpName);
+        OperationResult->SetBoolField("success", bSuccess);
+        if (!bSuccess)
         {
-            DirLight->GetLightComponent()->SetIntensity(Intensity);
+            OperationResult->SetStringField("error", Error);
         }
-    }
-    else if (LightType == TEXT("spot"))
+        ResultsArray[Index] = MakeShared<FJsonValueObject>(OperationResult);
+        (bSuccess ? SucceededCount : FailedCount)++;
+    };
+
     {
-        NewLight = World->SpawnActor<ASpotLight>(ASpotLight::StaticClass(), Location, FRotator::ZeroRotator);
-        if (ASpotLight *SpotLight = Cast<ASpotLight>(NewLight))
+        // 所有操作合并为一次撤销事务
+        FScopedTransaction Transaction(NSLOCTEXT("Unreal5MCP", "EditBlueprintTransaction", "MCP Edit Blueprint"));
+        Blueprint->Modify();
+
+        for (int32 i = 0; i < OperationsArray->Num(); ++i)
         {
-            SpotLight->GetLightComponent()->SetIntensity(Intensity);
+            const TSharedPtr<FJsonObject> *OperationObject = nullptr;
+            if (!(*OperationsArray)[i].IsValid() || !(*OperationsArray)[i]->TryGetObject(OperationObject))
+            {
+                RecordResult(i, FString(), false, TEXT("Operation must be an object"));
+                continue;
+            }
+
+            const TSharedPtr<FJsonObject> &Operation = *OperationObject;
+            const FString OpName = GetStringParam(Operation, TEXT("op"));
+            FString Error;
+            bool bSuccess = false;
+
+            if (OpName == TEXT("add_component"))
+            {
+                bSuccess = AddComponent(Blueprint, Operation, Error);
+                bStructurallyModified |= bSuccess;
+            }
+            else if (OpName == TEXT("add_variable"))
+            {
+                bSuccess = AddVariable(Blueprint, Operation, Error);
+                bStructurallyModified |= bSuccess;
+            }
+            else if (OpName == TEXT("set_component_property"))
+            {
+                bSuccess = SetComponentProperty(Blueprint, Operation, Error);
+            }
+            else if (OpName == TEXT("set_default"))
+            {
+                // 类默认值在编译后设置,新添加的变量此时已存在于生成类中
+                DeferredDefaultOperations.Add(i);
+                continue;
+            }
+            else
+            {
+                Error = FString::Printf(TEXT("Unknown operation: '%s'"), *OpName);
+            }
+
+            RecordResult(i, OpName, bSuccess, Error);
+        }
+
+        // 结构性修改只通知一次,而不是每个操作一次
+        if (bStructurallyModified)
+        {
+            FBlueprintEditorUtils::MarkBlueprintAsStructurallyModified(Blueprint);
+        }
+        else
+        {
+            FBlueprintEditorUtils::MarkBlueprintAsModified(Blueprint);
+        }
+
+        if (bCompile)
+        {
+            FKismetEditorUtilities::CompileBlueprint(Blueprint);
+        }
+
+        for (int32 Index : DeferredDefaultOperations)
+        {
+            const TSharedPtr<FJsonObject> Operation = (*OperationsArray)[Index]->AsObject();
+            FString Error;
+            const bool bSuccess = SetClassDefault(Blueprint, Operation, Error);
+            RecordResult(Index, TEXT("set_default"), bSuccess, Error);
         }
     }
-    else // 默认点光源
+
+    if (bSave && SaveQueue.IsValid())
     {
-        NewLight = World->SpawnActor<APointLight>(APointLight::StaticClass(), Location, FRotator::ZeroRotator);
-        if (APointLight *PointLight = Cast<APointLight>(NewLight))
+        SaveQueue->Enqueue(Blueprint->GetPackage());
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("blueprint_name", Blueprint->GetName());
+    Result->SetNumberField("succeeded_count", SucceededCount);
+    Result->SetNumberField("failed_count", FailedCount);
+    Result->SetArrayField("operations", ResultsArray);
+    Result->SetBoolField("compiled", bCompile);
+    if (bCompile)
+    {
+        Result->SetBoolField("compile_success", Blueprint->Status != BS_Error);
+    }
+    Result->SetBoolField("save_queued", bSave && SaveQueue.IsValid());
+
+    MCP_LOG_INFO("Blueprint edited: %s (%d operations succeeded, %d failed)", *BlueprintPath, SucceededCount, FailedCount);
+    return CreateSuccessResponse(Result);
+}
+
+bool FMCPEditBlueprintHandler::AddComponent(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const
+{
+    USimpleConstructionScript *SCS = Blueprint->SimpleConstructionScript;
+    if (!SCS)
+    {
+        OutError = TEXT("Blueprint has no construction script (not an actor blueprint)");
+        return false;
+    }
+
+    const FString ComponentName = GetStringParam(Operation, TEXT("name"));
+    const FString ClassName = GetStringParam(Operation, TEXT("class"));
+    if (ComponentName.IsEmpty() || ClassName.IsEmpty())
+    {
+        OutError = TEXT("add_component requires 'name' and 'class'");
+        return false;
+    }
+
+    UClass *ComponentClass = FindClassByName(ClassName);
+    if (!ComponentClass)
+    {
+        ComponentClass = FindClassByName(TEXT("U") + ClassName);
+    }
+    if (!ComponentClass || !ComponentClass->IsChildOf(UActorComponent::StaticClass()))
+    {
+        OutError = FString::Printf(TEXT("Component class not found: %s"), *ClassName);
+        return false;
+    }
+
+    if (SCS->FindSCSNode(FName(*ComponentName)))
+    {
+        OutError = FString::Printf(TEXT("Component already exists: %s"), *ComponentName);
+        return false;
+    }
+
+    // 挂载目标先行校验,失败时不留下半成品节点
+    const FString AttachTo = GetStringParam(Operation, TEXT("attach_to"));
+    USCS_Node *ParentNode = nullptr;
+    if (!AttachTo.IsEmpty())
+    {
+        if (!ComponentClass->IsChildOf(USceneComponent::StaticClass()))
         {
-            PointLight->GetLightComponent()->SetIntensity(Intensity);
+            OutError = FString::Printf(TEXT("attach_to requires a scene component, %s is not one"), *ClassName);
+            return false;
+        }
+
+        ParentNode = SCS->FindSCSNode(FName(*AttachTo));
+        if (!ParentNode)
+        {
+            OutError = FString::Printf(TEXT("Attach parent not found: %s"), *AttachTo);
+            return false;
         }
     }
 
-    if (!NewLight)
+    USCS_Node *NewNode = SCS->CreateNode(ComponentClass, FName(*ComponentName));
+    if (!NewNode)
     {
-        return CreateErrorResponse(TEXT("Failed to spawn light"));
+        OutError = TEXT("Failed to create component node");
+        return false;
     }
 
-    NewLight->SetActorLabel(LightName);
+    // 可选: 同时设置组件属性,全部成功后才把节点加入构造脚本
+    const TSharedPtr<FJsonObject> *PropertiesObject = nullptr;
+    if (Operation->TryGetObjectField(TEXT("properties"), PropertiesObject) && NewNode->ComponentTemplate)
+    {
+        for (const TPair<FString, TSharedPtr<FJsonValue>> &Pair : (*PropertiesObject)->Values)
+        {
+            FProperty *Property = NewNode->ComponentTemplate->GetClass()->FindPropertyByName(FName(*Pair.Key));
+            if (!Property || !FJsonObjectConverter::JsonValueToUProperty(Pair.Value, Property, Property->ContainerPtrToValuePtr<void>(NewNode->ComponentTemplate), 0, 0))
+            {
+                OutError = FString::Printf(TEXT("Failed to set component property: %s"), *Pair.Key);
+                return false;
+            }
+        }
+    }
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("light_name", NewLight->GetName());
-    Result->SetStringField("light_type", LightType);
-    Result->SetObjectField("location", VectorToJson(Location));
-    Result->SetNumberField("intensity", Intensity);
+    if (ParentNode)
+    {
+        ParentNode->AddChildNode(NewNode);
+    }
+    else
+    {
+        SCS->AddNode(NewNode);
+    }
 
-    MCP_LOG_INFO("Light created: %s of type %s at location", *LightName, *LightType);
-    return CreateSuccessResponse(Result);
+    return true;
 }
 
-TSharedPtr<FJsonObject> FMCPSelectActorHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+bool FMCPEditBlueprintHandler::AddVariable(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const
 {
-    TSharedPtr<FJsonObject> ErrorResponse;
-    UWorld *World = GetEditorWorld(ErrorResponse);
-    if (!World)
+    const FString VariableName = GetStringParam(Operation, TEXT("name"));
+    const FString TypeName = GetStringParam(Operation, TEXT("type"));
+    if (VariableName.IsEmpty() || TypeName.IsEmpty())
     {
-        return ErrorResponse;
+        OutError = TEXT("add_variable requires 'name' and 'type'");
+        return false;
     }
 
-    FString ActorName = GetStringParam(Params, TEXT("actor_name"));
-    if (ActorName.IsEmpty())
+    const FName VarName(*VariableName);
+    FKismetNameValidator NameValidator(Blueprint);
+    if (NameValidator.IsValid(VarName) != EValidatorResult::Ok)
     {
-        return CreateErrorResponse(TEXT("Missing required parameter: actor_name"));
+        OutError = FString::Printf(TEXT("Variable name is invalid or already in use: %s"), *VariableName);
+        return false;
     }
 
-    AActor *TargetActor = FindActorByName(World, ActorName, ErrorResponse);
-    if (!TargetActor)
+    FEdGraphPinType PinType;
+    if (!ParsePinType(TypeName, PinType, OutError))
     {
-        return ErrorResponse;
+        return false;
     }
 
-    bool bSelect = GetBoolParam(Params, TEXT("select"), true);
+    // 直接追加变量描述,结构性修改在所有操作结束后统一标记
+    FBPVariableDescription Variable;
+    Variable.VarName = VarName;
+    Variable.VarGuid = FGuid::NewGuid();
+    Variable.FriendlyName = FName::NameToDisplayString(VariableName, PinType.PinCategory == UEdGraphSchema_K2::PC_Boolean);
+    Variable.VarType = PinType;
+    Variable.PropertyFlags |= CPF_Edit | CPF_BlueprintVisible;
+    if (!GetBoolParam(Operation, TEXT("instance_editable"), false))
+    {
+        Variable.PropertyFlags |= CPF_DisableEditOnInstance;
+    }
+
+    const FString Category = GetStringParam(Operation, TEXT("category"));
+    Variable.Category = Category.IsEmpty() ? UEdGraphSchema_K2::VR_DefaultCategory : FText::FromString(Category);
+    Variable.DefaultValue = GetStringParam(Operation, TEXT("default_value"));
+
+    Blueprint->NewVariables.Add(Variable);
+    return true;
+}
+
+bool FMCPEditBlueprintHandler::SetComponentProperty(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const
+{
+    const FString ComponentName = GetStringParam(Operation, TEXT("component"));
+    const FString PropertyName = GetStringParam(Operation, TEXT("property"));
+    const TSharedPtr<FJsonValue> Value = Operation->TryGetField(TEXT("value"));
+    if (ComponentName.IsEmpty() || PropertyName.IsEmpty() || !Value.IsValid())
+    {
+        OutError = TEXT("set_component_property requires 'component', 'property' and 'value'");
+        return false;
+    }
+
+    USCS_Node *Node = Blueprint->SimpleConstructionScript ? Blueprint->SimpleConstructionScript->FindSCSNode(FName(*ComponentName)) : nullptr;
+    if (!Node || !Node->ComponentTemplate)
+    {
+        OutError = FString::Printf(TEXT("Component not found in this blueprint's construction script: %s"), *ComponentName);
+        return false;
+    }
+
+    UActorComponent *Template = Node->ComponentTemplate;
+    FProperty *Property = Template->GetClass()->FindPropertyByName(FName(*PropertyName));
+    if (!Property)
+    {
+        OutError = FString::Printf(TEXT("Property not found on %s: %s"), *Template->GetClass()->GetName(), *PropertyName);
+        return false;
+    }
+
+    Template->Modify();
+    if (!FJsonObjectConverter::JsonValueToUProperty(Value, Property, Property->ContainerPtrToValuePtr<void>(Template), 0, 0))
+    {
+        OutError = FString::Printf(TEXT("Invalid value for property: %s"), *PropertyName);
+        return false;
+    }
+
+    return true;
+}
+
+bool FMCPEditBlueprintHandler::SetClassDefault(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const
+{
+    const FString PropertyName = GetStringParam(Operation, TEXT("property"));
+    const TSharedPtr<FJsonValue> Value = Operation->TryGetField(TEXT("value"));
+    if (PropertyName.IsEmpty() || !Value.IsValid())
+    {
+        OutError = TEXT("set_default requires 'property' and 'value'");
+        return false;
+    }
+
+    UObject *DefaultObject = Blueprint->GeneratedClass ? Blueprint->GeneratedClass->GetDefaultObject() : nullptr;
+    FProperty *Property = DefaultObject ? DefaultObject->GetClass()->FindPropertyByName(FName(*PropertyName)) : nullptr;
+
+    if (!Property)
+    {
+        // 未编译时新变量尚不在生成类中,写入变量描述的默认值
+        const int32 VariableIndex = FBlueprintEditorUtils::FindNewVariableIndex(Blueprint, FName(*PropertyName));
+        FString ValueString;
+        if (VariableIndex != INDEX_NONE && Value->TryGetString(ValueString))
+        {
+            Blueprint->NewVariables[VariableIndex].DefaultValue = ValueString;
+            return true;
+        }
+
+        OutError = FString::Printf(TEXT("Class default property not found: %s"), *PropertyName);
+        return false;
+    }
+
+    DefaultObject->Modify();
+    if (!FJsonObjectConverter::JsonValueToUProperty(Value, Property, Property->ContainerPtrToValuePtr<void>(DefaultObject), 0, 0))
+    {
+        OutError = FString::Printf(TEXT("Invalid value for property: %s"), *PropertyName);
+        return false;
+    }
+
+    return true;
+}
+
+bool FMCPEditBlueprintHandler::ParsePinType(const FString &TypeName, FEdGraphPinType &OutPinType, FString &OutError) const
+{
+    FString BaseType = TypeName.TrimStartAndEnd();
+    if (BaseType.EndsWith(TEXT("[]")))
+    {
+        OutPinType.ContainerType = EPinContainerType::Array;
+        BaseType.LeftChopInline(2);
+    }
+
+    const FString LowerType = BaseType.ToLower();
+    if (LowerType == TEXT("bool") || LowerType == TEXT("boolean"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Boolean;
+    }
+    else if (LowerType == TEXT("int") || LowerType == TEXT("int32") || LowerType == TEXT("integer"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Int;
+    }
+    else if (LowerType == TEXT("int64"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Int64;
+    }
+    else if (LowerType == TEXT("float"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Real;
+        OutPinType.PinSubCategory = UEdGraphSchema_K2::PC_Float;
+    }
+    else if (LowerType == TEXT("double"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Real;
+        OutPinType.PinSubCategory = UEdGraphSchema_K2::PC_Double;
+    }
+    else if (LowerType == TEXT("byte"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Byte;
+    }
+    else if (LowerType == TEXT("string"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_String;
+    }
+    else if (LowerType == TEXT("name"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Name;
+    }
+    else if (LowerType == TEXT("text"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Text;
+    }
+    else if (LowerType == TEXT("vector"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+        OutPinType.PinSubCategoryObject = TBaseStructure<FVector>::Get();
+    }
+    else if (LowerType == TEXT("rotator"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+        OutPinType.PinSubCategoryObject = TBaseStructure<FRotator>::Get();
+    }
+    else if (LowerType == TEXT("transform"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+        OutPinType.PinSubCategoryObject = TBaseStructure<FTransform>::Get();
+    }
+    else if (LowerType == TEXT("color") || LowerType == TEXT("linearcolor"))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+        OutPinType.PinSubCategoryObject = TBaseStructure<FLinearColor>::Get();
+    }
+    else if (UScriptStruct *Struct = FindFirstObject<UScriptStruct>(*BaseType, EFindFirstObjectOptions::NativeFirst))
+    {
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Struct;
+        OutPinType.PinSubCategoryObject = Struct;
+    }
+    else if (UClass *Class = FindClassByName(BaseType))
+    {
+        // 类名作为对象引用
+        OutPinType.PinCategory = UEdGraphSchema_K2::PC_Object;
+        OutPinType.PinSubCategoryObject = Class;
+    }
+    else
+    {
+        OutError = FString::Printf(TEXT("Unknown variable type: %s"), *TypeName);
+        return false;
+    }
+
+    return true;
+}
+
+FString FMCPCompileBlueprintHandler::GetDescription() const
+{
+    return TEXT("Compile a Blueprint. Requires 'path' (asset path).");
+}
+
+TSharedPtr<FJsonObject> FMCPCompileBlueprintHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
+    PathSchema->SetStringField("type", TEXT("string"));
+    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
+    Props->SetObjectField("path", PathSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> Required;
+    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
+    Schema->SetArrayField("required", Required);
+
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPCompileBlueprintHandler::ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                                           const TArray<FString> &BlueprintPaths,
+                                                                           const TArray<UBlueprint *> &Blueprints)
+{
+    const FString &BlueprintPath = BlueprintPaths[0];
+    UBlueprint *Blueprint = Blueprints[0];
+    if (!Blueprint)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Blueprint not found: %s"), *BlueprintPath));
+    }
+
+    // 编译蓝图
+    FKismetEditorUtilities::CompileBlueprint(Blueprint);
+
+    bool bCompileSuccess = Blueprint->IsUpToDate();
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("blueprint_name", Blueprint->GetName());
+    Result->SetBoolField("compile_success", bCompileSuccess);
+
+    MCP_LOG_INFO("Blueprint compiled: %s (Success: %s)", *BlueprintPath, bCompileSuccess ? TEXT("true") : TEXT("false"));
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPCompileBlueprintsHandler::GetDescription() const
+{
+    return TEXT("Compile many blueprints in dependency order in one batch, skipping those already up to date. Requires 'paths' (array) or 'folder'. Optional: 'recursive', 'force', 'include_skipped', 'include_info'. Returns per-blueprint status and compiler errors/warnings.");
+}
+
+TSharedPtr<FJsonObject> FMCPCompileBlueprintsHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> PathsSchema = MakeShared<FJsonObject>();
+    PathsSchema->SetStringField("type", TEXT("array"));
+    PathsSchema->SetStringField("description", TEXT("Blueprint asset paths to compile (optional if 'folder' is given)"));
+    TSharedPtr<FJsonObject> PathItemSchema = MakeShared<FJsonObject>();
+    PathItemSchema->SetStringField("type", TEXT("string"));
+    PathsSchema->SetObjectField("items", PathItemSchema);
+    Props->SetObjectField("paths", PathsSchema);
+
+    TSharedPtr<FJsonObject> FolderSchema = MakeShared<FJsonObject>();
+    FolderSchema->SetStringField("type", TEXT("string"));
+    FolderSchema->SetStringField("description", TEXT("Compile every blueprint under this folder, e.g. /Game/Blueprints (optional)"));
+    Props->SetObjectField("folder", FolderSchema);
+
+    TSharedPtr<FJsonObject> RecursiveSchema = MakeShared<FJsonObject>();
+    RecursiveSchema->SetStringField("type", TEXT("boolean"));
+    RecursiveSchema->SetStringField("description", TEXT("Include sub folders of 'folder' (default true)"));
+    Props->SetObjectField("recursive", RecursiveSchema);
+
+    TSharedPtr<FJsonObject> ForceSchema = MakeShared<FJsonObject>();
+    ForceSchema->SetStringField("type", TEXT("boolean"));
+    ForceSchema->SetStringField("description", TEXT("Also recompile blueprints that are already up to date (default false)"));
+    Props->SetObjectField("force", ForceSchema);
+
+    TSharedPtr<FJsonObject> IncludeSkippedSchema = MakeShared<FJsonObject>();
+    IncludeSkippedSchema->SetStringField("type", TEXT("boolean"));
+    IncludeSkippedSchema->SetStringField("description", TEXT("List up-to-date blueprints in the result (default false)"));
+    Props->SetObjectField("include_skipped", IncludeSkippedSchema);
+
+    TSharedPtr<FJsonObject> IncludeInfoSchema = MakeShared<FJsonObject>();
+    IncludeInfoSchema->SetStringField("type", TEXT("boolean"));
+    IncludeInfoSchema->SetStringField("description", TEXT("Include info-level compiler messages (default false)"));
+    Props->SetObjectField("include_info", IncludeInfoSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    return Schema;
+}
+
+bool FMCPCompileBlueprintsHandler::ResolveBlueprintPaths(const TSharedPtr<FJsonObject> &Params, TArray<FString> &OutPaths, FString &OutError)
+{
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
+
+    TSet<FName> PackageNames;
+
+    const TArray<TSharedPtr<FJsonValue>> *PathsArray = nullptr;
+    if (Params.IsValid() && Params->TryGetArrayField(TEXT("paths"), PathsArray))
+    {
+        for (const TSharedPtr<FJsonValue> &PathValue : *PathsArray)
+        {
+            FString Path;
+            if (PathValue.IsValid() && PathValue->TryGetString(Path) && !Path.IsEmpty())
+            {
+                PackageNames.Add(FName(*FPackageName::ObjectPathToPackageName(Path)));
+            }
+        }
+    }
+
+    const FString Folder = GetStringParam(Params, TEXT("folder"));
+    if (!Folder.IsEmpty())
+    {
+        const bool bRecursive = GetBoolParam(Params, TEXT("recursive"), true);
+
+        // 注册表仍在扫描时先同步扫描目标目录,避免遗漏
+        if (AssetRegistry.IsLoadingAssets())
+        {
+            AssetRegistry.ScanPathsSynchronous({Folder}, false);
+        }
+
+        FARFilter Filter;
+        Filter.PackagePaths.Add(FName(*Folder));
+        Filter.bRecursivePaths = bRecursive;
+        Filter.ClassPaths.Add(UBlueprint::StaticClass()->GetClassPathName());
+        Filter.bRecursiveClasses = true;
+
+        TArray<FAssetData> Assets;
+        AssetRegistry.GetAssets(Filter, Assets);
+        for (const FAssetData &Asset : Assets)
+        {
+            PackageNames.Add(Asset.PackageName);
+        }
+    }
+
+    if (PackageNames.Num() == 0)
+    {
+        OutError = Folder.IsEmpty() ? TEXT("Missing required parameter: paths or folder")
+                                    : FString::Printf(TEXT("No blueprints found in folder: %s"), *Folder);
+        return false;
+    }
+
+    // 按名称排序,保证相同输入得到相同的编译顺序
+    TArray<FName> SortedPackages = PackageNames.Array();
+    SortedPackages.Sort(FNameLexicalLess());
+
+    TMap<FName, int32> PackageIndices;
+    for (int32 i = 0; i < SortedPackages.Num(); ++i)
+    {
+        PackageIndices.Add(SortedPackages[i], i);
+    }
+
+    // 依赖图(仅限本次编译的集合内): 硬依赖(父类、组件类等)需要先编译
+    TArray<TArray<int32>> Dependents;
+    TArray<int32> PendingDependencyCounts;
+    Dependents.SetNum(SortedPackages.Num());
+    PendingDependencyCounts.SetNumZeroed(SortedPackages.Num());
+
+    TArray<FName> Dependencies;
+    for (int32 i = 0; i < SortedPackages.Num(); ++i)
+    {
+        Dependencies.Reset();
+        AssetRegistry.GetDependencies(SortedPackages[i], Dependencies,
+                                      UE::AssetRegistry::EDependencyCategory::Package,
+                                      UE::AssetRegistry::EDependencyQuery::Hard);
+
+        for (const FName &Dependency : Dependencies)
+        {
+            const int32 *DependencyIndex = PackageIndices.Find(Dependency);
+            if (DependencyIndex && *DependencyIndex != i)
+            {
+                Dependents[*DependencyIndex].Add(i);
+                PendingDependencyCounts[i]++;
+            }
+        }
+    }
+
+    // 拓扑排序,就绪集合用最小堆保持名称顺序
+    TArray<int32> Ready;
+    for (int32 i = 0; i < SortedPackages.Num(); ++i)
+    {
+        if (PendingDependencyCounts[i] == 0)
+        {
+            Ready.HeapPush(i);
+        }
+    }
+
+    TArray<bool> Emitted;
+    Emitted.SetNumZeroed(SortedPackages.Num());
+    OutPaths.Reserve(SortedPackages.Num());
+
+    while (Ready.Num() > 0)
+    {
+        int32 Index = INDEX_NONE;
+        Ready.HeapPop(Index);
+
+        Emitted[Index] = true;
+        OutPaths.Add(SortedPackages[Index].ToString());
+
+        for (int32 DependentIndex : Dependents[Index])
+        {
+            if (--PendingDependencyCounts[DependentIndex] == 0)
+            {
+                Ready.HeapPush(DependentIndex);
+            }
+        }
+    }
+
+    // 循环依赖中的蓝图按名称顺序追加,由编译器处理
+    for (int32 i = 0; i < SortedPackages.Num(); ++i)
+    {
+        if (!Emitted[i])
+        {
+            OutPaths.Add(SortedPackages[i].ToString());
+        }
+    }
+
+    return true;
+}
+
+TSharedPtr<FJsonObject> FMCPCompileBlueprintsHandler::ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                                            const TArray<FString> &BlueprintPaths,
+                                                                            const TArray<UBlueprint *> &Blueprints)
+{
+    const bool bForce = GetBoolParam(Params, TEXT("force"), false);
+    const bool bIncludeSkipped = GetBoolParam(Params, TEXT("include_skipped"), false);
+    const bool bIncludeInfo = GetBoolParam(Params, TEXT("include_info"), false);
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    int32 CompiledCount = 0;
+    int32 SkippedCount = 0;
+    int32 FailedCount = 0;
+    int32 NotFoundCount = 0;
+    TArray<TSharedPtr<FJsonValue>> ResultsArray;
+
+    // 第一遍:所有过期蓝图带各自的日志加入编译队列,由编译管理器统一排序和重新实例化
+    TArray<TUniquePtr<FCompilerResultsLog>> CompilerLogs;
+    CompilerLogs.SetNum(Blueprints.Num());
+    int32 QueuedCount = 0;
+    for (int32 i = 0; i < Blueprints.Num(); ++i)
+    {
+        UBlueprint *Blueprint = Blueprints[i];
+        if (!Blueprint || (!bForce && Blueprint->IsUpToDate()))
+        {
+            continue;
+        }
+
+        CompilerLogs[i] = MakeUnique<FCompilerResultsLog>();
+        CompilerLogs[i]->bSilentMode = true;
+        CompilerLogs[i]->SetSourcePath(Blueprint->GetPathName());
+
+        // 垃圾回收推迟到整批编译结束后执行一次
+        FBlueprintCompilationManager::QueueForCompilation(
+            FBPCompileRequest(Blueprint, EBlueprintCompileOptions::SkipGarbageCollection, CompilerLogs[i].Get()));
+        QueuedCount++;
+    }
+
+    if (QueuedCount > 0)
+    {
+        FBlueprintCompilationManager::FlushCompilationQueueAndReinstance();
+    }
+
+    // 第二遍:按请求顺序读取每个蓝图的编译结果
+    for (int32 i = 0; i < Blueprints.Num(); ++i)
+    {
+        UBlueprint *Blueprint = Blueprints[i];
+
+        TSharedPtr<FJsonObject> Entry = MakeShared<FJsonObject>();
+        Entry->SetStringField("path", BlueprintPaths[i]);
+
+        if (!Blueprint)
+        {
+            Entry->SetStringField("status", TEXT("not_found"));
+            ResultsArray.Add(MakeShared<FJsonValueObject>(Entry));
+            NotFoundCount++;
+            continue;
+        }
+
+        if (!CompilerLogs[i].IsValid())
+        {
+            SkippedCount++;
+            if (bIncludeSkipped)
+            {
+                Entry->SetStringField("status", TEXT("up_to_date"));
+                ResultsArray.Add(MakeShared<FJsonValueObject>(Entry));
+            }
+            continue;
+        }
+
+        const FCompilerResultsLog &CompilerResults = *CompilerLogs[i];
+        const bool bFailed = CompilerResults.NumErrors > 0 || Blueprint->Status == BS_Error;
+        Entry->SetStringField("status", bFailed ? TEXT("failed") : TEXT("compiled"));
+        Entry->SetNumberField("errors", CompilerResults.NumErrors);
+        Entry->SetNumberField("warnings", CompilerResults.NumWarnings);
+
+        TArray<TSharedPtr<FJsonValue>> MessagesArray;
+        for (const TSharedRef<FTokenizedMessage> &Message : CompilerResults.Messages)
+        {
+            const EMessageSeverity::Type Severity = Message->GetSeverity();
+            if (Severity == EMessageSeverity::Info && !bIncludeInfo)
+            {
+                continue;
+            }
+
+            if (MessagesArray.Num() >= MCPConstants::MAX_COMPILER_MESSAGES_PER_BLUEPRINT)
+            {
+                Entry->SetBoolField("messages_truncated", true);
+                break;
+            }
+
+            TSharedPtr<FJsonObject> MessageObject = MakeShared<FJsonObject>();
+            MessageObject->SetStringField("severity", Severity == EMessageSeverity::Error     ? TEXT("error")
+                                                      : Severity == EMessageSeverity::Info    ? TEXT("info")
+                                                                                              : TEXT("warning"));
+            MessageObject->SetStringField("message", Message->ToText().ToString());
+            MessagesArray.Add(MakeShared<FJsonValueObject>(MessageObject));
+        }
+        if (MessagesArray.Num() > 0)
+        {
+            Entry->SetArrayField("messages", MessagesArray);
+        }
+
+        ResultsArray.Add(MakeShared<FJsonValueObject>(Entry));
+        if (bFailed)
+        {
+            FailedCount++;
+        }
+        else
+        {
+            CompiledCount++;
+        }
+    }
+
+    if (CompiledCount + FailedCount > 0)
+    {
+        CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+    }
+
+    const double ElapsedSeconds = FPlatformTime::Seconds() - StartTime;
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("total", Blueprints.Num());
+    Result->SetNumberField("compiled_count", CompiledCount);
+    Result->SetNumberField("failed_count", FailedCount);
+    Result->SetNumberField("skipped_count", SkippedCount);
+    Result->SetNumberField("not_found_count", NotFoundCount);
+    Result->SetNumberField("compile_ms", ElapsedSeconds * 1000.0);
+    Result->SetArrayField("blueprints", ResultsArray);
+
+    MCP_LOG_INFO("compile_blueprints: %d compiled, %d failed, %d up to date, %d not found in %.2f s",
+                 CompiledCount, FailedCount, SkippedCount, NotFoundCount, ElapsedSeconds);
+    return CreateSuccessResponse(Result);
+}
+
+// ============================================================================
+// 场景编辑命令处理器实现
+// ============================================================================
+
+FString FMCPSetCameraHandler::GetDescription() const
+{
+    return TEXT("Set editor camera position and rotation.");
+}
+
+TSharedPtr<FJsonObject> FMCPSetCameraHandler::ExecuteTyped(const FMCPSetCameraParams &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    UWorld *World = GetEditorWorld(ErrorResponse);
+    if (!World)
+    {
+        return ErrorResponse;
+    }
+
+    // 设置所有编辑器视口的摄像机
+    if (GEditor && GEditor->GetActiveViewport())
+    {
+        FLevelEditorViewportClient *ViewportClient =
+            static_cast<FLevelEditorViewportClient *>(GEditor->GetActiveViewport()->GetClient());
+
+        if (ViewportClient)
+        {
+            ViewportClient->SetViewLocation(Params.Location);
+            ViewportClient->SetViewRotation(Params.Rotation);
+        }
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetObjectField("location", VectorToJson(Params.Location));
+    Result->SetObjectField("rotation", RotatorToJson(Params.Rotation));
+
+    MCP_LOG_INFO("Camera set to location: (%.1f, %.1f, %.1f)", Params.Location.X, Params.Location.Y, Params.Location.Z);
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPGetCameraHandler::GetDescription() const
+{
+    return TEXT("Get current editor camera position and rotation.");
+}
+
+TSharedPtr<FJsonObject> FMCPGetCameraHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+
+    if (GEditor && GEditor->GetActiveViewport())
+    {
+        FLevelEditorViewportClient *ViewportClient =
+            static_cast<FLevelEditorViewportClient *>(GEditor->GetActiveViewport()->GetClient());
+
+        if (ViewportClient)
+        {
+            FVector Location = ViewportClient->GetViewLocation();
+            FRotator Rotation = ViewportClient->GetViewRotation();
+
+            Result->SetObjectField("location", VectorToJson(Location));
+            Result->SetObjectField("rotation", RotatorToJson(Rotation));
+            Result->SetNumberField("fov", ViewportClient->FOVAngle);
+        }
+    }
+
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPCreateLightHandler::GetDescription() const
+{
+    return TEXT("Create a light actor. Specify light type and properties.");
+}
+
+TSharedPtr<FJsonObject> FMCPCreateLightHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    UWorld *World = GetEditorWorld(ErrorResponse);
+    if (!World)
+    {
+        return ErrorResponse;
+    }
+
+    FString LightType = GetStringParam(Params, TEXT("type"), TEXT("point"));
+    FVector Location = FVector::ZeroVector;
+    if (Params->HasField(TEXT("location")))
+    {
+        const TSharedPtr<FJsonObject> *LocationObj;
+        if (Params->TryGetObjectField(TEXT("location"), LocationObj))
+        {
+            Location = GetVectorFromJson(*LocationObj);
+        }
+    }
+
+    float Intensity = static_cast<float>(GetNumberParam(Params, TEXT("intensity"), 1000.0));
+    float Temperature = static_cast<float>(GetNumberParam(Params, TEXT("temperature"), 6500.0));
+    FString LightName = GetStringParam(Params, TEXT("name"), TEXT("NewLight"));
+
+    AActor *NewLight = nullptr;
+
+    if (LightType == TEXT("directional"))
+    {
+        NewLight = World->SpawnActor<ADirectionalLight>(ADirectionalLight::StaticClass(), Location, FRotator::ZeroRotator);
+        if (ADirectionalLight *DirLight = Cast<ADirectionalLight>(NewLight))
+        {
+            DirLight->GetLightComponent()->SetIntensity(Intensity);
+        }
+    }
+    else if (LightType == TEXT("spot"))
+    {
+        NewLight = World->SpawnActor<ASpotLight>(ASpotLight::StaticClass(), Location, FRotator::ZeroRotator);
+        if (ASpotLight *SpotLight = Cast<ASpotLight>(NewLight))
+        {
+            SpotLight->GetLightComponent()->SetIntensity(Intensity);
+        }
+    }
+    else // 默认点光源
+    {
+        NewLight = World->SpawnActor<APointLight>(APointLight::StaticClass(), Location, FRotator::ZeroRotator);
+        if (APointLight *PointLight = Cast<APointLight>(NewLight))
+        {
+            PointLight->GetLightComponent()->SetIntensity(Intensity);
+        }
+    }
+
+    if (!NewLight)
+    {
+        return CreateErrorResponse(TEXT("Failed to spawn light"));
+    }
+
+    NewLight->SetActorLabel(LightName);
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("light_name", NewLight->GetName());
+    Result->SetStringField("light_type", LightType);
+    Result->SetObjectField("location", VectorToJson(Location));
+    Result->SetNumberField("intensity", Intensity);
+
+    MCP_LOG_INFO("Light created: %s of type %s at location", *LightName, *LightType);
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPSelectActorHandler::GetDescription() const
+{
+    return TEXT("Select an actor in the editor.");
+}
+
+TSharedPtr<FJsonObject> FMCPSelectActorHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    UWorld *World = GetEditorWorld(ErrorResponse);
+    if (!World)
+    {
+        return ErrorResponse;
+    }
+
+    FString ActorName = GetStringParam(Params, TEXT("actor_name"));
+    if (ActorName.IsEmpty())
+    {
+        return CreateErrorResponse(TEXT("Missing required parameter: actor_name"));
+    }
+
+    AActor *TargetActor = FindActorByName(World, ActorName, ErrorResponse);
+    if (!TargetActor)
+    {
+        return ErrorResponse;
+    }
+
+    bool bSelect = GetBoolParam(Params, TEXT("select"), true);
+
+    if (GEditor)
+    {
+        GEditor->SelectActor(TargetActor, bSelect, true);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("actor_name", ActorName);
+    Result->SetBoolField("selected", bSelect);
+
+    MCP_LOG_INFO("Actor %s: %s", *ActorName, bSelect ? TEXT("selected") : TEXT("deselected"));
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPGetSelectedActorsHandler::GetDescription() const
+{
+    return TEXT("Get list of currently selected actors.");
+}
+
+TSharedPtr<FJsonObject> FMCPGetSelectedActorsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    TArray<TSharedPtr<FJsonValue>> SelectedActorsArray;
+
+    if (GEditor)
+    {
+        for (FSelectionIterator It(GEditor->GetSelectedActorIterator()); It; ++It)
+        {
+            AActor *Actor = Cast<AActor>(*It);
+            if (Actor)
+            {
+                TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
+                ActorInfo->SetStringField("name", Actor->GetName());
+                ActorInfo->SetStringField("class", Actor->GetClass()->GetName());
+                ActorInfo->SetObjectField("location", VectorToJson(Actor->GetActorLocation()));
+
+                SelectedActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+            }
+        }
+    }
+
+    Result->SetArrayField("selected_actors", SelectedActorsArray);
+    Result->SetNumberField("count", SelectedActorsArray.Num());
+
+    MCP_LOG_INFO("Retrieved %d selected actors", SelectedActorsArray.Num());
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPSelectActorsHandler::GetDescription() const
+{
+    return TEXT("Select many actors at once with a single selection notification. Filters: 'names' (array), 'class_name', 'tag', 'region' ({min,max} box or {center,radius} sphere). Optional: 'mode' ('replace' default, 'add', 'remove'), 'max_results'.");
+}
+
+TSharedPtr<FJsonObject> FMCPSelectActorsHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> NamesSchema = MakeShared<FJsonObject>();
+    NamesSchema->SetStringField("type", TEXT("array"));
+    NamesSchema->SetStringField("description", TEXT("Actor names or labels to match (optional)"));
+    TSharedPtr<FJsonObject> NameItemSchema = MakeShared<FJsonObject>();
+    NameItemSchema->SetStringField("type", TEXT("string"));
+    NamesSchema->SetObjectField("items", NameItemSchema);
+    Props->SetObjectField("names", NamesSchema);
+
+    TSharedPtr<FJsonObject> ClassNameSchema = MakeShared<FJsonObject>();
+    ClassNameSchema->SetStringField("type", TEXT("string"));
+    ClassNameSchema->SetStringField("description", TEXT("Only match actors of this class or subclasses (optional)"));
+    Props->SetObjectField("class_name", ClassNameSchema);
+
+    TSharedPtr<FJsonObject> TagSchema = MakeShared<FJsonObject>();
+    TagSchema->SetStringField("type", TEXT("string"));
+    TagSchema->SetStringField("description", TEXT("Only match actors with this tag (optional)"));
+    Props->SetObjectField("tag", TagSchema);
+
+    TSharedPtr<FJsonObject> RegionSchema = MakeShared<FJsonObject>();
+    RegionSchema->SetStringField("type", TEXT("object"));
+    RegionSchema->SetStringField("description", TEXT("Spatial region as {min: {x,y,z}, max: {x,y,z}} or {center: {x,y,z}, radius} (optional)"));
+    Props->SetObjectField("region", RegionSchema);
+
+    TSharedPtr<FJsonObject> ModeSchema = MakeShared<FJsonObject>();
+    ModeSchema->SetStringField("type", TEXT("string"));
+    ModeSchema->SetStringField("description", TEXT("'replace' (default), 'add' or 'remove'"));
+    Props->SetObjectField("mode", ModeSchema);
+
+    TSharedPtr<FJsonObject> MaxResultsSchema = MakeShared<FJsonObject>();
+    MaxResultsSchema->SetStringField("type", TEXT("number"));
+    MaxResultsSchema->SetStringField("description", TEXT("Maximum number of actor names returned (default 100)"));
+    Props->SetObjectField("max_results", MaxResultsSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPSelectActorsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    UWorld *World = GetEditorWorld(ErrorResponse);
+    if (!World)
+    {
+        return ErrorResponse;
+    }
+
+    if (!GEditor)
+    {
+        return CreateErrorResponse(TEXT("Editor is not available"));
+    }
+
+    // 名称过滤 - 使用集合查找,避免每个名称遍历一次世界
+    TSet<FString> NameFilter;
+    const TArray<TSharedPtr<FJsonValue>> *NamesArray = nullptr;
+    if (Params.IsValid() && Params->TryGetArrayField(TEXT("names"), NamesArray))
+    {
+        NameFilter.Reserve(NamesArray->Num());
+        for (const TSharedPtr<FJsonValue> &NameValue : *NamesArray)
+        {
+            FString Name;
+            if (NameValue.IsValid() && NameValue->TryGetString(Name) && !Name.IsEmpty())
+            {
+                NameFilter.Add(Name);
+            }
+        }
+    }
+
+    // 类过滤
+    UClass *FilterClass = nullptr;
+    FString ClassName = GetStringParam(Params, TEXT("class_name"));
+    if (!ClassName.IsEmpty())
+    {
+        FilterClass = FindClassByName(ClassName);
+        if (!FilterClass)
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Class not found: %s"), *ClassName));
+        }
+    }
+
+    // 标签过滤
+    FString TagString = GetStringParam(Params, TEXT("tag"));
+    FName FilterTag = TagString.IsEmpty() ? NAME_None : FName(*TagString);
+
+    // 空间区域过滤 - 支持 {min, max} 包围盒或 {center, radius} 球体
+    bool bHasBox = false;
+    bool bHasSphere = false;
+    FBox RegionBox(ForceInit);
+    FVector SphereCenter = FVector::ZeroVector;
+    double SphereRadiusSquared = 0.0;
+
+    const TSharedPtr<FJsonObject> *RegionObj = nullptr;
+    if (Params.IsValid() && Params->TryGetObjectField(TEXT("region"), RegionObj))
+    {
+        const TSharedPtr<FJsonObject> *MinObj = nullptr;
+        const TSharedPtr<FJsonObject> *MaxObj = nullptr;
+        const TSharedPtr<FJsonObject> *CenterObj = nullptr;
+        double Radius = 0.0;
+
+        if ((*RegionObj)->TryGetObjectField(TEXT("min"), MinObj) && (*RegionObj)->TryGetObjectField(TEXT("max"), MaxObj))
+        {
+            RegionBox = FBox(GetVectorFromJson(*MinObj), GetVectorFromJson(*MaxObj));
+            bHasBox = true;
+        }
+        else if ((*RegionObj)->TryGetObjectField(TEXT("center"), CenterObj) && (*RegionObj)->TryGetNumberField(TEXT("radius"), Radius))
+        {
+            SphereCenter = GetVectorFromJson(*CenterObj);
+            SphereRadiusSquared = Radius * Radius;
+            bHasSphere = true;
+        }
+        else
+        {
+            return CreateErrorResponse(TEXT("Invalid region: expected {min, max} or {center, radius}"));
+        }
+    }
+
+    if (NameFilter.Num() == 0 && !FilterClass && FilterTag.IsNone() && !bHasBox && !bHasSphere)
+    {
+        return CreateErrorResponse(TEXT("At least one filter is required: names, class_name, tag or region"));
+    }
+
+    // 选择模式: replace(替换当前选择), add(追加), remove(取消选择)
+    FString Mode = GetStringParam(Params, TEXT("mode"), TEXT("replace"));
+    if (Mode != TEXT("replace") && Mode != TEXT("add") && Mode != TEXT("remove"))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Invalid mode: %s (expected replace, add or remove)"), *Mode));
+    }
+    const bool bSelect = Mode != TEXT("remove");
+    const int32 MaxResults = static_cast<int32>(GetNumberParam(Params, TEXT("max_results"), MCPConstants::MAX_QUERY_RESULTS));
+
+    TArray<TSharedPtr<FJsonValue>> ChangedActorsArray;
+    int32 MatchedCount = 0;
+    int32 ChangedCount = 0;
+    int32 SkippedCount = 0;
+
+    USelection *SelectedActors = GEditor->GetSelectedActors();
+
+    // 批量选择操作 - 期间不广播任何选择变更
+    SelectedActors->BeginBatchSelectOperation();
+    SelectedActors->Modify();
+
+    if (Mode == TEXT("replace"))
+    {
+        GEditor->SelectNone(false, true, false);
+    }
+
+    for (TActorIterator<AActor> It(World); It; ++It)
+    {
+        AActor *Actor = *It;
+        if (!Actor || Actor->IsTemplate())
+        {
+            continue;
+        }
+
+        if (NameFilter.Num() > 0 && !NameFilter.Contains(Actor->GetName()) && !NameFilter.Contains(Actor->GetActorLabel()))
+        {
+            continue;
+        }
+
+        if (FilterClass && !Actor->IsA(FilterClass))
+        {
+            continue;
+        }
+
+        if (!FilterTag.IsNone() && !Actor->ActorHasTag(FilterTag))
+        {
+            continue;
+        }
+
+        if (bHasBox || bHasSphere)
+        {
+            const FVector ActorLocation = Actor->GetActorLocation();
+            if (bHasBox && !RegionBox.IsInsideOrOn(ActorLocation))
+            {
+                continue;
+            }
+            if (bHasSphere && FVector::DistSquared(ActorLocation, SphereCenter) > SphereRadiusSquared)
+            {
+                continue;
+            }
+        }
+
+        MatchedCount++;
+
+        if (!GEditor->CanSelectActor(Actor, bSelect))
+        {
+            SkippedCount++;
+            continue;
+        }
+
+        GEditor->SelectActor(Actor, bSelect, false);
+        ChangedCount++;
+
+        if (ChangedActorsArray.Num() < MaxResults)
+        {
+            ChangedActorsArray.Add(MakeShared<FJsonValueString>(Actor->GetName()));
+        }
+    }
+
+    // 结束批量操作后只发送一次选择变更通知
+    SelectedActors->EndBatchSelectOperation(false);
+    GEditor->NoteSelectionChange();
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("mode", Mode);
+    Result->SetNumberField("matched_count", MatchedCount);
+    Result->SetNumberField(bSelect ? TEXT("selected_count") : TEXT("deselected_count"), ChangedCount);
+    Result->SetNumberField("skipped_count", SkippedCount);
+    Result->SetNumberField("total_selected", SelectedActors->Num());
+    Result->SetArrayField("actors", ChangedActorsArray);
+    Result->SetBoolField("truncated", ChangedCount > ChangedActorsArray.Num());
+
+    MCP_LOG_INFO("select_actors (%s): %d matched, %d changed, %d skipped", *Mode, MatchedCount, ChangedCount, SkippedCount);
+    return CreateSuccessResponse(Result);
+}
+
+// ============================================================================
+// 资源管理命令处理器实现
+// ============================================================================
+
+FString FMCPImportAssetHandler::GetDescription() const
+{
+    return TEXT("Import external files as a background job. Provide 'files' ([{source_path, destination_path, destination_name}]) or 'source_path'/'source_paths' with 'destination_path'. Imports run in parallel and imported packages are saved in one batch. Optional: 'replace_existing', 'save', 'wait' (default true; false returns 'job_id' immediately), 'max_parallel'.");
+}
+
+TSharedPtr<FJsonObject> FMCPImportAssetHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> FileProps = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> FileSourceSchema = MakeShared<FJsonObject>();
+    FileSourceSchema->SetStringField("type", TEXT("string"));
+    FileProps->SetObjectField("source_path", FileSourceSchema);
+    TSharedPtr<FJsonObject> FileDestinationSchema = MakeShared<FJsonObject>();
+    FileDestinationSchema->SetStringField("type", TEXT("string"));
+    FileProps->SetObjectField("destination_path", FileDestinationSchema);
+    TSharedPtr<FJsonObject> FileNameSchema = MakeShared<FJsonObject>();
+    FileNameSchema->SetStringField("type", TEXT("string"));
+    FileProps->SetObjectField("destination_name", FileNameSchema);
+
+    TSharedPtr<FJsonObject> FileItemSchema = MakeShared<FJsonObject>();
+    FileItemSchema->SetStringField("type", TEXT("object"));
+    FileItemSchema->SetObjectField("properties", FileProps);
+
+    TSharedPtr<FJsonObject> FilesSchema = MakeShared<FJsonObject>();
+    FilesSchema->SetStringField("type", TEXT("array"));
+    FilesSchema->SetStringField("description", TEXT("Files to import: [{source_path, destination_path, destination_name}]"));
+    FilesSchema->SetObjectField("items", FileItemSchema);
+    Props->SetObjectField("files", FilesSchema);
+
+    TSharedPtr<FJsonObject> SourcePathSchema = MakeShared<FJsonObject>();
+    SourcePathSchema->SetStringField("type", TEXT("string"));
+    SourcePathSchema->SetStringField("description", TEXT("Single source file on disk (alternative to 'files')"));
+    Props->SetObjectField("source_path", SourcePathSchema);
+
+    TSharedPtr<FJsonObject> SourcePathsSchema = MakeShared<FJsonObject>();
+    SourcePathsSchema->SetStringField("type", TEXT("array"));
+    SourcePathsSchema->SetStringField("description", TEXT("Several source files sharing 'destination_path' (alternative to 'files')"));
+    TSharedPtr<FJsonObject> SourcePathItemSchema = MakeShared<FJsonObject>();
+    SourcePathItemSchema->SetStringField("type", TEXT("string"));
+    SourcePathsSchema->SetObjectField("items", SourcePathItemSchema);
+    Props->SetObjectField("source_paths", SourcePathsSchema);
+
+    TSharedPtr<FJsonObject> DestinationSchema = MakeShared<FJsonObject>();
+    DestinationSchema->SetStringField("type", TEXT("string"));
+    DestinationSchema->SetStringField("description", TEXT("Destination folder, e.g. /Game/Imported (default for every file)"));
+    Props->SetObjectField("destination_path", DestinationSchema);
+
+    TSharedPtr<FJsonObject> ReplaceSchema = MakeShared<FJsonObject>();
+    ReplaceSchema->SetStringField("type", TEXT("boolean"));
+    ReplaceSchema->SetStringField("description", TEXT("Overwrite existing assets (default true)"));
+    Props->SetObjectField("replace_existing", ReplaceSchema);
+
+    TSharedPtr<FJsonObject> SaveSchema = MakeShared<FJsonObject>();
+    SaveSchema->SetStringField("type", TEXT("boolean"));
+    SaveSchema->SetStringField("description", TEXT("Save all imported packages in one batch when the job ends (default true)"));
+    Props->SetObjectField("save", SaveSchema);
+
+    TSharedPtr<FJsonObject> WaitSchema = MakeShared<FJsonObject>();
+    WaitSchema->SetStringField("type", TEXT("boolean"));
+    WaitSchema->SetStringField("description", TEXT("Respond when the job finishes (default true); false returns the job_id immediately"));
+    Props->SetObjectField("wait", WaitSchema);
+
+    TSharedPtr<FJsonObject> ParallelSchema = MakeShared<FJsonObject>();
+    ParallelSchema->SetStringField("type", TEXT("number"));
+    ParallelSchema->SetStringField("description", TEXT("Imports in flight at once (default 8, max 32)"));
+    Props->SetObjectField("max_parallel", ParallelSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPImportAssetHandler::StartImportJob(const TSharedPtr<FJsonObject> &Params, int32 &OutJobId)
+{
+    OutJobId = INDEX_NONE;
+    if (!JobManager.IsValid())
+    {
+        return CreateErrorResponse(TEXT("Import job manager is not available"));
+    }
+
+    TArray<FMCPImportFileRequest> Files;
+    const FString DefaultDestination = GetStringParam(Params, TEXT("destination_path"));
+
+    // files: [{source_path, destination_path, destination_name}]
+    const TArray<TSharedPtr<FJsonValue>> *FilesArray = nullptr;
+    if (Params.IsValid() && Params->TryGetArrayField(TEXT("files"), FilesArray))
+    {
+        for (const TSharedPtr<FJsonValue> &FileValue : *FilesArray)
+        {
+            const TSharedPtr<FJsonObject> *FileObject = nullptr;
+            if (!FileValue.IsValid() || !FileValue->TryGetObject(FileObject))
+            {
+                return CreateErrorResponse(TEXT("Each entry in files must be an object"));
+            }
+
+            FMCPImportFileRequest &Request = Files.AddDefaulted_GetRef();
+            Request.SourcePath = GetStringParam(*FileObject, TEXT("source_path"));
+            Request.DestinationPath = GetStringParam(*FileObject, TEXT("destination_path"), DefaultDestination);
+            Request.DestinationName = GetStringParam(*FileObject, TEXT("destination_name"));
+        }
+    }
+    else
+    {
+        // source_paths: [..] 或 source_path,共用 destination_path
+        TArray<FString> SourcePaths;
+        const TArray<TSharedPtr<FJsonValue>> *SourcePathsArray = nullptr;
+        if (Params.IsValid() && Params->TryGetArrayField(TEXT("source_paths"), SourcePathsArray))
+        {
+            for (const TSharedPtr<FJsonValue> &PathValue : *SourcePathsArray)
+            {
+                FString SourcePath;
+                if (PathValue.IsValid() && PathValue->TryGetString(SourcePath))
+                {
+                    SourcePaths.Add(SourcePath);
+                }
+            }
+        }
+        else
+        {
+            SourcePaths.Add(GetStringParam(Params, TEXT("source_path")));
+        }
+
+        for (const FString &SourcePath : SourcePaths)
+        {
+            FMCPImportFileRequest &Request = Files.AddDefaulted_GetRef();
+            Request.SourcePath = SourcePath;
+            Request.DestinationPath = DefaultDestination;
+            if (SourcePaths.Num() == 1)
+            {
+                Request.DestinationName = GetStringParam(Params, TEXT("destination_name"));
+            }
+        }
+    }
+
+    if (Files.Num() == 0)
+    {
+        return CreateErrorResponse(TEXT("Missing required parameters: files or source_path"));
+    }
+
+    if (Files.Num() > MCPConstants::MAX_IMPORT_FILES_PER_JOB)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Too many files in one import job (max %d)"), MCPConstants::MAX_IMPORT_FILES_PER_JOB));
+    }
+
+    for (const FMCPImportFileRequest &Request : Files)
+    {
+        if (Request.SourcePath.IsEmpty() || Request.DestinationPath.IsEmpty())
+        {
+            return CreateErrorResponse(TEXT("Each file requires source_path and destination_path"));
+        }
+    }
+
+    const bool bReplaceExisting = GetBoolParam(Params, TEXT("replace_existing"), true);
+    const bool bSave = GetBoolParam(Params, TEXT("save"), true);
+    const int32 MaxParallel = FMath::Clamp(static_cast<int32>(GetNumberParam(Params, TEXT("max_parallel"), MCPConstants::DEFAULT_IMPORT_PARALLELISM)),
+                                           1, MCPConstants::MAX_IMPORT_PARALLELISM);
+
+    OutJobId = JobManager->StartJob(Files, bReplaceExisting, bSave, MaxParallel);
+    return nullptr;
+}
+
+TSharedPtr<FJsonObject> FMCPImportAssetHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    // 同步调用无法等待作业结束,返回作业当前状态
+    int32 JobId = INDEX_NONE;
+    if (TSharedPtr<FJsonObject> ErrorResponse = StartImportJob(Params, JobId))
+    {
+        return ErrorResponse;
+    }
+    return CreateSuccessResponse(JobManager->GetJobStatus(JobId));
+}
+
+void FMCPImportAssetHandler::ExecuteAsync(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPCommandCallback OnComplete)
+{
+    int32 JobId = INDEX_NONE;
+    if (TSharedPtr<FJsonObject> ErrorResponse = StartImportJob(Params, JobId))
+    {
+        OnComplete(ErrorResponse);
+        return;
+    }
+
+    if (!GetBoolParam(Params, TEXT("wait"), true))
+    {
+        OnComplete(CreateSuccessResponse(JobManager->GetJobStatus(JobId)));
+        return;
+    }
+
+    TWeakPtr<FMCPCommandHandlerBase> WeakThis = AsShared();
+    JobManager->WaitForJob(JobId, [WeakThis, OnComplete = MoveTemp(OnComplete)](const TSharedPtr<FJsonObject> &Status)
+    {
+        TSharedPtr<FMCPCommandHandlerBase> PinnedThis = WeakThis.Pin();
+        if (!PinnedThis.IsValid())
+        {
+            OnComplete(nullptr);
+            return;
+        }
+
+        FMCPImportAssetHandler *Handler = static_cast<FMCPImportAssetHandler *>(PinnedThis.Get());
+        OnComplete(Handler->CreateSuccessResponse(Status));
+    });
+}
+
+/** import_status 和 cancel_import 共用的参数 schema */
+static TSharedPtr<FJsonObject> MakeImportJobSchema()
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> JobIdSchema = MakeShared<FJsonObject>();
+    JobIdSchema->SetStringField("type", TEXT("number"));
+    JobIdSchema->SetStringField("description", TEXT("Job ID returned by import_asset"));
+    Props->SetObjectField("job_id", JobIdSchema);
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> Required;
+    Required.Add(MakeShared<FJsonValueString>(TEXT("job_id")));
+    Schema->SetArrayField("required", Required);
+
+    return Schema;
+}
+
+FString FMCPImportStatusHandler::GetDescription() const
+{
+    return TEXT("Get progress and per-file results of an import job. Requires 'job_id'.");
+}
+
+TSharedPtr<FJsonObject> FMCPImportStatusHandler::GetInputSchema() const
+{
+    return MakeImportJobSchema();
+}
+
+TSharedPtr<FJsonObject> FMCPImportStatusHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    if (!ValidateRequiredField(Params, TEXT("job_id"), ErrorResponse))
+    {
+        return ErrorResponse;
+    }
+
+    const int32 JobId = static_cast<int32>(GetNumberParam(Params, TEXT("job_id")));
+    TSharedPtr<FJsonObject> Status = JobManager.IsValid() ? JobManager->GetJobStatus(JobId) : nullptr;
+    if (!Status.IsValid())
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Import job not found: %d"), JobId));
+    }
+
+    return CreateSuccessResponse(Status);
+}
+
+FString FMCPCancelImportHandler::GetDescription() const
+{
+    return TEXT("Cancel an import job. Files not yet started are skipped; imports already in flight finish. Requires 'job_id'.");
+}
+
+TSharedPtr<FJsonObject> FMCPCancelImportHandler::GetInputSchema() const
+{
+    return MakeImportJobSchema();
+}
+
+TSharedPtr<FJsonObject> FMCPCancelImportHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    if (!ValidateRequiredField(Params, TEXT("job_id"), ErrorResponse))
+    {
+        return ErrorResponse;
+    }
+
+    const int32 JobId = static_cast<int32>(GetNumberParam(Params, TEXT("job_id")));
+    if (!JobManager.IsValid() || !JobManager->CancelJob(JobId))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Import job not found: %d"), JobId));
+    }
+
+    return CreateSuccessResponse(JobManager->GetJobStatus(JobId));
+}
+
+FString FMCPCreateMaterialHandler::GetDescription() const
+{
+    return TEXT("Create a material asset. Requires 'path'. Optional: 'name', 'save' (default true, queued for a batched save).");
+}
+
+TSharedPtr<FJsonObject> FMCPCreateMaterialHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    FString MaterialPath = GetStringParam(Params, TEXT("path"));
+    FString MaterialName = GetStringParam(Params, TEXT("name"), TEXT("NewMaterial"));
+
+    if (MaterialPath.IsEmpty())
+    {
+        return CreateErrorResponse(TEXT("Missing required parameter: path"));
+    }
+
+    // 创建材质
+    UMaterialFactoryNew *MaterialFactory = NewObject<UMaterialFactoryNew>();
+    if (!MaterialFactory)
+    {
+        return CreateErrorResponse(TEXT("Failed to create material factory"));
+    }
+
+    FString PackageName = FPackageName::ObjectPathToPackageName(MaterialPath);
+    UPackage *Package = CreatePackage(*PackageName);
+
+    if (!Package)
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Failed to create package: %s"), *PackageName));
+    }
+
+    UMaterial *NewMaterial = Cast<UMaterial>(
+        MaterialFactory->FactoryCreateNew(
+            UMaterial::StaticClass(),
+            Package,
+            *MaterialName,
+            RF_Public | RF_Standalone,
+            nullptr,
+            GWarn));
+
+    if (!NewMaterial)
+    {
+        return CreateErrorResponse(TEXT("Failed to create material"));
+    }
+
+    FAssetRegistryModule::AssetCreated(NewMaterial);
+    Package->MarkPackageDirty();
+
+    const bool bSave = GetBoolParam(Params, TEXT("save"), true);
+    if (bSave && SaveQueue.IsValid())
+    {
+        SaveQueue->Enqueue(Package);
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("material_name", MaterialName);
+    Result->SetStringField("material_path", MaterialPath);
+    Result->SetBoolField("save_queued", bSave && SaveQueue.IsValid());
+
+    MCP_LOG_INFO("Material created: %s at %s", *MaterialName, *MaterialPath);
+    return CreateSuccessResponse(Result);
+}
+
+FString FMCPSaveDirtyHandler::GetDescription() const
+{
+    return TEXT("Save every package queued by MCP commands in one batch now (queued packages are otherwise saved after a short idle period). Optional: 'include_all' (also save other dirty content packages), 'include_maps' (with include_all, also save dirty maps).");
+}
+
+TSharedPtr<FJsonObject> FMCPSaveDirtyHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    if (!SaveQueue.IsValid())
+    {
+        return CreateErrorResponse(TEXT("Save queue is not available"));
+    }
+
+    const int32 PendingCount = SaveQueue->GetNumPending();
+    FMCPSaveQueue::FFlushResult FlushResult = SaveQueue->Flush();
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetNumberField("queued_count", PendingCount);
+
+    // 可选: 同时保存不是由 MCP 修改的脏资源包
+    if (GetBoolParam(Params, TEXT("include_all"), false))
+    {
+        const bool bSaveMaps = GetBoolParam(Params, TEXT("include_maps"), false);
+        const bool bAllSaved = UEditorLoadingAndSavingUtils::SaveDirtyPackages(bSaveMaps, true);
+        Result->SetBoolField("all_dirty_saved", bAllSaved);
+    }
+
+    TArray<TSharedPtr<FJsonValue>> SavedArray;
+    for (const FString &PackageName : FlushResult.SavedPackages)
+    {
+        SavedArray.Add(MakeShared<FJsonValueString>(PackageName));
+    }
+
+    TArray<TSharedPtr<FJsonValue>> FailedArray;
+    for (const FString &PackageName : FlushResult.FailedPackages)
+    {
+        FailedArray.Add(MakeShared<FJsonValueString>(PackageName));
+    }
+
+    Result->SetNumberField("saved_count", SavedArray.Num());
+    Result->SetNumberField("failed_count", FailedArray.Num());
+    Result->SetArrayField("saved", SavedArray);
+    Result->SetArrayField("failed", FailedArray);
+    Result->SetNumberField("save_ms", FlushResult.DurationSeconds * 1000.0);
+
+    return CreateSuccessResponse(Result);
+}
+
+/**
+ * 将类名解析为资源注册表使用的类路径
+ * 支持完整路径(/Script/Engine.StaticMesh)和短名称(StaticMesh)
+ */
+static FTopLevelAssetPath ResolveAssetClassPath(const FString &ClassName, UClass *FoundClass)
+{
+    if (FoundClass)
+    {
+        return FoundClass->GetClassPathName();
+    }
+
+    if (ClassName.StartsWith(TEXT("/")))
+    {
+        return FTopLevelAssetPath(ClassName);
+    }
+
+    return UClass::TryConvertShortTypeNameToPathName<UStruct>(ClassName, ELogVerbosity::NoLogging);
+}
+
+FString FMCPListAssetsHandler::GetDescription() const
+{
+    return TEXT("List assets in a directory, one page at a time. Optional: 'path' (default '/Game'), 'class' (short name or class path), 'recursive', 'recursive_classes', 'max_results' (page size, default 100), 'cursor' (the 'next_cursor' of the previous page), 'tags' (registry tags to return per asset).");
+}
+
+TSharedPtr<FJsonObject> FMCPListAssetsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    FString AssetPath = GetStringParam(Params, TEXT("path"), TEXT("/Game"));
+    FString AssetClass = GetStringParam(Params, TEXT("class"));
+    const bool bRecursivePaths = GetBoolParam(Params, TEXT("recursive"), true);
+    const bool bRecursiveClasses = GetBoolParam(Params, TEXT("recursive_classes"), true);
+    const int32 MaxResults = FMath::Clamp(static_cast<int32>(GetNumberParam(Params, TEXT("max_results"), MCPConstants::MAX_QUERY_RESULTS)),
+                                          1, MCPConstants::MAX_ASSET_PAGE_SIZE);
+
+    AssetPath.RemoveFromEnd(TEXT("/"));
+
+    // 解码分页游标 - 游标是上一页最后一个资源的对象路径
+    FString CursorObjectPath;
+    FString Cursor = GetStringParam(Params, TEXT("cursor"));
+    if (!Cursor.IsEmpty() && !FBase64::Decode(Cursor, CursorObjectPath))
+    {
+        return CreateErrorResponse(TEXT("Invalid cursor"));
+    }
+
+    FString CursorFolder;
+    if (!CursorObjectPath.IsEmpty())
+    {
+        CursorFolder = FPackageName::GetLongPackagePath(FSoftObjectPath(CursorObjectPath).GetLongPackageName());
+    }
+
+    // 需要投影的注册表标签
+    TArray<FName> ProjectedTags;
+    const TArray<TSharedPtr<FJsonValue>> *TagsArray = nullptr;
+    if (Params.IsValid() && Params->TryGetArrayField(TEXT("tags"), TagsArray))
+    {
+        for (const TSharedPtr<FJsonValue> &TagValue : *TagsArray)
+        {
+            FString TagName;
+            if (TagValue.IsValid() && TagValue->TryGetString(TagName) && !TagName.IsEmpty())
+            {
+                ProjectedTags.Add(FName(*TagName));
+            }
+        }
+    }
+
+    // 使用资源注册表
+    FAssetRegistryModule &AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
+    IAssetRegistry &AssetRegistry = AssetRegistryModule.Get();
+
+    FARFilter BaseFilter;
+    if (!AssetClass.IsEmpty())
+    {
+        FTopLevelAssetPath ClassPath = ResolveAssetClassPath(AssetClass, FindClassByName(AssetClass));
+        if (ClassPath.IsNull())
+        {
+            return CreateErrorResponse(FString::Printf(TEXT("Class not found: %s"), *AssetClass));
+        }
+        BaseFilter.ClassPaths.Add(ClassPath);
+        BaseFilter.bRecursiveClasses = bRecursiveClasses;
+    }
+
+    // 只收集目录列表(远小于资源数量),按目录顺序逐个枚举,页满即停止
+    TArray<FString> Folders;
+    Folders.Add(AssetPath);
+    if (bRecursivePaths)
+    {
+        AssetRegistry.GetSubPaths(AssetPath, Folders, true);
+    }
+    Folders.Sort();
+
+    TArray<FAssetData> PageAssets;
+    PageAssets.Reserve(MaxResults);
+    bool bHasMore = false;
+
+    // 目录内按对象路径取最小的若干个: 最大堆只保留填满本页所需的数量再多一个(用于判断 has_more),
+    // 内存与页大小成正比,与目录大小无关
+    using FPathAndAsset = TPair<FString, FAssetData>;
+    const auto HeapPredicate = [](const FPathAndAsset &A, const FPathAndAsset &B)
+    { return A.Key > B.Key; };
+
+    TArray<FPathAndAsset> FolderAssets;
+    for (const FString &Folder : Folders)
+    {
+        if (!CursorFolder.IsEmpty() && Folder < CursorFolder)
+        {
+            continue;
+        }
+
+        FARFilter Filter = BaseFilter;
+        Filter.PackagePaths.Add(FName(*Folder));
+        Filter.bRecursivePaths = false;
+
+        const bool bIsCursorFolder = !CursorFolder.IsEmpty() && Folder == CursorFolder;
+        const int32 Capacity = MaxResults - PageAssets.Num() + 1;
+        FolderAssets.Reset();
+
+        AssetRegistry.EnumerateAssets(Filter, [&FolderAssets, &CursorObjectPath, &HeapPredicate, bIsCursorFolder, Capacity](const FAssetData &Data)
+                                      {
+            FString ObjectPath = Data.GetObjectPathString();
+            if (bIsCursorFolder && ObjectPath <= CursorObjectPath)
+            {
+                return true;
+            }
+
+            if (FolderAssets.Num() < Capacity)
+            {
+                FolderAssets.HeapPush(FPathAndAsset(MoveTemp(ObjectPath), Data), HeapPredicate);
+            }
+            else if (ObjectPath < FolderAssets.HeapTop().Key)
+            {
+                FPathAndAsset Largest;
+                FolderAssets.HeapPop(Largest, HeapPredicate, EAllowShrinking::No);
+                FolderAssets.HeapPush(FPathAndAsset(MoveTemp(ObjectPath), Data), HeapPredicate);
+            }
+            return true; });
 
-    if (GEditor)
-    {
-        GEditor->SelectActor(TargetActor, bSelect, true);
-    }
+        // 目录内按对象路径排序,保证游标在多次调用之间稳定
+        FolderAssets.Sort([](const FPathAndAsset &A, const FPathAndAsset &B)
+                          { return A.Key < B.Key; });
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("actor_name", ActorName);
-    Result->SetBoolField("selected", bSelect);
+        for (FPathAndAsset &Entry : FolderAssets)
+        {
+            if (PageAssets.Num() >= MaxResults)
+            {
+                bHasMore = true;
+                break;
+            }
+            PageAssets.Add(MoveTemp(Entry.Value));
+        }
 
-    MCP_LOG_INFO("Actor %s: %s", *ActorName, bSelect ? TEXT("selected") : TEXT("deselected"));
-    return CreateSuccessResponse(Result);
-}
+        if (bHasMore)
+        {
+            break;
+        }
+    }
 
-TSharedPtr<FJsonObject> FMCPGetSelectedActorsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
-{
     TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    TArray<TSharedPtr<FJsonValue>> SelectedActorsArray;
+    TArray<TSharedPtr<FJsonValue>> AssetsArray;
+    AssetsArray.Reserve(PageAssets.Num());
 
-    if (GEditor)
+    for (const FAssetData &Data : PageAssets)
     {
-        for (FSelectionIterator It(GEditor->GetSelectedActorIterator()); It; ++It)
+        TSharedPtr<FJsonObject> AssetInfo = MakeShared<FJsonObject>();
+        AssetInfo->SetStringField("name", Data.AssetName.ToString());
+        AssetInfo->SetStringField("class", Data.AssetClassPath.GetAssetName().ToString());
+        AssetInfo->SetStringField("class_path", Data.AssetClassPath.ToString());
+        AssetInfo->SetStringField("path", Data.GetObjectPathString());
+
+        if (ProjectedTags.Num() > 0)
         {
-            AActor *Actor = Cast<AActor>(*It);
-            if (Actor)
+            TSharedPtr<FJsonObject> TagsObj = MakeShared<FJsonObject>();
+            for (const FName &Tag : ProjectedTags)
             {
-                TSharedPtr<FJsonObject> ActorInfo = MakeShared<FJsonObject>();
-                ActorInfo->SetStringField("name", Actor->GetName());
-                ActorInfo->SetStringField("class", Actor->GetClass()->GetName());
-                ActorInfo->SetObjectField("location", VectorToJson(Actor->GetActorLocation()));
-
-                SelectedActorsArray.Add(MakeShared<FJsonValueObject>(ActorInfo));
+                FString TagValue;
+                if (Data.GetTagValue(Tag, TagValue))
+                {
+                    TagsObj->SetStringField(Tag.ToString(), TagValue);
+                }
             }
+            AssetInfo->SetObjectField("tags", TagsObj);
         }
+
+        AssetsArray.Add(MakeShared<FJsonValueObject>(AssetInfo));
     }
 
-    Result->SetArrayField("selected_actors", SelectedActorsArray);
-    Result->SetNumberField("count", SelectedActorsArray.Num());
+    Result->SetArrayField("assets", AssetsArray);
+    Result->SetNumberField("count", AssetsArray.Num());
+    Result->SetBoolField("has_more", bHasMore);
+    if (bHasMore && PageAssets.Num() > 0)
+    {
+        Result->SetStringField("next_cursor", FBase64::Encode(PageAssets.Last().GetObjectPathString()));
+    }
 
-    MCP_LOG_INFO("Retrieved %d selected actors", SelectedActorsArray.Num());
+    MCP_LOG_INFO("Listed %d assets in path %s (has_more: %s)", AssetsArray.Num(), *AssetPath, bHasMore ? TEXT("true") : TEXT("false"));
     return CreateSuccessResponse(Result);
 }
 
-// ============================================================================
-// 资源管理命令处理器实现
-// ============================================================================
-
-TSharedPtr<FJsonObject> FMCPImportAssetHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+FString FMCPSearchAssetsHandler::GetDescription() const
 {
-    FString SourcePath = GetStringParam(Params, TEXT("source_path"));
-    FString DestinationPath = GetStringParam(Params, TEXT("destination_path"));
-
-    if (SourcePath.IsEmpty() || DestinationPath.IsEmpty())
-    {
-        return CreateErrorResponse(TEXT("Missing required parameters: source_path, destination_path"));
-    }
-
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("message", TEXT("Asset import functionality requires advanced asset tools integration"));
-    Result->SetStringField("source_path", SourcePath);
-    Result->SetStringField("destination_path", DestinationPath);
+    return TEXT("Fuzzy full-text search over asset names, package paths and indexed registry tags, ranked by relevance. Requires 'query' (e.g. 'rusty metal door'). Optional: 'class' (asset class short name), 'max_results' (default 20).");
+}
 
-    MCP_LOG_WARNING("Asset import requested: %s -> %s (requires custom implementation)",
-                    *SourcePath, *DestinationPath);
-    return CreateSuccessResponse(Result);
+FMCPSearchAssetsHandler::FMCPSearchAssetsHandler()
+    : SearchIndex(MakeShared<FMCPAssetSearchIndex>())
+{
+    SearchIndex->Initialize();
 }
 
-TSharedPtr<FJsonObject> FMCPCreateMaterialHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+FMCPSearchAssetsHandler::~FMCPSearchAssetsHandler()
 {
-    FString MaterialPath = GetStringParam(Params, TEXT("path"));
-    FString MaterialName = GetStringParam(Params, TEXT("name"), TEXT("NewMaterial"));
+    SearchIndex->Shutdown();
+}
 
-    if (MaterialPath.IsEmpty())
+TSharedPtr<FJsonObject> FMCPSearchAssetsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    FString Query = GetStringParam(Params, TEXT("query"));
+    if (Query.IsEmpty())
     {
-        return CreateErrorResponse(TEXT("Missing required parameter: path"));
+        return CreateErrorResponse(TEXT("Missing required parameter: query"));
     }
 
-    // 创建材质
-    UMaterialFactoryNew *MaterialFactory = NewObject<UMaterialFactoryNew>();
-    if (!MaterialFactory)
+    if (!SearchIndex->IsReady())
     {
-        return CreateErrorResponse(TEXT("Failed to create material factory"));
+        return CreateErrorResponse(TEXT("Asset search index is still building, try again shortly"));
     }
 
-    FString PackageName = FPackageName::ObjectPathToPackageName(MaterialPath);
-    UPackage *Package = CreatePackage(*PackageName);
-
-    if (!Package)
-    {
-        return CreateErrorResponse(FString::Printf(TEXT("Failed to create package: %s"), *PackageName));
-    }
+    FString ClassFilter = GetStringParam(Params, TEXT("class"));
+    const int32 MaxResults = FMath::Clamp(static_cast<int32>(GetNumberParam(Params, TEXT("max_results"), MCPConstants::DEFAULT_SEARCH_RESULTS)),
+                                          1, MCPConstants::MAX_QUERY_RESULTS);
 
-    UMaterial *NewMaterial = Cast<UMaterial>(
-        MaterialFactory->FactoryCreateNew(
-            UMaterial::StaticClass(),
-            Package,
-            *MaterialName,
-            RF_Public | RF_Standalone,
-            nullptr,
-            GWarn));
+    const double StartTime = FPlatformTime::Seconds();
+    TArray<FMCPAssetSearchIndex::FSearchResult> SearchResults;
+    SearchIndex->Search(Query, MaxResults, ClassFilter, SearchResults);
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
 
-    if (!NewMaterial)
+    TArray<TSharedPtr<FJsonValue>> AssetsArray;
+    AssetsArray.Reserve(SearchResults.Num());
+    for (const FMCPAssetSearchIndex::FSearchResult &SearchResult : SearchResults)
     {
-        return CreateErrorResponse(TEXT("Failed to create material"));
+        TSharedPtr<FJsonObject> AssetInfo = MakeShared<FJsonObject>();
+        AssetInfo->SetStringField("name", SearchResult.AssetName);
+        AssetInfo->SetStringField("class", SearchResult.ClassName);
+        AssetInfo->SetStringField("path", SearchResult.ObjectPath);
+        AssetInfo->SetNumberField("score", SearchResult.Score);
+        AssetsArray.Add(MakeShared<FJsonValueObject>(AssetInfo));
     }
 
     TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetStringField("material_name", MaterialName);
-    Result->SetStringField("material_path", MaterialPath);
+    Result->SetArrayField("assets", AssetsArray);
+    Result->SetNumberField("count", AssetsArray.Num());
+    Result->SetNumberField("indexed_assets", SearchIndex->GetNumEntries());
+    Result->SetNumberField("search_ms", ElapsedMs);
 
-    MCP_LOG_INFO("Material created: %s at %s", *MaterialName, *MaterialPath);
+    MCP_LOG_INFO("Asset search '%s': %d results in %.2f ms", *Query, AssetsArray.Num(), ElapsedMs);
     return CreateSuccessResponse(Result);
 }
 
-TSharedPtr<FJsonObject> FMCPListAssetsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+TSharedPtr<FJsonObject> FMCPAssetGraphQueryHandler::GetInputSchema() const
 {
-    FString AssetPath = GetStringParam(Params, TEXT("path"), TEXT("/Game"));
-    FString AssetClass = GetStringParam(Params, TEXT("class"));
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
+    PathSchema->SetStringField("type", TEXT("string"));
+    PathSchema->SetStringField("description", TEXT("Asset or package path, e.g. /Game/Meshes/SM_Door"));
+    Props->SetObjectField("path", PathSchema);
+
+    TSharedPtr<FJsonObject> DepthSchema = MakeShared<FJsonObject>();
+    DepthSchema->SetStringField("type", TEXT("integer"));
+    DepthSchema->SetStringField("description", TEXT("Traversal depth (default 1, max 10)"));
+    Props->SetObjectField("depth", DepthSchema);
+
+    TSharedPtr<FJsonObject> CategorySchema = MakeShared<FJsonObject>();
+    CategorySchema->SetStringField("type", TEXT("string"));
+    CategorySchema->SetStringField("description", TEXT("Dependency kind: 'all' (default), 'hard', 'soft' or 'manage'"));
+    TArray<TSharedPtr<FJsonValue>> CategoryEnum;
+    CategoryEnum.Add(MakeShared<FJsonValueString>(TEXT("all")));
+    CategoryEnum.Add(MakeShared<FJsonValueString>(TEXT("hard")));
+    CategoryEnum.Add(MakeShared<FJsonValueString>(TEXT("soft")));
+    CategoryEnum.Add(MakeShared<FJsonValueString>(TEXT("manage")));
+    CategorySchema->SetArrayField("enum", CategoryEnum);
+    Props->SetObjectField("category", CategorySchema);
+
+    TSharedPtr<FJsonObject> ClassSchema = MakeShared<FJsonObject>();
+    ClassSchema->SetStringField("description", TEXT("Only return assets of this class or its subclasses (short name, class path, or an array of them)"));
+    Props->SetObjectField("class", ClassSchema);
+
+    TSharedPtr<FJsonObject> MaxResultsSchema = MakeShared<FJsonObject>();
+    MaxResultsSchema->SetStringField("type", TEXT("integer"));
+    MaxResultsSchema->SetStringField("description", TEXT("Maximum assets returned (default 500, max 5000)"));
+    Props->SetObjectField("max_results", MaxResultsSchema);
+
+    TSharedPtr<FJsonObject> IncludeScriptSchema = MakeShared<FJsonObject>();
+    IncludeScriptSchema->SetStringField("type", TEXT("boolean"));
+    IncludeScriptSchema->SetStringField("description", TEXT("Include native /Script packages (default false)"));
+    Props->SetObjectField("include_script", IncludeScriptSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> Required;
+    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
+    Schema->SetArrayField("required", Required);
+
+    return Schema;
+}
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    TArray<TSharedPtr<FJsonValue>> AssetsArray;
+TSharedPtr<FJsonObject> FMCPAssetGraphQueryHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    const FString AssetPath = GetStringParam(Params, TEXT("path"));
+    if (AssetPath.IsEmpty())
+    {
+        return CreateErrorResponse(TEXT("Missing required parameter: path"));
+    }
 
-    // 使用资源注册表
-    FAssetRegistryModule &AssetRegistryModule = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry");
-    IAssetRegistry &AssetRegistry = AssetRegistryModule.Get();
+    if (!Graph.IsValid())
+    {
+        return CreateErrorResponse(TEXT("Dependency graph is not available"));
+    }
 
-    FARFilter Filter;
-    Filter.PackagePaths.Add(*AssetPath);
-    Filter.bRecursivePaths = true;
+    FMCPAssetDependencyGraph::FQuery Query;
+    Query.Direction = Direction;
+    Query.MaxDepth = FMath::Clamp(static_cast<int32>(GetNumberParam(Params, TEXT("depth"), 1)), 1, MCPConstants::MAX_DEPENDENCY_DEPTH);
+    Query.MaxResults = FMath::Clamp(static_cast<int32>(GetNumberParam(Params, TEXT("max_results"), MCPConstants::DEFAULT_DEPENDENCY_RESULTS)),
+                                    1, MCPConstants::MAX_DEPENDENCY_RESULTS);
+    Query.bIncludeScriptPackages = GetBoolParam(Params, TEXT("include_script"), false);
 
-    if (!AssetClass.IsEmpty())
+    // 依赖类别
+    const FString Category = GetStringParam(Params, TEXT("category"), TEXT("all"));
+    if (Category == TEXT("hard"))
+    {
+        Query.Flags = UE::AssetRegistry::EDependencyQuery::Hard;
+    }
+    else if (Category == TEXT("soft"))
+    {
+        Query.Flags = UE::AssetRegistry::EDependencyQuery::Soft;
+    }
+    else if (Category == TEXT("manage"))
+    {
+        Query.Category = UE::AssetRegistry::EDependencyCategory::Manage;
+    }
+    else if (Category != TEXT("all"))
     {
-        Filter.ClassNames.Add(*AssetClass);
+        return CreateErrorResponse(FString::Printf(TEXT("Invalid category '%s' (expected all, hard, soft or manage)"), *Category));
     }
 
-    TArray<FAssetData> AssetData;
-    AssetRegistry.GetAssets(Filter, AssetData);
+    IAssetRegistry &AssetRegistry = FModuleManager::LoadModuleChecked<FAssetRegistryModule>("AssetRegistry").Get();
 
-    int32 MaxResults = static_cast<int32>(GetNumberParam(Params, TEXT("max_results"), 100));
+    // 类过滤: 字符串或数组,展开为包含子类的集合
+    TArray<FString> ClassNames;
+    const TArray<TSharedPtr<FJsonValue>> *ClassArray = nullptr;
+    if (Params->TryGetArrayField(TEXT("class"), ClassArray))
+    {
+        for (const TSharedPtr<FJsonValue> &ClassValue : *ClassArray)
+        {
+            FString ClassName;
+            if (ClassValue.IsValid() && ClassValue->TryGetString(ClassName) && !ClassName.IsEmpty())
+            {
+                ClassNames.Add(ClassName);
+            }
+        }
+    }
+    else
+    {
+        const FString ClassName = GetStringParam(Params, TEXT("class"));
+        if (!ClassName.IsEmpty())
+        {
+            ClassNames.Add(ClassName);
+        }
+    }
 
-    for (int32 i = 0; i < AssetData.Num() && i < MaxResults; ++i)
+    if (ClassNames.Num() > 0)
     {
-        TSharedPtr<FJsonObject> AssetInfo = MakeShared<FJsonObject>();
-        AssetInfo->SetStringField("name", AssetData[i].AssetName.ToString());
-        AssetInfo->SetStringField("class", AssetData[i].AssetClass.ToString());
-        AssetInfo->SetStringField("path", AssetData[i].GetObjectPathString());
+        TArray<FTopLevelAssetPath> ClassPaths;
+        for (const FString &ClassName : ClassNames)
+        {
+            const FTopLevelAssetPath ClassPath = ResolveAssetClassPath(ClassName, FindClassByName(ClassName));
+            if (ClassPath.IsNull())
+            {
+                return CreateErrorResponse(FString::Printf(TEXT("Class not found: %s"), *ClassName));
+            }
+            ClassPaths.Add(ClassPath);
+        }
+        AssetRegistry.GetDerivedClassNames(ClassPaths, TSet<FTopLevelAssetPath>(), Query.ClassFilter);
+    }
 
-        AssetsArray.Add(MakeShared<FJsonValueObject>(AssetInfo));
+    const FName RootPackage(*FPackageName::ObjectPathToPackageName(AssetPath));
+    if (!AssetRegistry.GetAssetPackageDataCopy(RootPackage).IsSet() && !FPackageName::IsScriptPackage(RootPackage.ToString()))
+    {
+        return CreateErrorResponse(FString::Printf(TEXT("Package not found in asset registry: %s"), *RootPackage.ToString()));
     }
 
-    Result->SetArrayField("assets", AssetsArray);
-    Result->SetNumberField("count", AssetsArray.Num());
+    const double StartTime = FPlatformTime::Seconds();
+    FMCPAssetDependencyGraph::FResult GraphResult;
+    Graph->Traverse(RootPackage, Query, GraphResult);
+    const double ElapsedMs = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+
+    TArray<TSharedPtr<FJsonValue>> NodesArray;
+    NodesArray.Reserve(GraphResult.Nodes.Num());
+    for (const FMCPAssetDependencyGraph::FNode &Node : GraphResult.Nodes)
+    {
+        TSharedPtr<FJsonObject> NodeObject = MakeShared<FJsonObject>();
+        NodeObject->SetStringField("package", Node.PackageName.ToString());
+        if (!Node.AssetClass.IsNull())
+        {
+            NodeObject->SetStringField("class", Node.AssetClass.GetAssetName().ToString());
+        }
+        NodeObject->SetNumberField("depth", Node.Depth);
+        if (!Node.Via.IsNone())
+        {
+            NodeObject->SetStringField("via", Node.Via.ToString());
+        }
+        NodesArray.Add(MakeShared<FJsonValueObject>(NodeObject));
+    }
 
-    MCP_LOG_INFO("Listed %d assets in path %s", AssetsArray.Num(), *AssetPath);
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetStringField("root", RootPackage.ToString());
+    Result->SetStringField("direction", Direction == FMCPAssetDependencyGraph::EDirection::Dependencies ? TEXT("dependencies") : TEXT("referencers"));
+    Result->SetArrayField("assets", NodesArray);
+    Result->SetNumberField("count", NodesArray.Num());
+    Result->SetNumberField("visited_count", GraphResult.VisitedCount);
+    Result->SetBoolField("truncated", GraphResult.bTruncated);
+    Result->SetNumberField("query_ms", ElapsedMs);
+    Result->SetNumberField("cached_nodes", Graph->GetNumCachedNodes());
+
+    MCP_LOG_VERBOSE("%s %s: %d assets, %d visited in %.2f ms", *GetCommandName(), *RootPackage.ToString(),
+                    NodesArray.Num(), GraphResult.VisitedCount, ElapsedMs);
     return CreateSuccessResponse(Result);
 }
 
+FString FMCPGetDependenciesHandler::GetDescription() const
+{
+    return TEXT("List the assets an asset depends on, breadth first up to 'depth' levels. Requires 'path'. Optional: 'depth' (default 1), 'category' (all/hard/soft/manage), 'class' (filter results by class, subclasses included), 'max_results', 'include_script'. Each result has 'package', 'class', 'depth' and 'via' (the package it was reached through).");
+}
+
+FString FMCPGetReferencersHandler::GetDescription() const
+{
+    return TEXT("List the assets that reference an asset, breadth first up to 'depth' levels. Use before deleting or renaming an asset. Requires 'path'. Optional: 'depth' (default 1), 'category' (all/hard/soft/manage), 'class', 'max_results', 'include_script'.");
+}
+
 // ============================================================================
 // 批量操作命令处理器实现
 // ============================================================================
 
-TSharedPtr<FJsonObject> FMCPBatchCreateHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+FString FMCPBatchCreateHandler::GetDescription() const
 {
-    TSharedPtr<FJsonObject> ErrorResponse;
-    UWorld *World = GetEditorWorld(ErrorResponse);
-    if (!World)
-    {
-        return ErrorResponse;
-    }
+    return TEXT("Batch create multiple actors in the scene. Requires 'actors' array with each actor having 'class_name' (required), 'name', 'location' ({x,y,z}), 'rotation' ({pitch,yaw,roll}), and 'scale' ({x,y,z}).");
+}
 
-    const TArray<TSharedPtr<FJsonValue>> *ActorsArray = nullptr;
-    if (!Params->TryGetArrayField(TEXT("actors"), ActorsArray))
+TSharedPtr<FJsonObject> FMCPBatchCreateHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    // actors 数组
+    TSharedPtr<FJsonObject> ActorsSchema = MakeShared<FJsonObject>();
+    ActorsSchema->SetStringField("type", TEXT("array"));
+    ActorsSchema->SetStringField("description", TEXT("Array of actors to create"));
+
+    TSharedPtr<FJsonObject> ActorItemSchema = MakeShared<FJsonObject>();
+    ActorItemSchema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> ActorProps = MakeShared<FJsonObject>();
+
+    // class_name
+    TSharedPtr<FJsonObject> ClassNameSchema = MakeShared<FJsonObject>();
+    ClassNameSchema->SetStringField("type", TEXT("string"));
+    ClassNameSchema->SetStringField("description", TEXT("Full UE class name (e.g., 'ASkyAtmosphere', 'ASkyLight', 'AStaticMeshActor')"));
+    ActorProps->SetObjectField("class_name", ClassNameSchema);
+
+    // name
+    TSharedPtr<FJsonObject> NameSchema = MakeShared<FJsonObject>();
+    NameSchema->SetStringField("type", TEXT("string"));
+    NameSchema->SetStringField("description", TEXT("Actor name"));
+    ActorProps->SetObjectField("name", NameSchema);
+
+    // location
+    TSharedPtr<FJsonObject> LocationSchema = MakeShared<FJsonObject>();
+    LocationSchema->SetStringField("type", TEXT("object"));
+    LocationSchema->SetStringField("description", TEXT("Actor location as {x, y, z}"));
+    TSharedPtr<FJsonObject> LocationProps = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> XSchema = MakeShared<FJsonObject>();
+    XSchema->SetStringField("type", TEXT("number"));
+    LocationProps->SetObjectField("x", XSchema);
+    TSharedPtr<FJsonObject> YSchema = MakeShared<FJsonObject>();
+    YSchema->SetStringField("type", TEXT("number"));
+    LocationProps->SetObjectField("y", YSchema);
+    TSharedPtr<FJsonObject> ZSchema = MakeShared<FJsonObject>();
+    ZSchema->SetStringField("type", TEXT("number"));
+    LocationProps->SetObjectField("z", ZSchema);
+    LocationSchema->SetObjectField("properties", LocationProps);
+    ActorProps->SetObjectField("location", LocationSchema);
+
+    // rotation (optional)
+    TSharedPtr<FJsonObject> RotationSchema = MakeShared<FJsonObject>();
+    RotationSchema->SetStringField("type", TEXT("object"));
+    RotationSchema->SetStringField("description", TEXT("Actor rotation as {pitch, yaw, roll} (optional)"));
+    ActorProps->SetObjectField("rotation", RotationSchema);
+
+    // scale (optional)
+    TSharedPtr<FJsonObject> ScaleSchema = MakeShared<FJsonObject>();
+    ScaleSchema->SetStringField("type", TEXT("object"));
+    ScaleSchema->SetStringField("description", TEXT("Actor scale as {x, y, z} (optional)"));
+    ActorProps->SetObjectField("scale", ScaleSchema);
+
+    ActorItemSchema->SetObjectField("properties", ActorProps);
+
+    TArray<TSharedPtr<FJsonValue>> RequiredFields;
+    RequiredFields.Add(MakeShared<FJsonValueString>(TEXT("class_name")));
+    ActorItemSchema->SetArrayField("required", RequiredFields);
+
+    ActorsSchema->SetObjectField("items", ActorItemSchema);
+    Props->SetObjectField("actors", ActorsSchema);
+
+    Schema->SetObjectField("properties", Props);
+
+    TArray<TSharedPtr<FJsonValue>> RequiredTop;
+    RequiredTop.Add(MakeShared<FJsonValueString>(TEXT("actors")));
+    Schema->SetArrayField("required", RequiredTop);
+
+    return Schema;
+}
+
+class FMCPBatchCreateHandler::FActorCreator : public IMCPStreamedArrayConsumer
+{
+public:
+    FActorCreator(FMCPBatchCreateHandler &InHandler, UWorld *InWorld)
+        : Handler(InHandler), World(InWorld)
     {
-        return CreateErrorResponse(TEXT("Missing required parameter: actors (array)"));
     }
 
-    TArray<TSharedPtr<FJsonValue>> CreatedActorsArray;
-    int32 FailureCount = 0;
-
-    for (const TSharedPtr<FJsonValue> &ActorValue : *ActorsArray)
+    virtual void Consume(int32 Index, const TSharedPtr<FJsonValue> &ActorValue) override
     {
-        if (!ActorValue.IsValid())
-            continue;
+        const TSharedPtr<FJsonObject> *ActorObj = nullptr;
+        if (!ActorValue.IsValid() || !ActorValue->TryGetObject(ActorObj))
+        {
+            Reject(Index, TEXT("Entry is not an object"));
+            return;
+        }
 
-        const TSharedPtr<FJsonObject> ActorObj = ActorValue->AsObject();
-        if (!ActorObj.IsValid())
-            continue;
+        FString ClassName;
+        if (!(*ActorObj)->TryGetStringField(TEXT("class_name"), ClassName) || ClassName.IsEmpty())
+        {
+            Reject(Index, TEXT("Missing required field: class_name"));
+            return;
+        }
 
-        FString ClassName = ActorObj->GetStringField(TEXT("class_name"));
         FVector Location = FVector::ZeroVector;
-
-        if (ActorObj->HasField(TEXT("location")))
+        const TSharedPtr<FJsonObject> *LocationObj = nullptr;
+        if ((*ActorObj)->TryGetObjectField(TEXT("location"), LocationObj))
         {
-            const TSharedPtr<FJsonObject> LocationObj = ActorObj->GetObjectField(TEXT("location"));
-            Location = GetVectorFromJson(LocationObj);
+            Location = Handler.GetVectorFromJson(*LocationObj);
         }
 
-        FString ActorName = ActorObj->GetStringField(TEXT("name"));
+        FString ActorName;
+        (*ActorObj)->TryGetStringField(TEXT("name"), ActorName);
 
         UClass *ActorClass = FindObject<UClass>(nullptr, *ClassName);
         if (!ActorClass)
         {
-            FailureCount++;
-            continue;
+            Reject(Index, FString::Printf(TEXT("Class not found: %s"), *ClassName));
+            return;
         }
 
         FActorSpawnParameters SpawnParams;
@@ -1073,17 +3488,79 @@ TSharedPtr<FJsonObject> FMCPBatchCreateHandler::Execute(const TSharedPtr<FJsonOb
         }
         else
         {
-            FailureCount++;
+            Reject(Index, TEXT("Failed to spawn actor"));
         }
     }
 
-    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-    Result->SetArrayField("created_actors", CreatedActorsArray);
-    Result->SetNumberField("created_count", CreatedActorsArray.Num());
-    Result->SetNumberField("failed_count", FailureCount);
+    /** 记录失败的条目及原因 */
+    virtual void Reject(int32 Index, const FString &Message) override
+    {
+        TSharedPtr<FJsonObject> ErrorInfo = MakeShared<FJsonObject>();
+        ErrorInfo->SetNumberField("index", Index);
+        ErrorInfo->SetStringField("error", Message);
+        ErrorsArray.Add(MakeShared<FJsonValueObject>(ErrorInfo));
+    }
 
-    MCP_LOG_INFO("Batch create completed: %d created, %d failed", CreatedActorsArray.Num(), FailureCount);
-    return CreateSuccessResponse(Result);
+    virtual TSharedPtr<FJsonObject> Finish(const TSharedPtr<FJsonObject> &OtherParams) override
+    {
+        TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+        Result->SetArrayField("created_actors", CreatedActorsArray);
+        Result->SetNumberField("created_count", CreatedActorsArray.Num());
+        Result->SetNumberField("failed_count", ErrorsArray.Num());
+        if (ErrorsArray.Num() > 0)
+        {
+            Result->SetArrayField("errors", ErrorsArray);
+        }
+
+        MCP_LOG_INFO("Batch create completed: %d created, %d failed", CreatedActorsArray.Num(), ErrorsArray.Num());
+        return Handler.CreateSuccessResponse(Result);
+    }
+
+private:
+    FMCPBatchCreateHandler &Handler;
+    UWorld *World;
+    TArray<TSharedPtr<FJsonValue>> CreatedActorsArray;
+    TArray<TSharedPtr<FJsonValue>> ErrorsArray;
+};
+
+TSharedPtr<FJsonObject> FMCPBatchCreateHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    TSharedPtr<FJsonObject> ErrorResponse;
+    UWorld *World = GetEditorWorld(ErrorResponse);
+    if (!World)
+    {
+        return ErrorResponse;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>> *ActorsArray = nullptr;
+    if (!Params->TryGetArrayField(TEXT("actors"), ActorsArray))
+    {
+        return CreateErrorResponse(TEXT("Missing required parameter: actors (array)"));
+    }
+
+    FActorCreator Creator(*this, World);
+    for (int32 Index = 0; Index < ActorsArray->Num(); ++Index)
+    {
+        Creator.Consume(Index, (*ActorsArray)[Index]);
+    }
+    return Creator.Finish(Params);
+}
+
+TSharedPtr<IMCPStreamedArrayConsumer> FMCPBatchCreateHandler::CreateArrayConsumer(FSocket *ClientSocket)
+{
+    // 没有编辑器世界时返回空,由 Execute 报告错误
+    TSharedPtr<FJsonObject> ErrorResponse;
+    UWorld *World = GetEditorWorld(ErrorResponse);
+    if (!World)
+    {
+        return nullptr;
+    }
+    return MakeShared<FActorCreator>(*this, World);
+}
+
+FString FMCPBatchModifyHandler::GetDescription() const
+{
+    return TEXT("Batch modify multiple actors. Requires 'actors' array with each containing 'name' and properties to modify.");
 }
 
 TSharedPtr<FJsonObject> FMCPBatchModifyHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
@@ -1157,6 +3634,11 @@ TSharedPtr<FJsonObject> FMCPBatchModifyHandler::Execute(const TSharedPtr<FJsonOb
     return CreateSuccessResponse(Result);
 }
 
+FString FMCPBatchDeleteHandler::GetDescription() const
+{
+    return TEXT("Batch delete multiple actors. Requires 'actor_names' array of actor names to delete.");
+}
+
 TSharedPtr<FJsonObject> FMCPBatchDeleteHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
 {
     TSharedPtr<FJsonObject> ErrorResponse;
@@ -1209,3 +3691,51 @@ TSharedPtr<FJsonObject> FMCPBatchDeleteHandler::Execute(const TSharedPtr<FJsonOb
     MCP_LOG_INFO("Batch delete completed: %d deleted, %d failed", DeletedActors.Num(), FailureCount);
     return CreateSuccessResponse(Result);
 }
+
+// ============================================================================
+// 服务器统计命令处理器实现
+// ============================================================================
+
+FString FMCPServerStatsHandler::GetDescription() const
+{
+    return TEXT("Get server statistics: per-tool request and error counts, latency percentiles (p50/p90/p99/max in ms) for queue_wait, execute, serialize, send and end-to-end total, game-thread time spent in MCP per frame, bytes in/out and connections. Optional: 'tool' (only this tool), 'reset' (clear counters after reading).");
+}
+
+TSharedPtr<FJsonObject> FMCPServerStatsHandler::GetInputSchema() const
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+
+    TSharedPtr<FJsonObject> ToolSchema = MakeShared<FJsonObject>();
+    ToolSchema->SetStringField("type", TEXT("string"));
+    ToolSchema->SetStringField("description", TEXT("Only include statistics for this tool"));
+    Props->SetObjectField("tool", ToolSchema);
+
+    TSharedPtr<FJsonObject> ResetSchema = MakeShared<FJsonObject>();
+    ResetSchema->SetStringField("type", TEXT("boolean"));
+    ResetSchema->SetStringField("description", TEXT("Clear all counters and histograms after reading"));
+    Props->SetObjectField("reset", ResetSchema);
+
+    Schema->SetObjectField("properties", Props);
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPServerStatsHandler::Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket)
+{
+    if (!Metrics.IsValid())
+    {
+        return CreateErrorResponse(TEXT("Server metrics are not available"));
+    }
+
+    TSharedPtr<FJsonObject> Snapshot = Metrics->CreateSnapshot(GetStringParam(Params, TEXT("tool")));
+
+    if (GetBoolParam(Params, TEXT("reset"), false))
+    {
+        Metrics->Reset();
+        MCP_LOG_INFO("Server statistics reset");
+    }
+
+    return CreateSuccessResponse(Snapshot);
+}
@@ -0,0 +1,375 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPImportJobManager.h"
+#include "MCPConstants.h"
+#include "MCPSaveQueue.h"
+#include "Unreal5MCP.h"
+#include "AssetImportTask.h"
+#include "AssetToolsModule.h"
+#include "IAssetTools.h"
+#include "HAL/FileManager.h"
+
+FMCPImportJobManager::FMCPImportJobManager(TSharedPtr<FMCPSaveQueue> InSaveQueue)
+    : SaveQueue(InSaveQueue), NextJobId(1)
+{
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateRaw(this, &FMCPImportJobManager::Tick),
+        MCPConstants::IMPORT_POLL_INTERVAL_SECONDS);
+}
+
+FMCPImportJobManager::~FMCPImportJobManager()
+{
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+}
+
+int32 FMCPImportJobManager::StartJob(const TArray<FMCPImportFileRequest> &Files, bool bReplaceExisting, bool bSave, int32 MaxParallel)
+{
+    TSharedPtr<FJob> Job = MakeShared<FJob>();
+    Job->JobId = NextJobId++;
+    Job->MaxParallel = FMath::Max(1, MaxParallel);
+    Job->bReplaceExisting = bReplaceExisting;
+    Job->bSave = bSave;
+    Job->StartTime = FPlatformTime::Seconds();
+    Job->Files.Reserve(Files.Num());
+
+    for (const FMCPImportFileRequest &Request : Files)
+    {
+        FFileEntry &Entry = Job->Files.AddDefaulted_GetRef();
+        Entry.Request = Request;
+
+        // 提前拒绝无效请求,避免占用导入槽位
+        if (!IFileManager::Get().FileExists(*Request.SourcePath))
+        {
+            Entry.State = EFileState::Failed;
+            Entry.Error = TEXT("Source file not found");
+        }
+        else if (!Request.DestinationPath.StartsWith(TEXT("/")))
+        {
+            Entry.State = EFileState::Failed;
+            Entry.Error = TEXT("Destination path must be a package path such as /Game/Imported");
+        }
+    }
+
+    Jobs.Add(Job->JobId, Job);
+    PruneFinishedJobs();
+
+    MCP_LOG_INFO("Import job %d started: %d files, %d in parallel", Job->JobId, Files.Num(), Job->MaxParallel);
+
+    // 立即提交第一批,不必等到下一次 Tick
+    if (UpdateJob(*Job))
+    {
+        FinishJob(*Job);
+    }
+
+    return Job->JobId;
+}
+
+bool FMCPImportJobManager::WaitForJob(int32 JobId, FMCPCommandCallback OnFinished)
+{
+    const TSharedPtr<FJob> *JobPtr = Jobs.Find(JobId);
+    if (!JobPtr)
+    {
+        return false;
+    }
+
+    FJob &Job = **JobPtr;
+    if (Job.bFinished)
+    {
+        OnFinished(MakeJobStatus(Job));
+    }
+    else
+    {
+        Job.Waiters.Add(MoveTemp(OnFinished));
+    }
+    return true;
+}
+
+bool FMCPImportJobManager::CancelJob(int32 JobId)
+{
+    const TSharedPtr<FJob> *JobPtr = Jobs.Find(JobId);
+    if (!JobPtr)
+    {
+        return false;
+    }
+
+    FJob &Job = **JobPtr;
+    if (Job.bFinished)
+    {
+        return true;
+    }
+
+    // 已提交的任务无法中断,等待其完成;尚未提交的文件直接取消
+    Job.bCancelRequested = true;
+    for (int32 i = Job.NextFileIndex; i < Job.Files.Num(); ++i)
+    {
+        if (Job.Files[i].State == EFileState::Pending)
+        {
+            Job.Files[i].State = EFileState::Cancelled;
+        }
+    }
+    Job.NextFileIndex = Job.Files.Num();
+
+    MCP_LOG_INFO("Import job %d cancellation requested (%d imports still in flight)", JobId, Job.ActiveCount);
+    return true;
+}
+
+TSharedPtr<FJsonObject> FMCPImportJobManager::GetJobStatus(int32 JobId) const
+{
+    const TSharedPtr<FJob> *JobPtr = Jobs.Find(JobId);
+    return JobPtr ? MakeJobStatus(**JobPtr) : nullptr;
+}
+
+void FMCPImportJobManager::AddReferencedObjects(FReferenceCollector &Collector)
+{
+    for (TPair<int32, TSharedPtr<FJob>> &Pair : Jobs)
+    {
+        for (FFileEntry &Entry : Pair.Value->Files)
+        {
+            if (Entry.Task)
+            {
+                Collector.AddReferencedObject(Entry.Task);
+            }
+        }
+    }
+}
+
+bool FMCPImportJobManager::Tick(float DeltaTime)
+{
+    for (TPair<int32, TSharedPtr<FJob>> &Pair : Jobs)
+    {
+        FJob &Job = *Pair.Value;
+        if (!Job.bFinished && UpdateJob(Job))
+        {
+            FinishJob(Job);
+        }
+    }
+    return true;
+}
+
+bool FMCPImportJobManager::UpdateJob(FJob &Job)
+{
+    // 收集已完成的任务
+    for (FFileEntry &Entry : Job.Files)
+    {
+        if (Entry.State != EFileState::Importing || !Entry.Task || !Entry.Task->IsAsyncImportComplete())
+        {
+            continue;
+        }
+
+        for (UObject *ImportedObject : Entry.Task->GetObjects())
+        {
+            if (ImportedObject)
+            {
+                Entry.ImportedObjectPaths.Add(ImportedObject->GetPathName());
+            }
+        }
+
+        if (Entry.ImportedObjectPaths.Num() > 0)
+        {
+            Entry.State = EFileState::Succeeded;
+        }
+        else
+        {
+            Entry.State = EFileState::Failed;
+            Entry.Error = TEXT("Importer produced no assets");
+        }
+
+        Entry.Task = nullptr;
+        Job.ActiveCount--;
+    }
+
+    if (!Job.bCancelRequested)
+    {
+        SubmitPendingFiles(Job);
+    }
+
+    return Job.ActiveCount == 0 && Job.NextFileIndex >= Job.Files.Num();
+}
+
+void FMCPImportJobManager::SubmitPendingFiles(FJob &Job)
+{
+    TArray<UAssetImportTask *> Batch;
+
+    while (Job.ActiveCount + Batch.Num() < Job.MaxParallel && Job.NextFileIndex < Job.Files.Num())
+    {
+        FFileEntry &Entry = Job.Files[Job.NextFileIndex++];
+        if (Entry.State != EFileState::Pending)
+        {
+            continue;
+        }
+
+        UAssetImportTask *Task = NewObject<UAssetImportTask>();
+        Task->Filename = Entry.Request.SourcePath;
+        Task->DestinationPath = Entry.Request.DestinationPath;
+        Task->DestinationName = Entry.Request.DestinationName;
+        Task->bAutomated = true;
+        Task->bReplaceExisting = Job.bReplaceExisting;
+        Task->bSave = false; // 作业结束后统一保存
+        Task->bAsync = true; // Interchange 可用时在后台解析文件
+
+        Entry.Task = Task;
+        Entry.State = EFileState::Importing;
+        Batch.Add(Task);
+    }
+
+    if (Batch.Num() == 0)
+    {
+        return;
+    }
+
+    Job.ActiveCount += Batch.Num();
+
+    // 同一批任务一次提交,由导入器并行处理
+    IAssetTools &AssetTools = FModuleManager::LoadModuleChecked<FAssetToolsModule>("AssetTools").Get();
+    AssetTools.ImportAssetTasks(Batch);
+
+    MCP_LOG_VERBOSE("Import job %d submitted %d files (%d/%d)", Job.JobId, Batch.Num(), Job.NextFileIndex, Job.Files.Num());
+}
+
+void FMCPImportJobManager::FinishJob(FJob &Job)
+{
+    Job.bFinished = true;
+    Job.EndTime = FPlatformTime::Seconds();
+
+    if (Job.bSave && SaveQueue.IsValid())
+    {
+        // 所有生成的包合并为一次保存
+        TArray<UPackage *> PackagesToSave;
+        for (const FFileEntry &Entry : Job.Files)
+        {
+            for (const FString &ObjectPath : Entry.ImportedObjectPaths)
+            {
+                if (UObject *ImportedObject = FindObject<UObject>(nullptr, *ObjectPath))
+                {
+                    PackagesToSave.AddUnique(ImportedObject->GetPackage());
+                }
+            }
+        }
+
+        if (PackagesToSave.Num() > 0)
+        {
+            SaveQueue->Enqueue(PackagesToSave);
+            Job.SavedPackageCount = SaveQueue->Flush().SavedPackages.Num();
+        }
+    }
+
+    MCP_LOG_INFO("Import job %d finished in %.2f s (%d files, %d packages saved)",
+                 Job.JobId, Job.EndTime - Job.StartTime, Job.Files.Num(), Job.SavedPackageCount);
+
+    TArray<FMCPCommandCallback> Waiters = MoveTemp(Job.Waiters);
+    if (Waiters.Num() > 0)
+    {
+        TSharedPtr<FJsonObject> Status = MakeJobStatus(Job);
+        for (FMCPCommandCallback &Waiter : Waiters)
+        {
+            Waiter(Status);
+        }
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPImportJobManager::MakeJobStatus(const FJob &Job)
+{
+    TSharedPtr<FJsonObject> Status = MakeShared<FJsonObject>();
+    Status->SetNumberField("job_id", Job.JobId);
+
+    FString State = TEXT("running");
+    if (Job.bFinished)
+    {
+        State = Job.bCancelRequested ? TEXT("cancelled") : TEXT("completed");
+    }
+    else if (Job.bCancelRequested)
+    {
+        State = TEXT("cancelling");
+    }
+    Status->SetStringField("state", State);
+
+    int32 Succeeded = 0;
+    int32 Failed = 0;
+    int32 Cancelled = 0;
+    int32 Importing = 0;
+    TArray<TSharedPtr<FJsonValue>> FilesArray;
+    FilesArray.Reserve(Job.Files.Num());
+
+    for (const FFileEntry &Entry : Job.Files)
+    {
+        TSharedPtr<FJsonObject> FileInfo = MakeShared<FJsonObject>();
+        FileInfo->SetStringField("source_path", Entry.Request.SourcePath);
+        FileInfo->SetStringField("destination_path", Entry.Request.DestinationPath);
+
+        switch (Entry.State)
+        {
+        case EFileState::Pending:
+            FileInfo->SetStringField("status", TEXT("pending"));
+            break;
+        case EFileState::Importing:
+            FileInfo->SetStringField("status", TEXT("importing"));
+            Importing++;
+            break;
+        case EFileState::Succeeded:
+            FileInfo->SetStringField("status", TEXT("succeeded"));
+            Succeeded++;
+            break;
+        case EFileState::Failed:
+            FileInfo->SetStringField("status", TEXT("failed"));
+            FileInfo->SetStringField("error", Entry.Error);
+            Failed++;
+            break;
+        case EFileState::Cancelled:
+            FileInfo->SetStringField("status", TEXT("cancelled"));
+            Cancelled++;
+            break;
+        }
+
+        if (Entry.ImportedObjectPaths.Num() > 0)
+        {
+            TArray<TSharedPtr<FJsonValue>> ImportedArray;
+            for (const FString &ObjectPath : Entry.ImportedObjectPaths)
+            {
+                ImportedArray.Add(MakeShared<FJsonValueString>(ObjectPath));
+            }
+            FileInfo->SetArrayField("imported", ImportedArray);
+        }
+
+        FilesArray.Add(MakeShared<FJsonValueObject>(FileInfo));
+    }
+
+    Status->SetNumberField("total", Job.Files.Num());
+    Status->SetNumberField("completed", Succeeded + Failed + Cancelled);
+    Status->SetNumberField("importing", Importing);
+    Status->SetNumberField("succeeded", Succeeded);
+    Status->SetNumberField("failed", Failed);
+    Status->SetNumberField("cancelled", Cancelled);
+    Status->SetNumberField("saved_packages", Job.SavedPackageCount);
+    Status->SetNumberField("elapsed_seconds", (Job.bFinished ? Job.EndTime : FPlatformTime::Seconds()) - Job.StartTime);
+    Status->SetArrayField("files", FilesArray);
+    return Status;
+}
+
+void FMCPImportJobManager::PruneFinishedJobs()
+{
+    TArray<int32> FinishedIds;
+    for (const TPair<int32, TSharedPtr<FJob>> &Pair : Jobs)
+    {
+        if (Pair.Value->bFinished)
+        {
+            FinishedIds.Add(Pair.Key);
+        }
+    }
+
+    if (FinishedIds.Num() <= MCPConstants::MAX_RETAINED_IMPORT_JOBS)
+    {
+        return;
+    }
+
+    // TMap 的遍历顺序不等于插入顺序,作业 ID 单调递增,排序后删除 ID 最小的已结束作业
+    FinishedIds.Sort();
+    const int32 RemoveCount = FinishedIds.Num() - MCPConstants::MAX_RETAINED_IMPORT_JOBS;
+    for (int32 Index = 0; Index < RemoveCount; ++Index)
+    {
+        Jobs.Remove(FinishedIds[Index]);
+    }
+}
@@ -0,0 +1,426 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPJsonPullParser.h"
+#include "MCPConstants.h"
+
+FMCPJsonPullParser::FMCPJsonPullParser(const UTF8CHAR *InData, int32 InLength)
+    : Data(InData), Length(InData ? InLength : 0), Position(0), bRootStarted(false),
+      NumberValue(0.0), bBoolValue(false)
+{
+}
+
+EMCPJsonToken FMCPJsonPullParser::Next()
+{
+    if (!ErrorMessage.IsEmpty())
+    {
+        return EMCPJsonToken::Error;
+    }
+
+    SkipWhitespace();
+
+    if (Levels.Num() == 0)
+    {
+        if (!bRootStarted)
+        {
+            bRootStarted = true;
+            return ParseValueToken();
+        }
+        return Position < Length ? Fail(TEXT("Unexpected data after root value")) : EMCPJsonToken::End;
+    }
+
+    FLevel &Level = Levels.Last();
+    if (Level.bExpectValue)
+    {
+        Level.bExpectValue = false;
+        return ParseValueToken();
+    }
+
+    if (Position >= Length)
+    {
+        return Fail(TEXT("Unexpected end of data"));
+    }
+
+    const UTF8CHAR Char = Data[Position];
+    if (Char == (Level.bIsObject ? '}' : ']'))
+    {
+        const bool bWasObject = Level.bIsObject;
+        ++Position;
+        Levels.Pop(EAllowShrinking::No);
+        return bWasObject ? EMCPJsonToken::EndObject : EMCPJsonToken::EndArray;
+    }
+
+    if (Level.bHasElements)
+    {
+        if (Char != ',')
+        {
+            return Fail(TEXT("Expected ','"));
+        }
+        ++Position;
+        SkipWhitespace();
+    }
+    Level.bHasElements = true;
+
+    if (!Level.bIsObject)
+    {
+        return ParseValueToken();
+    }
+
+    // 对象成员: "key" :
+    if (Position >= Length || Data[Position] != '"')
+    {
+        return Fail(TEXT("Expected object key"));
+    }
+    if (!ParseString())
+    {
+        return EMCPJsonToken::Error;
+    }
+    SkipWhitespace();
+    if (Position >= Length || Data[Position] != ':')
+    {
+        return Fail(TEXT("Expected ':'"));
+    }
+    ++Position;
+    Level.bExpectValue = true;
+    return EMCPJsonToken::Key;
+}
+
+TSharedPtr<FJsonValue> FMCPJsonPullParser::ReadValue()
+{
+    const EMCPJsonToken Token = Next();
+    if (Token == EMCPJsonToken::EndObject || Token == EMCPJsonToken::EndArray || Token == EMCPJsonToken::Key)
+    {
+        if (Token == EMCPJsonToken::Key)
+        {
+            Fail(TEXT("Expected value"));
+        }
+        return nullptr;
+    }
+    return BuildValue(Token);
+}
+
+bool FMCPJsonPullParser::SkipValue()
+{
+    const EMCPJsonToken Token = Next();
+    switch (Token)
+    {
+    case EMCPJsonToken::BeginObject:
+    case EMCPJsonToken::BeginArray:
+    {
+        // 读到回到起始层级为止
+        const int32 TargetDepth = Levels.Num() - 1;
+        while (Levels.Num() > TargetDepth)
+        {
+            if (Next() == EMCPJsonToken::Error)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+    case EMCPJsonToken::String:
+    case EMCPJsonToken::Number:
+    case EMCPJsonToken::Boolean:
+    case EMCPJsonToken::Null:
+        return true;
+    default:
+        if (ErrorMessage.IsEmpty())
+        {
+            Fail(TEXT("Expected value"));
+        }
+        return false;
+    }
+}
+
+EMCPJsonToken FMCPJsonPullParser::ParseValueToken()
+{
+    if (Position >= Length)
+    {
+        return Fail(TEXT("Unexpected end of data"));
+    }
+
+    switch (Data[Position])
+    {
+    case '{':
+        ++Position;
+        return PushLevel(true) ? EMCPJsonToken::BeginObject : EMCPJsonToken::Error;
+    case '[':
+        ++Position;
+        return PushLevel(false) ? EMCPJsonToken::BeginArray : EMCPJsonToken::Error;
+    case '"':
+        return ParseString() ? EMCPJsonToken::String : EMCPJsonToken::Error;
+    case 't':
+        bBoolValue = true;
+        return ParseLiteral("true", 4) ? EMCPJsonToken::Boolean : EMCPJsonToken::Error;
+    case 'f':
+        bBoolValue = false;
+        return ParseLiteral("false", 5) ? EMCPJsonToken::Boolean : EMCPJsonToken::Error;
+    case 'n':
+        return ParseLiteral("null", 4) ? EMCPJsonToken::Null : EMCPJsonToken::Error;
+    default:
+        return ParseNumber() ? EMCPJsonToken::Number : EMCPJsonToken::Error;
+    }
+}
+
+TSharedPtr<FJsonValue> FMCPJsonPullParser::BuildValue(EMCPJsonToken Token)
+{
+    switch (Token)
+    {
+    case EMCPJsonToken::BeginObject:
+    {
+        TSharedPtr<FJsonObject> Object = MakeShared<FJsonObject>();
+        for (EMCPJsonToken MemberToken = Next(); MemberToken != EMCPJsonToken::EndObject; MemberToken = Next())
+        {
+            if (MemberToken != EMCPJsonToken::Key)
+            {
+                return nullptr;
+            }
+
+            FString FieldName = StringValue;
+            TSharedPtr<FJsonValue> FieldValue = BuildValue(Next());
+            if (!FieldValue.IsValid())
+            {
+                return nullptr;
+            }
+            Object->SetField(MoveTemp(FieldName), FieldValue);
+        }
+        return MakeShared<FJsonValueObject>(Object);
+    }
+    case EMCPJsonToken::BeginArray:
+    {
+        TArray<TSharedPtr<FJsonValue>> Elements;
+        for (EMCPJsonToken ElementToken = Next(); ElementToken != EMCPJsonToken::EndArray; ElementToken = Next())
+        {
+            TSharedPtr<FJsonValue> Element = BuildValue(ElementToken);
+            if (!Element.IsValid())
+            {
+                return nullptr;
+            }
+            Elements.Add(Element);
+        }
+        return MakeShared<FJsonValueArray>(Elements);
+    }
+    case EMCPJsonToken::String:
+        return MakeShared<FJsonValueString>(StringValue);
+    case EMCPJsonToken::Number:
+        return MakeShared<FJsonValueNumber>(NumberValue);
+    case EMCPJsonToken::Boolean:
+        return MakeShared<FJsonValueBoolean>(bBoolValue);
+    case EMCPJsonToken::Null:
+        return MakeShared<FJsonValueNull>();
+    default:
+        if (ErrorMessage.IsEmpty())
+        {
+            Fail(TEXT("Expected value"));
+        }
+        return nullptr;
+    }
+}
+
+bool FMCPJsonPullParser::ParseString()
+{
+    // 调用时 Data[Position] 为起始引号
+    ++Position;
+    StringValue.Reset();
+
+    int32 RunStart = Position;
+    auto FlushRun = [this, &RunStart]()
+    {
+        if (Position > RunStart)
+        {
+            // 未转义的片段按 UTF-8 一次性解码
+            FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR *>(Data + RunStart), Position - RunStart);
+            StringValue.AppendChars(Converter.Get(), Converter.Length());
+        }
+    };
+
+    while (Position < Length)
+    {
+        const UTF8CHAR Char = Data[Position];
+
+        if (Char == '"')
+        {
+            FlushRun();
+            ++Position;
+            return true;
+        }
+
+        if (static_cast<uint8>(Char) < 0x20)
+        {
+            Fail(TEXT("Control character in string"));
+            return false;
+        }
+
+        if (Char != '\\')
+        {
+            ++Position;
+            continue;
+        }
+
+        FlushRun();
+        if (Position + 1 >= Length)
+        {
+            break;
+        }
+
+        const UTF8CHAR Escape = Data[Position + 1];
+        Position += 2;
+        switch (Escape)
+        {
+        case '"':
+            StringValue.AppendChar(TEXT('"'));
+            break;
+        case '\\':
+            StringValue.AppendChar(TEXT('\\'));
+            break;
+        case '/':
+            StringValue.AppendChar(TEXT('/'));
+            break;
+        case 'b':
+            StringValue.AppendChar(TEXT('\b'));
+            break;
+        case 'f':
+            StringValue.AppendChar(TEXT('\f'));
+            break;
+        case 'n':
+            StringValue.AppendChar(TEXT('\n'));
+            break;
+        case 'r':
+            StringValue.AppendChar(TEXT('\r'));
+            break;
+        case 't':
+            StringValue.AppendChar(TEXT('\t'));
+            break;
+        case 'u':
+        {
+            uint32 CodeUnit = 0;
+            for (int32 Digit = 0; Digit < 4; ++Digit)
+            {
+                if (Position >= Length || !FChar::IsHexDigit(static_cast<TCHAR>(Data[Position])))
+                {
+                    Fail(TEXT("Invalid \\u escape"));
+                    return false;
+                }
+                CodeUnit = (CodeUnit << 4) | FParse::HexDigit(static_cast<TCHAR>(Data[Position]));
+                ++Position;
+            }
+            // 代理对按 UTF-16 码元依次追加,由 FString 自身的编码组合
+            StringValue.AppendChar(static_cast<TCHAR>(CodeUnit));
+            break;
+        }
+        default:
+            Fail(TEXT("Invalid escape sequence"));
+            return false;
+        }
+        RunStart = Position;
+    }
+
+    Fail(TEXT("Unterminated string"));
+    return false;
+}
+
+bool FMCPJsonPullParser::ParseNumber()
+{
+    const int32 Start = Position;
+
+    if (Position < Length && Data[Position] == '-')
+    {
+        ++Position;
+    }
+
+    auto SkipDigits = [this]()
+    {
+        const int32 DigitsStart = Position;
+        while (Position < Length && Data[Position] >= '0' && Data[Position] <= '9')
+        {
+            ++Position;
+        }
+        return Position > DigitsStart;
+    };
+
+    if (!SkipDigits())
+    {
+        Position = Start;
+        Fail(TEXT("Unexpected character"));
+        return false;
+    }
+    if (Position < Length && Data[Position] == '.')
+    {
+        ++Position;
+        if (!SkipDigits())
+        {
+            Fail(TEXT("Invalid number"));
+            return false;
+        }
+    }
+    if (Position < Length && (Data[Position] == 'e' || Data[Position] == 'E'))
+    {
+        ++Position;
+        if (Position < Length && (Data[Position] == '+' || Data[Position] == '-'))
+        {
+            ++Position;
+        }
+        if (!SkipDigits())
+        {
+            Fail(TEXT("Invalid number"));
+            return false;
+        }
+    }
+
+    // Atod 需要以 0 结尾的字符串,数字通常很短,复制到栈上
+    ANSICHAR Digits[64];
+    const int32 NumberLength = Position - Start;
+    if (NumberLength >= UE_ARRAY_COUNT(Digits))
+    {
+        Fail(TEXT("Number too long"));
+        return false;
+    }
+    FMemory::Memcpy(Digits, Data + Start, NumberLength);
+    Digits[NumberLength] = '\0';
+    NumberValue = FCStringAnsi::Atod(Digits);
+    return true;
+}
+
+bool FMCPJsonPullParser::ParseLiteral(const ANSICHAR *Literal, int32 LiteralLength)
+{
+    if (Position + LiteralLength > Length ||
+        FMemory::Memcmp(Data + Position, Literal, LiteralLength) != 0)
+    {
+        Fail(TEXT("Unexpected character"));
+        return false;
+    }
+    Position += LiteralLength;
+    return true;
+}
+
+bool FMCPJsonPullParser::PushLevel(bool bIsObject)
+{
+    if (Levels.Num() >= MCPConstants::MAX_JSON_NESTING_DEPTH)
+    {
+        Fail(TEXT("Nesting too deep"));
+        return false;
+    }
+    Levels.Add({bIsObject, false, false});
+    return true;
+}
+
+void FMCPJsonPullParser::SkipWhitespace()
+{
+    while (Position < Length)
+    {
+        const UTF8CHAR Char = Data[Position];
+        if (Char != ' ' && Char != '\t' && Char != '\r' && Char != '\n')
+        {
+            break;
+        }
+        ++Position;
+    }
+}
+
+EMCPJsonToken FMCPJsonPullParser::Fail(const TCHAR *Message)
+{
+    if (ErrorMessage.IsEmpty())
+    {
+        ErrorMessage = FString::Printf(TEXT("%s at offset %d"), Message, Position);
+    }
+    return EMCPJsonToken::Error;
+}
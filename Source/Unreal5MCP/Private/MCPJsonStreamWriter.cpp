@@ -0,0 +1,393 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPJsonStreamWriter.h"
+
+FMCPJsonStreamWriter::FMCPJsonStreamWriter(TArray<ANSICHAR> &InBuffer)
+    : Buffer(InBuffer), bAfterKey(false)
+{
+}
+
+void FMCPJsonStreamWriter::BeginObject()
+{
+    BeginValue();
+    Buffer.Add('{');
+    Scopes.Add({true, false});
+}
+
+void FMCPJsonStreamWriter::EndObject()
+{
+    check(Scopes.Num() > 0 && Scopes.Last().bIsObject && !bAfterKey);
+    Scopes.Pop(EAllowShrinking::No);
+    Buffer.Add('}');
+}
+
+void FMCPJsonStreamWriter::BeginArray()
+{
+    BeginValue();
+    Buffer.Add('[');
+    Scopes.Add({false, false});
+}
+
+void FMCPJsonStreamWriter::EndArray()
+{
+    check(Scopes.Num() > 0 && !Scopes.Last().bIsObject);
+    Scopes.Pop(EAllowShrinking::No);
+    Buffer.Add(']');
+}
+
+void FMCPJsonStreamWriter::WriteKey(FStringView Key)
+{
+    check(Scopes.Num() > 0 && Scopes.Last().bIsObject && !bAfterKey);
+    if (Scopes.Last().bHasElements)
+    {
+        Buffer.Add(',');
+    }
+    Scopes.Last().bHasElements = true;
+
+    AppendQuotedString(Key);
+    Buffer.Add(':');
+    bAfterKey = true;
+}
+
+void FMCPJsonStreamWriter::WriteString(FStringView Value)
+{
+    BeginValue();
+    AppendQuotedString(Value);
+}
+
+void FMCPJsonStreamWriter::WriteNumber(double Value)
+{
+    if (!FMath::IsFinite(Value))
+    {
+        WriteNull();
+        return;
+    }
+
+    // 整数值按整数输出,与 FJsonSerializer 的结果一致
+    if (FMath::Abs(Value) < 9007199254740992.0 && FMath::RoundToDouble(Value) == Value)
+    {
+        WriteInteger(static_cast<int64>(Value));
+        return;
+    }
+
+    BeginValue();
+
+    // 先用 15 位有效数字,不能精确还原时再用 17 位
+    ANSICHAR Digits[32];
+    int32 Length = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%.15g", Value);
+    if (FCStringAnsi::Atod(Digits) != Value)
+    {
+        Length = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%.17g", Value);
+    }
+    AppendLiteral(Digits, Length);
+}
+
+void FMCPJsonStreamWriter::WriteInteger(int64 Value)
+{
+    BeginValue();
+
+    ANSICHAR Digits[24];
+    const int32 Length = FCStringAnsi::Snprintf(Digits, UE_ARRAY_COUNT(Digits), "%lld", static_cast<long long>(Value));
+    AppendLiteral(Digits, Length);
+}
+
+void FMCPJsonStreamWriter::WriteBool(bool Value)
+{
+    BeginValue();
+    if (Value)
+    {
+        AppendLiteral("true", 4);
+    }
+    else
+    {
+        AppendLiteral("false", 5);
+    }
+}
+
+void FMCPJsonStreamWriter::WriteNull()
+{
+    BeginValue();
+    AppendLiteral("null", 4);
+}
+
+namespace
+{
+    /** UTF-8 内容转义后的字节数(不含引号) */
+    int32 GetEscapedUtf8Length(const ANSICHAR *Data, int32 Length)
+    {
+        int32 EscapedLength = Length;
+        for (int32 Index = 0; Index < Length; ++Index)
+        {
+            const uint8 Char = static_cast<uint8>(Data[Index]);
+            if (Char == '"' || Char == '\\' || Char == '\n' || Char == '\r' || Char == '\t')
+            {
+                EscapedLength += 1;
+            }
+            else if (Char < 0x20)
+            {
+                // \u00XX
+                EscapedLength += 5;
+            }
+        }
+        return EscapedLength;
+    }
+}
+
+void FMCPJsonStreamWriter::WriteUtf8String(const ANSICHAR *Data, int32 Length)
+{
+    BeginValue();
+
+    Buffer.Reserve(Buffer.Num() + Length + 2);
+    Buffer.Add('"');
+    AppendEscapedUtf8(Data, Length);
+    Buffer.Add('"');
+}
+
+void FMCPJsonStreamWriter::WriteBufferRangeAsString(int32 Start, int32 Length)
+{
+    check(Start >= 0 && Start + Length <= Buffer.Num());
+
+    // 预留逗号、引号和转义后的全部内容,写入期间缓冲区不会重新分配,源范围保持有效
+    Buffer.Reserve(Buffer.Num() + GetEscapedUtf8Length(Buffer.GetData() + Start, Length) + 3);
+
+    BeginValue();
+    Buffer.Add('"');
+    AppendEscapedUtf8(Buffer.GetData() + Start, Length);
+    Buffer.Add('"');
+}
+
+void FMCPJsonStreamWriter::AppendEscapedUtf8(const ANSICHAR *Data, int32 Length)
+{
+    // 未转义的片段用 memcpy 复制: Data 可能指向 Buffer 自身,TArray::Append 不接受这种别名
+    auto AppendRun = [this](const ANSICHAR *Run, int32 RunLength)
+    {
+        const int32 Offset = Buffer.AddUninitialized(RunLength);
+        FMemory::Memcpy(Buffer.GetData() + Offset, Run, RunLength);
+    };
+
+    // 只需转义 ASCII 控制字符、引号和反斜杠,多字节序列原样复制
+    int32 RunStart = 0;
+    for (int32 Index = 0; Index < Length; ++Index)
+    {
+        const uint8 Char = static_cast<uint8>(Data[Index]);
+        if (Char >= 0x20 && Char != '"' && Char != '\\')
+        {
+            continue;
+        }
+
+        AppendRun(Data + RunStart, Index - RunStart);
+        RunStart = Index + 1;
+
+        switch (Char)
+        {
+        case '"':
+            AppendLiteral("\\\"", 2);
+            break;
+        case '\\':
+            AppendLiteral("\\\\", 2);
+            break;
+        case '\n':
+            AppendLiteral("\\n", 2);
+            break;
+        case '\r':
+            AppendLiteral("\\r", 2);
+            break;
+        case '\t':
+            AppendLiteral("\\t", 2);
+            break;
+        default:
+        {
+            ANSICHAR Escape[8];
+            const int32 EscapeLength = FCStringAnsi::Snprintf(Escape, UE_ARRAY_COUNT(Escape), "\\u%04x", Char);
+            AppendLiteral(Escape, EscapeLength);
+            break;
+        }
+        }
+    }
+    AppendRun(Data + RunStart, Length - RunStart);
+}
+
+void FMCPJsonStreamWriter::WriteVector(const FVector &Value)
+{
+    BeginObject();
+    WriteField(TEXT("x"), Value.X);
+    WriteField(TEXT("y"), Value.Y);
+    WriteField(TEXT("z"), Value.Z);
+    EndObject();
+}
+
+void FMCPJsonStreamWriter::WriteRotator(const FRotator &Value)
+{
+    BeginObject();
+    WriteField(TEXT("pitch"), Value.Pitch);
+    WriteField(TEXT("yaw"), Value.Yaw);
+    WriteField(TEXT("roll"), Value.Roll);
+    EndObject();
+}
+
+void FMCPJsonStreamWriter::WriteJsonObject(const TSharedPtr<FJsonObject> &Object)
+{
+    if (!Object.IsValid())
+    {
+        WriteNull();
+        return;
+    }
+
+    BeginObject();
+    for (const auto &Pair : Object->Values)
+    {
+        WriteKey(Pair.Key);
+        WriteJsonValue(Pair.Value);
+    }
+    EndObject();
+}
+
+void FMCPJsonStreamWriter::WriteJsonValue(const TSharedPtr<FJsonValue> &Value)
+{
+    switch (Value.IsValid() ? Value->Type : EJson::Null)
+    {
+    case EJson::String:
+        WriteString(Value->AsString());
+        break;
+    case EJson::Number:
+        WriteNumber(Value->AsNumber());
+        break;
+    case EJson::Boolean:
+        WriteBool(Value->AsBool());
+        break;
+    case EJson::Array:
+        BeginArray();
+        for (const TSharedPtr<FJsonValue> &Element : Value->AsArray())
+        {
+            WriteJsonValue(Element);
+        }
+        EndArray();
+        break;
+    case EJson::Object:
+        WriteJsonObject(Value->AsObject());
+        break;
+    default:
+        WriteNull();
+        break;
+    }
+}
+
+void FMCPJsonStreamWriter::WriteRawJson(const ANSICHAR *Json, int32 Length)
+{
+    BeginValue();
+    AppendLiteral(Json, Length);
+}
+
+void FMCPJsonStreamWriter::BeginValue()
+{
+    if (bAfterKey)
+    {
+        bAfterKey = false;
+        return;
+    }
+
+    if (Scopes.Num() > 0)
+    {
+        // 对象中的值必须先写键,数组元素之间插入逗号
+        FScope &Scope = Scopes.Last();
+        check(!Scope.bIsObject);
+        if (Scope.bHasElements)
+        {
+            Buffer.Add(',');
+        }
+        Scope.bHasElements = true;
+    }
+}
+
+void FMCPJsonStreamWriter::AppendLiteral(const ANSICHAR *Literal, int32 Length)
+{
+    Buffer.Append(Literal, Length);
+}
+
+void FMCPJsonStreamWriter::AppendQuotedString(FStringView Value)
+{
+    Buffer.Reserve(Buffer.Num() + Value.Len() + 2);
+    Buffer.Add('"');
+
+    const TCHAR *Chars = Value.GetData();
+    const int32 Length = Value.Len();
+    for (int32 Index = 0; Index < Length; ++Index)
+    {
+        uint32 CodePoint = static_cast<uint32>(Chars[Index]);
+
+        if (CodePoint < 0x80)
+        {
+            switch (CodePoint)
+            {
+            case '"':
+                AppendLiteral("\\\"", 2);
+                break;
+            case '\\':
+                AppendLiteral("\\\\", 2);
+                break;
+            case '\n':
+                AppendLiteral("\\n", 2);
+                break;
+            case '\r':
+                AppendLiteral("\\r", 2);
+                break;
+            case '\t':
+                AppendLiteral("\\t", 2);
+                break;
+            default:
+                if (CodePoint < 0x20)
+                {
+                    ANSICHAR Escape[8];
+                    const int32 EscapeLength = FCStringAnsi::Snprintf(Escape, UE_ARRAY_COUNT(Escape), "\\u%04x", CodePoint);
+                    AppendLiteral(Escape, EscapeLength);
+                }
+                else
+                {
+                    Buffer.Add(static_cast<ANSICHAR>(CodePoint));
+                }
+                break;
+            }
+            continue;
+        }
+
+        // UTF-16 代理对合并为一个码点,孤立的代理项替换为 U+FFFD
+        if (CodePoint >= 0xD800 && CodePoint <= 0xDBFF)
+        {
+            const uint32 Low = Index + 1 < Length ? static_cast<uint32>(Chars[Index + 1]) : 0;
+            if (Low >= 0xDC00 && Low <= 0xDFFF)
+            {
+                CodePoint = 0x10000 + ((CodePoint - 0xD800) << 10) + (Low - 0xDC00);
+                ++Index;
+            }
+            else
+            {
+                CodePoint = 0xFFFD;
+            }
+        }
+        else if ((CodePoint >= 0xDC00 && CodePoint <= 0xDFFF) || CodePoint > 0x10FFFF)
+        {
+            CodePoint = 0xFFFD;
+        }
+
+        if (CodePoint < 0x800)
+        {
+            Buffer.Add(static_cast<ANSICHAR>(0xC0 | (CodePoint >> 6)));
+            Buffer.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+        }
+        else if (CodePoint < 0x10000)
+        {
+            Buffer.Add(static_cast<ANSICHAR>(0xE0 | (CodePoint >> 12)));
+            Buffer.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+            Buffer.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+        }
+        else
+        {
+            Buffer.Add(static_cast<ANSICHAR>(0xF0 | (CodePoint >> 18)));
+            Buffer.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 12) & 0x3F)));
+            Buffer.Add(static_cast<ANSICHAR>(0x80 | ((CodePoint >> 6) & 0x3F)));
+            Buffer.Add(static_cast<ANSICHAR>(0x80 | (CodePoint & 0x3F)));
+        }
+    }
+
+    Buffer.Add('"');
+}
@@ -0,0 +1,482 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPParamBinding.h"
+#include "Unreal5MCP.h"
+#include "JsonObjectConverter.h"
+#include "UObject/UnrealType.h"
+#include "UObject/EnumProperty.h"
+
+TMap<const UScriptStruct *, TUniquePtr<FMCPParamBinding::FFieldTable>> FMCPParamBinding::FieldTables;
+
+namespace
+{
+    /** 读取属性元数据(无元数据的构建中返回空) */
+    FString GetPropertyMetaData(const FProperty *Property, const TCHAR *Key)
+    {
+#if WITH_METADATA
+        if (Property->HasMetaData(Key))
+        {
+            return Property->GetMetaData(Key);
+        }
+#endif
+        return FString();
+    }
+
+    bool HasPropertyMetaData(const FProperty *Property, const TCHAR *Key)
+    {
+#if WITH_METADATA
+        return Property->HasMetaData(Key);
+#else
+        return false;
+#endif
+    }
+
+    TOptional<double> GetNumericMetaData(const FProperty *Property, const TCHAR *Key)
+    {
+        const FString Value = GetPropertyMetaData(Property, Key);
+        if (Value.IsEmpty())
+        {
+            return TOptional<double>();
+        }
+        return FCString::Atod(*Value);
+    }
+
+    /** 读取 {x,y,z} 形式的对象,缺失的分量保持原值 */
+    bool ReadVector(const TSharedPtr<FJsonValue> &Value, FVector &InOutVector)
+    {
+        const TSharedPtr<FJsonObject> *Object = nullptr;
+        if (!Value->TryGetObject(Object))
+        {
+            return false;
+        }
+        (*Object)->TryGetNumberField(TEXT("x"), InOutVector.X);
+        (*Object)->TryGetNumberField(TEXT("y"), InOutVector.Y);
+        (*Object)->TryGetNumberField(TEXT("z"), InOutVector.Z);
+        return true;
+    }
+
+    /** 读取 {pitch,yaw,roll} 形式的对象,缺失的分量保持原值 */
+    bool ReadRotator(const TSharedPtr<FJsonValue> &Value, FRotator &InOutRotator)
+    {
+        const TSharedPtr<FJsonObject> *Object = nullptr;
+        if (!Value->TryGetObject(Object))
+        {
+            return false;
+        }
+        (*Object)->TryGetNumberField(TEXT("pitch"), InOutRotator.Pitch);
+        (*Object)->TryGetNumberField(TEXT("yaw"), InOutRotator.Yaw);
+        (*Object)->TryGetNumberField(TEXT("roll"), InOutRotator.Roll);
+        return true;
+    }
+
+    TSharedPtr<FJsonObject> MakeNumberComponentsSchema(std::initializer_list<const TCHAR *> Components)
+    {
+        TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField("type", TEXT("object"));
+
+        TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+        for (const TCHAR *Component : Components)
+        {
+            TSharedPtr<FJsonObject> ComponentSchema = MakeShared<FJsonObject>();
+            ComponentSchema->SetStringField("type", TEXT("number"));
+            Props->SetObjectField(Component, ComponentSchema);
+        }
+        Schema->SetObjectField("properties", Props);
+        return Schema;
+    }
+}
+
+bool FMCPParamBinding::Decode(const UScriptStruct *Struct, const TSharedPtr<FJsonObject> &Params, void *OutStruct, FString &OutError)
+{
+    check(Struct && OutStruct);
+
+    const FFieldTable &Table = GetFieldTable(Struct);
+    for (const FField &Field : Table.Fields)
+    {
+        const TSharedPtr<FJsonValue> *Value = Params.IsValid() ? Params->Values.Find(Field.JsonName) : nullptr;
+        if (!Value || !Value->IsValid() || (*Value)->IsNull())
+        {
+            if (Field.bRequired)
+            {
+                OutError = FString::Printf(TEXT("Missing required parameter: %s"), *Field.JsonName);
+                return false;
+            }
+            continue;
+        }
+
+        void *FieldPtr = Field.Property->ContainerPtrToValuePtr<void>(OutStruct);
+        if (!DecodeValue(Field, Field.Property, Field.Kind, *Value, FieldPtr, OutError))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+TSharedPtr<FJsonObject> FMCPParamBinding::GetSchema(const UScriptStruct *Struct)
+{
+    return GetFieldTable(Struct).Schema;
+}
+
+const FMCPParamBinding::FFieldTable &FMCPParamBinding::GetFieldTable(const UScriptStruct *Struct)
+{
+    if (const TUniquePtr<FFieldTable> *Existing = FieldTables.Find(Struct))
+    {
+        return **Existing;
+    }
+
+    TUniquePtr<FFieldTable> Table = MakeUnique<FFieldTable>();
+    for (TFieldIterator<FProperty> It(Struct); It; ++It)
+    {
+        const FProperty *Property = *It;
+
+        FField &Field = Table->Fields.AddDefaulted_GetRef();
+        Field.Property = Property;
+        Field.JsonName = MakeJsonName(Property);
+        Field.Kind = ClassifyProperty(Property);
+        if (const FArrayProperty *ArrayProperty = CastField<FArrayProperty>(Property))
+        {
+            Field.InnerKind = ClassifyProperty(ArrayProperty->Inner);
+        }
+        Field.bRequired = HasPropertyMetaData(Property, TEXT("MCPRequired"));
+        Field.ClampMin = GetNumericMetaData(Property, TEXT("ClampMin"));
+        Field.ClampMax = GetNumericMetaData(Property, TEXT("ClampMax"));
+    }
+
+    // 嵌套结构体的字段表在生成 Schema 时递归构建,表本身由 TUniquePtr 持有,地址不随映射扩容变化
+    Table->Schema = MakeStructSchema(Struct, Table->Fields);
+
+    MCP_LOG_VERBOSE("Built parameter field table for %s (%d fields)", *Struct->GetName(), Table->Fields.Num());
+    return *FieldTables.Add(Struct, MoveTemp(Table));
+}
+
+FMCPParamBinding::EFieldKind FMCPParamBinding::ClassifyProperty(const FProperty *Property)
+{
+    if (Property->IsA<FStrProperty>())
+    {
+        return EFieldKind::String;
+    }
+    if (Property->IsA<FNameProperty>())
+    {
+        return EFieldKind::Name;
+    }
+    if (Property->IsA<FBoolProperty>())
+    {
+        return EFieldKind::Bool;
+    }
+    if (const FNumericProperty *NumericProperty = CastField<FNumericProperty>(Property))
+    {
+        // 带枚举的字节属性按名称解码
+        if (!NumericProperty->IsEnum())
+        {
+            return EFieldKind::Number;
+        }
+    }
+    if (const FStructProperty *StructProperty = CastField<FStructProperty>(Property))
+    {
+        if (StructProperty->Struct == TBaseStructure<FVector>::Get())
+        {
+            return EFieldKind::Vector;
+        }
+        if (StructProperty->Struct == TBaseStructure<FRotator>::Get())
+        {
+            return EFieldKind::Rotator;
+        }
+        return EFieldKind::Struct;
+    }
+    if (Property->IsA<FArrayProperty>())
+    {
+        return EFieldKind::Array;
+    }
+    return EFieldKind::Generic;
+}
+
+bool FMCPParamBinding::DecodeValue(const FField &Field, const FProperty *Property, EFieldKind Kind,
+                                   const TSharedPtr<FJsonValue> &Value, void *ValuePtr, FString &OutError)
+{
+    auto TypeError = [&Field, &OutError](const TCHAR *Expected)
+    {
+        OutError = FString::Printf(TEXT("Invalid type for parameter '%s' (expected %s)"), *Field.JsonName, Expected);
+        return false;
+    };
+
+    switch (Kind)
+    {
+    case EFieldKind::String:
+        if (Value->Type != EJson::String)
+        {
+            return TypeError(TEXT("string"));
+        }
+        *static_cast<FString *>(ValuePtr) = Value->AsString();
+        return true;
+
+    case EFieldKind::Name:
+        if (Value->Type != EJson::String)
+        {
+            return TypeError(TEXT("string"));
+        }
+        *static_cast<FName *>(ValuePtr) = FName(*Value->AsString());
+        return true;
+
+    case EFieldKind::Bool:
+    {
+        bool bValue = false;
+        if (!Value->TryGetBool(bValue))
+        {
+            return TypeError(TEXT("boolean"));
+        }
+        CastFieldChecked<FBoolProperty>(Property)->SetPropertyValue(ValuePtr, bValue);
+        return true;
+    }
+
+    case EFieldKind::Number:
+    {
+        double Number = 0.0;
+        if (Value->Type != EJson::Number || !Value->TryGetNumber(Number))
+        {
+            return TypeError(TEXT("number"));
+        }
+        if (Field.ClampMin.IsSet())
+        {
+            Number = FMath::Max(Number, Field.ClampMin.GetValue());
+        }
+        if (Field.ClampMax.IsSet())
+        {
+            Number = FMath::Min(Number, Field.ClampMax.GetValue());
+        }
+
+        const FNumericProperty *NumericProperty = CastFieldChecked<FNumericProperty>(Property);
+        if (NumericProperty->IsFloatingPoint())
+        {
+            NumericProperty->SetFloatingPointPropertyValue(ValuePtr, Number);
+        }
+        else
+        {
+            NumericProperty->SetIntPropertyValue(ValuePtr, static_cast<int64>(Number));
+        }
+        return true;
+    }
+
+    case EFieldKind::Vector:
+        return ReadVector(Value, *static_cast<FVector *>(ValuePtr)) || TypeError(TEXT("object {x, y, z}"));
+
+    case EFieldKind::Rotator:
+        return ReadRotator(Value, *static_cast<FRotator *>(ValuePtr)) || TypeError(TEXT("object {pitch, yaw, roll}"));
+
+    case EFieldKind::Struct:
+    {
+        const TSharedPtr<FJsonObject> *Object = nullptr;
+        if (!Value->TryGetObject(Object))
+        {
+            return TypeError(TEXT("object"));
+        }
+
+        FString NestedError;
+        if (!Decode(CastFieldChecked<FStructProperty>(Property)->Struct, *Object, ValuePtr, NestedError))
+        {
+            OutError = FString::Printf(TEXT("%s: %s"), *Field.JsonName, *NestedError);
+            return false;
+        }
+        return true;
+    }
+
+    case EFieldKind::Array:
+    {
+        const TArray<TSharedPtr<FJsonValue>> *Items = nullptr;
+        if (!Value->TryGetArray(Items))
+        {
+            return TypeError(TEXT("array"));
+        }
+
+        const FArrayProperty *ArrayProperty = CastFieldChecked<FArrayProperty>(Property);
+        FScriptArrayHelper ArrayHelper(ArrayProperty, ValuePtr);
+        ArrayHelper.EmptyAndAddValues(Items->Num());
+
+        for (int32 Index = 0; Index < Items->Num(); ++Index)
+        {
+            const TSharedPtr<FJsonValue> &Item = (*Items)[Index];
+            if (!Item.IsValid() || !DecodeValue(Field, ArrayProperty->Inner, Field.InnerKind, Item, ArrayHelper.GetRawPtr(Index), OutError))
+            {
+                if (OutError.IsEmpty())
+                {
+                    OutError = FString::Printf(TEXT("Invalid element %d in parameter '%s'"), Index, *Field.JsonName);
+                }
+                return false;
+            }
+        }
+        return true;
+    }
+
+    case EFieldKind::Generic:
+    default:
+        if (!FJsonObjectConverter::JsonValueToUProperty(Value, Property, ValuePtr, 0, 0))
+        {
+            OutError = FString::Printf(TEXT("Invalid value for parameter '%s'"), *Field.JsonName);
+            return false;
+        }
+        return true;
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPParamBinding::MakeStructSchema(const UScriptStruct *Struct, const TArray<FField> &Fields)
+{
+    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+    Schema->SetStringField("type", TEXT("object"));
+
+    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+    TArray<TSharedPtr<FJsonValue>> Required;
+
+    for (const FField &Field : Fields)
+    {
+        Props->SetObjectField(Field.JsonName, MakePropertySchema(Field.Property));
+        if (Field.bRequired)
+        {
+            Required.Add(MakeShared<FJsonValueString>(Field.JsonName));
+        }
+    }
+
+    Schema->SetObjectField("properties", Props);
+    if (Required.Num() > 0)
+    {
+        Schema->SetArrayField("required", Required);
+    }
+    return Schema;
+}
+
+TSharedPtr<FJsonObject> FMCPParamBinding::MakePropertySchema(const FProperty *Property)
+{
+    TSharedPtr<FJsonObject> Schema;
+
+    switch (ClassifyProperty(Property))
+    {
+    case EFieldKind::String:
+    case EFieldKind::Name:
+        Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField("type", TEXT("string"));
+        break;
+
+    case EFieldKind::Bool:
+        Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField("type", TEXT("boolean"));
+        break;
+
+    case EFieldKind::Number:
+    {
+        Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField("type", CastFieldChecked<FNumericProperty>(Property)->IsInteger() ? TEXT("integer") : TEXT("number"));
+
+        const TOptional<double> ClampMin = GetNumericMetaData(Property, TEXT("ClampMin"));
+        const TOptional<double> ClampMax = GetNumericMetaData(Property, TEXT("ClampMax"));
+        if (ClampMin.IsSet())
+        {
+            Schema->SetNumberField("minimum", ClampMin.GetValue());
+        }
+        if (ClampMax.IsSet())
+        {
+            Schema->SetNumberField("maximum", ClampMax.GetValue());
+        }
+        break;
+    }
+
+    case EFieldKind::Vector:
+        Schema = MakeNumberComponentsSchema({TEXT("x"), TEXT("y"), TEXT("z")});
+        break;
+
+    case EFieldKind::Rotator:
+        Schema = MakeNumberComponentsSchema({TEXT("pitch"), TEXT("yaw"), TEXT("roll")});
+        break;
+
+    case EFieldKind::Struct:
+    {
+        // 复制嵌套结构体的缓存 Schema,下面还要加入字段自己的描述
+        const TSharedPtr<FJsonObject> &NestedSchema = GetFieldTable(CastFieldChecked<FStructProperty>(Property)->Struct).Schema;
+        Schema = MakeShared<FJsonObject>(*NestedSchema);
+        break;
+    }
+
+    case EFieldKind::Array:
+        Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField("type", TEXT("array"));
+        Schema->SetObjectField("items", MakePropertySchema(CastFieldChecked<FArrayProperty>(Property)->Inner));
+        break;
+
+    case EFieldKind::Generic:
+    default:
+    {
+        Schema = MakeShared<FJsonObject>();
+
+        const UEnum *Enum = nullptr;
+        if (const FEnumProperty *EnumProperty = CastField<FEnumProperty>(Property))
+        {
+            Enum = EnumProperty->GetEnum();
+        }
+        else if (const FByteProperty *ByteProperty = CastField<FByteProperty>(Property))
+        {
+            Enum = ByteProperty->Enum;
+        }
+
+        if (Enum)
+        {
+            Schema->SetStringField("type", TEXT("string"));
+
+            // 最后一项是自动生成的 _MAX
+            TArray<TSharedPtr<FJsonValue>> EnumValues;
+            for (int32 Index = 0; Index < Enum->NumEnums() - 1; ++Index)
+            {
+                EnumValues.Add(MakeShared<FJsonValueString>(Enum->GetNameStringByIndex(Index)));
+            }
+            Schema->SetArrayField("enum", EnumValues);
+        }
+        else if (Property->IsA<FObjectPropertyBase>() || Property->IsA<FSoftObjectProperty>() || Property->IsA<FTextProperty>())
+        {
+            // 对象引用以路径字符串传入
+            Schema->SetStringField("type", TEXT("string"));
+        }
+        break;
+    }
+    }
+
+    const FString Description = GetPropertyMetaData(Property, TEXT("ToolTip"));
+    if (!Description.IsEmpty())
+    {
+        Schema->SetStringField("description", Description);
+    }
+    return Schema;
+}
+
+FString FMCPParamBinding::MakeJsonName(const FProperty *Property)
+{
+    const FString Override = GetPropertyMetaData(Property, TEXT("MCPName"));
+    if (!Override.IsEmpty())
+    {
+        return Override;
+    }
+
+    FString Name = Property->GetName();
+
+    // 布尔属性的 b 前缀不出现在 JSON 中
+    if (Property->IsA<FBoolProperty>() && Name.Len() > 1 && Name[0] == TEXT('b') && FChar::IsUpper(Name[1]))
+    {
+        Name.RightChopInline(1);
+    }
+
+    // CamelCase -> snake_case,连续大写视为一个词(如 HTTPPort -> http_port)
+    FString Result;
+    Result.Reserve(Name.Len() + 4);
+    for (int32 Index = 0; Index < Name.Len(); ++Index)
+    {
+        const TCHAR Char = Name[Index];
+        if (FChar::IsUpper(Char) && Index > 0)
+        {
+            const TCHAR Prev = Name[Index - 1];
+            const bool bNextIsLower = Index + 1 < Name.Len() && FChar::IsLower(Name[Index + 1]);
+            if (FChar::IsLower(Prev) || FChar::IsDigit(Prev) || (FChar::IsUpper(Prev) && bNextIsLower))
+            {
+                Result.AppendChar(TEXT('_'));
+            }
+        }
+        Result.AppendChar(FChar::ToLower(Char));
+    }
+    return Result;
+}
@@ -0,0 +1,288 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPRequestJournal.h"
+#include "MCPJsonStreamWriter.h"
+#include "MCPConstants.h"
+#include "MCPTrace.h"
+#include "Unreal5MCP.h"
+#include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformFileManager.h"
+#include "Misc/Paths.h"
+
+FMCPRequestJournal::FMCPRequestJournal(const FMCPRequestJournalConfig &InConfig)
+    : Config(InConfig), Queue(MCPConstants::JOURNAL_QUEUE_CAPACITY), Thread(nullptr), WakeEvent(nullptr),
+      bStopRequested(false), DroppedCount(0), FileBytes(0), ReportedDroppedCount(0)
+{
+    Config.MaxFiles = FMath::Max(Config.MaxFiles, 1);
+}
+
+FMCPRequestJournal::~FMCPRequestJournal()
+{
+    Shutdown();
+}
+
+bool FMCPRequestJournal::Start()
+{
+    if (Thread)
+    {
+        return true;
+    }
+
+    if (!OpenFile())
+    {
+        return false;
+    }
+
+    WakeEvent = FPlatformProcess::GetSynchEventFromPool(false);
+    Thread = FRunnableThread::Create(this, TEXT("MCPRequestJournal"), 0, TPri_BelowNormal);
+    if (!Thread)
+    {
+        MCP_LOG_ERROR("Failed to create request journal thread");
+        FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+        WakeEvent = nullptr;
+        File.Reset();
+        return false;
+    }
+
+    MCP_LOG_INFO("Request journal: %s", *GetFilePath(0));
+    return true;
+}
+
+void FMCPRequestJournal::Shutdown()
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    // Run 在退出前写完剩余条目
+    Stop();
+    Thread->WaitForCompletion();
+    delete Thread;
+    Thread = nullptr;
+
+    FPlatformProcess::ReturnSynchEventToPool(WakeEvent);
+    WakeEvent = nullptr;
+    File.Reset();
+}
+
+void FMCPRequestJournal::RecordRequest(const FIPv4Endpoint &Client, const FString &Tool, int32 RequestId, int32 RequestBytes,
+                                       FUtf8StringView JsonPayload)
+{
+    FEntry Entry;
+    Entry.Timestamp = FDateTime::UtcNow();
+    Entry.Client = Client;
+    Entry.Tool = Tool;
+    Entry.RequestId = RequestId;
+    Entry.Bytes = RequestBytes;
+
+    if (!JsonPayload.IsEmpty() && Config.PayloadSampleRate > 0.0f && FMath::FRand() < Config.PayloadSampleRate)
+    {
+        int32 PayloadLength = FMath::Min(JsonPayload.Len(), MCPConstants::MAX_JOURNAL_PAYLOAD_BYTES);
+
+        // 截断时退回到 UTF-8 字符边界
+        while (PayloadLength < JsonPayload.Len() && PayloadLength > 0 &&
+               (static_cast<uint8>(JsonPayload[PayloadLength]) & 0xC0) == 0x80)
+        {
+            --PayloadLength;
+        }
+        Entry.Payload.Append(reinterpret_cast<const ANSICHAR *>(JsonPayload.GetData()), PayloadLength);
+        Entry.bPayloadTruncated = PayloadLength < JsonPayload.Len();
+    }
+
+    Enqueue(MoveTemp(Entry));
+}
+
+void FMCPRequestJournal::RecordResponse(const FIPv4Endpoint &Client, const FString &Tool, int32 RequestId, int32 ResponseBytes,
+                                        double LatencySeconds, bool bError)
+{
+    FEntry Entry;
+    Entry.bResponse = true;
+    Entry.bError = bError;
+    Entry.Timestamp = FDateTime::UtcNow();
+    Entry.Client = Client;
+    Entry.Tool = Tool;
+    Entry.RequestId = RequestId;
+    Entry.Bytes = ResponseBytes;
+    Entry.LatencySeconds = LatencySeconds;
+
+    Enqueue(MoveTemp(Entry));
+}
+
+void FMCPRequestJournal::Enqueue(FEntry &&Entry)
+{
+    if (!Thread)
+    {
+        return;
+    }
+
+    if (!Queue.Enqueue(MoveTemp(Entry)))
+    {
+        DroppedCount.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // 平时由写入线程定时取出,积压过半时提前唤醒
+    if (Queue.Count() >= MCPConstants::JOURNAL_QUEUE_CAPACITY / 2)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+uint32 FMCPRequestJournal::Run()
+{
+    const uint32 WaitMilliseconds = static_cast<uint32>(MCPConstants::JOURNAL_FLUSH_INTERVAL_SECONDS * 1000.0f);
+
+    while (!bStopRequested.load(std::memory_order_acquire))
+    {
+        WakeEvent->Wait(WaitMilliseconds);
+        DrainQueue();
+    }
+
+    DrainQueue();
+    return 0;
+}
+
+void FMCPRequestJournal::Stop()
+{
+    bStopRequested.store(true, std::memory_order_release);
+    if (WakeEvent)
+    {
+        WakeEvent->Trigger();
+    }
+}
+
+void FMCPRequestJournal::DrainQueue()
+{
+    if (!File.IsValid())
+    {
+        return;
+    }
+
+    bool bWrote = false;
+    FEntry Entry;
+    while (Queue.Dequeue(Entry))
+    {
+        FormatEntry(Entry, LineBuffer);
+        WriteLine(LineBuffer);
+        bWrote = true;
+    }
+
+    // 丢弃的条目以一行汇总记录,便于审计时发现缺口
+    const uint64 Dropped = DroppedCount.load(std::memory_order_relaxed);
+    if (Dropped > ReportedDroppedCount)
+    {
+        LineBuffer.Reset();
+        FMCPJsonStreamWriter Writer(LineBuffer);
+        Writer.BeginObject();
+        Writer.WriteField(TEXT("ts"), FDateTime::UtcNow().ToIso8601());
+        Writer.WriteField(TEXT("type"), TEXT("dropped"));
+        Writer.WriteField(TEXT("count"), static_cast<int64>(Dropped - ReportedDroppedCount));
+        Writer.EndObject();
+        LineBuffer.Add('\n');
+
+        WriteLine(LineBuffer);
+        ReportedDroppedCount = Dropped;
+        bWrote = true;
+    }
+
+    if (bWrote && File.IsValid())
+    {
+        File->Flush();
+    }
+}
+
+void FMCPRequestJournal::FormatEntry(const FEntry &Entry, TArray<ANSICHAR> &OutLine) const
+{
+    OutLine.Reset();
+    FMCPJsonStreamWriter Writer(OutLine);
+
+    Writer.BeginObject();
+    Writer.WriteField(TEXT("ts"), Entry.Timestamp.ToIso8601());
+    Writer.WriteField(TEXT("type"), Entry.bResponse ? TEXT("response") : TEXT("request"));
+    Writer.WriteField(TEXT("client"), Entry.Client.ToString());
+    Writer.WriteField(TEXT("tool"), Entry.Tool);
+    if (Entry.RequestId != MCPTrace::NO_REQUEST_ID)
+    {
+        Writer.WriteField(TEXT("id"), Entry.RequestId);
+    }
+    Writer.WriteField(TEXT("bytes"), Entry.Bytes);
+
+    if (Entry.bResponse)
+    {
+        Writer.WriteField(TEXT("latency_ms"), Entry.LatencySeconds * 1000.0);
+        Writer.WriteField(TEXT("status"), Entry.bError ? TEXT("error") : TEXT("ok"));
+    }
+    else if (Entry.Payload.Num() > 0)
+    {
+        // 截断的请求体可能不是完整的 JSON,统一以字符串记录
+        Writer.WriteKey(TEXT("payload"));
+        Writer.WriteUtf8String(Entry.Payload.GetData(), Entry.Payload.Num());
+        if (Entry.bPayloadTruncated)
+        {
+            Writer.WriteField(TEXT("payload_truncated"), true);
+        }
+    }
+    Writer.EndObject();
+
+    OutLine.Add('\n');
+}
+
+void FMCPRequestJournal::WriteLine(const TArray<ANSICHAR> &Line)
+{
+    if (FileBytes > 0 && FileBytes + Line.Num() > Config.MaxFileBytes)
+    {
+        RotateFiles();
+    }
+
+    if (!File.IsValid())
+    {
+        return;
+    }
+
+    if (File->Write(reinterpret_cast<const uint8 *>(Line.GetData()), Line.Num()))
+    {
+        FileBytes += Line.Num();
+    }
+}
+
+bool FMCPRequestJournal::OpenFile()
+{
+    IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.CreateDirectoryTree(*Config.Directory);
+
+    const FString Path = GetFilePath(0);
+    File.Reset(PlatformFile.OpenWrite(*Path, true));
+    if (!File.IsValid())
+    {
+        MCP_LOG_ERROR("Failed to open request journal: %s", *Path);
+        return false;
+    }
+
+    FileBytes = File->Size();
+    return true;
+}
+
+void FMCPRequestJournal::RotateFiles()
+{
+    File.Reset();
+
+    // 最旧的文件被删除(只保留一个文件时即当前文件),其余依次后移
+    IPlatformFile &PlatformFile = FPlatformFileManager::Get().GetPlatformFile();
+    PlatformFile.DeleteFile(*GetFilePath(Config.MaxFiles - 1));
+    for (int32 Index = Config.MaxFiles - 2; Index >= 0; --Index)
+    {
+        PlatformFile.MoveFile(*GetFilePath(Index + 1), *GetFilePath(Index));
+    }
+
+    OpenFile();
+}
+
+FString FMCPRequestJournal::GetFilePath(int32 Index) const
+{
+    const FString FileName = Index == 0
+                                 ? FString::Printf(TEXT("%s.jsonl"), *MCPConstants::JOURNAL_FILE_BASENAME)
+                                 : FString::Printf(TEXT("%s.%d.jsonl"), *MCPConstants::JOURNAL_FILE_BASENAME, Index);
+    return FPaths::Combine(Config.Directory, FileName);
+}
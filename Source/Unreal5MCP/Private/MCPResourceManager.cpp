@@ -0,0 +1,422 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPResourceManager.h"
+#include "MCPTCPServer.h"
+#include "MCPConstants.h"
+#include "MCPJsonStreamWriter.h"
+#include "MCPJsonPullParser.h"
+#include "Unreal5MCP.h"
+#include "Editor.h"
+#include "Selection.h"
+#include "LevelEditorViewport.h"
+#include "GameFramework/Actor.h"
+
+namespace
+{
+    /**
+     * 在处理器输出的 {status, result, message} 中定位 result 值的字节范围
+     * @return 没有 result(处理器返回错误)时返回 false,OutMessage 为错误信息
+     */
+    bool FindResultValue(const TArray<ANSICHAR> &Response, int32 &OutStart, int32 &OutLength, FString &OutMessage)
+    {
+        FMCPJsonPullParser Parser(reinterpret_cast<const UTF8CHAR *>(Response.GetData()), Response.Num());
+        if (Parser.Next() != EMCPJsonToken::BeginObject)
+        {
+            OutMessage = TEXT("Handler response is not an object");
+            return false;
+        }
+
+        bool bFound = false;
+        for (EMCPJsonToken Token = Parser.Next(); Token == EMCPJsonToken::Key; Token = Parser.Next())
+        {
+            if (Parser.GetString() == TEXT("result"))
+            {
+                // 键之后的位置紧跟冒号,处理器输出的 JSON 没有多余空白
+                OutStart = Parser.GetOffset();
+                if (!Parser.SkipValue())
+                {
+                    break;
+                }
+                OutLength = Parser.GetOffset() - OutStart;
+                bFound = true;
+            }
+            else if (Parser.GetString() == TEXT("message"))
+            {
+                if (Parser.Next() != EMCPJsonToken::String)
+                {
+                    break;
+                }
+                OutMessage = Parser.GetString();
+            }
+            else if (!Parser.SkipValue())
+            {
+                break;
+            }
+        }
+
+        return bFound;
+    }
+}
+
+FMCPResourceManager::FMCPResourceManager(FSendNotification InSendNotification)
+    : SendNotification(MoveTemp(InSendNotification)),
+      LastCameraLocation(FVector::ZeroVector),
+      LastCameraRotation(FRotator::ZeroRotator),
+      bHasCameraState(false),
+      bInitialized(false)
+{
+}
+
+FMCPResourceManager::~FMCPResourceManager()
+{
+    Shutdown();
+}
+
+void FMCPResourceManager::Initialize()
+{
+    if (bInitialized)
+    {
+        return;
+    }
+
+    bInitialized = true;
+
+    if (GEngine)
+    {
+        ActorAddedHandle = GEngine->OnLevelActorAdded().AddRaw(this, &FMCPResourceManager::HandleActorAdded);
+        ActorDeletedHandle = GEngine->OnLevelActorDeleted().AddRaw(this, &FMCPResourceManager::HandleActorDeleted);
+        ActorListChangedHandle = GEngine->OnLevelActorListChanged().AddRaw(this, &FMCPResourceManager::HandleActorListChanged);
+    }
+
+    if (GEditor)
+    {
+        ActorMovedHandle = GEditor->OnActorMoved().AddRaw(this, &FMCPResourceManager::HandleActorMoved);
+    }
+
+    MapChangeHandle = FEditorDelegates::MapChange.AddRaw(this, &FMCPResourceManager::HandleMapChange);
+    SelectionChangedHandle = USelection::SelectionChangedEvent.AddRaw(this, &FMCPResourceManager::HandleSelectionChanged);
+
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateRaw(this, &FMCPResourceManager::Tick),
+        MCPConstants::DEFAULT_TICK_INTERVAL_SECONDS);
+}
+
+void FMCPResourceManager::Shutdown()
+{
+    if (!bInitialized)
+    {
+        return;
+    }
+
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+
+    if (GEngine)
+    {
+        GEngine->OnLevelActorAdded().Remove(ActorAddedHandle);
+        GEngine->OnLevelActorDeleted().Remove(ActorDeletedHandle);
+        GEngine->OnLevelActorListChanged().Remove(ActorListChangedHandle);
+    }
+
+    if (GEditor)
+    {
+        GEditor->OnActorMoved().Remove(ActorMovedHandle);
+    }
+
+    FEditorDelegates::MapChange.Remove(MapChangeHandle);
+    USelection::SelectionChangedEvent.Remove(SelectionChangedHandle);
+
+    ActorAddedHandle.Reset();
+    ActorDeletedHandle.Reset();
+    ActorListChangedHandle.Reset();
+    ActorMovedHandle.Reset();
+    MapChangeHandle.Reset();
+    SelectionChangedHandle.Reset();
+
+    Subscriptions.Empty();
+    bInitialized = false;
+}
+
+void FMCPResourceManager::RegisterResource(const FString &Uri, const FString &Name, const FString &Description, TSharedPtr<IMCPCommandHandler> Handler)
+{
+    if (!Handler.IsValid())
+    {
+        MCP_LOG_WARNING("Resource %s registered without a handler, ignoring", *Uri);
+        return;
+    }
+
+    FResource &Resource = Resources.AddDefaulted_GetRef();
+    Resource.Uri = Uri;
+    Resource.Name = Name;
+    Resource.Description = Description;
+    Resource.Handler = Handler;
+}
+
+TSharedPtr<FJsonObject> FMCPResourceManager::ListResources() const
+{
+    TArray<TSharedPtr<FJsonValue>> ResourcesArray;
+    for (const FResource &Resource : Resources)
+    {
+        TSharedPtr<FJsonObject> ResourceObject = MakeShared<FJsonObject>();
+        ResourceObject->SetStringField("uri", Resource.Uri);
+        ResourceObject->SetStringField("name", Resource.Name);
+        ResourceObject->SetStringField("description", Resource.Description);
+        ResourceObject->SetStringField("mimeType", TEXT("application/json"));
+        ResourcesArray.Add(MakeShared<FJsonValueObject>(ResourceObject));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("resources", ResourcesArray);
+    return Result;
+}
+
+bool FMCPResourceManager::ReadResource(const FString &Uri, FMCPJsonStreamWriter &Writer, FString &OutError) const
+{
+    const FResource *Resource = FindResource(Uri);
+    if (!Resource)
+    {
+        OutError = FString::Printf(TEXT("Resource not found: %s"), *Uri);
+        return false;
+    }
+
+    TArray<ANSICHAR> Response;
+    {
+        FMCPJsonStreamWriter HandlerWriter(Response);
+        Resource->Handler->ExecuteStreaming(MakeShared<FJsonObject>(), nullptr, HandlerWriter);
+    }
+
+    // 处理器写出 {status, result},资源内容只包含 result
+    int32 ContentStart = INDEX_NONE;
+    int32 ContentLength = 0;
+    FString Message;
+    if (!FindResultValue(Response, ContentStart, ContentLength, Message))
+    {
+        OutError = FString::Printf(TEXT("Failed to read resource %s: %s"), *Uri, *Message);
+        return false;
+    }
+
+    Writer.BeginObject();
+    Writer.WriteKey(TEXT("contents"));
+    Writer.BeginArray();
+    Writer.BeginObject();
+    Writer.WriteField(TEXT("uri"), Uri);
+    Writer.WriteField(TEXT("mimeType"), TEXT("application/json"));
+    Writer.WriteKey(TEXT("text"));
+    Writer.WriteUtf8String(Response.GetData() + ContentStart, ContentLength);
+    Writer.EndObject();
+    Writer.EndArray();
+    Writer.EndObject();
+    return true;
+}
+
+bool FMCPResourceManager::Subscribe(FSocket *ClientSocket, const FString &Uri)
+{
+    if (!ClientSocket || !FindResource(Uri))
+    {
+        return false;
+    }
+
+    TArray<FSubscription> &Subscribers = Subscriptions.FindOrAdd(Uri);
+    if (!Subscribers.ContainsByPredicate([ClientSocket](const FSubscription &Subscription)
+                                         { return Subscription.Socket == ClientSocket; }))
+    {
+        FSubscription &Subscription = Subscribers.AddDefaulted_GetRef();
+        Subscription.Socket = ClientSocket;
+    }
+
+    // 新订阅从当前摄像机状态开始比较
+    if (Uri == MCPConstants::RESOURCE_URI_CAMERA)
+    {
+        bHasCameraState = false;
+    }
+
+    MCP_LOG_INFO("Client subscribed to %s (%d subscribers)", *Uri, Subscribers.Num());
+    return true;
+}
+
+bool FMCPResourceManager::Unsubscribe(FSocket *ClientSocket, const FString &Uri)
+{
+    TArray<FSubscription> *Subscribers = Subscriptions.Find(Uri);
+    if (!Subscribers)
+    {
+        return false;
+    }
+
+    const int32 Removed = Subscribers->RemoveAll([ClientSocket](const FSubscription &Subscription)
+                                                 { return Subscription.Socket == ClientSocket; });
+    if (Subscribers->Num() == 0)
+    {
+        Subscriptions.Remove(Uri);
+    }
+    return Removed > 0;
+}
+
+void FMCPResourceManager::RemoveClient(FSocket *ClientSocket)
+{
+    for (auto It = Subscriptions.CreateIterator(); It; ++It)
+    {
+        It->Value.RemoveAll([ClientSocket](const FSubscription &Subscription)
+                            { return Subscription.Socket == ClientSocket; });
+        if (It->Value.Num() == 0)
+        {
+            It.RemoveCurrent();
+        }
+    }
+}
+
+bool FMCPResourceManager::HasSubscriptions(FSocket *ClientSocket) const
+{
+    for (const auto &Pair : Subscriptions)
+    {
+        if (Pair.Value.ContainsByPredicate([ClientSocket](const FSubscription &Subscription)
+                                           { return Subscription.Socket == ClientSocket; }))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void FMCPResourceManager::MarkChanged(const FString &Uri)
+{
+    if (TArray<FSubscription> *Subscribers = Subscriptions.Find(Uri))
+    {
+        for (FSubscription &Subscription : *Subscribers)
+        {
+            Subscription.bPending = true;
+        }
+    }
+}
+
+const FMCPResourceManager::FResource *FMCPResourceManager::FindResource(const FString &Uri) const
+{
+    return Resources.FindByPredicate([&Uri](const FResource &Resource)
+                                     { return Resource.Uri == Uri; });
+}
+
+bool FMCPResourceManager::Tick(float DeltaTime)
+{
+    if (Subscriptions.Num() == 0)
+    {
+        return true;
+    }
+
+    PollCamera();
+
+    const double Now = FPlatformTime::Seconds();
+    TArray<FSocket *> DeadSockets;
+
+    for (auto &Pair : Subscriptions)
+    {
+        for (FSubscription &Subscription : Pair.Value)
+        {
+            if (!Subscription.bPending ||
+                Now - Subscription.LastNotifyTime < MCPConstants::RESOURCE_NOTIFY_MIN_INTERVAL_SECONDS)
+            {
+                continue;
+            }
+
+            TSharedPtr<FJsonObject> Params = MakeShared<FJsonObject>();
+            Params->SetStringField("uri", Pair.Key);
+
+            TSharedPtr<FJsonObject> Notification = MakeShared<FJsonObject>();
+            Notification->SetStringField("jsonrpc", TEXT("2.0"));
+            Notification->SetStringField("method", TEXT("notifications/resources/updated"));
+            Notification->SetObjectField("params", Params);
+
+            Subscription.bPending = false;
+            Subscription.LastNotifyTime = Now;
+
+            if (!SendNotification(Subscription.Socket, Notification))
+            {
+                DeadSockets.AddUnique(Subscription.Socket);
+            }
+        }
+    }
+
+    for (FSocket *Socket : DeadSockets)
+    {
+        RemoveClient(Socket);
+    }
+
+    return true;
+}
+
+void FMCPResourceManager::PollCamera()
+{
+    if (!Subscriptions.Contains(MCPConstants::RESOURCE_URI_CAMERA) || !GEditor || !GEditor->GetActiveViewport())
+    {
+        return;
+    }
+
+    // 活动视口可能属于资源编辑器或 PIE,只跟踪关卡编辑器视口
+    const FViewport *ActiveViewport = GEditor->GetActiveViewport();
+    const FLevelEditorViewportClient *ViewportClient = nullptr;
+    for (const FLevelEditorViewportClient *Candidate : GEditor->GetLevelViewportClients())
+    {
+        if (Candidate && Candidate->Viewport == ActiveViewport)
+        {
+            ViewportClient = Candidate;
+            break;
+        }
+    }
+    if (!ViewportClient)
+    {
+        return;
+    }
+
+    const FVector Location = ViewportClient->GetViewLocation();
+    const FRotator Rotation = ViewportClient->GetViewRotation();
+
+    if (bHasCameraState && (!Location.Equals(LastCameraLocation, KINDA_SMALL_NUMBER) || !Rotation.Equals(LastCameraRotation, KINDA_SMALL_NUMBER)))
+    {
+        MarkChanged(MCPConstants::RESOURCE_URI_CAMERA);
+    }
+
+    LastCameraLocation = Location;
+    LastCameraRotation = Rotation;
+    bHasCameraState = true;
+}
+
+// ============================================================================
+// 编辑器回调
+// ============================================================================
+
+void FMCPResourceManager::HandleActorAdded(AActor *Actor)
+{
+    MarkChanged(MCPConstants::RESOURCE_URI_SCENE);
+}
+
+void FMCPResourceManager::HandleActorDeleted(AActor *Actor)
+{
+    MarkChanged(MCPConstants::RESOURCE_URI_SCENE);
+    MarkChanged(MCPConstants::RESOURCE_URI_SELECTION);
+}
+
+void FMCPResourceManager::HandleActorListChanged()
+{
+    MarkChanged(MCPConstants::RESOURCE_URI_SCENE);
+}
+
+void FMCPResourceManager::HandleActorMoved(AActor *Actor)
+{
+    MarkChanged(MCPConstants::RESOURCE_URI_SCENE);
+    if (Actor && Actor->IsSelected())
+    {
+        MarkChanged(MCPConstants::RESOURCE_URI_SELECTION);
+    }
+}
+
+void FMCPResourceManager::HandleMapChange(uint32 MapChangeFlags)
+{
+    MarkChanged(MCPConstants::RESOURCE_URI_SCENE);
+    MarkChanged(MCPConstants::RESOURCE_URI_SELECTION);
+}
+
+void FMCPResourceManager::HandleSelectionChanged(UObject *Selection)
+{
+    MarkChanged(MCPConstants::RESOURCE_URI_SELECTION);
+}
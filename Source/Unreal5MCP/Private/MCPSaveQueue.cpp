@@ -0,0 +1,145 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPSaveQueue.h"
+#include "MCPConstants.h"
+#include "Unreal5MCP.h"
+#include "FileHelpers.h"
+#include "Editor.h"
+#include "UObject/Package.h"
+
+FMCPSaveQueue::FScopedBatch::FScopedBatch(TSharedPtr<FMCPSaveQueue> InQueue)
+    : Queue(InQueue)
+{
+    if (Queue.IsValid())
+    {
+        Queue->BeginBatch();
+    }
+}
+
+FMCPSaveQueue::FScopedBatch::~FScopedBatch()
+{
+    if (Queue.IsValid())
+    {
+        Queue->EndBatch();
+    }
+}
+
+FMCPSaveQueue::FMCPSaveQueue()
+    : LastEnqueueTime(0.0), BatchDepth(0), TotalSavedCount(0)
+{
+    TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
+        FTickerDelegate::CreateRaw(this, &FMCPSaveQueue::Tick),
+        MCPConstants::DEFAULT_TICK_INTERVAL_SECONDS);
+}
+
+FMCPSaveQueue::~FMCPSaveQueue()
+{
+    if (TickerHandle.IsValid())
+    {
+        FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
+        TickerHandle.Reset();
+    }
+
+    // 编辑器关闭期间不再写盘,未保存的包保持脏状态由编辑器提示
+    if (PendingPackages.Num() > 0)
+    {
+        MCP_LOG_WARNING("Save queue destroyed with %d packages still pending", PendingPackages.Num());
+    }
+}
+
+void FMCPSaveQueue::Enqueue(UPackage *Package)
+{
+    if (!Package || Package == GetTransientPackage())
+    {
+        return;
+    }
+
+    PendingPackages.AddUnique(Package);
+    LastEnqueueTime = FPlatformTime::Seconds();
+}
+
+void FMCPSaveQueue::Enqueue(const TArray<UPackage *> &Packages)
+{
+    for (UPackage *Package : Packages)
+    {
+        Enqueue(Package);
+    }
+}
+
+FMCPSaveQueue::FFlushResult FMCPSaveQueue::Flush()
+{
+    FFlushResult Result;
+    if (PendingPackages.Num() == 0)
+    {
+        return Result;
+    }
+
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<UPackage *> PackagesToSave;
+    PackagesToSave.Reserve(PendingPackages.Num());
+    for (const TWeakObjectPtr<UPackage> &WeakPackage : PendingPackages)
+    {
+        UPackage *Package = WeakPackage.Get();
+        if (Package && Package->IsDirty())
+        {
+            PackagesToSave.Add(Package);
+        }
+    }
+    PendingPackages.Reset();
+
+    if (PackagesToSave.Num() > 0)
+    {
+        // 一次保存所有包,不弹出签出提示
+        UEditorLoadingAndSavingUtils::SavePackages(PackagesToSave, true);
+
+        for (UPackage *Package : PackagesToSave)
+        {
+            if (Package->IsDirty())
+            {
+                Result.FailedPackages.Add(Package->GetName());
+            }
+            else
+            {
+                Result.SavedPackages.Add(Package->GetName());
+            }
+        }
+    }
+
+    Result.DurationSeconds = FPlatformTime::Seconds() - StartTime;
+    TotalSavedCount += Result.SavedPackages.Num();
+
+    MCP_LOG_INFO("Save queue flushed: %d saved, %d failed in %.2f s",
+                 Result.SavedPackages.Num(), Result.FailedPackages.Num(), Result.DurationSeconds);
+    return Result;
+}
+
+void FMCPSaveQueue::BeginBatch()
+{
+    BatchDepth++;
+}
+
+void FMCPSaveQueue::EndBatch()
+{
+    BatchDepth = FMath::Max(0, BatchDepth - 1);
+    if (BatchDepth == 0 && PendingPackages.Num() > 0)
+    {
+        Flush();
+    }
+}
+
+bool FMCPSaveQueue::Tick(float DeltaTime)
+{
+    // PIE 运行期间不自动保存,结束后再刷新
+    if (GEditor && GEditor->PlayWorld)
+    {
+        return true;
+    }
+
+    if (BatchDepth == 0 && PendingPackages.Num() > 0 &&
+        FPlatformTime::Seconds() - LastEnqueueTime >= MCPConstants::SAVE_QUEUE_IDLE_FLUSH_SECONDS)
+    {
+        Flush();
+    }
+    return true;
+}
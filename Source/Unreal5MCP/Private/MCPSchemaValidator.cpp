@@ -0,0 +1,399 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPSchemaValidator.h"
+#include "MCPConstants.h"
+#include "Unreal5MCP.h"
+
+TSharedPtr<FMCPSchemaValidator> FMCPSchemaValidator::Compile(const TSharedPtr<FJsonObject> &Schema)
+{
+    if (!Schema.IsValid())
+    {
+        return nullptr;
+    }
+
+    TSharedPtr<FMCPSchemaValidator> Validator = MakeShared<FMCPSchemaValidator>();
+    if (Validator->CompileNode(Schema, 0) == INDEX_NONE)
+    {
+        return nullptr;
+    }
+    return Validator;
+}
+
+bool FMCPSchemaValidator::Validate(const TSharedPtr<FJsonObject> &Params, FError &OutError) const
+{
+    if (Nodes.Num() == 0)
+    {
+        return true;
+    }
+
+    if (!Params.IsValid())
+    {
+        OutError.Pointer.Reset();
+        OutError.Message = TEXT("Expected object");
+        return false;
+    }
+
+    FString Pointer;
+    return ValidateObject(Nodes[0], Params, Pointer, OutError);
+}
+
+bool FMCPSchemaValidator::ValidateArrayElement(const FString &FieldName, int32 Index, const TSharedPtr<FJsonValue> &Element, FError &OutError) const
+{
+    if (Nodes.Num() == 0)
+    {
+        return true;
+    }
+
+    const int32 *FieldIndex = Nodes[0].Properties.Find(FieldName);
+    if (!FieldIndex || Nodes[*FieldIndex].Items == INDEX_NONE)
+    {
+        return true;
+    }
+
+    FString Pointer = FString::Printf(TEXT("/%s/%d"), *EscapePointerToken(FieldName), Index);
+    return ValidateNode(Nodes[*FieldIndex].Items, Element, Pointer, OutError);
+}
+
+int32 FMCPSchemaValidator::CompileNode(const TSharedPtr<FJsonObject> &Schema, int32 Depth)
+{
+    if (!Schema.IsValid() || Depth > MCPConstants::MAX_SCHEMA_DEPTH)
+    {
+        return INDEX_NONE;
+    }
+
+    // 先占位,子节点编译后数组可能扩容,因此之后按索引访问
+    const int32 NodeIndex = Nodes.AddDefaulted();
+
+    uint8 TypeMask = Type_Any;
+    FString TypeName;
+    const TArray<TSharedPtr<FJsonValue>> *TypeNames = nullptr;
+    if (Schema->TryGetStringField(TEXT("type"), TypeName))
+    {
+        TypeMask = ParseTypeName(TypeName);
+    }
+    else if (Schema->TryGetArrayField(TEXT("type"), TypeNames))
+    {
+        TypeMask = 0;
+        for (const TSharedPtr<FJsonValue> &TypeValue : *TypeNames)
+        {
+            FString Name;
+            if (TypeValue.IsValid() && TypeValue->TryGetString(Name))
+            {
+                TypeMask |= ParseTypeName(Name);
+            }
+        }
+    }
+
+    // integer 是 number 的子集,声明 number 时同样接受整数
+    if (TypeMask & Type_Number)
+    {
+        TypeMask |= Type_Integer;
+    }
+    Nodes[NodeIndex].TypeMask = TypeMask == 0 ? uint8(Type_Any) : TypeMask;
+
+    const TSharedPtr<FJsonObject> *Properties = nullptr;
+    if (Schema->TryGetObjectField(TEXT("properties"), Properties))
+    {
+        for (const auto &Pair : (*Properties)->Values)
+        {
+            const TSharedPtr<FJsonObject> *PropertySchema = nullptr;
+            if (Pair.Value.IsValid() && Pair.Value->TryGetObject(PropertySchema))
+            {
+                const int32 ChildIndex = CompileNode(*PropertySchema, Depth + 1);
+                if (ChildIndex == INDEX_NONE)
+                {
+                    return INDEX_NONE;
+                }
+                Nodes[NodeIndex].Properties.Add(Pair.Key, ChildIndex);
+            }
+        }
+    }
+
+    const TArray<TSharedPtr<FJsonValue>> *Required = nullptr;
+    if (Schema->TryGetArrayField(TEXT("required"), Required))
+    {
+        for (const TSharedPtr<FJsonValue> &RequiredValue : *Required)
+        {
+            FString FieldName;
+            if (RequiredValue.IsValid() && RequiredValue->TryGetString(FieldName))
+            {
+                Nodes[NodeIndex].Required.Add(FieldName);
+            }
+        }
+    }
+
+    bool bAdditionalProperties = true;
+    if (Schema->TryGetBoolField(TEXT("additionalProperties"), bAdditionalProperties))
+    {
+        Nodes[NodeIndex].bAllowAdditionalProperties = bAdditionalProperties;
+    }
+
+    const TSharedPtr<FJsonObject> *Items = nullptr;
+    if (Schema->TryGetObjectField(TEXT("items"), Items))
+    {
+        const int32 ItemsIndex = CompileNode(*Items, Depth + 1);
+        if (ItemsIndex == INDEX_NONE)
+        {
+            return INDEX_NONE;
+        }
+        Nodes[NodeIndex].Items = ItemsIndex;
+    }
+
+    int32 MinItems = 0;
+    if (Schema->TryGetNumberField(TEXT("minItems"), MinItems))
+    {
+        Nodes[NodeIndex].MinItems = MinItems;
+    }
+    int32 MaxItems = 0;
+    if (Schema->TryGetNumberField(TEXT("maxItems"), MaxItems))
+    {
+        Nodes[NodeIndex].MaxItems = MaxItems;
+    }
+
+    const TArray<TSharedPtr<FJsonValue>> *EnumValues = nullptr;
+    if (Schema->TryGetArrayField(TEXT("enum"), EnumValues))
+    {
+        for (const TSharedPtr<FJsonValue> &EnumValue : *EnumValues)
+        {
+            FString EnumString;
+            if (EnumValue.IsValid() && EnumValue->TryGetString(EnumString))
+            {
+                Nodes[NodeIndex].EnumValues.Add(EnumString);
+            }
+        }
+    }
+
+    double Bound = 0.0;
+    if (Schema->TryGetNumberField(TEXT("minimum"), Bound))
+    {
+        Nodes[NodeIndex].Minimum = Bound;
+    }
+    if (Schema->TryGetNumberField(TEXT("maximum"), Bound))
+    {
+        Nodes[NodeIndex].Maximum = Bound;
+    }
+
+    return NodeIndex;
+}
+
+bool FMCPSchemaValidator::ValidateNode(int32 NodeIndex, const TSharedPtr<FJsonValue> &Value, FString &Pointer, FError &OutError) const
+{
+    const FNode &Node = Nodes[NodeIndex];
+
+    auto Fail = [&Pointer, &OutError](FString Message)
+    {
+        OutError.Pointer = Pointer;
+        OutError.Message = MoveTemp(Message);
+        return false;
+    };
+
+    // 确定值的类型
+    uint8 ValueType = Type_Null;
+    double Number = 0.0;
+    switch (Value.IsValid() ? Value->Type : EJson::Null)
+    {
+    case EJson::Boolean:
+        ValueType = Type_Boolean;
+        break;
+    case EJson::Number:
+        Number = Value->AsNumber();
+        ValueType = FMath::RoundToDouble(Number) == Number ? uint8(Type_Integer) : uint8(Type_Number);
+        break;
+    case EJson::String:
+        ValueType = Type_String;
+        break;
+    case EJson::Array:
+        ValueType = Type_Array;
+        break;
+    case EJson::Object:
+        ValueType = Type_Object;
+        break;
+    default:
+        break;
+    }
+
+    if ((Node.TypeMask & ValueType) == 0)
+    {
+        return Fail(FString::Printf(TEXT("Expected %s"), *DescribeTypeMask(Node.TypeMask)));
+    }
+
+    switch (ValueType)
+    {
+    case Type_Integer:
+    case Type_Number:
+        if (Node.Minimum.IsSet() && Number < Node.Minimum.GetValue())
+        {
+            return Fail(FString::Printf(TEXT("Must be >= %g"), Node.Minimum.GetValue()));
+        }
+        if (Node.Maximum.IsSet() && Number > Node.Maximum.GetValue())
+        {
+            return Fail(FString::Printf(TEXT("Must be <= %g"), Node.Maximum.GetValue()));
+        }
+        return true;
+
+    case Type_String:
+        if (Node.EnumValues.Num() > 0 && !Node.EnumValues.Contains(Value->AsString()))
+        {
+            return Fail(FString::Printf(TEXT("Must be one of: %s"), *FString::Join(Node.EnumValues, TEXT(", "))));
+        }
+        return true;
+
+    case Type_Array:
+    {
+        const TArray<TSharedPtr<FJsonValue>> &Items = Value->AsArray();
+        if (Items.Num() < Node.MinItems)
+        {
+            return Fail(FString::Printf(TEXT("Expected at least %d items"), Node.MinItems));
+        }
+        if (Items.Num() > Node.MaxItems)
+        {
+            return Fail(FString::Printf(TEXT("Expected at most %d items"), Node.MaxItems));
+        }
+
+        if (Node.Items != INDEX_NONE)
+        {
+            const int32 BaseLength = Pointer.Len();
+            for (int32 Index = 0; Index < Items.Num(); ++Index)
+            {
+                Pointer.AppendChar(TEXT('/'));
+                Pointer.AppendInt(Index);
+                if (!ValidateNode(Node.Items, Items[Index], Pointer, OutError))
+                {
+                    return false;
+                }
+                Pointer.LeftInline(BaseLength, EAllowShrinking::No);
+            }
+        }
+        return true;
+    }
+
+    case Type_Object:
+        return ValidateObject(Node, Value->AsObject(), Pointer, OutError);
+
+    default:
+        return true;
+    }
+}
+
+bool FMCPSchemaValidator::ValidateObject(const FNode &Node, const TSharedPtr<FJsonObject> &Object, FString &Pointer, FError &OutError) const
+{
+    const int32 BaseLength = Pointer.Len();
+
+    for (const FString &FieldName : Node.Required)
+    {
+        const TSharedPtr<FJsonValue> *Value = Object->Values.Find(FieldName);
+        if (!Value || !Value->IsValid() || (*Value)->IsNull())
+        {
+            OutError.Pointer = Pointer + TEXT("/") + EscapePointerToken(FieldName);
+            OutError.Message = TEXT("Missing required field");
+            return false;
+        }
+    }
+
+    for (const auto &Pair : Object->Values)
+    {
+        const int32 *ChildIndex = Node.Properties.Find(Pair.Key);
+        if (!ChildIndex)
+        {
+            if (!Node.bAllowAdditionalProperties)
+            {
+                OutError.Pointer = Pointer + TEXT("/") + EscapePointerToken(Pair.Key);
+                OutError.Message = TEXT("Unknown field");
+                return false;
+            }
+            continue;
+        }
+
+        // 可选字段传 null 视为未传
+        if (!Pair.Value.IsValid() || Pair.Value->IsNull())
+        {
+            continue;
+        }
+
+        Pointer.AppendChar(TEXT('/'));
+        Pointer += EscapePointerToken(Pair.Key);
+        if (!ValidateNode(*ChildIndex, Pair.Value, Pointer, OutError))
+        {
+            return false;
+        }
+        Pointer.LeftInline(BaseLength, EAllowShrinking::No);
+    }
+
+    return true;
+}
+
+uint8 FMCPSchemaValidator::ParseTypeName(const FString &TypeName)
+{
+    if (TypeName == TEXT("object"))
+    {
+        return Type_Object;
+    }
+    if (TypeName == TEXT("array"))
+    {
+        return Type_Array;
+    }
+    if (TypeName == TEXT("string"))
+    {
+        return Type_String;
+    }
+    if (TypeName == TEXT("number"))
+    {
+        return Type_Number;
+    }
+    if (TypeName == TEXT("integer"))
+    {
+        return Type_Integer;
+    }
+    if (TypeName == TEXT("boolean"))
+    {
+        return Type_Boolean;
+    }
+    if (TypeName == TEXT("null"))
+    {
+        return Type_Null;
+    }
+    return Type_Any;
+}
+
+FString FMCPSchemaValidator::DescribeTypeMask(uint8 TypeMask)
+{
+    TArray<FString> Names;
+    if (TypeMask & Type_Object)
+    {
+        Names.Add(TEXT("object"));
+    }
+    if (TypeMask & Type_Array)
+    {
+        Names.Add(TEXT("array"));
+    }
+    if (TypeMask & Type_String)
+    {
+        Names.Add(TEXT("string"));
+    }
+    if (TypeMask & Type_Number)
+    {
+        Names.Add(TEXT("number"));
+    }
+    else if (TypeMask & Type_Integer)
+    {
+        Names.Add(TEXT("integer"));
+    }
+    if (TypeMask & Type_Boolean)
+    {
+        Names.Add(TEXT("boolean"));
+    }
+    if (TypeMask & Type_Null)
+    {
+        Names.Add(TEXT("null"));
+    }
+    return FString::Join(Names, TEXT(" or "));
+}
+
+FString FMCPSchemaValidator::EscapePointerToken(const FString &Token)
+{
+    if (!Token.Contains(TEXT("~")) && !Token.Contains(TEXT("/")))
+    {
+        return Token;
+    }
+    return Token.Replace(TEXT("~"), TEXT("~0")).Replace(TEXT("/"), TEXT("~1"));
+}
@@ -0,0 +1,441 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPServerMetrics.h"
+#include "MCPTrace.h"
+#include "MCPConstants.h"
+
+namespace
+{
+    /** 每个 2 的幂区间的子桶数为 2^SUB_BUCKET_BITS */
+    constexpr int32 SUB_BUCKET_BITS = 5;
+    constexpr int32 SUB_BUCKET_COUNT = 1 << SUB_BUCKET_BITS;
+
+    /** 记录上限 2^36 微秒(约 19 小时) */
+    constexpr int32 MAX_VALUE_BITS = 36;
+    constexpr int32 BUCKET_COUNT = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    /** Prometheus 输出的分位数 */
+    constexpr double EXPORTED_QUANTILES[] = {0.5, 0.9, 0.99};
+
+    /** Prometheus 标签值转义 */
+    FString EscapeLabel(const FString &Value)
+    {
+        return Value.Replace(TEXT("\\"), TEXT("\\\\")).Replace(TEXT("\""), TEXT("\\\"")).Replace(TEXT("\n"), TEXT("\\n"));
+    }
+}
+
+// ============================================================================
+// FMCPLatencyHistogram
+// ============================================================================
+
+void FMCPLatencyHistogram::Record(double Seconds)
+{
+    Seconds = FMath::Max(Seconds, 0.0);
+    if (Buckets.Num() == 0)
+    {
+        Buckets.SetNumZeroed(BUCKET_COUNT);
+    }
+
+    const uint64 Microseconds = static_cast<uint64>(Seconds * 1000000.0);
+    ++Buckets[GetBucketIndex(Microseconds)];
+    ++Count;
+    SumSeconds += Seconds;
+    MaxSeconds = FMath::Max(MaxSeconds, Seconds);
+}
+
+void FMCPLatencyHistogram::Reset()
+{
+    Buckets.Empty();
+    Count = 0;
+    SumSeconds = 0.0;
+    MaxSeconds = 0.0;
+}
+
+double FMCPLatencyHistogram::GetPercentile(double Percentile) const
+{
+    if (Count == 0)
+    {
+        return 0.0;
+    }
+
+    const uint64 Target = FMath::Max<uint64>(1, static_cast<uint64>(FMath::CeilToDouble(FMath::Clamp(Percentile, 0.0, 1.0) * Count)));
+    uint64 Cumulative = 0;
+    for (int32 Index = 0; Index < Buckets.Num(); ++Index)
+    {
+        Cumulative += Buckets[Index];
+        if (Cumulative >= Target)
+        {
+            // 桶中点可能超过实际最大值
+            return FMath::Min(GetBucketMidpoint(Index) / 1000000.0, MaxSeconds);
+        }
+    }
+    return MaxSeconds;
+}
+
+TSharedPtr<FJsonObject> FMCPLatencyHistogram::ToJson() const
+{
+    TSharedPtr<FJsonObject> Json = MakeShared<FJsonObject>();
+    Json->SetNumberField("count", static_cast<double>(Count));
+    Json->SetNumberField("mean_ms", Count > 0 ? SumSeconds * 1000.0 / Count : 0.0);
+    Json->SetNumberField("p50_ms", GetPercentile(0.5) * 1000.0);
+    Json->SetNumberField("p90_ms", GetPercentile(0.9) * 1000.0);
+    Json->SetNumberField("p99_ms", GetPercentile(0.99) * 1000.0);
+    Json->SetNumberField("max_ms", MaxSeconds * 1000.0);
+    return Json;
+}
+
+int32 FMCPLatencyHistogram::GetBucketIndex(uint64 Microseconds)
+{
+    Microseconds = FMath::Min<uint64>(Microseconds, (uint64(1) << MAX_VALUE_BITS) - 1);
+    if (Microseconds < SUB_BUCKET_COUNT)
+    {
+        return static_cast<int32>(Microseconds);
+    }
+
+    // 最高位决定区间,其后 SUB_BUCKET_BITS 位决定子桶
+    const int32 HighestBit = static_cast<int32>(FMath::FloorLog2_64(Microseconds));
+    const int32 Shift = HighestBit - SUB_BUCKET_BITS;
+    const int32 SubBucket = static_cast<int32>(Microseconds >> Shift) - SUB_BUCKET_COUNT;
+    return (Shift + 1) * SUB_BUCKET_COUNT + SubBucket;
+}
+
+double FMCPLatencyHistogram::GetBucketMidpoint(int32 Index)
+{
+    if (Index < SUB_BUCKET_COUNT)
+    {
+        return Index;
+    }
+
+    const int32 Shift = Index / SUB_BUCKET_COUNT - 1;
+    const double Lower = static_cast<double>(static_cast<uint64>(SUB_BUCKET_COUNT + Index % SUB_BUCKET_COUNT) << Shift);
+    const double Width = static_cast<double>(uint64(1) << Shift);
+    return Lower + Width * 0.5;
+}
+
+// ============================================================================
+// FMCPServerMetrics
+// ============================================================================
+
+FMCPServerMetrics::FMCPServerMetrics()
+    : RecentCallsHead(0), FrameHistoryHead(0), GameThreadWorkDepth(0), GameThreadWorkStart(0.0), FrameGameThreadSeconds(0.0),
+      GameThreadSecondsTotal(0.0), RequestsTotal(0), MessagesTotal(0), BytesReceived(0), BytesSent(0), ConnectionsTotal(0), ActiveConnections(0),
+      StartTime(FPlatformTime::Seconds())
+{
+}
+
+void FMCPServerMetrics::RecordRequest(const FString &Command)
+{
+    ++Commands.FindOrAdd(Command).Requests;
+    ++RequestsTotal;
+}
+
+void FMCPServerMetrics::RecordError(const FString &Command)
+{
+    ++Commands.FindOrAdd(Command).Errors;
+}
+
+void FMCPServerMetrics::RecordLatency(const FString &Command, EMCPLatencyPhase Phase, double Seconds)
+{
+    Commands.FindOrAdd(Command).Phases[static_cast<int32>(Phase)].Record(Seconds);
+}
+
+void FMCPServerMetrics::RecordCompletion(const FString &Command, int32 RequestId, double LatencySeconds, bool bError)
+{
+    FMCPCompletedCall Call;
+    Call.Command = Command;
+    Call.RequestId = RequestId;
+    Call.LatencySeconds = LatencySeconds;
+    Call.bError = bError;
+    Call.Time = FDateTime::Now();
+
+    if (RecentCalls.Num() < MCPConstants::RECENT_CALLS_CAPACITY)
+    {
+        RecentCalls.Add(MoveTemp(Call));
+        return;
+    }
+
+    RecentCalls[RecentCallsHead] = MoveTemp(Call);
+    RecentCallsHead = (RecentCallsHead + 1) % MCPConstants::RECENT_CALLS_CAPACITY;
+}
+
+void FMCPServerMetrics::BeginGameThreadWork()
+{
+    if (GameThreadWorkDepth++ == 0)
+    {
+        GameThreadWorkStart = FPlatformTime::Seconds();
+    }
+}
+
+void FMCPServerMetrics::EndGameThreadWork()
+{
+    check(GameThreadWorkDepth > 0);
+    if (--GameThreadWorkDepth == 0)
+    {
+        FrameGameThreadSeconds += FPlatformTime::Seconds() - GameThreadWorkStart;
+    }
+}
+
+void FMCPServerMetrics::EndFrame(double FrameSeconds)
+{
+    FMCPFrameSample Sample;
+    Sample.FrameMilliseconds = static_cast<float>(FrameSeconds * 1000.0);
+    Sample.MCPMilliseconds = static_cast<float>(FrameGameThreadSeconds * 1000.0);
+
+    GameThreadSecondsTotal += FrameGameThreadSeconds;
+    FrameGameThreadSeconds = 0.0;
+
+    if (FrameHistory.Num() < MCPConstants::FRAME_HISTORY_LENGTH)
+    {
+        FrameHistory.Add(Sample);
+        return;
+    }
+
+    FrameHistory[FrameHistoryHead] = Sample;
+    FrameHistoryHead = (FrameHistoryHead + 1) % MCPConstants::FRAME_HISTORY_LENGTH;
+}
+
+void FMCPServerMetrics::GetCommandSummaries(TArray<FMCPCommandSummary> &OutSummaries) const
+{
+    OutSummaries.Reset(Commands.Num());
+    for (const auto &Pair : Commands)
+    {
+        const FMCPLatencyHistogram &Total = Pair.Value.Phases[static_cast<int32>(EMCPLatencyPhase::Total)];
+
+        FMCPCommandSummary &Summary = OutSummaries.AddDefaulted_GetRef();
+        Summary.Command = Pair.Key;
+        Summary.Requests = Pair.Value.Requests;
+        Summary.Errors = Pair.Value.Errors;
+        Summary.P50Seconds = Total.GetPercentile(0.5);
+        Summary.P99Seconds = Total.GetPercentile(0.99);
+    }
+
+    OutSummaries.Sort([](const FMCPCommandSummary &A, const FMCPCommandSummary &B)
+                      { return A.Command < B.Command; });
+}
+
+void FMCPServerMetrics::GetSlowestRecentCalls(int32 Count, TArray<FMCPCompletedCall> &OutCalls) const
+{
+    OutCalls = RecentCalls;
+    OutCalls.Sort([](const FMCPCompletedCall &A, const FMCPCompletedCall &B)
+                  { return A.LatencySeconds > B.LatencySeconds; });
+    if (OutCalls.Num() > Count)
+    {
+        OutCalls.SetNum(Count);
+    }
+}
+
+void FMCPServerMetrics::GetFrameHistory(TArray<FMCPFrameSample> &OutSamples) const
+{
+    OutSamples.Reset(FrameHistory.Num());
+    for (int32 Offset = 0; Offset < FrameHistory.Num(); ++Offset)
+    {
+        OutSamples.Add(FrameHistory[(FrameHistoryHead + Offset) % FrameHistory.Num()]);
+    }
+}
+
+TSharedPtr<FJsonObject> FMCPServerMetrics::CreateSnapshot(const FString &CommandFilter) const
+{
+    TSharedPtr<FJsonObject> Snapshot = MakeShared<FJsonObject>();
+    Snapshot->SetNumberField("uptime_seconds", FPlatformTime::Seconds() - StartTime);
+    Snapshot->SetNumberField("active_connections", ActiveConnections);
+    Snapshot->SetNumberField("connections_total", static_cast<double>(ConnectionsTotal));
+    Snapshot->SetNumberField("messages_total", static_cast<double>(MessagesTotal));
+    Snapshot->SetNumberField("bytes_received", static_cast<double>(BytesReceived));
+    Snapshot->SetNumberField("bytes_sent", static_cast<double>(BytesSent));
+
+    // 最近帧中 MCP 占用的游戏线程时间
+    double FrameSumMilliseconds = 0.0;
+    double FrameMaxMilliseconds = 0.0;
+    for (const FMCPFrameSample &Sample : FrameHistory)
+    {
+        FrameSumMilliseconds += Sample.MCPMilliseconds;
+        FrameMaxMilliseconds = FMath::Max<double>(FrameMaxMilliseconds, Sample.MCPMilliseconds);
+    }
+
+    TSharedPtr<FJsonObject> GameThread = MakeShared<FJsonObject>();
+    GameThread->SetNumberField("total_ms", GameThreadSecondsTotal * 1000.0);
+    GameThread->SetNumberField("recent_frames", FrameHistory.Num());
+    GameThread->SetNumberField("recent_avg_ms_per_frame", FrameHistory.Num() > 0 ? FrameSumMilliseconds / FrameHistory.Num() : 0.0);
+    GameThread->SetNumberField("recent_max_ms_per_frame", FrameMaxMilliseconds);
+    Snapshot->SetObjectField("game_thread", GameThread);
+
+    uint64 ErrorsTotal = 0;
+    TSharedPtr<FJsonObject> Tools = MakeShared<FJsonObject>();
+    for (const auto &Pair : Commands)
+    {
+        ErrorsTotal += Pair.Value.Errors;
+
+        if (!CommandFilter.IsEmpty() && Pair.Key != CommandFilter)
+        {
+            continue;
+        }
+
+        TSharedPtr<FJsonObject> Tool = MakeShared<FJsonObject>();
+        Tool->SetNumberField("requests", static_cast<double>(Pair.Value.Requests));
+        Tool->SetNumberField("errors", static_cast<double>(Pair.Value.Errors));
+
+        TSharedPtr<FJsonObject> Latency = MakeShared<FJsonObject>();
+        for (int32 PhaseIndex = 0; PhaseIndex < static_cast<int32>(EMCPLatencyPhase::Count); ++PhaseIndex)
+        {
+            Latency->SetObjectField(GetPhaseName(static_cast<EMCPLatencyPhase>(PhaseIndex)), Pair.Value.Phases[PhaseIndex].ToJson());
+        }
+        Tool->SetObjectField("latency", Latency);
+        Tools->SetObjectField(Pair.Key, Tool);
+    }
+
+    Snapshot->SetNumberField("requests_total", static_cast<double>(RequestsTotal));
+    Snapshot->SetNumberField("errors_total", static_cast<double>(ErrorsTotal));
+    Snapshot->SetObjectField("tools", Tools);
+    return Snapshot;
+}
+
+FString FMCPServerMetrics::FormatPrometheus() const
+{
+    TStringBuilder<4096> Output;
+
+    auto AppendMetric = [&Output](const TCHAR *Name, const TCHAR *Type, const TCHAR *Help, double Value)
+    {
+        Output.Appendf(TEXT("# HELP %s %s\n# TYPE %s %s\n%s %.17g\n"), Name, Help, Name, Type, Name, Value);
+    };
+
+    AppendMetric(TEXT("unreal_mcp_uptime_seconds"), TEXT("gauge"), TEXT("Seconds since metrics collection started."),
+                 FPlatformTime::Seconds() - StartTime);
+    AppendMetric(TEXT("unreal_mcp_active_connections"), TEXT("gauge"), TEXT("Currently connected clients."), ActiveConnections);
+    AppendMetric(TEXT("unreal_mcp_connections_total"), TEXT("counter"), TEXT("Accepted client connections."), ConnectionsTotal);
+    AppendMetric(TEXT("unreal_mcp_messages_total"), TEXT("counter"), TEXT("Complete request messages received."), MessagesTotal);
+    AppendMetric(TEXT("unreal_mcp_received_bytes_total"), TEXT("counter"), TEXT("Bytes read from client sockets."), BytesReceived);
+    AppendMetric(TEXT("unreal_mcp_sent_bytes_total"), TEXT("counter"), TEXT("Bytes written to client sockets."), BytesSent);
+    AppendMetric(TEXT("unreal_mcp_game_thread_seconds_total"), TEXT("counter"), TEXT("Game thread time spent in MCP work."),
+                 GameThreadSecondsTotal);
+
+    // 工具名排序后输出,便于比较
+    TArray<FString> CommandNames;
+    Commands.GetKeys(CommandNames);
+    CommandNames.Sort();
+
+    Output.Append(TEXT("# HELP unreal_mcp_requests_total Tool requests dispatched.\n# TYPE unreal_mcp_requests_total counter\n"));
+    for (const FString &Name : CommandNames)
+    {
+        Output.Appendf(TEXT("unreal_mcp_requests_total{tool=\"%s\"} %llu\n"), *EscapeLabel(Name), Commands[Name].Requests);
+    }
+
+    Output.Append(TEXT("# HELP unreal_mcp_errors_total Tool requests that ended in an error.\n# TYPE unreal_mcp_errors_total counter\n"));
+    for (const FString &Name : CommandNames)
+    {
+        Output.Appendf(TEXT("unreal_mcp_errors_total{tool=\"%s\"} %llu\n"), *EscapeLabel(Name), Commands[Name].Errors);
+    }
+
+    Output.Append(TEXT("# HELP unreal_mcp_request_duration_seconds Tool request latency by phase.\n# TYPE unreal_mcp_request_duration_seconds summary\n"));
+    for (const FString &Name : CommandNames)
+    {
+        const FString Tool = EscapeLabel(Name);
+        const FCommandMetrics &Metrics = Commands[Name];
+
+        for (int32 PhaseIndex = 0; PhaseIndex < static_cast<int32>(EMCPLatencyPhase::Count); ++PhaseIndex)
+        {
+            const FMCPLatencyHistogram &Histogram = Metrics.Phases[PhaseIndex];
+            if (Histogram.GetCount() == 0)
+            {
+                continue;
+            }
+
+            const TCHAR *Phase = GetPhaseName(static_cast<EMCPLatencyPhase>(PhaseIndex));
+            for (const double Quantile : EXPORTED_QUANTILES)
+            {
+                Output.Appendf(TEXT("unreal_mcp_request_duration_seconds{tool=\"%s\",phase=\"%s\",quantile=\"%g\"} %.9g\n"),
+                               *Tool, Phase, Quantile, Histogram.GetPercentile(Quantile));
+            }
+            Output.Appendf(TEXT("unreal_mcp_request_duration_seconds_sum{tool=\"%s\",phase=\"%s\"} %.9g\n"), *Tool, Phase, Histogram.GetSumSeconds());
+            Output.Appendf(TEXT("unreal_mcp_request_duration_seconds_count{tool=\"%s\",phase=\"%s\"} %llu\n"), *Tool, Phase, Histogram.GetCount());
+        }
+    }
+
+    return FString(Output.ToView());
+}
+
+void FMCPServerMetrics::Reset()
+{
+    // 游戏线程工作的嵌套状态不清空: server_stats 的重置本身就在计时作用域内
+    Commands.Empty();
+    RecentCalls.Empty();
+    RecentCallsHead = 0;
+    FrameHistory.Empty();
+    FrameHistoryHead = 0;
+    GameThreadSecondsTotal = 0.0;
+    RequestsTotal = 0;
+    MessagesTotal = 0;
+    BytesReceived = 0;
+    BytesSent = 0;
+    ConnectionsTotal = 0;
+    StartTime = FPlatformTime::Seconds();
+}
+
+const TCHAR *FMCPServerMetrics::GetPhaseName(EMCPLatencyPhase Phase)
+{
+    switch (Phase)
+    {
+    case EMCPLatencyPhase::QueueWait:
+        return TEXT("queue_wait");
+    case EMCPLatencyPhase::Execute:
+        return TEXT("execute");
+    case EMCPLatencyPhase::Serialize:
+        return TEXT("serialize");
+    case EMCPLatencyPhase::Send:
+        return TEXT("send");
+    case EMCPLatencyPhase::Total:
+        return TEXT("total");
+    default:
+        return TEXT("unknown");
+    }
+}
+
+// ============================================================================
+// FMCPRequestTimer
+// ============================================================================
+
+FMCPRequestTimer::FMCPRequestTimer(const TSharedPtr<FMCPServerMetrics> &InMetrics, const FString &InCommand, double InReceiveTime,
+                                   double DispatchTime)
+    : Metrics(InMetrics), Command(InCommand), ReceiveTime(InReceiveTime), LastMarkTime(DispatchTime), RequestId(MCPTrace::NO_REQUEST_ID),
+      bErrorRecorded(false)
+{
+    if (Metrics.IsValid())
+    {
+        Metrics->RecordRequest(Command);
+        Metrics->RecordLatency(Command, EMCPLatencyPhase::QueueWait, DispatchTime - InReceiveTime);
+    }
+}
+
+void FMCPRequestTimer::MarkError()
+{
+    if (bErrorRecorded)
+    {
+        return;
+    }
+
+    bErrorRecorded = true;
+    if (Metrics.IsValid())
+    {
+        Metrics->RecordError(Command);
+    }
+}
+
+void FMCPRequestTimer::MarkSent()
+{
+    MarkPhase(EMCPLatencyPhase::Send);
+    if (Metrics.IsValid())
+    {
+        const double LatencySeconds = LastMarkTime - ReceiveTime;
+        Metrics->RecordLatency(Command, EMCPLatencyPhase::Total, LatencySeconds);
+        Metrics->RecordCompletion(Command, RequestId, LatencySeconds, bErrorRecorded);
+    }
+}
+
+void FMCPRequestTimer::MarkPhase(EMCPLatencyPhase Phase)
+{
+    const double Now = FPlatformTime::Seconds();
+    if (Metrics.IsValid())
+    {
+        Metrics->RecordLatency(Command, Phase, Now - LastMarkTime);
+    }
+    LastMarkTime = Now;
+}
@@ -18,6 +18,12 @@ UMCPSettings::UMCPSettings()
     ServerTickInterval = MCPConstants::DEFAULT_TICK_INTERVAL_SECONDS;
     MaxActorsInSceneInfo = MCPConstants::MAX_ACTORS_IN_SCENE_INFO;
     CommandExecutionTimeout = MCPConstants::MAX_COMMAND_EXECUTION_TIME;
+    bEnableCompression = MCPConstants::DEFAULT_ENABLE_COMPRESSION;
+    CompressionThresholdBytes = MCPConstants::DEFAULT_COMPRESSION_THRESHOLD_BYTES;
+    bEnableRequestJournal = MCPConstants::DEFAULT_ENABLE_REQUEST_JOURNAL;
+    JournalMaxFileSizeMB = MCPConstants::DEFAULT_JOURNAL_MAX_FILE_SIZE_MB;
+    JournalMaxFiles = MCPConstants::DEFAULT_JOURNAL_MAX_FILES;
+    JournalPayloadSampleRate = MCPConstants::DEFAULT_JOURNAL_PAYLOAD_SAMPLE_RATE;
     bAutoStartOnEditorLaunch = false;
 }
 
@@ -97,6 +103,11 @@ void UMCPSettings::PostEditChangeProperty(FPropertyChangedEvent &PropertyChanged
         MCP_LOG_INFO("Full JSON message logging %s", bLogFullJsonMessages ? TEXT("enabled") : TEXT("disabled"));
     }
 
+    if (PropertyName == GET_MEMBER_NAME_CHECKED(UMCPSettings, bEnableRequestJournal))
+    {
+        MCP_LOG_INFO("Request journal %s (restart server to apply)", bEnableRequestJournal ? TEXT("enabled") : TEXT("disabled"));
+    }
+
     // 保存设置
     SaveConfig();
 }
@@ -153,6 +164,36 @@ bool UMCPSettings::ValidateSettings(FString &OutErrorMessage) const
         return false;
     }
 
+    // 验证压缩阈值
+    if (CompressionThresholdBytes < 256 || CompressionThresholdBytes > 1048576)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid compression threshold %d. Must be between 256 and 1048576 bytes."),
+                                          CompressionThresholdBytes);
+        return false;
+    }
+
+    // 验证请求日志设置
+    if (JournalMaxFileSizeMB < 1 || JournalMaxFileSizeMB > 1024)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid journal max file size %d MB. Must be between 1 and 1024."),
+                                          JournalMaxFileSizeMB);
+        return false;
+    }
+
+    if (JournalMaxFiles < 1 || JournalMaxFiles > 100)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid journal max files %d. Must be between 1 and 100."),
+                                          JournalMaxFiles);
+        return false;
+    }
+
+    if (JournalPayloadSampleRate < 0.0f || JournalPayloadSampleRate > 1.0f)
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid journal payload sample rate %.2f. Must be between 0.0 and 1.0."),
+                                          JournalPayloadSampleRate);
+        return false;
+    }
+
     OutErrorMessage.Empty();
     return true;
 }
@@ -168,6 +209,13 @@ void UMCPSettings::ResetToDefaults()
     ServerTickInterval = MCPConstants::DEFAULT_TICK_INTERVAL_SECONDS;
     MaxActorsInSceneInfo = MCPConstants::MAX_ACTORS_IN_SCENE_INFO;
     CommandExecutionTimeout = MCPConstants::MAX_COMMAND_EXECUTION_TIME;
+    bEnableCompression = MCPConstants::DEFAULT_ENABLE_COMPRESSION;
+    CompressionThresholdBytes = MCPConstants::DEFAULT_COMPRESSION_THRESHOLD_BYTES;
+    bEnableRequestJournal = MCPConstants::DEFAULT_ENABLE_REQUEST_JOURNAL;
+    JournalMaxFileSizeMB = MCPConstants::DEFAULT_JOURNAL_MAX_FILE_SIZE_MB;
+    JournalMaxFiles = MCPConstants::DEFAULT_JOURNAL_MAX_FILES;
+    JournalPayloadSampleRate = MCPConstants::DEFAULT_JOURNAL_PAYLOAD_SAMPLE_RATE;
+    SearchIndexedTags.Empty();
     bAutoStartOnEditorLaunch = false;
 
     SaveConfig();
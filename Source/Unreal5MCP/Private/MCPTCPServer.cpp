@@ -2,6 +2,14 @@
 
 #include "MCPTCPServer.h"
 #include "MCPCommandHandlers.h"
+#include "MCPImportJobManager.h"
+#include "MCPResourceManager.h"
+#include "MCPSaveQueue.h"
+#include "MCPSchemaValidator.h"
+#include "MCPJsonPullParser.h"
+#include "MCPBinaryCodec.h"
+#include "MCPTrace.h"
+#include "MCPRequestJournal.h"
 #include "MCPConstants.h"
 #include "MCPSettings.h"
 #include "Unreal5MCP.h"
@@ -15,9 +23,17 @@
 #include "Containers/Ticker.h"
 #include "Json.h"
 #include "JsonObjectConverter.h"
+#include "Hash/xxhash.h"
+#include "Misc/Compression.h"
+#include "Async/Async.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/App.h"
 
 FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig &InConfig)
-    : Config(InConfig), Listener(nullptr), bRunning(false)
+    : Config(InConfig), Listener(nullptr), NextConnectionId(1), bRunning(false), LifetimeToken(MakeShared<bool>(true)),
+      SaveQueue(MakeShared<FMCPSaveQueue>()), Metrics(MakeShared<FMCPServerMetrics>()), CurrentMessageReceiveTime(0.0),
+      CurrentMessageFormat(EMCPWireFormat::Json), CurrentResponseEncoding(EMCPContentEncoding::Identity),
+      CurrentResponseFormat(EMCPWireFormat::Json)
 {
     // ============================================================================
     // 注册基础命令处理器
@@ -30,10 +46,12 @@ FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig &InConfig)
     // ============================================================================
     // 注册蓝图命令处理器
     // ============================================================================
-    RegisterCommandHandler(MakeShared<FMCPCreateBlueprintHandler>());
+    RegisterCommandHandler(MakeShared<FMCPCreateBlueprintHandler>(SaveQueue));
     RegisterCommandHandler(MakeShared<FMCPGetBlueprintInfoHandler>());
-    RegisterCommandHandler(MakeShared<FMCPModifyBlueprintHandler>());
+    RegisterCommandHandler(MakeShared<FMCPModifyBlueprintHandler>(SaveQueue));
+    RegisterCommandHandler(MakeShared<FMCPEditBlueprintHandler>(SaveQueue));
     RegisterCommandHandler(MakeShared<FMCPCompileBlueprintHandler>());
+    RegisterCommandHandler(MakeShared<FMCPCompileBlueprintsHandler>());
 
     // ============================================================================
     // 注册场景编辑命令处理器
@@ -43,13 +61,24 @@ FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig &InConfig)
     RegisterCommandHandler(MakeShared<FMCPCreateLightHandler>());
     RegisterCommandHandler(MakeShared<FMCPSelectActorHandler>());
     RegisterCommandHandler(MakeShared<FMCPGetSelectedActorsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPSelectActorsHandler>());
 
     // ============================================================================
     // 注册资源管理命令处理器
     // ============================================================================
-    RegisterCommandHandler(MakeShared<FMCPImportAssetHandler>());
-    RegisterCommandHandler(MakeShared<FMCPCreateMaterialHandler>());
+    TSharedPtr<FMCPImportJobManager> ImportJobManager = MakeShared<FMCPImportJobManager>(SaveQueue);
+    RegisterCommandHandler(MakeShared<FMCPImportAssetHandler>(ImportJobManager));
+    RegisterCommandHandler(MakeShared<FMCPImportStatusHandler>(ImportJobManager));
+    RegisterCommandHandler(MakeShared<FMCPCancelImportHandler>(ImportJobManager));
+    RegisterCommandHandler(MakeShared<FMCPCreateMaterialHandler>(SaveQueue));
+    RegisterCommandHandler(MakeShared<FMCPSaveDirtyHandler>(SaveQueue));
     RegisterCommandHandler(MakeShared<FMCPListAssetsHandler>());
+    RegisterCommandHandler(MakeShared<FMCPSearchAssetsHandler>());
+
+    TSharedPtr<FMCPAssetDependencyGraph> DependencyGraph = MakeShared<FMCPAssetDependencyGraph>();
+    DependencyGraph->Initialize();
+    RegisterCommandHandler(MakeShared<FMCPGetDependenciesHandler>(DependencyGraph));
+    RegisterCommandHandler(MakeShared<FMCPGetReferencersHandler>(DependencyGraph));
 
     // ============================================================================
     // 注册批量操作命令处理器
@@ -58,6 +87,31 @@ FMCPTCPServer::FMCPTCPServer(const FMCPTCPServerConfig &InConfig)
     RegisterCommandHandler(MakeShared<FMCPBatchModifyHandler>());
     RegisterCommandHandler(MakeShared<FMCPBatchDeleteHandler>());
 
+    // ============================================================================
+    // 注册服务器命令处理器
+    // ============================================================================
+    RegisterCommandHandler(MakeShared<FMCPServerStatsHandler>(Metrics));
+
+    // ============================================================================
+    // 注册资源
+    // ============================================================================
+    // 通知经由订阅时的连接发送,连接已断开或改用 HTTP 时由资源管理器移除订阅
+    ResourceManager = MakeShared<FMCPResourceManager>([this](FSocket *Socket, const TSharedPtr<FJsonObject> &Notification)
+                                                      {
+        const FMCPClientConnection *Connection = FindClientConnection(Socket);
+        if (!Connection || Connection->bHttp)
+        {
+            return false;
+        }
+        SendNotificationLine(Socket, Notification);
+        return true; });
+    ResourceManager->RegisterResource(MCPConstants::RESOURCE_URI_SCENE, TEXT("Scene"),
+                                      TEXT("Actors in the current editor level"), CommandHandlers.FindRef(TEXT("get_scene_info")));
+    ResourceManager->RegisterResource(MCPConstants::RESOURCE_URI_SELECTION, TEXT("Selection"),
+                                      TEXT("Actors currently selected in the editor"), CommandHandlers.FindRef(TEXT("get_selected_actors")));
+    ResourceManager->RegisterResource(MCPConstants::RESOURCE_URI_CAMERA, TEXT("Camera"),
+                                      TEXT("Location and rotation of the active editor viewport camera"), CommandHandlers.FindRef(TEXT("get_camera")));
+
     MCP_LOG_INFO("MCP Server initialized with %d command handlers", CommandHandlers.Num());
 }
 
@@ -72,6 +126,8 @@ void FMCPTCPServer::RegisterCommandHandler(TSharedPtr<IMCPCommandHandler> Handle
     {
         FString CommandName = Handler->GetCommandName();
         CommandHandlers.Add(CommandName, Handler);
+        CompileValidator(Handler);
+        ToolsListCache.Reset();
         MCP_LOG_INFO("Registered command handler: %s", *CommandName);
     }
 }
@@ -80,6 +136,8 @@ void FMCPTCPServer::UnregisterCommandHandler(const FString &CommandName)
 {
     if (CommandHandlers.Remove(CommandName) > 0)
     {
+        Validators.Remove(CommandName);
+        ToolsListCache.Reset();
         MCP_LOG_INFO("Unregistered command handler: %s", *CommandName);
     }
 }
@@ -99,6 +157,8 @@ bool FMCPTCPServer::RegisterExternalCommandHandler(TSharedPtr<IMCPCommandHandler
     }
 
     CommandHandlers.Add(CommandName, Handler);
+    CompileValidator(Handler);
+    ToolsListCache.Reset();
     MCP_LOG_INFO("Registered external command handler: %s", *CommandName);
     return true;
 }
@@ -107,6 +167,8 @@ bool FMCPTCPServer::UnregisterExternalCommandHandler(const FString &CommandName)
 {
     if (CommandHandlers.Remove(CommandName) > 0)
     {
+        Validators.Remove(CommandName);
+        ToolsListCache.Reset();
         MCP_LOG_INFO("Unregistered external command handler: %s", *CommandName);
         return true;
     }
@@ -115,6 +177,42 @@ bool FMCPTCPServer::UnregisterExternalCommandHandler(const FString &CommandName)
     return false;
 }
 
+void FMCPTCPServer::CompileValidator(const TSharedPtr<IMCPCommandHandler> &Handler)
+{
+    const FString CommandName = Handler->GetCommandName();
+    TSharedPtr<FMCPSchemaValidator> Validator = FMCPSchemaValidator::Compile(Handler->GetInputSchema());
+    if (Validator.IsValid())
+    {
+        Validators.Add(CommandName, Validator);
+    }
+    else
+    {
+        Validators.Remove(CommandName);
+        MCP_LOG_WARNING("Could not compile input schema for %s, requests will not be validated", *CommandName);
+    }
+}
+
+bool FMCPTCPServer::ValidateCommandParams(const FString &CommandName, const TSharedPtr<FJsonObject> &Params,
+                                          FString &OutPointer, FString &OutMessage) const
+{
+    const TSharedPtr<FMCPSchemaValidator> *Validator = Validators.Find(CommandName);
+    if (!Validator)
+    {
+        return true;
+    }
+
+    FMCPSchemaValidator::FError Error;
+    if ((*Validator)->Validate(Params, Error))
+    {
+        return true;
+    }
+
+    OutPointer = Error.Pointer;
+    OutMessage = Error.Message;
+    MCP_LOG_WARNING("Rejected %s: %s at '%s'", *CommandName, *OutMessage, *OutPointer);
+    return false;
+}
+
 bool FMCPTCPServer::Start()
 {
     if (bRunning)
@@ -134,6 +232,9 @@ bool FMCPTCPServer::Start()
         return false;
     }
 
+    // 监听线程已在运行,立即绑定以免错过早到的连接
+    Listener->OnConnectionAccepted().BindRaw(this, &FMCPTCPServer::HandleConnectionAccepted);
+
     // 清空现有客户端连接
     ClientConnections.Empty();
 
@@ -141,9 +242,28 @@ bool FMCPTCPServer::Start()
     TickerHandle = FTSTicker::GetCoreTicker().AddTicker(
         FTickerDelegate::CreateRaw(this, &FMCPTCPServer::Tick),
         Config.TickIntervalSeconds);
+    EndFrameHandle = FCoreDelegates::OnEndFrame.AddRaw(this, &FMCPTCPServer::HandleEndFrame);
+
+    ResourceManager->Initialize();
+
+    if (Config.bEnableRequestJournal && !MCPConstants::PluginLogsPath.IsEmpty())
+    {
+        FMCPRequestJournalConfig JournalConfig;
+        JournalConfig.Directory = MCPConstants::PluginLogsPath;
+        JournalConfig.MaxFileBytes = static_cast<int64>(Config.JournalMaxFileSizeMB) * 1048576;
+        JournalConfig.MaxFiles = Config.JournalMaxFiles;
+        JournalConfig.PayloadSampleRate = Config.JournalPayloadSampleRate;
+
+        Journal = MakeUnique<FMCPRequestJournal>(JournalConfig);
+        if (!Journal->Start())
+        {
+            // 日志不可用不影响服务器运行
+            Journal.Reset();
+        }
+    }
 
     bRunning = true;
-    MCP_LOG_INFO("MCP Server started successfully on port %d", Config.Port);
+    MCP_LOG_INFO("MCP Server started successfully on port %d", GetListenPort());
     return true;
 }
 
@@ -152,18 +272,46 @@ void FMCPTCPServer::Stop()
     // 清理所有客户端连接
     CleanupAllClientConnections();
 
+    if (ResourceManager.IsValid())
+    {
+        ResourceManager->Shutdown();
+    }
+
+    // 写完缓冲区中的记录后关闭日志文件
+    Journal.Reset();
+
+    // 保存尚在队列中的包(编辑器退出时由编辑器自己提示)
+    if (SaveQueue.IsValid() && SaveQueue->GetNumPending() > 0 && !IsEngineExitRequested())
+    {
+        SaveQueue->Flush();
+    }
+
     if (Listener)
     {
         delete Listener;
         Listener = nullptr;
     }
 
+    // 监听线程已停止,关闭尚未取出的连接
+    TPair<FSocket *, FIPv4Endpoint> Accepted;
+    while (AcceptedConnections.Dequeue(Accepted))
+    {
+        Accepted.Key->Close();
+        ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Accepted.Key);
+    }
+
     if (TickerHandle.IsValid())
     {
         FTSTicker::GetCoreTicker().RemoveTicker(TickerHandle);
         TickerHandle.Reset();
     }
 
+    if (EndFrameHandle.IsValid())
+    {
+        FCoreDelegates::OnEndFrame.Remove(EndFrameHandle);
+        EndFrameHandle.Reset();
+    }
+
     bRunning = false;
     MCP_LOG_INFO("MCP Server stopped");
 }
@@ -173,22 +321,63 @@ bool FMCPTCPServer::Tick(float DeltaTime)
     if (!bRunning)
         return false;
 
+    FMCPGameThreadScope GameThreadScope(Metrics);
+
     // 正常处理
     ProcessPendingConnections();
     ProcessClientData();
+    FlushAllSendQueues();
     CheckClientTimeouts(DeltaTime);
+    Metrics->SetActiveConnections(ClientConnections.Num());
+
+    if (UE_TRACE_CHANNELEXPR_IS_ENABLED(MCPChannel))
+    {
+        MCPTrace::SetSendQueueDepth(GetSendQueueDepth());
+    }
     return true;
 }
 
-void FMCPTCPServer::ProcessPendingConnections()
+void FMCPTCPServer::HandleEndFrame()
 {
-    if (!Listener)
-        return;
+    Metrics->EndFrame(FApp::GetDeltaTime());
+}
+
+TArray<FIPv4Endpoint> FMCPTCPServer::GetClientEndpoints() const
+{
+    TArray<FIPv4Endpoint> Endpoints;
+    Endpoints.Reserve(ClientConnections.Num());
+    for (const FMCPClientConnection &Connection : ClientConnections)
+    {
+        Endpoints.Add(Connection.Endpoint);
+    }
+    return Endpoints;
+}
+
+int32 FMCPTCPServer::GetListenPort() const
+{
+    FSocket *ListenSocket = Listener ? Listener->GetSocket() : nullptr;
+    return ListenSocket ? ListenSocket->GetPortNo() : Config.Port;
+}
 
-    // 始终接受新连接
-    if (!Listener->OnConnectionAccepted().IsBound())
+int32 FMCPTCPServer::GetSendQueueDepth() const
+{
+    int32 SendQueueDepth = 0;
+    for (const FMCPClientConnection &Connection : ClientConnections)
+    {
+        SendQueueDepth += Connection.SendQueue.Num();
+    }
+    return SendQueueDepth;
+}
+
+void FMCPTCPServer::ProcessPendingConnections()
+{
+    TPair<FSocket *, FIPv4Endpoint> Accepted;
+    while (AcceptedConnections.Dequeue(Accepted))
     {
-        Listener->OnConnectionAccepted().BindRaw(this, &FMCPTCPServer::HandleConnectionAccepted);
+        ClientConnections.Add(FMCPClientConnection(NextConnectionId++, Accepted.Key, Accepted.Value, Config.ReceiveBufferSize));
+        Metrics->RecordConnectionAccepted();
+
+        MCP_LOG_INFO("MCP Client connected from %s (Total clients: %d)", *Accepted.Value.ToString(), ClientConnections.Num());
     }
 }
 
@@ -205,10 +394,8 @@ bool FMCPTCPServer::HandleConnectionAccepted(FSocket *InSocket, const FIPv4Endpo
     // 接受所有连接
     InSocket->SetNonBlocking(true);
 
-    // 添加到客户端连接列表
-    ClientConnections.Add(FMCPClientConnection(InSocket, Endpoint, Config.ReceiveBufferSize));
-
-    MCP_LOG_INFO("MCP Client connected from %s (Total clients: %d)", *Endpoint.ToString(), ClientConnections.Num());
+    // 连接列表只在游戏线程访问,下次 Tick 时加入
+    AcceptedConnections.Enqueue(TPair<FSocket *, FIPv4Endpoint>(InSocket, Endpoint));
     return true;
 }
 
@@ -228,66 +415,36 @@ void FMCPTCPServer::ProcessClientData()
         uint32 PendingDataSize = 0;
         if (ClientSocket->HasPendingData(PendingDataSize) && PendingDataSize > 0)
         {
+            // 直接读取到接收缓冲区末尾,与之前未处理完的数据拼接
+            TArray<uint8> &Buffer = ClientConnection.ReceiveBuffer;
+            const int32 PreviousSize = Buffer.Num();
+            const int32 ReadSize = FMath::Max(ClientConnection.ReceiveChunkSize, static_cast<int32>(FMath::Min<uint32>(PendingDataSize, MCPConstants::MAX_MESSAGE_SIZE)));
+            Buffer.AddUninitialized(ReadSize);
+
             int32 BytesRead = 0;
-            if (ClientSocket->Recv(ClientConnection.ReceiveBuffer.GetData(), ClientConnection.ReceiveBuffer.Num(), BytesRead))
+            bool bReceived = false;
+            {
+                MCP_TRACE_SCOPE("MCP.Receive");
+                bReceived = ClientSocket->Recv(Buffer.GetData() + PreviousSize, ReadSize, BytesRead);
+                Buffer.SetNum(PreviousSize + FMath::Max(BytesRead, 0), EAllowShrinking::No);
+            }
+
+            if (bReceived)
             {
                 if (BytesRead > 0)
                 {
                     // 重置活动计时器
                     ClientConnection.TimeSinceLastActivity = 0.0f;
+                    ClientConnection.LastReceiveTime = FPlatformTime::Seconds();
+                    Metrics->AddBytesReceived(BytesRead);
+                    MCPTrace::AddBytesReceived(BytesRead);
 
-                    // 将接收到的数据转换为字符串
-                    FString ReceivedData = FString(BytesRead, (ANSICHAR *)ClientConnection.ReceiveBuffer.GetData());
-
-                    MCP_LOG_VERBOSE("Received %d bytes from client %s", BytesRead, *ClientConnection.Endpoint.ToString());
-
-                    // 检查是否是 HTTP 请求
-                    if (ReceivedData.StartsWith(TEXT("POST")) || ReceivedData.StartsWith(TEXT("GET")))
-                    {
-                        // 这是一个 HTTP 请求，提取 JSON body
-                        int32 BodyStartIndex = ReceivedData.Find(TEXT("\r\n\r\n"));
-                        int32 HeaderLength = 4; // "\r\n\r\n" 的长度
-
-                        if (BodyStartIndex == INDEX_NONE)
-                        {
-                            BodyStartIndex = ReceivedData.Find(TEXT("\n\n"));
-                            HeaderLength = 2; // "\n\n" 的长度
-                        }
-
-                        if (BodyStartIndex != INDEX_NONE)
-                        {
-                            // 跳过分隔符，提取 body（JSON 数据）
-                            FString JsonBody = ReceivedData.Mid(BodyStartIndex + HeaderLength).TrimStartAndEnd();
+                    MCP_LOG_VERBOSE("Received %d bytes from client %s (%d buffered)",
+                                    BytesRead, *ClientConnection.Endpoint.ToString(), Buffer.Num());
 
-                            MCP_LOG_VERBOSE("Extracted JSON body (%d chars): %s", JsonBody.Len(), *JsonBody.Left(200));
-
-                            if (!JsonBody.IsEmpty())
-                            {
-                                ProcessCommand(JsonBody, ClientSocket);
-                            }
-                            else
-                            {
-                                MCP_LOG_WARNING("Empty JSON body in HTTP request");
-                            }
-                        }
-                        else
-                        {
-                            MCP_LOG_WARNING("Could not find HTTP header/body separator");
-                        }
-                    }
-                    else
+                    if (!ProcessReceivedData(ClientConnection))
                     {
-                        // 纯 JSON 数据（原始 TCP 协议）
-                        TArray<FString> Commands;
-                        ReceivedData.ParseIntoArray(Commands, TEXT("\n"), true);
-
-                        for (const FString &Command : Commands)
-                        {
-                            if (!Command.IsEmpty())
-                            {
-                                ProcessCommand(Command.TrimStartAndEnd(), ClientSocket);
-                            }
-                        }
+                        CleanupClientConnection(ClientSocket);
                     }
                 }
             }
@@ -307,573 +464,1629 @@ void FMCPTCPServer::ProcessClientData()
     }
 }
 
-void FMCPTCPServer::ProcessCommand(const FString &CommandJson, FSocket *ClientSocket)
+namespace
 {
-    MCP_LOG_VERBOSE("Processing command (%d chars): %s", CommandJson.Len(), *CommandJson.Left(500));
+    /** 在 HTTP 头中查找字段值(名称不区分大小写) */
+    bool FindHttpHeader(FUtf8StringView Headers, FUtf8StringView Name, FUtf8StringView &OutValue)
+    {
+        while (!Headers.IsEmpty())
+        {
+            int32 LineEnd = INDEX_NONE;
+            FUtf8StringView Line = Headers;
+            if (Headers.FindChar('\n', LineEnd))
+            {
+                Line = Headers.Left(LineEnd);
+                Headers.RightChopInline(LineEnd + 1);
+            }
+            else
+            {
+                Headers.Reset();
+            }
 
-    TSharedPtr<FJsonObject> JsonObject;
-    TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(CommandJson);
-
-    if (FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid())
-    {
-        // 检查是否是 JSON-RPC 格式（MCP 协议）
-        FString JsonRpcVersion;
-        FString Method;
-        int32 RequestId = 0;
-
-        bool bIsJsonRpc = JsonObject->TryGetStringField(TEXT("jsonrpc"), JsonRpcVersion) && JsonRpcVersion == TEXT("2.0");
-        bool bHasMethod = JsonObject->TryGetStringField(TEXT("method"), Method);
-        bool bHasId = JsonObject->TryGetNumberField(TEXT("id"), RequestId);
-
-        if (bIsJsonRpc && bHasMethod)
-        {
-            // JSON-RPC 请求（MCP 协议）
-            MCP_LOG_INFO("Received JSON-RPC method: %s (id: %d)", *Method, RequestId);
-
-            TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
-            Response->SetStringField("jsonrpc", TEXT("2.0"));
-
-            if (bHasId)
-            {
-                Response->SetNumberField("id", RequestId);
-            }
-
-            // 处理 MCP 协议方法
-            if (Method == TEXT("initialize"))
-            {
-                // 处理 initialize 请求
-                TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-                Result->SetStringField("protocolVersion", TEXT("2025-11-13"));
-
-                TSharedPtr<FJsonObject> ServerInfo = MakeShared<FJsonObject>();
-                ServerInfo->SetStringField("name", TEXT("Unreal5MCP"));
-                ServerInfo->SetStringField("version", TEXT("1.0.0"));
-                Result->SetObjectField("serverInfo", ServerInfo);
-
-                TSharedPtr<FJsonObject> Capabilities = MakeShared<FJsonObject>();
-                Capabilities->SetBoolField("tools", true);
-                Result->SetObjectField("capabilities", Capabilities);
-
-                Response->SetObjectField("result", Result);
-                MCP_LOG_INFO("Sent initialize response");
-            }
-            else if (Method == TEXT("tools/list"))
-            {
-                // 列出可用工具
-                TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
-                TArray<TSharedPtr<FJsonValue>> Tools;
-
-                // 定义每个工具的详细 schema
-                TMap<FString, TFunction<TSharedPtr<FJsonObject>()>> SchemaGenerators;
-
-                // batch_create schema
-                SchemaGenerators.Add(TEXT("batch_create"), []() -> TSharedPtr<FJsonObject>
-                                     {
-                    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
-                    Schema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
-                    
-                    // actors 数组
-                    TSharedPtr<FJsonObject> ActorsSchema = MakeShared<FJsonObject>();
-                    ActorsSchema->SetStringField("type", TEXT("array"));
-                    ActorsSchema->SetStringField("description", TEXT("Array of actors to create"));
-                    
-                    TSharedPtr<FJsonObject> ActorItemSchema = MakeShared<FJsonObject>();
-                    ActorItemSchema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> ActorProps = MakeShared<FJsonObject>();
-                    
-                    // class_name
-                    TSharedPtr<FJsonObject> ClassNameSchema = MakeShared<FJsonObject>();
-                    ClassNameSchema->SetStringField("type", TEXT("string"));
-                    ClassNameSchema->SetStringField("description", TEXT("Full UE class name (e.g., 'ASkyAtmosphere', 'ASkyLight', 'AStaticMeshActor')"));
-                    ActorProps->SetObjectField("class_name", ClassNameSchema);
-                    
-                    // name
-                    TSharedPtr<FJsonObject> NameSchema = MakeShared<FJsonObject>();
-                    NameSchema->SetStringField("type", TEXT("string"));
-                    NameSchema->SetStringField("description", TEXT("Actor name"));
-                    ActorProps->SetObjectField("name", NameSchema);
-                    
-                    // location
-                    TSharedPtr<FJsonObject> LocationSchema = MakeShared<FJsonObject>();
-                    LocationSchema->SetStringField("type", TEXT("object"));
-                    LocationSchema->SetStringField("description", TEXT("Actor location as {x, y, z}"));
-                    TSharedPtr<FJsonObject> LocationProps = MakeShared<FJsonObject>();
-                    TSharedPtr<FJsonObject> XSchema = MakeShared<FJsonObject>();
-                    XSchema->SetStringField("type", TEXT("number"));
-                    LocationProps->SetObjectField("x", XSchema);
-                    TSharedPtr<FJsonObject> YSchema = MakeShared<FJsonObject>();
-                    YSchema->SetStringField("type", TEXT("number"));
-                    LocationProps->SetObjectField("y", YSchema);
-                    TSharedPtr<FJsonObject> ZSchema = MakeShared<FJsonObject>();
-                    ZSchema->SetStringField("type", TEXT("number"));
-                    LocationProps->SetObjectField("z", ZSchema);
-                    LocationSchema->SetObjectField("properties", LocationProps);
-                    ActorProps->SetObjectField("location", LocationSchema);
-                    
-                    // rotation (optional)
-                    TSharedPtr<FJsonObject> RotationSchema = MakeShared<FJsonObject>();
-                    RotationSchema->SetStringField("type", TEXT("object"));
-                    RotationSchema->SetStringField("description", TEXT("Actor rotation as {pitch, yaw, roll} (optional)"));
-                    ActorProps->SetObjectField("rotation", RotationSchema);
-                    
-                    // scale (optional)
-                    TSharedPtr<FJsonObject> ScaleSchema = MakeShared<FJsonObject>();
-                    ScaleSchema->SetStringField("type", TEXT("object"));
-                    ScaleSchema->SetStringField("description", TEXT("Actor scale as {x, y, z} (optional)"));
-                    ActorProps->SetObjectField("scale", ScaleSchema);
-                    
-                    ActorItemSchema->SetObjectField("properties", ActorProps);
-                    
-                    TArray<TSharedPtr<FJsonValue>> RequiredFields;
-                    RequiredFields.Add(MakeShared<FJsonValueString>(TEXT("class_name")));
-                    ActorItemSchema->SetArrayField("required", RequiredFields);
-                    
-                    ActorsSchema->SetObjectField("items", ActorItemSchema);
-                    Props->SetObjectField("actors", ActorsSchema);
-                    
-                    Schema->SetObjectField("properties", Props);
-                    
-                    TArray<TSharedPtr<FJsonValue>> RequiredTop;
-                    RequiredTop.Add(MakeShared<FJsonValueString>(TEXT("actors")));
-                    Schema->SetArrayField("required", RequiredTop);
-                    
-                    return Schema; });
-
-                // create_object schema
-                SchemaGenerators.Add(TEXT("create_object"), []() -> TSharedPtr<FJsonObject>
-                                     {
-                    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
-                    Schema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
-                    
-                    TSharedPtr<FJsonObject> ClassNameSchema = MakeShared<FJsonObject>();
-                    ClassNameSchema->SetStringField("type", TEXT("string"));
-                    ClassNameSchema->SetStringField("description", TEXT("Full UE class name (e.g., 'ASkyAtmosphere', 'AStaticMeshActor')"));
-                    Props->SetObjectField("class_name", ClassNameSchema);
-                    
-                    TSharedPtr<FJsonObject> NameSchema = MakeShared<FJsonObject>();
-                    NameSchema->SetStringField("type", TEXT("string"));
-                    NameSchema->SetStringField("description", TEXT("Actor name (optional)"));
-                    Props->SetObjectField("name", NameSchema);
-                    
-                    TSharedPtr<FJsonObject> LocationSchema = MakeShared<FJsonObject>();
-                    LocationSchema->SetStringField("type", TEXT("object"));
-                    LocationSchema->SetStringField("description", TEXT("Location as {x, y, z} (optional)"));
-                    Props->SetObjectField("location", LocationSchema);
-                    
-                    TSharedPtr<FJsonObject> RotationSchema = MakeShared<FJsonObject>();
-                    RotationSchema->SetStringField("type", TEXT("object"));
-                    RotationSchema->SetStringField("description", TEXT("Rotation as {pitch, yaw, roll} (optional)"));
-                    Props->SetObjectField("rotation", RotationSchema);
-                    
-                    TSharedPtr<FJsonObject> ScaleSchema = MakeShared<FJsonObject>();
-                    ScaleSchema->SetStringField("type", TEXT("object"));
-                    ScaleSchema->SetStringField("description", TEXT("Scale as {x, y, z} (optional)"));
-                    Props->SetObjectField("scale", ScaleSchema);
-                    
-                    TSharedPtr<FJsonObject> AssetPathSchema = MakeShared<FJsonObject>();
-                    AssetPathSchema->SetStringField("type", TEXT("string"));
-                    AssetPathSchema->SetStringField("description", TEXT("Asset path for StaticMeshActor (optional)"));
-                    Props->SetObjectField("asset_path", AssetPathSchema);
-                    
-                    Schema->SetObjectField("properties", Props);
-                    
-                    TArray<TSharedPtr<FJsonValue>> Required;
-                    Required.Add(MakeShared<FJsonValueString>(TEXT("class_name")));
-                    Schema->SetArrayField("required", Required);
-                    
-                    return Schema; });
-
-                // create_blueprint schema
-                SchemaGenerators.Add(TEXT("create_blueprint"), []() -> TSharedPtr<FJsonObject>
-                                     {
-                    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
-                    Schema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
-                    
-                    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
-                    PathSchema->SetStringField("type", TEXT("string"));
-                    PathSchema->SetStringField("description", TEXT("Blueprint package path (e.g., '/Game/Blueprints/BP_MyActor')"));
-                    Props->SetObjectField("path", PathSchema);
-                    
-                    TSharedPtr<FJsonObject> NameSchema = MakeShared<FJsonObject>();
-                    NameSchema->SetStringField("type", TEXT("string"));
-                    NameSchema->SetStringField("description", TEXT("Blueprint name (optional, extracted from path if not provided)"));
-                    Props->SetObjectField("name", NameSchema);
-                    
-                    TSharedPtr<FJsonObject> ParentClassSchema = MakeShared<FJsonObject>();
-                    ParentClassSchema->SetStringField("type", TEXT("string"));
-                    ParentClassSchema->SetStringField("description", TEXT("Parent class name (e.g., 'Actor', 'Character', 'Pawn'). Default: 'Character'"));
-                    Props->SetObjectField("parent_class", ParentClassSchema);
-                    
-                    Schema->SetObjectField("properties", Props);
-                    
-                    TArray<TSharedPtr<FJsonValue>> Required;
-                    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
-                    Schema->SetArrayField("required", Required);
-                    
-                    return Schema; });
-
-                // get_blueprint_info schema
-                SchemaGenerators.Add(TEXT("get_blueprint_info"), []() -> TSharedPtr<FJsonObject>
-                                     {
-                    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
-                    Schema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
-                    
-                    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
-                    PathSchema->SetStringField("type", TEXT("string"));
-                    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
-                    Props->SetObjectField("path", PathSchema);
-                    
-                    Schema->SetObjectField("properties", Props);
-                    
-                    TArray<TSharedPtr<FJsonValue>> Required;
-                    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
-                    Schema->SetArrayField("required", Required);
-                    
-                    return Schema; });
-
-                // modify_blueprint schema
-                SchemaGenerators.Add(TEXT("modify_blueprint"), []() -> TSharedPtr<FJsonObject>
-                                     {
-                    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
-                    Schema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
-                    
-                    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
-                    PathSchema->SetStringField("type", TEXT("string"));
-                    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
-                    Props->SetObjectField("path", PathSchema);
-                    
-                    TSharedPtr<FJsonObject> DescSchema = MakeShared<FJsonObject>();
-                    DescSchema->SetStringField("type", TEXT("string"));
-                    DescSchema->SetStringField("description", TEXT("Blueprint description (optional)"));
-                    Props->SetObjectField("description", DescSchema);
-                    
-                    Schema->SetObjectField("properties", Props);
-                    
-                    TArray<TSharedPtr<FJsonValue>> Required;
-                    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
-                    Schema->SetArrayField("required", Required);
-                    
-                    return Schema; });
-
-                // compile_blueprint schema
-                SchemaGenerators.Add(TEXT("compile_blueprint"), []() -> TSharedPtr<FJsonObject>
-                                     {
-                    TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
-                    Schema->SetStringField("type", TEXT("object"));
-                    
-                    TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
-                    
-                    TSharedPtr<FJsonObject> PathSchema = MakeShared<FJsonObject>();
-                    PathSchema->SetStringField("type", TEXT("string"));
-                    PathSchema->SetStringField("description", TEXT("Blueprint asset path"));
-                    Props->SetObjectField("path", PathSchema);
-                    
-                    Schema->SetObjectField("properties", Props);
-                    
-                    TArray<TSharedPtr<FJsonValue>> Required;
-                    Required.Add(MakeShared<FJsonValueString>(TEXT("path")));
-                    Schema->SetArrayField("required", Required);
-                    
-                    return Schema; });
-
-                // 为每个命令生成工具定义
-                for (const auto &Pair : CommandHandlers)
-                {
-                    TSharedPtr<FJsonObject> Tool = MakeShared<FJsonObject>();
-                    Tool->SetStringField("name", Pair.Key);
+            int32 Colon = INDEX_NONE;
+            if (Line.FindChar(':', Colon) && Line.Left(Colon).TrimStartAndEnd().Equals(Name, ESearchCase::IgnoreCase))
+            {
+                OutValue = Line.RightChop(Colon + 1).TrimStartAndEnd();
+                return true;
+            }
+        }
+        return false;
+    }
 
-                    // 为已知命令提供详细描述
-                    if (Pair.Key == TEXT("batch_create"))
-                    {
-                        Tool->SetStringField("description", TEXT("Batch create multiple actors in the scene. Requires 'actors' array with each actor having 'class_name' (required), 'name', 'location' ({x,y,z}), 'rotation' ({pitch,yaw,roll}), and 'scale' ({x,y,z})."));
-                    }
-                    else if (Pair.Key == TEXT("create_object"))
-                    {
-                        Tool->SetStringField("description", TEXT("Create a single actor in the scene. Requires 'class_name' (e.g., 'ASkyAtmosphere', 'ASkyLight', 'AStaticMeshActor'). Optional: 'name', 'location' ({x,y,z}), 'rotation' ({pitch,yaw,roll}), 'scale' ({x,y,z}), 'asset_path'."));
-                    }
-                    else if (Pair.Key == TEXT("modify_object"))
-                    {
-                        Tool->SetStringField("description", TEXT("Modify an existing actor. Requires 'actor_name'. Can update 'location' ({x,y,z}), 'rotation' ({pitch,yaw,roll}), 'scale' ({x,y,z}), and other properties."));
-                    }
-                    else if (Pair.Key == TEXT("batch_modify"))
-                    {
-                        Tool->SetStringField("description", TEXT("Batch modify multiple actors. Requires 'actors' array with each containing 'name' and properties to modify."));
-                    }
-                    else if (Pair.Key == TEXT("batch_delete"))
-                    {
-                        Tool->SetStringField("description", TEXT("Batch delete multiple actors. Requires 'actor_names' array of actor names to delete."));
-                    }
-                    else if (Pair.Key == TEXT("create_blueprint"))
-                    {
-                        Tool->SetStringField("description", TEXT("Create a new Blueprint class. Requires 'path' (package path). Optional: 'name', 'parent_class' (default: 'Character'). Note: Does not support 'components' parameter - components must be added after creation."));
-                    }
-                    else if (Pair.Key == TEXT("get_blueprint_info"))
-                    {
-                        Tool->SetStringField("description", TEXT("Get information about a Blueprint. Requires 'path' (asset path)."));
-                    }
-                    else if (Pair.Key == TEXT("modify_blueprint"))
-                    {
-                        Tool->SetStringField("description", TEXT("Modify a Blueprint. Requires 'path'. Optional: 'description'."));
-                    }
-                    else if (Pair.Key == TEXT("compile_blueprint"))
-                    {
-                        Tool->SetStringField("description", TEXT("Compile a Blueprint. Requires 'path' (asset path)."));
-                    }
-                    else if (Pair.Key == TEXT("get_scene_info"))
-                    {
-                        Tool->SetStringField("description", TEXT("Get information about all actors in the current scene."));
-                    }
-                    else if (Pair.Key == TEXT("delete_object"))
-                    {
-                        Tool->SetStringField("description", TEXT("Delete an actor from the scene. Requires 'actor_name'."));
-                    }
-                    else if (Pair.Key == TEXT("create_light"))
-                    {
-                        Tool->SetStringField("description", TEXT("Create a light actor. Specify light type and properties."));
-                    }
-                    else if (Pair.Key == TEXT("create_material"))
-                    {
-                        Tool->SetStringField("description", TEXT("Create a material asset."));
-                    }
-                    else if (Pair.Key == TEXT("import_asset"))
-                    {
-                        Tool->SetStringField("description", TEXT("Import an external asset file."));
-                    }
-                    else if (Pair.Key == TEXT("list_assets"))
-                    {
-                        Tool->SetStringField("description", TEXT("List assets in a directory."));
-                    }
-                    else if (Pair.Key == TEXT("set_camera"))
-                    {
-                        Tool->SetStringField("description", TEXT("Set editor camera position and rotation."));
-                    }
-                    else if (Pair.Key == TEXT("get_camera"))
-                    {
-                        Tool->SetStringField("description", TEXT("Get current editor camera position and rotation."));
-                    }
-                    else if (Pair.Key == TEXT("select_actor"))
-                    {
-                        Tool->SetStringField("description", TEXT("Select an actor in the editor."));
-                    }
-                    else if (Pair.Key == TEXT("get_selected_actors"))
-                    {
-                        Tool->SetStringField("description", TEXT("Get list of currently selected actors."));
-                    }
-                    else
-                    {
-                        Tool->SetStringField("description", FString::Printf(TEXT("Execute %s command"), *Pair.Key));
-                    }
+    /** 解析非负十进制整数,失败返回 INDEX_NONE */
+    int64 ParseContentLength(FUtf8StringView Value)
+    {
+        if (Value.IsEmpty())
+        {
+            return INDEX_NONE;
+        }
 
-                    // 使用详细的 schema 或默认 schema
-                    if (auto SchemaGen = SchemaGenerators.Find(Pair.Key))
-                    {
-                        Tool->SetObjectField("inputSchema", (*SchemaGen)());
-                    }
-                    else
-                    {
-                        TSharedPtr<FJsonObject> InputSchema = MakeShared<FJsonObject>();
-                        InputSchema->SetStringField("type", TEXT("object"));
-                        Tool->SetObjectField("inputSchema", InputSchema);
-                    }
+        int64 Result = 0;
+        for (const UTF8CHAR Char : Value)
+        {
+            if (Char < '0' || Char > '9' || Result > MCPConstants::MAX_MESSAGE_SIZE)
+            {
+                return INDEX_NONE;
+            }
+            Result = Result * 10 + (Char - '0');
+        }
+        return Result;
+    }
 
-                    Tools.Add(MakeShared<FJsonValueObject>(Tool));
-                }
+    /** 判断 Accept-Encoding 中的 q 参数是否为 0(即明确不接受该编码) */
+    bool IsZeroQuality(FUtf8StringView Params)
+    {
+        Params.TrimStartAndEndInline();
+        if (!Params.StartsWith(UTF8TEXT("q="), ESearchCase::IgnoreCase))
+        {
+            return false;
+        }
 
-                Result->SetArrayField("tools", Tools);
-                Response->SetObjectField("result", Result);
-                MCP_LOG_INFO("Sent tools/list response with %d tools", Tools.Num());
-            }
-            else if (Method == TEXT("tools/call"))
+        const FUtf8StringView Quality = Params.RightChop(2).TrimStartAndEnd();
+        for (const UTF8CHAR Char : Quality)
+        {
+            if (Char != '0' && Char != '.')
             {
-                // 调用工具
-                const TSharedPtr<FJsonObject> *ParamsObj;
-                if (JsonObject->TryGetObjectField(TEXT("params"), ParamsObj))
-                {
-                    FString ToolName;
-                    if ((*ParamsObj)->TryGetStringField(TEXT("name"), ToolName))
-                    {
-                        const TSharedPtr<FJsonObject> *ToolArgs;
-                        (*ParamsObj)->TryGetObjectField(TEXT("arguments"), ToolArgs);
+                return false;
+            }
+        }
+        return !Quality.IsEmpty();
+    }
 
-                        if (TSharedPtr<IMCPCommandHandler> *HandlerPtr = CommandHandlers.Find(ToolName))
-                        {
-                            MCP_LOG_INFO("Executing tool: %s", *ToolName);
-                            TSharedPtr<FJsonObject> ToolResult = (*HandlerPtr)->Execute(ToolArgs ? *ToolArgs : *ParamsObj, ClientSocket);
+    /** 从 Accept-Encoding 中选择响应编码,gzip 优先于 deflate */
+    EMCPContentEncoding ParseAcceptEncoding(FUtf8StringView Value)
+    {
+        bool bAcceptsGzip = false;
+        bool bAcceptsDeflate = false;
 
-                            // 根据 MCP 标准, tools/call 的响应必须包含 content 数组
-                            if (ToolResult.IsValid())
-                            {
-                                TSharedPtr<FJsonObject> ResultWrapper = MakeShared<FJsonObject>();
-
-                                // 创建 content 数组
-                                TArray<TSharedPtr<FJsonValue>> ContentArray;
-                                TSharedPtr<FJsonObject> ContentItem = MakeShared<FJsonObject>();
-                                ContentItem->SetStringField("type", TEXT("text"));
-
-                                // 将工具结果转换为 JSON 字符串
-                                FString ResultStr;
-                                TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResultStr);
-                                FJsonSerializer::Serialize(ToolResult.ToSharedRef(), Writer);
-                                ContentItem->SetStringField("text", ResultStr);
-
-                                ContentArray.Add(MakeShared<FJsonValueObject>(ContentItem));
-                                ResultWrapper->SetArrayField("content", ContentArray);
-                                Response->SetObjectField("result", ResultWrapper);
-                            }
-                            else
-                            {
-                                TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
-                                Error->SetNumberField("code", -32603);
-                                Error->SetStringField("message", TEXT("Internal error: Tool returned null result"));
-                                Response->SetObjectField("error", Error);
-                            }
-                        }
-                        else
-                        {
-                            TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
-                            Error->SetNumberField("code", -32601);
-                            Error->SetStringField("message", TEXT("Tool not found"));
-                            Response->SetObjectField("error", Error);
-                        }
-                    }
-                    else
-                    {
-                        TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
-                        Error->SetNumberField("code", -32602);
-                        Error->SetStringField("message", TEXT("Missing 'name' parameter"));
-                        Response->SetObjectField("error", Error);
-                    }
-                }
-                else
-                {
-                    TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
-                    Error->SetNumberField("code", -32602);
-                    Error->SetStringField("message", TEXT("Missing 'params' object"));
-                    Response->SetObjectField("error", Error);
-                }
+        while (!Value.IsEmpty())
+        {
+            int32 Comma = INDEX_NONE;
+            FUtf8StringView Item = Value;
+            if (Value.FindChar(',', Comma))
+            {
+                Item = Value.Left(Comma);
+                Value.RightChopInline(Comma + 1);
             }
             else
             {
-                // 未知方法
-                TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
-                Error->SetNumberField("code", -32601);
-                Error->SetStringField("message", TEXT("Method not found"));
-                Response->SetObjectField("error", Error);
-                MCP_LOG_WARNING("Unknown JSON-RPC method: %s", *Method);
+                Value.Reset();
             }
 
-            SendResponse(ClientSocket, Response);
-        }
-        else
-        {
-            // 尝试简单命令格式（向后兼容）
-            FString CommandType;
-            if (JsonObject->TryGetStringField(TEXT("type"), CommandType))
+            // 形如 "gzip;q=0.8"
+            FUtf8StringView Coding = Item;
+            bool bRejected = false;
+            int32 Semicolon = INDEX_NONE;
+            if (Item.FindChar(';', Semicolon))
             {
-                if (TSharedPtr<IMCPCommandHandler> *HandlerPtr = CommandHandlers.Find(CommandType))
-                {
-                    TSharedPtr<IMCPCommandHandler> Handler = *HandlerPtr;
-                    MCP_LOG_INFO("Executing command: %s", *CommandType);
-                    TSharedPtr<FJsonObject> Response = Handler->Execute(JsonObject, ClientSocket);
-                    if (Response.IsValid())
-                    {
-                        SendResponse(ClientSocket, Response);
-                    }
-                }
-                else
-                {
-                    TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
-                    Response->SetStringField("status", TEXT("error"));
-                    Response->SetStringField("message", FString::Printf(TEXT("Unknown command type: %s"), *CommandType));
-                    SendResponse(ClientSocket, Response);
-                }
+                Coding = Item.Left(Semicolon);
+                bRejected = IsZeroQuality(Item.RightChop(Semicolon + 1));
             }
-            else
+            Coding.TrimStartAndEndInline();
+
+            if (Coding.Equals(UTF8TEXT("gzip"), ESearchCase::IgnoreCase))
             {
-                MCP_LOG_WARNING("Invalid request format. JSON keys: ");
-                TArray<FString> Keys;
-                JsonObject->Values.GetKeys(Keys);
-                for (const FString &Key : Keys)
-                {
-                    MCP_LOG_WARNING("  - %s", *Key);
-                }
+                bAcceptsGzip = !bRejected;
+            }
+            else if (Coding.Equals(UTF8TEXT("deflate"), ESearchCase::IgnoreCase))
+            {
+                bAcceptsDeflate = !bRejected;
             }
         }
-    }
-    else
-    {
-        MCP_LOG_WARNING("Invalid JSON format (first 200 chars): %s", *CommandJson.Left(200));
-    }
-}
 
-void FMCPTCPServer::SendResponse(FSocket *Client, const TSharedPtr<FJsonObject> &Response)
-{
-    if (!Client || !Response.IsValid())
-    {
-        return;
+        if (bAcceptsGzip)
+        {
+            return EMCPContentEncoding::Gzip;
+        }
+        return bAcceptsDeflate ? EMCPContentEncoding::Deflate : EMCPContentEncoding::Identity;
     }
 
-    // 将响应转换为 JSON 字符串
-    FString ResponseString;
-    TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&ResponseString);
-    FJsonSerializer::Serialize(Response.ToSharedRef(), Writer);
-
-    // 构建 HTTP 响应
-    FString HttpResponse = TEXT("HTTP/1.1 200 OK\r\n");
-    HttpResponse += TEXT("Content-Type: application/json\r\n");
-    HttpResponse += TEXT("Access-Control-Allow-Origin: *\r\n");
-    HttpResponse += TEXT("Connection: close\r\n");
+    /** 请求行是否为 GET /metrics */
+    bool IsMetricsRequest(FUtf8StringView Headers)
+    {
+        if (!Headers.StartsWith(UTF8TEXT("GET ")))
+        {
+            return false;
+        }
 
-    // 计算内容长度
-    FTCHARToUTF8 JsonConverter(*ResponseString);
-    int32 ContentLength = JsonConverter.Length();
-    HttpResponse += FString::Printf(TEXT("Content-Length: %d\r\n"), ContentLength);
-    HttpResponse += TEXT("\r\n");
-    HttpResponse += ResponseString;
+        FUtf8StringView Target = Headers.RightChop(4);
+        int32 TargetEnd = INDEX_NONE;
+        if (Target.FindChar(' ', TargetEnd))
+        {
+            Target.LeftInline(TargetEnd);
+        }
+        return Target == UTF8TEXT("/metrics") || Target.StartsWith(UTF8TEXT("/metrics?"));
+    }
 
-    // 发送响应
-    int32 BytesSent = 0;
-    FTCHARToUTF8 Converter(*HttpResponse);
-    if (!Client->Send((const uint8 *)Converter.Get(), Converter.Length(), BytesSent))
+    /** 工具结果是否为错误响应(CreateErrorResponse 的 status 字段) */
+    bool IsErrorResult(const TSharedPtr<FJsonObject> &Result)
     {
-        MCP_LOG_ERROR("Failed to send response to client");
+        FString Status;
+        return !Result.IsValid() || (Result->TryGetStringField(TEXT("status"), Status) && Status == TEXT("error"));
     }
-    else
+
+    /** 日志用: 截取消息开头并转换为 FString */
+    FString DescribeMessage(FUtf8StringView Message, int32 MaxBytes)
     {
-        MCP_LOG_VERBOSE("Sent %d bytes HTTP response to client", BytesSent);
+        const FUtf8StringView Prefix = Message.Left(MaxBytes);
+        FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR *>(Prefix.GetData()), Prefix.Len());
+        return FString(Converter.Length(), Converter.Get());
     }
 }
 
-void FMCPTCPServer::CheckClientTimeouts(float DeltaTime)
+bool FMCPTCPServer::ProcessReceivedData(FMCPClientConnection &ClientConnection)
 {
-    for (int32 i = ClientConnections.Num() - 1; i >= 0; i--)
+    FSocket *ClientSocket = ClientConnection.Socket;
+    const FUtf8StringView Data(reinterpret_cast<const UTF8CHAR *>(ClientConnection.ReceiveBuffer.GetData()), ClientConnection.ReceiveBuffer.Num());
+
+    /** 一条完整消息及其请求协商的格式和响应编码 */
+    struct FReceivedMessage
     {
-        FMCPClientConnection &ClientConnection = ClientConnections[i];
-        ClientConnection.TimeSinceLastActivity += DeltaTime;
+        FUtf8StringView Body;
+        EMCPContentEncoding Encoding;
+        EMCPWireFormat RequestFormat;
+        EMCPWireFormat ResponseFormat;
 
-        if (ClientConnection.TimeSinceLastActivity > Config.ClientTimeoutSeconds)
-        {
-            MCP_LOG_WARNING("Client %s timed out after %.1f seconds",
-                            *ClientConnection.Endpoint.ToString(),
-                            ClientConnection.TimeSinceLastActivity);
-            CleanupClientConnection(ClientConnection);
-        }
-    }
-}
+        /** GET /metrics,没有请求体 */
+        bool bMetricsRequest;
+    };
 
-void FMCPTCPServer::CleanupAllClientConnections()
-{
+    // 先切分出所有完整消息,再统一处理;处理期间缓冲区不会被修改
+    TArray<FReceivedMessage, TInlineAllocator<8>> Messages;
+    int32 Consumed = 0;
+    bool bFramingError = false;
+
+    // 上次处理时缓冲区开头的未完成消息已扫描过的部分
+    const int32 ResumeScanOffset = ClientConnection.LineScanOffset;
+    ClientConnection.LineScanOffset = 0;
+
+    while (Consumed < Data.Len())
+    {
+        const FUtf8StringView Remaining = Data.RightChop(Consumed);
+
+        if (Remaining.StartsWith(UTF8TEXT("POST")) || Remaining.StartsWith(UTF8TEXT("GET")))
+        {
+            // HTTP 请求: 请求头以空行结束,请求体长度由 Content-Length 给出
+            int32 HeaderEnd = Remaining.Find(UTF8TEXT("\r\n\r\n"));
+            int32 SeparatorLength = 4;
+            if (HeaderEnd == INDEX_NONE)
+            {
+                HeaderEnd = Remaining.Find(UTF8TEXT("\n\n"));
+                SeparatorLength = 2;
+            }
+
+            if (HeaderEnd == INDEX_NONE)
+            {
+                if (Remaining.Len() > MCPConstants::MAX_HTTP_HEADER_SIZE)
+                {
+                    MCP_LOG_WARNING("HTTP header exceeds %d bytes", MCPConstants::MAX_HTTP_HEADER_SIZE);
+                    bFramingError = true;
+                }
+                break;
+            }
+
+            const FUtf8StringView Headers = Remaining.Left(HeaderEnd);
+            const int32 BodyStart = HeaderEnd + SeparatorLength;
+            ClientConnection.bHttp = true;
+
+            if (IsMetricsRequest(Headers))
+            {
+                Messages.Add({FUtf8StringView(), EMCPContentEncoding::Identity, EMCPWireFormat::Json, EMCPWireFormat::Json, true});
+                Consumed += BodyStart;
+                continue;
+            }
+
+            EMCPContentEncoding Encoding = EMCPContentEncoding::Identity;
+            FUtf8StringView AcceptEncodingValue;
+            if (Config.bEnableCompression && FindHttpHeader(Headers, UTF8TEXT("Accept-Encoding"), AcceptEncodingValue))
+            {
+                Encoding = ParseAcceptEncoding(AcceptEncodingValue);
+            }
+
+            // 请求体格式由 Content-Type 决定;Accept 中列出二进制格式时按其响应,否则与请求格式相同
+            EMCPWireFormat RequestFormat = EMCPWireFormat::Json;
+            FUtf8StringView ContentTypeValue;
+            if (FindHttpHeader(Headers, UTF8TEXT("Content-Type"), ContentTypeValue))
+            {
+                RequestFormat = FMCPBinaryCodec::FromMimeType(ContentTypeValue);
+            }
+
+            EMCPWireFormat ResponseFormat = RequestFormat;
+            FUtf8StringView AcceptValue;
+            if (FindHttpHeader(Headers, UTF8TEXT("Accept"), AcceptValue))
+            {
+                FMCPBinaryCodec::FindAcceptedFormat(AcceptValue, ResponseFormat);
+            }
+
+            // 没有 Content-Length 时把已收到的数据视为完整请求体
+            int64 BodyLength = Remaining.Len() - BodyStart;
+            FUtf8StringView ContentLengthValue;
+            if (FindHttpHeader(Headers, UTF8TEXT("Content-Length"), ContentLengthValue))
+            {
+                BodyLength = ParseContentLength(ContentLengthValue);
+                if (BodyLength < 0 || BodyLength > MCPConstants::MAX_MESSAGE_SIZE)
+                {
+                    MCP_LOG_WARNING("Invalid or oversized Content-Length: %s", *DescribeMessage(ContentLengthValue, 32));
+                    bFramingError = true;
+                    break;
+                }
+                if (Remaining.Len() - BodyStart < BodyLength)
+                {
+                    // 请求体尚未收完
+                    break;
+                }
+            }
+
+            // 二进制请求体中的空白字节是数据的一部分,不能裁剪
+            FUtf8StringView Body = Remaining.Mid(BodyStart, static_cast<int32>(BodyLength));
+            if (RequestFormat == EMCPWireFormat::Json)
+            {
+                Body.TrimStartAndEndInline();
+            }
+
+            if (Body.IsEmpty())
+            {
+                MCP_LOG_WARNING("Empty %s body in HTTP request", FMCPBinaryCodec::GetFormatName(RequestFormat));
+            }
+            else
+            {
+                Messages.Add({Body, Encoding, RequestFormat, ResponseFormat, false});
+            }
+            Consumed += BodyStart + static_cast<int32>(BodyLength);
+        }
+        else
+        {
+            // 纯 JSON 数据（原始 TCP 协议）: 每行一条命令
+            // 缓冲区开头的消息上次已扫描过的部分不含换行,从新数据开始查找
+            const int32 SearchStart = Consumed == 0 ? FMath::Min(ResumeScanOffset, Remaining.Len()) : 0;
+            int32 LineEnd = INDEX_NONE;
+            if (Remaining.RightChop(SearchStart).FindChar('\n', LineEnd))
+            {
+                LineEnd += SearchStart;
+            }
+            else
+            {
+                // 最后一条命令可能不带换行: 只有当它已是完整的 JSON 值时才处理,否则等待后续数据。
+                // 完整的命令总以 } 或 ] 结尾,其他情况不必解析整个缓冲区
+                const FUtf8StringView Trimmed = Remaining.TrimEnd();
+                const bool bMayBeComplete = Trimmed.Len() > 0 && (Trimmed[Trimmed.Len() - 1] == '}' || Trimmed[Trimmed.Len() - 1] == ']');
+
+                bool bComplete = false;
+                bool bSyntaxError = false;
+                if (bMayBeComplete)
+                {
+                    FMCPJsonPullParser Parser(Remaining.GetData(), Remaining.Len());
+                    bComplete = Parser.SkipValue() && Parser.Next() == EMCPJsonToken::End;
+                    bSyntaxError = !bComplete && Parser.GetOffset() < Remaining.Len();
+                }
+
+                if (!bComplete && !bSyntaxError)
+                {
+                    if (Remaining.Len() > MCPConstants::MAX_MESSAGE_SIZE)
+                    {
+                        MCP_LOG_WARNING("Message exceeds %d bytes without a line break", MCPConstants::MAX_MESSAGE_SIZE);
+                        bFramingError = true;
+                    }
+                    ClientConnection.LineScanOffset = Remaining.Len();
+                    break;
+                }
+                LineEnd = Remaining.Len();
+            }
+
+            const FUtf8StringView Line = Remaining.Left(LineEnd).TrimStartAndEnd();
+            if (!Line.IsEmpty())
+            {
+                Messages.Add({Line, EMCPContentEncoding::Identity, EMCPWireFormat::Json, EMCPWireFormat::Json, false});
+            }
+            Consumed += FMath::Min(LineEnd + 1, Remaining.Len());
+        }
+    }
+
+    {
+        // 一次收到的多条命令视为一个批次,结束时统一保存
+        FMCPSaveQueue::FScopedBatch SaveBatch(Messages.Num() > 1 ? SaveQueue : nullptr);
+
+        // 协商结果只在处理消息期间有效,结束后恢复默认,不影响其他连接之后的发送
+        TGuardValue<EMCPContentEncoding> EncodingScope(CurrentResponseEncoding, EMCPContentEncoding::Identity);
+        TGuardValue<EMCPWireFormat> FormatScope(CurrentResponseFormat, EMCPWireFormat::Json);
+
+        for (int32 Index = 0; Index < Messages.Num(); ++Index)
+        {
+            const FReceivedMessage &Message = Messages[Index];
+            MCPTrace::SetPendingMessages(Messages.Num() - Index);
+
+            // 消息指向连接的接收缓冲区,连接被清理后不能再访问
+            FMCPClientConnection *Connection = FindClientConnection(ClientSocket);
+            if (!Connection)
+            {
+                return true;
+            }
+            CurrentResponseEncoding = Message.Encoding;
+            CurrentResponseFormat = Message.ResponseFormat;
+            CurrentMessageReceiveTime = Connection->LastReceiveTime;
+            CurrentMessageBody = Message.Body;
+            CurrentMessageFormat = Message.RequestFormat;
+
+            if (Message.bMetricsRequest)
+            {
+                SendMetricsResponse(ClientSocket);
+                continue;
+            }
+
+            Metrics->RecordMessage();
+            if (Message.RequestFormat == EMCPWireFormat::Json)
+            {
+                ProcessMessage(Message.Body, ClientSocket);
+            }
+            else
+            {
+                ProcessBinaryMessage(Message.Body, Message.RequestFormat, ClientSocket);
+            }
+        }
+        MCPTrace::SetPendingMessages(0);
+    }
+
+    // 处理过程中连接可能已被清理,重新查找
+    FMCPClientConnection *Connection = FindClientConnection(ClientSocket);
+    if (Connection && Consumed > 0)
+    {
+        Connection->ReceiveBuffer.RemoveAt(0, Consumed, EAllowShrinking::No);
+
+        // 大请求处理完后释放多余的容量
+        if (Connection->ReceiveBuffer.Num() == 0 && Connection->ReceiveBuffer.Max() > Connection->ReceiveChunkSize)
+        {
+            Connection->ReceiveBuffer.Empty(Connection->ReceiveChunkSize);
+        }
+    }
+    return !bFramingError;
+}
+
+void FMCPTCPServer::ProcessMessage(FUtf8StringView Message, FSocket *ClientSocket)
+{
+    MCP_LOG_VERBOSE("Extracted JSON message (%d bytes): %s", Message.Len(), *DescribeMessage(Message, 200));
+
+    if (!TryProcessStreamedCommand(Message.GetData(), Message.Len(), ClientSocket))
+    {
+        ProcessCommand(Message, ClientSocket);
+    }
+}
+
+void FMCPTCPServer::ProcessCommand(FUtf8StringView CommandJson, FSocket *ClientSocket)
+{
+    MCP_LOG_VERBOSE("Processing command (%d bytes): %s", CommandJson.Len(), *DescribeMessage(CommandJson, 500));
+
+    TSharedPtr<FJsonObject> JsonObject;
+    bool bParsed = false;
+    {
+        MCP_TRACE_SCOPE("MCP.Parse");
+        TSharedRef<TJsonReader<UTF8CHAR>> Reader = TJsonReaderFactory<UTF8CHAR>::CreateFromView(CommandJson);
+        bParsed = FJsonSerializer::Deserialize(Reader, JsonObject) && JsonObject.IsValid();
+    }
+
+    if (bParsed)
+    {
+        ProcessCommandObject(JsonObject, ClientSocket);
+    }
+    else
+    {
+        MCP_LOG_WARNING("Invalid JSON format (first 200 bytes): %s", *DescribeMessage(CommandJson, 200));
+    }
+}
+
+void FMCPTCPServer::ProcessBinaryMessage(FUtf8StringView Message, EMCPWireFormat Format, FSocket *ClientSocket)
+{
+    MCP_LOG_VERBOSE("Processing %s command (%d bytes)", FMCPBinaryCodec::GetFormatName(Format), Message.Len());
+
+    FString Error;
+    TSharedPtr<FJsonValue> Value;
+    {
+        MCP_TRACE_SCOPE("MCP.Parse");
+        Value = FMCPBinaryCodec::Decode(Format, reinterpret_cast<const uint8 *>(Message.GetData()), Message.Len(), Error);
+    }
+    if (!Value.IsValid() || Value->Type != EJson::Object)
+    {
+        const FString Reason = FString::Printf(TEXT("Invalid %s request: %s"), FMCPBinaryCodec::GetFormatName(Format),
+                                               Error.IsEmpty() ? TEXT("root value is not a map") : *Error);
+        MCP_LOG_WARNING("%s", *Reason);
+
+        // 二进制请求只能通过 HTTP 到达,必须回复,否则客户端会一直等待
+        TSharedPtr<FJsonObject> ErrorObject = MakeShared<FJsonObject>();
+        ErrorObject->SetNumberField("code", -32700);
+        ErrorObject->SetStringField("message", Reason);
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField("jsonrpc", "2.0");
+        Response->SetField("id", MakeShared<FJsonValueNull>());
+        Response->SetObjectField("error", ErrorObject);
+        SendResponse(ClientSocket, Response);
+        return;
+    }
+
+    ProcessCommandObject(Value->AsObject(), ClientSocket);
+}
+
+void FMCPTCPServer::ProcessCommandObject(const TSharedPtr<FJsonObject> &JsonObject, FSocket *ClientSocket)
+{
+    MCP_TRACE_SCOPE("MCP.Dispatch");
+
+    // 检查是否是 JSON-RPC 格式（MCP 协议）
+    FString JsonRpcVersion;
+    FString Method;
+    int32 RequestId = 0;
+
+    bool bIsJsonRpc = JsonObject->TryGetStringField(TEXT("jsonrpc"), JsonRpcVersion) && JsonRpcVersion == TEXT("2.0");
+    bool bHasMethod = JsonObject->TryGetStringField(TEXT("method"), Method);
+    bool bHasId = JsonObject->TryGetNumberField(TEXT("id"), RequestId);
+
+    if (bIsJsonRpc && bHasMethod)
+    {
+        // JSON-RPC 请求（MCP 协议）
+        MCP_LOG_INFO("Received JSON-RPC method: %s (id: %d)", *Method, RequestId);
+
+        TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+        Response->SetStringField("jsonrpc", TEXT("2.0"));
+
+        // 异步工具调用在完成回调中发送响应
+        bool bResponseDeferred = false;
+
+        if (bHasId)
+        {
+            Response->SetNumberField("id", RequestId);
+        }
+
+        // 处理 MCP 协议方法
+        if (Method == TEXT("initialize"))
+        {
+            // 处理 initialize 请求;记录客户端是否理解 structuredContent(协议版本为 ISO 日期,可按字符串比较)
+            const TSharedPtr<FJsonObject> *InitParams = nullptr;
+            FString ClientProtocolVersion;
+            if (JsonObject->TryGetObjectField(TEXT("params"), InitParams))
+            {
+                (*InitParams)->TryGetStringField(TEXT("protocolVersion"), ClientProtocolVersion);
+            }
+            if (FMCPClientConnection *Connection = FindClientConnection(ClientSocket))
+            {
+                Connection->bStructuredContent = ClientProtocolVersion >= MCPConstants::STRUCTURED_CONTENT_PROTOCOL_VERSION;
+            }
+
+            TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+            Result->SetStringField("protocolVersion", TEXT("2025-11-13"));
+
+            TSharedPtr<FJsonObject> ServerInfo = MakeShared<FJsonObject>();
+            ServerInfo->SetStringField("name", TEXT("Unreal5MCP"));
+            ServerInfo->SetStringField("version", TEXT("1.0.0"));
+            Result->SetObjectField("serverInfo", ServerInfo);
+
+            TSharedPtr<FJsonObject> Capabilities = MakeShared<FJsonObject>();
+            Capabilities->SetBoolField("tools", true);
+
+            TSharedPtr<FJsonObject> ResourcesCapability = MakeShared<FJsonObject>();
+            ResourcesCapability->SetBoolField("subscribe", !IsHttpConnection(ClientSocket));
+            ResourcesCapability->SetBoolField("listChanged", false);
+            Capabilities->SetObjectField("resources", ResourcesCapability);
+            Result->SetObjectField("capabilities", Capabilities);
+
+            Response->SetObjectField("result", Result);
+            MCP_LOG_INFO("Sent initialize response");
+        }
+        else if (Method == TEXT("tools/list"))
+        {
+            // 工具列表在处理器变化后首次请求时序列化一次,之后直接发送缓存的字节
+            if (ToolsListCache.Num() == 0)
+            {
+                RebuildToolsListCache();
+            }
+
+            // 响应已直接发送,跳过下方的通用序列化
+            SendToolsListResponse(ClientSocket, bHasId ? &RequestId : nullptr);
+            bResponseDeferred = true;
+        }
+        else if (Method == TEXT("tools/call"))
+        {
+            // 调用工具
+            const TSharedPtr<FJsonObject> *ParamsObj;
+            if (JsonObject->TryGetObjectField(TEXT("params"), ParamsObj))
+            {
+                FString ToolName;
+                if ((*ParamsObj)->TryGetStringField(TEXT("name"), ToolName))
+                {
+                    const TSharedPtr<FJsonObject> *ToolArgs = nullptr;
+                    (*ParamsObj)->TryGetObjectField(TEXT("arguments"), ToolArgs);
+
+                    const TSharedPtr<FJsonObject> &ToolParams = ToolArgs ? *ToolArgs : *ParamsObj;
+                    FString ErrorPointer;
+                    FString ErrorMessage;
+
+                    TSharedPtr<IMCPCommandHandler> *HandlerPtr = CommandHandlers.Find(ToolName);
+
+                    // 只为已注册的工具计时,避免未知名称使指标无限增长
+                    TSharedPtr<FMCPRequestTimer> Timer;
+                    if (HandlerPtr)
+                    {
+                        Timer = BeginToolRequest(ClientSocket, ToolName, bHasId ? RequestId : MCPTrace::NO_REQUEST_ID);
+                    }
+
+                    if (HandlerPtr && !ValidateCommandParams(ToolName, ToolParams, ErrorPointer, ErrorMessage))
+                    {
+                        // 参数不符合 schema,不进入处理器
+                        Timer->MarkError();
+                        TSharedPtr<FJsonObject> ErrorData = MakeShared<FJsonObject>();
+                        ErrorData->SetStringField("pointer", ErrorPointer);
+                        ErrorData->SetStringField("message", ErrorMessage);
+
+                        TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                        Error->SetNumberField("code", -32602);
+                        Error->SetStringField("message", FString::Printf(TEXT("Invalid params: %s at '%s'"), *ErrorMessage, *ErrorPointer));
+                        Error->SetObjectField("data", ErrorData);
+                        Response->SetObjectField("error", Error);
+                    }
+                    else if (HandlerPtr && (*HandlerPtr)->SupportsStreaming())
+                    {
+                        // 流式处理器同步执行,结果直接写入响应缓冲区
+                        MCP_LOG_INFO("Executing tool (streaming): %s", *ToolName);
+                        bResponseDeferred = true;
+
+                        TSharedPtr<IMCPCommandHandler> Handler = *HandlerPtr;
+                        TGuardValue<TSharedPtr<FMCPRequestTimer>> TimerScope(ActiveTimer, Timer);
+                        SendToolCallResponse(ClientSocket, bHasId ? &RequestId : nullptr,
+                                             [&Handler, &ToolParams, &Timer, ClientSocket](FMCPJsonStreamWriter &Writer)
+                                             {
+                            {
+                                MCP_TRACE_EXECUTE_SCOPE(Timer->GetCommand(), Timer->GetRequestId());
+                                Handler->ExecuteStreaming(ToolParams, ClientSocket, Writer);
+                            }
+                            Timer->MarkExecuted(); });
+                    }
+                    else if (HandlerPtr)
+                    {
+                        MCP_LOG_INFO("Executing tool: %s", *ToolName);
+                        bResponseDeferred = true;
+
+                        TWeakPtr<bool> WeakLifetime = LifetimeToken;
+                        const uint64 ConnectionId = BeginAsyncRequest(ClientSocket);
+                        const EMCPContentEncoding ResponseEncoding = CurrentResponseEncoding;
+                        const EMCPWireFormat ResponseFormat = CurrentResponseFormat;
+                        MCP_TRACE_EXECUTE_SCOPE(ToolName, Timer->GetRequestId());
+                        (*HandlerPtr)->ExecuteAsync(ToolParams, ClientSocket,
+                                                    [this, WeakLifetime, Response, ConnectionId, ResponseEncoding, ResponseFormat, ToolName, bHasId, RequestId, Timer](const TSharedPtr<FJsonObject> &ToolResult)
+                                                    {
+                            if (!WeakLifetime.IsValid())
+                            {
+                                return;
+                            }
+
+                            FMCPGameThreadScope GameThreadScope(Metrics);
+
+                            Timer->MarkExecuted();
+                            if (IsErrorResult(ToolResult))
+                            {
+                                Timer->MarkError();
+                            }
+                            TGuardValue<TSharedPtr<FMCPRequestTimer>> TimerScope(ActiveTimer, Timer);
+                            TGuardValue<EMCPContentEncoding> EncodingScope(CurrentResponseEncoding, ResponseEncoding);
+                            TGuardValue<EMCPWireFormat> FormatScope(CurrentResponseFormat, ResponseFormat);
+
+                            const FMCPClientConnection *Connection = EndAsyncRequest(ConnectionId);
+                            if (!Connection)
+                            {
+                                MCP_LOG_WARNING("Client disconnected before tool %s completed, dropping response", *ToolName);
+                                return;
+                            }
+                            FSocket *ClientSocket = Connection->Socket;
+
+                            if (ToolResult.IsValid())
+                            {
+                                SendToolCallResponse(ClientSocket, bHasId ? &RequestId : nullptr,
+                                                     [&ToolResult](FMCPJsonStreamWriter &Writer)
+                                                     { Writer.WriteJsonObject(ToolResult); });
+                            }
+                            else
+                            {
+                                TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                                Error->SetNumberField("code", -32603);
+                                Error->SetStringField("message", TEXT("Internal error: Tool returned null result"));
+                                Response->SetObjectField("error", Error);
+                                SendResponse(ClientSocket, Response);
+                            } });
+                    }
+                    else
+                    {
+                        TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                        Error->SetNumberField("code", -32601);
+                        Error->SetStringField("message", TEXT("Tool not found"));
+                        Response->SetObjectField("error", Error);
+                    }
+                }
+                else
+                {
+                    TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                    Error->SetNumberField("code", -32602);
+                    Error->SetStringField("message", TEXT("Missing 'name' parameter"));
+                    Response->SetObjectField("error", Error);
+                }
+            }
+            else
+            {
+                TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                Error->SetNumberField("code", -32602);
+                Error->SetStringField("message", TEXT("Missing 'params' object"));
+                Response->SetObjectField("error", Error);
+            }
+        }
+        else if (Method == TEXT("resources/list"))
+        {
+            Response->SetObjectField("result", ResourceManager->ListResources());
+        }
+        else if (Method == TEXT("resources/read") || Method == TEXT("resources/subscribe") || Method == TEXT("resources/unsubscribe"))
+        {
+            // 三个方法都只有 uri 参数
+            const TSharedPtr<FJsonObject> *ParamsObj = nullptr;
+            FString Uri;
+            if (!JsonObject->TryGetObjectField(TEXT("params"), ParamsObj) || !(*ParamsObj)->TryGetStringField(TEXT("uri"), Uri))
+            {
+                TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                Error->SetNumberField("code", -32602);
+                Error->SetStringField("message", TEXT("Missing 'uri' parameter"));
+                Response->SetObjectField("error", Error);
+            }
+            else if (Method == TEXT("resources/read"))
+            {
+                // 资源内容由处理器流式写出后直接嵌入响应,不经过 DOM
+                TArray<ANSICHAR> Body;
+                FMCPJsonStreamWriter Writer(Body);
+                Writer.BeginObject();
+                Writer.WriteField(TEXT("jsonrpc"), TEXT("2.0"));
+                if (bHasId)
+                {
+                    Writer.WriteField(TEXT("id"), RequestId);
+                }
+                Writer.WriteKey(TEXT("result"));
+
+                FString ReadError;
+                if (ResourceManager->ReadResource(Uri, Writer, ReadError))
+                {
+                    Writer.EndObject();
+                    bResponseDeferred = true;
+                    SendRawResponse(ClientSocket, Body.GetData(), Body.Num());
+                }
+                else
+                {
+                    TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                    Error->SetNumberField("code", -32002);
+                    Error->SetStringField("message", ReadError);
+                    Response->SetObjectField("error", Error);
+                }
+            }
+            else if (Method == TEXT("resources/subscribe") && IsHttpConnection(ClientSocket))
+            {
+                TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                Error->SetNumberField("code", -32600);
+                Error->SetStringField("message", TEXT("resources/subscribe requires a raw TCP connection, HTTP cannot carry server notifications"));
+                Response->SetObjectField("error", Error);
+            }
+            else
+            {
+                const bool bSubscribe = Method == TEXT("resources/subscribe");
+                const bool bSucceeded = bSubscribe ? ResourceManager->Subscribe(ClientSocket, Uri)
+                                                   : ResourceManager->Unsubscribe(ClientSocket, Uri);
+                if (bSucceeded || !bSubscribe)
+                {
+                    // 取消不存在的订阅视为成功
+                    Response->SetObjectField("result", MakeShared<FJsonObject>());
+                }
+                else
+                {
+                    TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+                    Error->SetNumberField("code", -32002);
+                    Error->SetStringField("message", FString::Printf(TEXT("Resource not found: %s"), *Uri));
+                    Response->SetObjectField("error", Error);
+                }
+            }
+        }
+        else
+        {
+            // 未知方法
+            TSharedPtr<FJsonObject> Error = MakeShared<FJsonObject>();
+            Error->SetNumberField("code", -32601);
+            Error->SetStringField("message", TEXT("Method not found"));
+            Response->SetObjectField("error", Error);
+            MCP_LOG_WARNING("Unknown JSON-RPC method: %s", *Method);
+        }
+
+        if (!bResponseDeferred)
+        {
+            SendResponse(ClientSocket, Response);
+        }
+    }
+    else
+    {
+        // 尝试简单命令格式（向后兼容）
+        FString CommandType;
+        if (JsonObject->TryGetStringField(TEXT("type"), CommandType))
+        {
+            FString ErrorPointer;
+            FString ErrorMessage;
+
+            TSharedPtr<IMCPCommandHandler> *HandlerPtr = CommandHandlers.Find(CommandType);
+
+            TSharedPtr<FMCPRequestTimer> Timer;
+            if (HandlerPtr)
+            {
+                Timer = BeginToolRequest(ClientSocket, CommandType, MCPTrace::NO_REQUEST_ID);
+            }
+
+            if (HandlerPtr && !ValidateCommandParams(CommandType, JsonObject, ErrorPointer, ErrorMessage))
+            {
+                Timer->MarkError();
+                TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+                Response->SetStringField("status", TEXT("error"));
+                Response->SetStringField("message", FString::Printf(TEXT("Invalid params: %s at '%s'"), *ErrorMessage, *ErrorPointer));
+                Response->SetStringField("pointer", ErrorPointer);
+                SendResponse(ClientSocket, Response);
+            }
+            else if (HandlerPtr && (*HandlerPtr)->SupportsStreaming())
+            {
+                MCP_LOG_INFO("Executing command (streaming): %s", *CommandType);
+
+                TArray<ANSICHAR> Body;
+                FMCPJsonStreamWriter Writer(Body);
+                {
+                    MCP_TRACE_EXECUTE_SCOPE(CommandType, MCPTrace::NO_REQUEST_ID);
+                    (*HandlerPtr)->ExecuteStreaming(JsonObject, ClientSocket, Writer);
+                }
+                Timer->MarkExecuted();
+
+                TGuardValue<TSharedPtr<FMCPRequestTimer>> TimerScope(ActiveTimer, Timer);
+                SendRawResponse(ClientSocket, Body.GetData(), Body.Num());
+            }
+            else if (HandlerPtr)
+            {
+                TSharedPtr<IMCPCommandHandler> Handler = *HandlerPtr;
+                MCP_LOG_INFO("Executing command: %s", *CommandType);
+
+                TWeakPtr<bool> WeakLifetime = LifetimeToken;
+                const uint64 ConnectionId = BeginAsyncRequest(ClientSocket);
+                const EMCPContentEncoding ResponseEncoding = CurrentResponseEncoding;
+                const EMCPWireFormat ResponseFormat = CurrentResponseFormat;
+                MCP_TRACE_EXECUTE_SCOPE(CommandType, MCPTrace::NO_REQUEST_ID);
+                Handler->ExecuteAsync(JsonObject, ClientSocket, [this, WeakLifetime, ConnectionId, ResponseEncoding, ResponseFormat, Timer](const TSharedPtr<FJsonObject> &Response)
+                                      {
+                    if (!WeakLifetime.IsValid())
+                    {
+                        return;
+                    }
+
+                    FMCPGameThreadScope GameThreadScope(Metrics);
+
+                    Timer->MarkExecuted();
+                    if (IsErrorResult(Response))
+                    {
+                        Timer->MarkError();
+                    }
+
+                    const FMCPClientConnection *Connection = EndAsyncRequest(ConnectionId);
+                    if (Response.IsValid() && Connection)
+                    {
+                        TGuardValue<TSharedPtr<FMCPRequestTimer>> TimerScope(ActiveTimer, Timer);
+                        TGuardValue<EMCPContentEncoding> EncodingScope(CurrentResponseEncoding, ResponseEncoding);
+                        TGuardValue<EMCPWireFormat> FormatScope(CurrentResponseFormat, ResponseFormat);
+                        SendResponse(Connection->Socket, Response);
+                    } });
+            }
+            else
+            {
+                TSharedPtr<FJsonObject> Response = MakeShared<FJsonObject>();
+                Response->SetStringField("status", TEXT("error"));
+                Response->SetStringField("message", FString::Printf(TEXT("Unknown command type: %s"), *CommandType));
+                SendResponse(ClientSocket, Response);
+            }
+        }
+        else
+        {
+            MCP_LOG_WARNING("Invalid request format. JSON keys: ");
+            TArray<FString> Keys;
+            JsonObject->Values.GetKeys(Keys);
+            for (const FString &Key : Keys)
+            {
+                MCP_LOG_WARNING("  - %s", *Key);
+            }
+        }
+    }
+}
+
+bool FMCPTCPServer::TryProcessStreamedCommand(const UTF8CHAR *Data, int32 Length, FSocket *ClientSocket)
+{
+    const double DispatchTime = FPlatformTime::Seconds();
+    FMCPJsonPullParser Parser(Data, Length);
+    if (Parser.Next() != EMCPJsonToken::BeginObject)
+    {
+        return false;
+    }
+
+    // 顶层成员: JSON-RPC 的 jsonrpc/id/method/params,或旧格式的 type 和参数
+    TSharedPtr<FJsonObject> Envelope = MakeShared<FJsonObject>();
+    TSharedPtr<FJsonObject> Response;
+    FString CommandName;
+    bool bStarted = false;
+
+    for (EMCPJsonToken Token = Parser.Next(); Token != EMCPJsonToken::EndObject; Token = Parser.Next())
+    {
+        if (Token != EMCPJsonToken::Key)
+        {
+            if (!bStarted)
+            {
+                return false;
+            }
+            break;
+        }
+        const FString Key = Parser.GetString();
+
+        if (Key == TEXT("params") && !bStarted)
+        {
+            // 只有已知为 tools/call 时才流式读取 params
+            FString Method;
+            if (!Envelope->TryGetStringField(TEXT("method"), Method) || Method != TEXT("tools/call") ||
+                Parser.Next() != EMCPJsonToken::BeginObject)
+            {
+                return false;
+            }
+
+            for (EMCPJsonToken ParamToken = Parser.Next(); ParamToken != EMCPJsonToken::EndObject; ParamToken = Parser.Next())
+            {
+                if (ParamToken != EMCPJsonToken::Key)
+                {
+                    if (!bStarted)
+                    {
+                        return false;
+                    }
+                    break;
+                }
+                const FString ParamKey = Parser.GetString();
+
+                if (ParamKey == TEXT("name") && !bStarted)
+                {
+                    TSharedPtr<FJsonValue> NameValue = Parser.ReadValue();
+                    if (!NameValue.IsValid() || !NameValue->TryGetString(CommandName))
+                    {
+                        return false;
+                    }
+                }
+                else if (ParamKey == TEXT("arguments") && !bStarted)
+                {
+                    // arguments 出现在 name 之前时无法确定处理器,走普通路径
+                    TSharedPtr<IMCPCommandHandler> Handler = CommandHandlers.FindRef(CommandName);
+                    if (!Handler.IsValid() || Handler->GetStreamedArrayField().IsEmpty() ||
+                        Parser.Next() != EMCPJsonToken::BeginObject)
+                    {
+                        return false;
+                    }
+
+                    int32 TraceRequestId = MCPTrace::NO_REQUEST_ID;
+                    Envelope->TryGetNumberField(TEXT("id"), TraceRequestId);
+                    MCP_TRACE_EXECUTE_SCOPE(CommandName, TraceRequestId);
+                    Response = StreamCommandParams(Parser, CommandName, Handler, ClientSocket, MakeShared<FJsonObject>(), bStarted);
+                    if (!bStarted)
+                    {
+                        return false;
+                    }
+                }
+                else if (!Parser.SkipValue())
+                {
+                    if (!bStarted)
+                    {
+                        return false;
+                    }
+                    break;
+                }
+            }
+            continue;
+        }
+
+        TSharedPtr<FJsonValue> Value = Parser.ReadValue();
+        if (!Value.IsValid())
+        {
+            if (!bStarted)
+            {
+                return false;
+            }
+            break;
+        }
+        Envelope->SetField(Key, Value);
+
+        if (bStarted)
+        {
+            continue;
+        }
+
+        if (Key == TEXT("method"))
+        {
+            // tools/call 以外的方法走普通路径
+            if (Value->AsString() != TEXT("tools/call"))
+            {
+                return false;
+            }
+        }
+        else if (Key == TEXT("type") && !Envelope->HasField(TEXT("method")))
+        {
+            // 旧格式: 顶层对象即参数,其余成员由 StreamCommandParams 读取
+            CommandName = Value->AsString();
+            TSharedPtr<IMCPCommandHandler> Handler = CommandHandlers.FindRef(CommandName);
+            if (!Handler.IsValid() || Handler->GetStreamedArrayField().IsEmpty())
+            {
+                return false;
+            }
+
+            MCP_TRACE_EXECUTE_SCOPE(CommandName, MCPTrace::NO_REQUEST_ID);
+            Response = StreamCommandParams(Parser, CommandName, Handler, ClientSocket, Envelope, bStarted);
+            if (!bStarted)
+            {
+                return false;
+            }
+            break;
+        }
+    }
+
+    if (!bStarted)
+    {
+        return false;
+    }
+
+    int32 RequestId = MCPTrace::NO_REQUEST_ID;
+    const bool bHasId = Envelope->TryGetNumberField(TEXT("id"), RequestId);
+
+    // 流式请求的解析与执行交织,一并计入执行阶段
+    TSharedPtr<FMCPRequestTimer> Timer = BeginToolRequest(ClientSocket, CommandName, RequestId, DispatchTime);
+    Timer->MarkExecuted();
+    if (IsErrorResult(Response))
+    {
+        Timer->MarkError();
+    }
+    TGuardValue<TSharedPtr<FMCPRequestTimer>> TimerScope(ActiveTimer, Timer);
+
+    if (Envelope->HasField(TEXT("method")))
+    {
+        SendToolCallResponse(ClientSocket, bHasId ? &RequestId : nullptr,
+                             [&Response](FMCPJsonStreamWriter &Writer)
+                             { Writer.WriteJsonObject(Response); });
+    }
+    else
+    {
+        SendResponse(ClientSocket, Response);
+    }
+    return true;
+}
+
+TSharedPtr<FJsonObject> FMCPTCPServer::StreamCommandParams(FMCPJsonPullParser &Parser, const FString &CommandName,
+                                                           const TSharedPtr<IMCPCommandHandler> &Handler, FSocket *ClientSocket,
+                                                           const TSharedPtr<FJsonObject> &OtherParams, bool &bOutStarted)
+{
+    bOutStarted = false;
+
+    const FString ArrayField = Handler->GetStreamedArrayField();
+    const TSharedPtr<FMCPSchemaValidator> Validator = Validators.FindRef(CommandName);
+    TSharedPtr<IMCPStreamedArrayConsumer> Consumer;
+    int32 ElementCount = 0;
+    const double StartTime = FPlatformTime::Seconds();
+
+    for (EMCPJsonToken Token = Parser.Next(); Token != EMCPJsonToken::EndObject; Token = Parser.Next())
+    {
+        if (Token != EMCPJsonToken::Key)
+        {
+            if (!bOutStarted)
+            {
+                return nullptr;
+            }
+            Consumer->Reject(ElementCount, Parser.GetError());
+            break;
+        }
+        const FString Key = Parser.GetString();
+
+        if (Key != ArrayField || bOutStarted)
+        {
+            TSharedPtr<FJsonValue> Value = Parser.ReadValue();
+            if (!Value.IsValid())
+            {
+                if (!bOutStarted)
+                {
+                    return nullptr;
+                }
+                Consumer->Reject(ElementCount, Parser.GetError());
+                break;
+            }
+            OtherParams->SetField(Key, Value);
+            continue;
+        }
+
+        // 数组参数不是数组时交给普通路径报告校验错误
+        if (Parser.Next() != EMCPJsonToken::BeginArray)
+        {
+            return nullptr;
+        }
+        Consumer = Handler->CreateArrayConsumer(ClientSocket);
+        if (!Consumer.IsValid())
+        {
+            return nullptr;
+        }
+        bOutStarted = true;
+
+        MCP_LOG_INFO("Executing %s with streamed '%s' entries", *CommandName, *ArrayField);
+
+        // 每解码一个元素立即处理,后面的元素此时尚未解析
+        while (true)
+        {
+            TSharedPtr<FJsonValue> Element = Parser.ReadValue();
+            if (!Element.IsValid())
+            {
+                if (!Parser.GetError().IsEmpty())
+                {
+                    Consumer->Reject(ElementCount, Parser.GetError());
+                }
+                break;
+            }
+
+            FMCPSchemaValidator::FError Error;
+            if (Validator.IsValid() && !Validator->ValidateArrayElement(ArrayField, ElementCount, Element, Error))
+            {
+                Consumer->Reject(ElementCount, FString::Printf(TEXT("Invalid params: %s at '%s'"), *Error.Message, *Error.Pointer));
+            }
+            else
+            {
+                Consumer->Consume(ElementCount, Element);
+            }
+            ++ElementCount;
+        }
+
+        if (!Parser.GetError().IsEmpty())
+        {
+            break;
+        }
+    }
+
+    if (!bOutStarted)
+    {
+        return nullptr;
+    }
+
+    MCP_LOG_INFO("Streamed %d '%s' entries of %s in %.2f ms", ElementCount, *ArrayField, *CommandName,
+                 (FPlatformTime::Seconds() - StartTime) * 1000.0);
+    return Consumer->Finish(OtherParams);
+}
+
+void FMCPTCPServer::SendResponse(FSocket *Client, const TSharedPtr<FJsonObject> &Response)
+{
+    if (!Client || !Response.IsValid())
+    {
+        return;
+    }
+
+    // 直接序列化为 UTF-8,不经过 FString 中转
+    TArray<ANSICHAR> Body;
+    {
+        MCP_TRACE_REQUEST_SCOPE(Serialize, "MCP.Serialize", ActiveTimer.Get());
+        FMCPJsonStreamWriter Writer(Body);
+        Writer.WriteJsonObject(Response);
+    }
+
+    if (ActiveTimer.IsValid())
+    {
+        ActiveTimer->MarkSerialized();
+    }
+    SendRawResponse(Client, Body.GetData(), Body.Num());
+}
+
+namespace
+{
+    /** 组合 HTTP 响应头和响应体,可在任意线程调用 */
+    TArray<uint8> BuildHttpResponse(const uint8 *Body, int32 BodyLength, const TCHAR *ContentType, const FString &ExtraHeaders)
+    {
+        FString HttpHeader = TEXT("HTTP/1.1 200 OK\r\n");
+        HttpHeader += FString::Printf(TEXT("Content-Type: %s\r\n"), ContentType);
+        HttpHeader += TEXT("Access-Control-Allow-Origin: *\r\n");
+        HttpHeader += TEXT("Connection: close\r\n");
+        HttpHeader += ExtraHeaders;
+        HttpHeader += FString::Printf(TEXT("Content-Length: %d\r\n"), BodyLength);
+        HttpHeader += TEXT("\r\n");
+
+        // 响应头和响应体合并为一次发送
+        FTCHARToUTF8 HeaderConverter(*HttpHeader);
+        TArray<uint8> Buffer;
+        Buffer.Reserve(HeaderConverter.Length() + BodyLength);
+        Buffer.Append(reinterpret_cast<const uint8 *>(HeaderConverter.Get()), HeaderConverter.Length());
+        Buffer.Append(Body, BodyLength);
+        return Buffer;
+    }
+
+    /**
+     * 按协商的编码压缩响应体
+     * @return 压缩失败或没有变小时返回 false
+     */
+    bool CompressBody(const uint8 *Body, int32 BodyLength, EMCPContentEncoding Encoding, TArray<uint8> &OutCompressed)
+    {
+        const double StartTime = FPlatformTime::Seconds();
+
+        // HTTP 的 deflate 指 zlib 格式(RFC 1950),对应 NAME_Zlib
+        const FName FormatName = Encoding == EMCPContentEncoding::Gzip ? NAME_Gzip : NAME_Zlib;
+
+        int32 CompressedSize = FCompression::CompressMemoryBound(FormatName, BodyLength);
+        OutCompressed.SetNumUninitialized(CompressedSize);
+
+        if (!FCompression::CompressMemory(FormatName, OutCompressed.GetData(), CompressedSize, Body, BodyLength) ||
+            CompressedSize >= BodyLength)
+        {
+            MCP_LOG_VERBOSE("Response of %d bytes not compressed with %s", BodyLength, *FormatName.ToString());
+            return false;
+        }
+
+        OutCompressed.SetNum(CompressedSize, EAllowShrinking::No);
+        MCP_LOG_VERBOSE("Compressed response with %s: %d -> %d bytes in %.2f ms", *FormatName.ToString(), BodyLength, CompressedSize,
+                        (FPlatformTime::Seconds() - StartTime) * 1000.0);
+        return true;
+    }
+
+    /**
+     * 把 UTF-8 JSON 响应体按协商的格式和内容编码组合为 HTTP 响应,可在任意线程调用
+     * 转码失败时按 JSON 发送,客户端可由 Content-Type 区分
+     */
+    TArray<uint8> EncodeHttpResponse(const ANSICHAR *Json, int32 JsonLength, EMCPWireFormat Format, EMCPContentEncoding Encoding,
+                                     const FString &ExtraHeaders)
+    {
+        const uint8 *Body = reinterpret_cast<const uint8 *>(Json);
+        int32 BodyLength = JsonLength;
+
+        TArray<uint8> Transcoded;
+        if (Format != EMCPWireFormat::Json)
+        {
+            FString Error;
+            if (FMCPBinaryCodec::TranscodeJson(Format, Json, JsonLength, Transcoded, Error))
+            {
+                Body = Transcoded.GetData();
+                BodyLength = Transcoded.Num();
+            }
+            else
+            {
+                MCP_LOG_ERROR("Failed to encode response as %s, sending JSON: %s", FMCPBinaryCodec::GetFormatName(Format), *Error);
+                Format = EMCPWireFormat::Json;
+            }
+        }
+
+        TArray<uint8> Compressed;
+        if (Encoding != EMCPContentEncoding::Identity && CompressBody(Body, BodyLength, Encoding, Compressed))
+        {
+            const TCHAR *CodingName = Encoding == EMCPContentEncoding::Gzip ? TEXT("gzip") : TEXT("deflate");
+            const FString Headers = ExtraHeaders + FString::Printf(TEXT("Content-Encoding: %s\r\nVary: Accept-Encoding\r\n"), CodingName);
+            return BuildHttpResponse(Compressed.GetData(), Compressed.Num(), FMCPBinaryCodec::GetMimeType(Format), Headers);
+        }
+
+        return BuildHttpResponse(Body, BodyLength, FMCPBinaryCodec::GetMimeType(Format), ExtraHeaders);
+    }
+}
+
+void FMCPTCPServer::SendRawResponse(FSocket *Client, const ANSICHAR *Body, int32 BodyLength, const FString &ExtraHeaders)
+{
+    if (!Client || !Body)
+    {
+        return;
+    }
+
+    MCP_TRACE_REQUEST_SCOPE(Send, "MCP.Send", ActiveTimer.Get());
+
+    FMCPClientConnection *Connection = FindClientConnection(Client);
+    const EMCPWireFormat Format = Connection ? CurrentResponseFormat : EMCPWireFormat::Json;
+    const EMCPContentEncoding Encoding = Connection && Config.bEnableCompression && BodyLength >= Config.CompressionThresholdBytes
+                                             ? CurrentResponseEncoding
+                                             : EMCPContentEncoding::Identity;
+
+    // 压缩和大响应的二进制转码在线程池中进行
+    const bool bEncodeInBackground = Encoding != EMCPContentEncoding::Identity ||
+                                     (Format != EMCPWireFormat::Json && BodyLength >= MCPConstants::MIN_BACKGROUND_ENCODE_BYTES);
+
+    if (!bEncodeInBackground)
+    {
+        SendHttpResponse(Client, EncodeHttpResponse(Body, BodyLength, Format, EMCPContentEncoding::Identity, ExtraHeaders));
+        return;
+    }
+
+    // 完成后回到游戏线程按队列顺序发送
+    TSharedRef<FMCPPendingResponse> Pending = MakeShared<FMCPPendingResponse>();
+    Pending->Timer = ActiveTimer;
+    Connection->SendQueue.Add(Pending);
+
+    TArray<ANSICHAR> BodyCopy(Body, BodyLength);
+    TWeakPtr<bool> WeakLifetime = LifetimeToken;
+    const uint64 ConnectionId = Connection->Id;
+
+    Async(EAsyncExecution::ThreadPool, [this, WeakLifetime, ConnectionId, Pending, Body = MoveTemp(BodyCopy), Format, Encoding, ExtraHeaders]()
+          {
+        TArray<uint8> Response;
+        {
+            MCP_TRACE_SCOPE("MCP.Encode");
+            Response = EncodeHttpResponse(Body.GetData(), Body.Num(), Format, Encoding, ExtraHeaders);
+        }
+
+        AsyncTask(ENamedThreads::GameThread, [this, WeakLifetime, ConnectionId, Pending, Response = MoveTemp(Response)]() mutable
+                  {
+            if (!WeakLifetime.IsValid())
+            {
+                return;
+            }
+
+            FMCPGameThreadScope GameThreadScope(Metrics);
+            Pending->Data = MoveTemp(Response);
+            Pending->bReady = true;
+
+            // 连接已断开时队列随连接一起释放
+            if (FMCPClientConnection *Connection = FindClientConnectionById(ConnectionId))
+            {
+                FlushSendQueue(*Connection);
+            } }); });
+}
+
+void FMCPTCPServer::SendHttpResponse(FSocket *Client, TArray<uint8> &&Buffer)
+{
+    // 前面还有编码中或未写完的响应时排队,保持响应顺序
+    FMCPClientConnection *Connection = FindClientConnection(Client);
+    if (Connection && Connection->SendQueue.Num() > 0)
+    {
+        TSharedRef<FMCPPendingResponse> Pending = MakeShared<FMCPPendingResponse>();
+        Pending->Data = MoveTemp(Buffer);
+        Pending->bReady = true;
+        Pending->Timer = ActiveTimer;
+        Connection->SendQueue.Add(Pending);
+        return;
+    }
+
+    int32 Offset = 0;
+    if (!SendHttpBytes(Client, Buffer, Offset, ActiveTimer) && Connection)
+    {
+        // 发送缓冲区已满,剩余部分排队
+        TSharedRef<FMCPPendingResponse> Pending = MakeShared<FMCPPendingResponse>();
+        Pending->Data = MoveTemp(Buffer);
+        Pending->Offset = Offset;
+        Pending->bReady = true;
+        Pending->Timer = ActiveTimer;
+        Connection->SendQueue.Add(Pending);
+    }
+}
+
+void FMCPTCPServer::SendNotificationLine(FSocket *Client, const TSharedPtr<FJsonObject> &Notification)
+{
+    TArray<ANSICHAR> Line;
+    {
+        FMCPJsonStreamWriter Writer(Line);
+        Writer.WriteJsonObject(Notification);
+    }
+    Line.Add('\n');
+
+    // 通知不属于任何请求,不计入请求耗时
+    TGuardValue<TSharedPtr<FMCPRequestTimer>> TimerScope(ActiveTimer, nullptr);
+    SendHttpResponse(Client, TArray<uint8>(reinterpret_cast<const uint8 *>(Line.GetData()), Line.Num()));
+}
+
+bool FMCPTCPServer::SendHttpBytes(FSocket *Client, const TArray<uint8> &Buffer, int32 &InOutOffset, const TSharedPtr<FMCPRequestTimer> &Timer)
+{
+    int32 BytesSent = 0;
+    const bool bSent = Client->Send(Buffer.GetData() + InOutOffset, Buffer.Num() - InOutOffset, BytesSent);
+    if (!bSent)
+    {
+        const int32 ErrorCode = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+        if (ErrorCode == SE_EWOULDBLOCK)
+        {
+            return false;
+        }
+        MCP_LOG_ERROR("Failed to send response to client (error %d)", ErrorCode);
+    }
+
+    BytesSent = FMath::Max(BytesSent, 0);
+    InOutOffset += BytesSent;
+    Metrics->AddBytesSent(BytesSent);
+    MCPTrace::AddBytesSent(BytesSent);
+
+    if (bSent && InOutOffset < Buffer.Num())
+    {
+        MCP_LOG_VERBOSE("Sent %d of %d bytes HTTP response, waiting for send buffer", InOutOffset, Buffer.Num());
+        return false;
+    }
+    MCP_LOG_VERBOSE("Sent %d bytes HTTP response to client", InOutOffset);
+
+    if (!Timer.IsValid())
+    {
+        return true;
+    }
+
+    Timer->MarkSent();
+    if (Journal.IsValid())
+    {
+        if (const FMCPClientConnection *Connection = FindClientConnection(Client))
+        {
+            Journal->RecordResponse(Connection->Endpoint, Timer->GetCommand(), Timer->GetRequestId(), InOutOffset,
+                                    FPlatformTime::Seconds() - Timer->GetReceiveTime(), Timer->HasError() || !bSent);
+        }
+    }
+    return true;
+}
+
+TSharedPtr<FMCPRequestTimer> FMCPTCPServer::BeginToolRequest(FSocket *ClientSocket, const FString &Command, int32 RequestId, double DispatchTime)
+{
+    TSharedPtr<FMCPRequestTimer> Timer = MakeShared<FMCPRequestTimer>(Metrics, Command, CurrentMessageReceiveTime, DispatchTime);
+    Timer->SetRequestId(RequestId);
+
+    if (Journal.IsValid())
+    {
+        if (const FMCPClientConnection *Connection = FindClientConnection(ClientSocket))
+        {
+            Journal->RecordRequest(Connection->Endpoint, Command, RequestId, CurrentMessageBody.Len(),
+                                   CurrentMessageFormat == EMCPWireFormat::Json ? CurrentMessageBody : FUtf8StringView());
+        }
+    }
+    return Timer;
+}
+
+void FMCPTCPServer::SendMetricsResponse(FSocket *Client)
+{
+    const FString Text = Metrics->FormatPrometheus();
+    FTCHARToUTF8 Converter(*Text);
+    SendHttpResponse(Client, BuildHttpResponse(reinterpret_cast<const uint8 *>(Converter.Get()), Converter.Length(),
+                                               TEXT("text/plain; version=0.0.4; charset=utf-8"), FString()));
+}
+
+FMCPClientConnection *FMCPTCPServer::FindClientConnection(FSocket *Client)
+{
+    if (!Client)
+    {
+        return nullptr;
+    }
+
+    return ClientConnections.FindByPredicate([Client](const FMCPClientConnection &Connection)
+                                             { return Connection.Socket == Client; });
+}
+
+FMCPClientConnection *FMCPTCPServer::FindClientConnectionById(uint64 ConnectionId)
+{
+    return ClientConnections.FindByPredicate([ConnectionId](const FMCPClientConnection &Connection)
+                                             { return Connection.Id == ConnectionId; });
+}
+
+uint64 FMCPTCPServer::BeginAsyncRequest(FSocket *Client)
+{
+    FMCPClientConnection *Connection = FindClientConnection(Client);
+    if (!Connection)
+    {
+        return 0;
+    }
+
+    if (Connection->PendingAsyncRequests++ == 0)
+    {
+        Connection->TimeSinceAsyncProgress = 0.0f;
+    }
+    return Connection->Id;
+}
+
+FMCPClientConnection *FMCPTCPServer::EndAsyncRequest(uint64 ConnectionId)
+{
+    FMCPClientConnection *Connection = FindClientConnectionById(ConnectionId);
+    if (Connection)
+    {
+        Connection->PendingAsyncRequests--;
+        Connection->TimeSinceLastActivity = 0.0f;
+        Connection->TimeSinceAsyncProgress = 0.0f;
+    }
+    return Connection;
+}
+
+void FMCPTCPServer::FlushSendQueue(FMCPClientConnection &Connection)
+{
+    MCP_TRACE_SCOPE("MCP.Send");
+
+    // SendHttpBytes 不会修改连接列表,Connection 在循环中保持有效
+    int32 SentCount = 0;
+    while (SentCount < Connection.SendQueue.Num() && Connection.SendQueue[SentCount]->bReady)
+    {
+        FMCPPendingResponse &Pending = *Connection.SendQueue[SentCount];
+        const int32 PreviousOffset = Pending.Offset;
+        if (PreviousOffset == 0)
+        {
+            MCPTrace::OutputRequest(MCPTrace::EPhase::Send, Pending.Timer.Get());
+        }
+        const bool bComplete = SendHttpBytes(Connection.Socket, Pending.Data, Pending.Offset, Pending.Timer);
+
+        // 客户端仍在读取大响应,不算空闲
+        if (Pending.Offset > PreviousOffset)
+        {
+            Connection.TimeSinceLastActivity = 0.0f;
+        }
+        if (!bComplete)
+        {
+            break;
+        }
+        ++SentCount;
+    }
+    Connection.SendQueue.RemoveAt(0, SentCount);
+}
+
+void FMCPTCPServer::FlushAllSendQueues()
+{
+    for (int32 Index = 0; Index < ClientConnections.Num(); ++Index)
+    {
+        FMCPClientConnection &Connection = ClientConnections[Index];
+        if (Connection.SendQueue.Num() > 0 && Connection.SendQueue[0]->bReady)
+        {
+            FlushSendQueue(Connection);
+        }
+    }
+}
+
+void FMCPTCPServer::RebuildToolsListCache()
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    TArray<TSharedPtr<FJsonValue>> Tools;
+    Tools.Reserve(CommandHandlers.Num());
+
+    for (const auto &Pair : CommandHandlers)
+    {
+        TSharedPtr<FJsonObject> Tool = MakeShared<FJsonObject>();
+        Tool->SetStringField("name", Pair.Key);
+        Tool->SetStringField("description", Pair.Value->GetDescription());
+
+        TSharedPtr<FJsonObject> InputSchema = Pair.Value->GetInputSchema();
+        if (!InputSchema.IsValid())
+        {
+            InputSchema = MakeShared<FJsonObject>();
+            InputSchema->SetStringField("type", TEXT("object"));
+        }
+        Tool->SetObjectField("inputSchema", InputSchema);
+
+        Tools.Add(MakeShared<FJsonValueObject>(Tool));
+    }
+
+    TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+    Result->SetArrayField("tools", Tools);
+
+    ToolsListCache.Reset();
+    FMCPJsonStreamWriter Writer(ToolsListCache);
+    Writer.WriteJsonObject(Result);
+
+    const FXxHash64 Hash = FXxHash64::HashBuffer(ToolsListCache.GetData(), ToolsListCache.Num());
+    ToolsListETag = FString::Printf(TEXT("\"%016llx\""), Hash.Hash);
+
+    MCP_LOG_INFO("Built tools/list cache: %d tools, %d bytes in %.2f ms",
+                 Tools.Num(), ToolsListCache.Num(), (FPlatformTime::Seconds() - StartTime) * 1000.0);
+}
+
+void FMCPTCPServer::SendToolsListResponse(FSocket *ClientSocket, const int32 *RequestId)
+{
+    // JSON-RPC 信封很短,直接拼接在缓存的结果对象前后
+    const FString Envelope = RequestId
+                                 ? FString::Printf(TEXT("{\"jsonrpc\":\"2.0\",\"id\":%d,\"result\":"), *RequestId)
+                                 : FString(TEXT("{\"jsonrpc\":\"2.0\",\"result\":"));
+    FTCHARToUTF8 EnvelopeConverter(*Envelope);
+
+    TArray<ANSICHAR> Body;
+    Body.Reserve(EnvelopeConverter.Length() + ToolsListCache.Num() + 1);
+    Body.Append(EnvelopeConverter.Get(), EnvelopeConverter.Length());
+    Body.Append(ToolsListCache);
+    Body.Add('}');
+
+    SendRawResponse(ClientSocket, Body.GetData(), Body.Num(), FString::Printf(TEXT("ETag: %s\r\n"), *ToolsListETag));
+    MCP_LOG_VERBOSE("Sent tools/list response (%d bytes, ETag %s)", Body.Num(), *ToolsListETag);
+}
+
+void FMCPTCPServer::SendToolCallResponse(FSocket *ClientSocket, const int32 *RequestId, TFunctionRef<void(FMCPJsonStreamWriter &)> WriteToolResult)
+{
+    TArray<ANSICHAR> Body;
+    int32 ResultLength = 0;
+    {
+        MCP_TRACE_REQUEST_SCOPE(Serialize, "MCP.Serialize", ActiveTimer.Get());
+        FMCPJsonStreamWriter Writer(Body);
+
+        Writer.BeginObject();
+        Writer.WriteField(TEXT("jsonrpc"), TEXT("2.0"));
+        if (RequestId)
+        {
+            Writer.WriteField(TEXT("id"), *RequestId);
+        }
+
+        Writer.WriteKey(TEXT("result"));
+        Writer.BeginObject();
+
+        // 结果以 JSON 对象写入 structuredContent,不再序列化成字符串后二次转义
+        Writer.WriteKey(TEXT("structuredContent"));
+        const int32 ResultStart = Writer.GetPosition();
+        WriteToolResult(Writer);
+        ResultLength = Writer.GetPosition() - ResultStart;
+
+        // MCP 要求 content 数组;只读取 content 的客户端依赖其中的完整文本,
+        // 声明支持 structuredContent 的客户端收到大结果时只附说明,避免结果编码两次
+        const FMCPClientConnection *Connection = FindClientConnection(ClientSocket);
+        const bool bWriteText = ResultLength <= MCPConstants::MAX_TOOL_RESULT_TEXT_BYTES || !Connection || !Connection->bStructuredContent;
+
+        Writer.WriteKey(TEXT("content"));
+        Writer.BeginArray();
+        Writer.BeginObject();
+        Writer.WriteField(TEXT("type"), TEXT("text"));
+        Writer.WriteKey(TEXT("text"));
+        if (bWriteText)
+        {
+            Writer.WriteBufferRangeAsString(ResultStart, ResultLength);
+        }
+        else
+        {
+            Writer.WriteString(FString::Printf(TEXT("Result is %d bytes, see structuredContent"), ResultLength));
+        }
+        Writer.EndObject();
+        Writer.EndArray();
+
+        Writer.EndObject();
+        Writer.EndObject();
+    }
+
+    if (ActiveTimer.IsValid())
+    {
+        ActiveTimer->MarkSerialized();
+    }
+    SendRawResponse(ClientSocket, Body.GetData(), Body.Num());
+    MCP_LOG_VERBOSE("Sent tools/call response (%d bytes, result %d bytes)", Body.Num(), ResultLength);
+}
+
+bool FMCPTCPServer::IsClientConnected(FSocket *Client) const
+{
+    if (!Client)
+    {
+        return false;
+    }
+
+    return ClientConnections.ContainsByPredicate([Client](const FMCPClientConnection &Connection)
+                                                 { return Connection.Socket == Client; });
+}
+
+bool FMCPTCPServer::IsHttpConnection(FSocket *Client) const
+{
+    const FMCPClientConnection *Connection = ClientConnections.FindByPredicate([Client](const FMCPClientConnection &Candidate)
+                                                                               { return Candidate.Socket == Client; });
+    return Connection && Connection->bHttp;
+}
+
+void FMCPTCPServer::CheckClientTimeouts(float DeltaTime)
+{
+    for (int32 i = ClientConnections.Num() - 1; i >= 0; i--)
+    {
+        FMCPClientConnection &ClientConnection = ClientConnections[i];
+        ClientConnection.TimeSinceLastActivity += DeltaTime;
+
+        // 有未完成异步请求的连接等待响应,不按空闲超时断开;
+        // 但处理器可能永远不回调,超过硬性期限仍没有异步请求完成时断开,避免连接永久占用
+        if (ClientConnection.PendingAsyncRequests > 0)
+        {
+            ClientConnection.TimeSinceAsyncProgress += DeltaTime;
+            const float AsyncDeadline = Config.ClientTimeoutSeconds * MCPConstants::ASYNC_REQUEST_TIMEOUT_MULTIPLIER;
+            if (ClientConnection.TimeSinceAsyncProgress > AsyncDeadline)
+            {
+                MCP_LOG_WARNING("Client %s closed: %d async request(s) did not complete within %.1f seconds",
+                                *ClientConnection.Endpoint.ToString(),
+                                ClientConnection.PendingAsyncRequests,
+                                AsyncDeadline);
+                CleanupClientConnection(ClientConnection);
+            }
+            continue;
+        }
+
+        // 有资源订阅的连接等待服务器推送,不按空闲超时断开
+        if (ResourceManager.IsValid() && ResourceManager->HasSubscriptions(ClientConnection.Socket))
+        {
+            continue;
+        }
+
+        if (ClientConnection.TimeSinceLastActivity > Config.ClientTimeoutSeconds)
+        {
+            MCP_LOG_WARNING("Client %s timed out after %.1f seconds",
+                            *ClientConnection.Endpoint.ToString(),
+                            ClientConnection.TimeSinceLastActivity);
+            CleanupClientConnection(ClientConnection);
+        }
+    }
+}
+
+void FMCPTCPServer::CleanupAllClientConnections()
+{
     MCP_LOG_INFO("Cleaning up all client connections (%d clients)", ClientConnections.Num());
 
     for (FMCPClientConnection &ClientConnection : ClientConnections)
@@ -907,6 +2120,11 @@ void FMCPTCPServer::CleanupClientConnection(FMCPClientConnection &ClientConnecti
     {
         MCP_LOG_INFO("Cleaning up client connection from %s", *ClientConnection.Endpoint.ToString());
 
+        if (ResourceManager.IsValid())
+        {
+            ResourceManager->RemoveClient(ClientConnection.Socket);
+        }
+
         ClientConnection.Socket->Close();
         ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(ClientConnection.Socket);
         ClientConnection.Socket = nullptr;
@@ -952,6 +2170,12 @@ FMCPTCPServerConfig FMCPTCPServerConfig::FromSettings(const class UMCPSettings *
         Config.TickIntervalSeconds = Settings->ServerTickInterval;
         Config.MaxActorsInSceneInfo = Settings->MaxActorsInSceneInfo;
         Config.CommandExecutionTimeout = Settings->CommandExecutionTimeout;
+        Config.bEnableCompression = Settings->bEnableCompression;
+        Config.CompressionThresholdBytes = Settings->CompressionThresholdBytes;
+        Config.bEnableRequestJournal = Settings->bEnableRequestJournal;
+        Config.JournalMaxFileSizeMB = Settings->JournalMaxFileSizeMB;
+        Config.JournalMaxFiles = Settings->JournalMaxFiles;
+        Config.JournalPayloadSampleRate = Settings->JournalPayloadSampleRate;
     }
 
     return Config;
@@ -984,6 +2208,22 @@ bool FMCPTCPServerConfig::Validate(FString &OutErrorMessage) const
         return false;
     }
 
+    // 验证压缩阈值
+    if (bEnableCompression && (CompressionThresholdBytes < 256 || CompressionThresholdBytes > 1048576))
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid compression threshold %d. Must be between 256 and 1048576 bytes."),
+                                          CompressionThresholdBytes);
+        return false;
+    }
+
+    // 验证请求日志
+    if (bEnableRequestJournal && (JournalMaxFileSizeMB < 1 || JournalMaxFileSizeMB > 1024 || JournalMaxFiles < 1 || JournalMaxFiles > 100))
+    {
+        OutErrorMessage = FString::Printf(TEXT("Invalid journal rotation %d MB x %d files. Size must be 1-1024 MB and count 1-100."),
+                                          JournalMaxFileSizeMB, JournalMaxFiles);
+        return false;
+    }
+
     OutErrorMessage.Empty();
     return true;
 }
@@ -0,0 +1,75 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MCPTrace.h"
+#include "MCPServerMetrics.h"
+#include "ProfilingDebugging/CountersTrace.h"
+#include "HAL/PlatformTLS.h"
+
+UE_TRACE_CHANNEL_DEFINE(MCPChannel);
+
+UE_TRACE_EVENT_BEGIN(MCP, Request)
+    UE_TRACE_EVENT_FIELD(uint64, Cycle)
+    UE_TRACE_EVENT_FIELD(uint32, ThreadId)
+    UE_TRACE_EVENT_FIELD(int32, RequestId)
+    UE_TRACE_EVENT_FIELD(uint8, Phase)
+    UE_TRACE_EVENT_FIELD(UE::Trace::WideString, Tool)
+UE_TRACE_EVENT_END()
+
+TRACE_DECLARE_INT_COUNTER(MCP_PendingMessages, TEXT("MCP/PendingMessages"));
+TRACE_DECLARE_INT_COUNTER(MCP_SendQueueDepth, TEXT("MCP/SendQueueDepth"));
+TRACE_DECLARE_MEMORY_COUNTER(MCP_BytesReceived, TEXT("MCP/BytesReceived"));
+TRACE_DECLARE_MEMORY_COUNTER(MCP_BytesSent, TEXT("MCP/BytesSent"));
+
+namespace MCPTrace
+{
+    void OutputRequest(EPhase Phase, const FString &Tool, int32 RequestId)
+    {
+        UE_TRACE_LOG(MCP, Request, MCPChannel)
+            << Request.Cycle(FPlatformTime::Cycles64())
+            << Request.ThreadId(FPlatformTLS::GetCurrentThreadId())
+            << Request.RequestId(RequestId)
+            << Request.Phase(static_cast<uint8>(Phase))
+            << Request.Tool(*Tool, Tool.Len());
+    }
+
+    void OutputRequest(EPhase Phase, const FMCPRequestTimer *Timer)
+    {
+        if (Timer && UE_TRACE_CHANNELEXPR_IS_ENABLED(MCPChannel))
+        {
+            OutputRequest(Phase, Timer->GetCommand(), Timer->GetRequestId());
+        }
+    }
+
+    const TCHAR *GetExecuteScopeName(const FString &Tool)
+    {
+        // 工具集合有限,名称常驻以免每次调用都格式化
+        static TMap<FString, FString> ScopeNames;
+
+        const FString *Cached = ScopeNames.Find(Tool);
+        if (!Cached)
+        {
+            Cached = &ScopeNames.Add(Tool, FString::Printf(TEXT("MCP.Execute(%s)"), *Tool));
+        }
+        return **Cached;
+    }
+
+    void SetPendingMessages(int32 Count)
+    {
+        TRACE_COUNTER_SET(MCP_PendingMessages, Count);
+    }
+
+    void SetSendQueueDepth(int32 Depth)
+    {
+        TRACE_COUNTER_SET(MCP_SendQueueDepth, Depth);
+    }
+
+    void AddBytesReceived(int64 Bytes)
+    {
+        TRACE_COUNTER_ADD(MCP_BytesReceived, Bytes);
+    }
+
+    void AddBytesSent(int64 Bytes)
+    {
+        TRACE_COUNTER_ADD(MCP_BytesSent, Bytes);
+    }
+}
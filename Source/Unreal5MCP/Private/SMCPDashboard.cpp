@@ -0,0 +1,371 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SMCPDashboard.h"
+#include "MCPTCPServer.h"
+#include "MCPConstants.h"
+#include "Rendering/DrawElements.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Styling/AppStyle.h"
+#include "Styling/CoreStyle.h"
+#include "Widgets/SBoxPanel.h"
+#include "Widgets/Layout/SGridPanel.h"
+#include "Widgets/Layout/SBox.h"
+#include "Widgets/Text/STextBlock.h"
+
+#define LOCTEXT_NAMESPACE "SMCPDashboard"
+
+namespace
+{
+    /** 请求速率和每帧统计的时间窗口(秒) */
+    constexpr double STATS_WINDOW_SECONDS = 1.0;
+
+    /** 60 FPS 的帧预算(毫秒) */
+    constexpr float FRAME_BUDGET_MILLISECONDS = 1000.0f / 60.0f;
+
+    /** 曲线纵轴的最小上限(毫秒),约 30 FPS */
+    constexpr float MIN_GRAPH_MILLISECONDS = 33.3f;
+
+    const FLinearColor FRAME_LINE_COLOR(0.5f, 0.5f, 0.5f);
+    const FLinearColor MCP_LINE_COLOR(1.0f, 0.5f, 0.0f);
+    const FLinearColor BUDGET_LINE_COLOR(0.25f, 0.25f, 0.25f);
+    const FLinearColor GRAPH_BACKGROUND_COLOR(0.015f, 0.015f, 0.015f);
+
+    /** 小节标题 */
+    TSharedRef<SWidget> MakeSectionTitle(const FText &Text)
+    {
+        return SNew(STextBlock)
+            .Text(Text)
+            .Font(FCoreStyle::GetDefaultFontStyle("Bold", 11));
+    }
+
+    /** 表格单元格,Header 为表头 */
+    TSharedRef<SWidget> MakeCell(const FText &Text, bool bHeader = false, bool bError = false)
+    {
+        return SNew(SBox)
+            .Padding(FMargin(0, 1, 12, 1))
+                [SNew(STextBlock)
+                     .Text(Text)
+                     .Font(FCoreStyle::GetDefaultFontStyle(bHeader ? "Bold" : "Regular", 9))
+                     .ColorAndOpacity(bError ? FSlateColor(FLinearColor::Red) : FSlateColor::UseForeground())];
+    }
+
+    FText FormatMilliseconds(double Seconds)
+    {
+        FNumberFormattingOptions Options;
+        Options.SetMinimumFractionalDigits(1).SetMaximumFractionalDigits(1);
+        return FText::AsNumber(Seconds * 1000.0, &Options);
+    }
+}
+
+// ============================================================================
+// SMCPFrameGraph
+// ============================================================================
+
+void SMCPFrameGraph::Construct(const FArguments &InArgs)
+{
+}
+
+int32 SMCPFrameGraph::OnPaint(const FPaintArgs &Args, const FGeometry &AllottedGeometry, const FSlateRect &MyCullingRect,
+                              FSlateWindowElementList &OutDrawElements, int32 LayerId, const FWidgetStyle &InWidgetStyle,
+                              bool bParentEnabled) const
+{
+    const FVector2f Size = FVector2f(AllottedGeometry.GetLocalSize());
+    const FPaintGeometry PaintGeometry = AllottedGeometry.ToPaintGeometry();
+
+    FSlateDrawElement::MakeBox(OutDrawElements, LayerId, PaintGeometry, FAppStyle::GetBrush("WhiteBrush"),
+                               ESlateDrawEffect::None, GRAPH_BACKGROUND_COLOR);
+
+    // 纵轴上限至少到 30 FPS 的帧时间,出现更慢的帧时随之放大
+    float MaxMilliseconds = MIN_GRAPH_MILLISECONDS;
+    for (const FMCPFrameSample &Sample : Samples)
+    {
+        MaxMilliseconds = FMath::Max(MaxMilliseconds, Sample.FrameMilliseconds);
+    }
+
+    auto ToY = [&Size, MaxMilliseconds](float Milliseconds)
+    {
+        return Size.Y * (1.0f - FMath::Clamp(Milliseconds / MaxMilliseconds, 0.0f, 1.0f));
+    };
+
+    TArray<FVector2f> BudgetLine;
+    BudgetLine.Add(FVector2f(0.0f, ToY(FRAME_BUDGET_MILLISECONDS)));
+    BudgetLine.Add(FVector2f(Size.X, ToY(FRAME_BUDGET_MILLISECONDS)));
+    FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 1, PaintGeometry, BudgetLine, ESlateDrawEffect::None, BUDGET_LINE_COLOR);
+
+    if (Samples.Num() >= 2)
+    {
+        // 横轴固定为 FRAME_HISTORY_LENGTH 帧,最新的帧对齐右边缘
+        const float Step = Size.X / FMath::Max(MCPConstants::FRAME_HISTORY_LENGTH - 1, 1);
+        const float StartX = Size.X - Step * (Samples.Num() - 1);
+
+        TArray<FVector2f> FramePoints;
+        TArray<FVector2f> MCPPoints;
+        FramePoints.Reserve(Samples.Num());
+        MCPPoints.Reserve(Samples.Num());
+        for (int32 Index = 0; Index < Samples.Num(); ++Index)
+        {
+            const float X = StartX + Step * Index;
+            FramePoints.Add(FVector2f(X, ToY(Samples[Index].FrameMilliseconds)));
+            MCPPoints.Add(FVector2f(X, ToY(Samples[Index].MCPMilliseconds)));
+        }
+
+        FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 2, PaintGeometry, FramePoints, ESlateDrawEffect::None, FRAME_LINE_COLOR);
+        FSlateDrawElement::MakeLines(OutDrawElements, LayerId + 3, PaintGeometry, MCPPoints, ESlateDrawEffect::None, MCP_LINE_COLOR, true, 1.5f);
+    }
+
+    const FText ScaleText = FText::Format(LOCTEXT("GraphScale", "{0} ms"), FText::AsNumber(FMath::RoundToInt(MaxMilliseconds)));
+    FSlateDrawElement::MakeText(OutDrawElements, LayerId + 4, AllottedGeometry.ToPaintGeometry(FVector2f(60.0f, 14.0f), FSlateLayoutTransform(FVector2f(4.0f, 2.0f))),
+                                ScaleText, FCoreStyle::GetDefaultFontStyle("Regular", 8), ESlateDrawEffect::None, FRAME_LINE_COLOR);
+
+    return LayerId + 4;
+}
+
+FVector2D SMCPFrameGraph::ComputeDesiredSize(float LayoutScaleMultiplier) const
+{
+    return FVector2D(MCPConstants::FRAME_HISTORY_LENGTH, 100.0);
+}
+
+// ============================================================================
+// SMCPDashboard
+// ============================================================================
+
+void SMCPDashboard::Construct(const FArguments &InArgs)
+{
+    GetServer = InArgs._GetServer;
+
+    ChildSlot
+        [SNew(SVerticalBox)
+
+         // 总览
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 4)
+                   [SNew(STextBlock).Text(this, &SMCPDashboard::GetSummaryText)]
+
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 4)
+                   [SNew(STextBlock).Text(this, &SMCPDashboard::GetFrameText)]
+
+         // 每帧耗时曲线
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 12)
+                   [SNew(SBox)
+                        .HeightOverride(100.0f)
+                            [SAssignNew(FrameGraph, SMCPFrameGraph)]]
+
+         // 客户端
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 4)
+                   [MakeSectionTitle(LOCTEXT("ClientsTitle", "Connected Clients"))]
+
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 12)
+                   [SAssignNew(ClientsBox, SVerticalBox)]
+
+         // 各工具延迟
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 4)
+                   [MakeSectionTitle(LOCTEXT("ToolsTitle", "Tool Latency (end to end)"))]
+
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 12)
+                   [SAssignNew(ToolsGrid, SGridPanel)]
+
+         // 最慢的请求
+         + SVerticalBox::Slot()
+               .AutoHeight()
+               .Padding(0, 0, 0, 4)
+                   [MakeSectionTitle(FText::Format(LOCTEXT("SlowCallsTitle", "Slowest of the Last {0} Calls"),
+                                                   FText::AsNumber(MCPConstants::RECENT_CALLS_CAPACITY)))]
+
+         + SVerticalBox::Slot()
+               .AutoHeight()
+                   [SAssignNew(SlowCallsGrid, SGridPanel)]];
+
+    RegisterActiveTimer(MCPConstants::DASHBOARD_REFRESH_INTERVAL_SECONDS,
+                        FWidgetActiveTimerDelegate::CreateSP(this, &SMCPDashboard::Refresh));
+    Refresh(FSlateApplication::Get().GetCurrentTime(), 0.0f);
+}
+
+EActiveTimerReturnType SMCPDashboard::Refresh(double InCurrentTime, float InDeltaTime)
+{
+    const FMCPTCPServer *Server = GetServer ? GetServer() : nullptr;
+    if (Server != LastServer)
+    {
+        RequestSamples.Reset();
+        LastServer = Server;
+    }
+
+    TArray<FIPv4Endpoint> Endpoints;
+    TArray<FMCPFrameSample> Samples;
+    TArray<FMCPCommandSummary> Summaries;
+    TArray<FMCPCompletedCall> SlowCalls;
+
+    if (Server && Server->GetMetrics().IsValid())
+    {
+        const FMCPServerMetrics &Metrics = *Server->GetMetrics();
+        Endpoints = Server->GetClientEndpoints();
+        Metrics.GetFrameHistory(Samples);
+        Metrics.GetCommandSummaries(Summaries);
+        Metrics.GetSlowestRecentCalls(MCPConstants::DASHBOARD_SLOW_CALLS_SHOWN, SlowCalls);
+
+        SendQueueDepth = Server->GetSendQueueDepth();
+        UpdateRequestRate(Server, InCurrentTime);
+    }
+    else
+    {
+        SendQueueDepth = 0;
+        RequestsPerSecond = 0.0f;
+    }
+
+    ClientCount = Endpoints.Num();
+    UpdateFrameStats(Samples);
+    FrameGraph->SetSamples(MoveTemp(Samples));
+
+    RebuildClients(Endpoints);
+    RebuildTools(Summaries);
+    RebuildSlowCalls(SlowCalls);
+
+    return EActiveTimerReturnType::Continue;
+}
+
+void SMCPDashboard::UpdateRequestRate(const FMCPTCPServer *Server, double CurrentTime)
+{
+    const uint64 RequestsTotal = Server->GetMetrics()->GetRequestsTotal();
+
+    // server_stats 重置计数后重新采样
+    if (RequestSamples.Num() > 0 && RequestsTotal < RequestSamples.Last().Value)
+    {
+        RequestSamples.Reset();
+    }
+    RequestSamples.Emplace(CurrentTime, RequestsTotal);
+
+    // 保留一个不晚于窗口起点的采样作为基准
+    while (RequestSamples.Num() > 2 && RequestSamples[1].Key <= CurrentTime - STATS_WINDOW_SECONDS)
+    {
+        RequestSamples.RemoveAt(0);
+    }
+
+    const double Elapsed = CurrentTime - RequestSamples[0].Key;
+    RequestsPerSecond = Elapsed > 0.0 ? static_cast<float>((RequestsTotal - RequestSamples[0].Value) / Elapsed) : 0.0f;
+}
+
+void SMCPDashboard::UpdateFrameStats(const TArray<FMCPFrameSample> &Samples)
+{
+    double WindowFrameMilliseconds = 0.0;
+    double WindowMCPMilliseconds = 0.0;
+    int32 WindowFrames = 0;
+    MaxMCPMilliseconds = 0.0f;
+
+    for (int32 Index = Samples.Num() - 1; Index >= 0; --Index)
+    {
+        const FMCPFrameSample &Sample = Samples[Index];
+        MaxMCPMilliseconds = FMath::Max(MaxMCPMilliseconds, Sample.MCPMilliseconds);
+
+        if (WindowFrameMilliseconds < STATS_WINDOW_SECONDS * 1000.0)
+        {
+            WindowFrameMilliseconds += Sample.FrameMilliseconds;
+            WindowMCPMilliseconds += Sample.MCPMilliseconds;
+            ++WindowFrames;
+        }
+    }
+
+    AverageMCPMilliseconds = WindowFrames > 0 ? static_cast<float>(WindowMCPMilliseconds / WindowFrames) : 0.0f;
+    MCPFrameShare = WindowFrameMilliseconds > 0.0 ? static_cast<float>(WindowMCPMilliseconds / WindowFrameMilliseconds) : 0.0f;
+}
+
+void SMCPDashboard::RebuildClients(const TArray<FIPv4Endpoint> &Endpoints)
+{
+    ClientsBox->ClearChildren();
+    if (Endpoints.Num() == 0)
+    {
+        ClientsBox->AddSlot().AutoHeight()[MakeCell(LOCTEXT("NoClients", "No clients connected"))];
+        return;
+    }
+
+    for (const FIPv4Endpoint &Endpoint : Endpoints)
+    {
+        ClientsBox->AddSlot().AutoHeight()[MakeCell(FText::FromString(Endpoint.ToString()))];
+    }
+}
+
+void SMCPDashboard::RebuildTools(const TArray<FMCPCommandSummary> &Summaries)
+{
+    ToolsGrid->ClearChildren();
+    if (Summaries.Num() == 0)
+    {
+        ToolsGrid->AddSlot(0, 0)[MakeCell(LOCTEXT("NoRequests", "No requests yet"))];
+        return;
+    }
+
+    ToolsGrid->AddSlot(0, 0)[MakeCell(LOCTEXT("ToolColumn", "Tool"), true)];
+    ToolsGrid->AddSlot(1, 0)[MakeCell(LOCTEXT("RequestsColumn", "Requests"), true)];
+    ToolsGrid->AddSlot(2, 0)[MakeCell(LOCTEXT("ErrorsColumn", "Errors"), true)];
+    ToolsGrid->AddSlot(3, 0)[MakeCell(LOCTEXT("P50Column", "p50 ms"), true)];
+    ToolsGrid->AddSlot(4, 0)[MakeCell(LOCTEXT("P99Column", "p99 ms"), true)];
+
+    for (int32 Index = 0; Index < Summaries.Num(); ++Index)
+    {
+        const FMCPCommandSummary &Summary = Summaries[Index];
+        const int32 Row = Index + 1;
+        ToolsGrid->AddSlot(0, Row)[MakeCell(FText::FromString(Summary.Command))];
+        ToolsGrid->AddSlot(1, Row)[MakeCell(FText::AsNumber(Summary.Requests))];
+        ToolsGrid->AddSlot(2, Row)[MakeCell(FText::AsNumber(Summary.Errors), false, Summary.Errors > 0)];
+        ToolsGrid->AddSlot(3, Row)[MakeCell(FormatMilliseconds(Summary.P50Seconds))];
+        ToolsGrid->AddSlot(4, Row)[MakeCell(FormatMilliseconds(Summary.P99Seconds))];
+    }
+}
+
+void SMCPDashboard::RebuildSlowCalls(const TArray<FMCPCompletedCall> &Calls)
+{
+    SlowCallsGrid->ClearChildren();
+    if (Calls.Num() == 0)
+    {
+        SlowCallsGrid->AddSlot(0, 0)[MakeCell(LOCTEXT("NoCalls", "No completed calls yet"))];
+        return;
+    }
+
+    SlowCallsGrid->AddSlot(0, 0)[MakeCell(LOCTEXT("TimeColumn", "Time"), true)];
+    SlowCallsGrid->AddSlot(1, 0)[MakeCell(LOCTEXT("CallToolColumn", "Tool"), true)];
+    SlowCallsGrid->AddSlot(2, 0)[MakeCell(LOCTEXT("IdColumn", "Id"), true)];
+    SlowCallsGrid->AddSlot(3, 0)[MakeCell(LOCTEXT("LatencyColumn", "ms"), true)];
+    SlowCallsGrid->AddSlot(4, 0)[MakeCell(LOCTEXT("StatusColumn", "Status"), true)];
+
+    for (int32 Index = 0; Index < Calls.Num(); ++Index)
+    {
+        const FMCPCompletedCall &Call = Calls[Index];
+        const int32 Row = Index + 1;
+        SlowCallsGrid->AddSlot(0, Row)[MakeCell(FText::FromString(Call.Time.ToString(TEXT("%H:%M:%S"))))];
+        SlowCallsGrid->AddSlot(1, Row)[MakeCell(FText::FromString(Call.Command))];
+        SlowCallsGrid->AddSlot(2, Row)[MakeCell(Call.RequestId >= 0 ? FText::AsNumber(Call.RequestId) : FText::FromString(TEXT("-")))];
+        SlowCallsGrid->AddSlot(3, Row)[MakeCell(FormatMilliseconds(Call.LatencySeconds))];
+        SlowCallsGrid->AddSlot(4, Row)[MakeCell(Call.bError ? LOCTEXT("StatusError", "error") : LOCTEXT("StatusOk", "ok"), false, Call.bError)];
+    }
+}
+
+FText SMCPDashboard::GetSummaryText() const
+{
+    FNumberFormattingOptions RateOptions;
+    RateOptions.SetMaximumFractionalDigits(1);
+
+    return FText::Format(LOCTEXT("SummaryText", "Clients: {0}    Requests/s: {1}    Send queue: {2}"),
+                         FText::AsNumber(ClientCount), FText::AsNumber(RequestsPerSecond, &RateOptions), FText::AsNumber(SendQueueDepth));
+}
+
+FText SMCPDashboard::GetFrameText() const
+{
+    FNumberFormattingOptions MillisecondOptions;
+    MillisecondOptions.SetMinimumFractionalDigits(2).SetMaximumFractionalDigits(2);
+
+    return FText::Format(LOCTEXT("FrameText", "Game thread used by MCP: {0} ms/frame ({1} of frame time), peak {2} ms"),
+                         FText::AsNumber(AverageMCPMilliseconds, &MillisecondOptions), FText::AsPercent(MCPFrameShare),
+                         FText::AsNumber(MaxMCPMilliseconds, &MillisecondOptions));
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,1174 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "MCPTCPServer.h"
+#include "MCPBinaryCodec.h"
+#include "Sockets.h"
+#include "SocketSubsystem.h"
+#include "IPAddress.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Misc/Compression.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "HAL/PlatformProcess.h"
+
+namespace
+{
+    /** 等待服务器响应的默认时限(秒) */
+    constexpr double DEFAULT_WAIT_SECONDS = 10.0;
+
+    /** 每次驱动服务器时传给 Tick 的帧时间(秒) */
+    constexpr float DEFAULT_TICK_SECONDS = 1.0f / 60.0f;
+
+    /**
+     * 测试用的同步工具: 返回参数中的 value
+     */
+    class FMCPTestEchoHandler : public IMCPCommandHandler
+    {
+    public:
+        virtual FString GetCommandName() const override { return TEXT("test_echo"); }
+
+        virtual TSharedPtr<FJsonObject> GetInputSchema() const override
+        {
+            TSharedPtr<FJsonObject> ValueSchema = MakeShared<FJsonObject>();
+            ValueSchema->SetStringField("type", TEXT("string"));
+
+            TSharedPtr<FJsonObject> Props = MakeShared<FJsonObject>();
+            Props->SetObjectField("value", ValueSchema);
+
+            TArray<TSharedPtr<FJsonValue>> Required;
+            Required.Add(MakeShared<FJsonValueString>(TEXT("value")));
+
+            TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+            Schema->SetStringField("type", TEXT("object"));
+            Schema->SetObjectField("properties", Props);
+            Schema->SetArrayField("required", Required);
+            return Schema;
+        }
+
+        virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override
+        {
+            TSharedPtr<FJsonObject> Result = MakeShared<FJsonObject>();
+            Result->SetStringField("status", TEXT("success"));
+            Result->SetStringField("value", Params->GetStringField(TEXT("value")));
+            return Result;
+        }
+    };
+
+    /**
+     * 测试用的异步工具: 永远不调用完成回调
+     */
+    class FMCPTestStalledHandler : public IMCPCommandHandler
+    {
+    public:
+        virtual FString GetCommandName() const override { return TEXT("test_stall"); }
+
+        virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override
+        {
+            return nullptr;
+        }
+
+        virtual void ExecuteAsync(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPCommandCallback OnComplete) override
+        {
+        }
+    };
+
+    /**
+     * 可由测试直接驱动 Tick 的服务器
+     */
+    class FMCPTestServer : public FMCPTCPServer
+    {
+    public:
+        using FMCPTCPServer::FMCPTCPServer;
+
+        void Pump(float DeltaTime) { Tick(DeltaTime); }
+    };
+
+    /**
+     * 一个 HTTP 响应
+     */
+    struct FMCPTestResponse
+    {
+        FString Headers;
+        TArray<uint8> Body;
+
+        /** 响应体按 Content-Type 解码(JSON / MessagePack / CBOR)的结果,无法解码时为空 */
+        TSharedPtr<FJsonObject> Json;
+
+        FString GetBodyString() const
+        {
+            FUTF8ToTCHAR Converter(reinterpret_cast<const ANSICHAR *>(Body.GetData()), Body.Num());
+            return FString(Converter.Length(), Converter.Get());
+        }
+
+        bool HasHeader(const FString &Line) const
+        {
+            return Headers.Contains(Line + TEXT("\r\n"));
+        }
+    };
+
+    /**
+     * 回环 TCP 客户端
+     * 非阻塞收发: 待发送的数据和收到的数据都在缓冲区中,由测试在驱动服务器的同时调用 Flush / Receive
+     */
+    class FMCPTestClient
+    {
+    public:
+        explicit FMCPTestClient(int32 Port)
+        {
+            ISocketSubsystem *SocketSubsystem = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM);
+            Socket = SocketSubsystem->CreateSocket(NAME_Stream, TEXT("MCP test client"), false);
+
+            bool bValidAddress = false;
+            TSharedRef<FInternetAddr> Address = SocketSubsystem->CreateInternetAddr();
+            Address->SetIp(TEXT("127.0.0.1"), bValidAddress);
+            Address->SetPort(Port);
+
+            bConnected = Socket && bValidAddress && Socket->Connect(*Address);
+            if (Socket)
+            {
+                Socket->SetNonBlocking(true);
+            }
+        }
+
+        ~FMCPTestClient()
+        {
+            if (Socket)
+            {
+                Socket->Close();
+                ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->DestroySocket(Socket);
+            }
+        }
+
+        bool IsConnected() const { return bConnected; }
+        bool IsClosedByPeer() const { return bPeerClosed; }
+        bool HasPendingOutput() const { return SendOffset < Outgoing.Num(); }
+
+        /** 以 UTF-8 加入发送缓冲区并尽量写出 */
+        void Send(const FString &Text)
+        {
+            FTCHARToUTF8 Converter(*Text);
+            Outgoing.Append(reinterpret_cast<const uint8 *>(Converter.Get()), Converter.Length());
+            Flush();
+        }
+
+        /** 原样加入发送缓冲区并尽量写出 */
+        void SendBytes(const TArray<uint8> &Bytes)
+        {
+            Outgoing.Append(Bytes);
+            Flush();
+        }
+
+        /** 写出发送缓冲区中的数据,直到 Socket 缓冲区已满 */
+        void Flush()
+        {
+            while (Socket && SendOffset < Outgoing.Num())
+            {
+                int32 BytesSent = 0;
+                if (!Socket->Send(Outgoing.GetData() + SendOffset, Outgoing.Num() - SendOffset, BytesSent) || BytesSent <= 0)
+                {
+                    return;
+                }
+                SendOffset += BytesSent;
+            }
+
+            Outgoing.Reset();
+            SendOffset = 0;
+        }
+
+        /** 读取所有已到达的数据,检测对端关闭 */
+        void Receive()
+        {
+            uint8 Chunk[65536];
+            while (Socket && !bPeerClosed)
+            {
+                int32 BytesRead = 0;
+                const bool bReceived = Socket->Recv(Chunk, sizeof(Chunk), BytesRead);
+                if (bReceived && BytesRead > 0)
+                {
+                    Incoming.Append(Chunk, BytesRead);
+                    continue;
+                }
+
+                const ESocketErrors Error = ISocketSubsystem::Get(PLATFORM_SOCKETSUBSYSTEM)->GetLastErrorCode();
+                if ((bReceived && BytesRead == 0) || (!bReceived && Error != SE_EWOULDBLOCK))
+                {
+                    bPeerClosed = true;
+                }
+                return;
+            }
+        }
+
+        /** 从接收缓冲区取出一个完整的响应 */
+        bool PopResponse(FMCPTestResponse &OutResponse)
+        {
+            const FUtf8StringView Data(reinterpret_cast<const UTF8CHAR *>(Incoming.GetData()), Incoming.Num());
+            const int32 HeaderEnd = Data.Find(UTF8TEXT("\r\n\r\n"));
+            if (HeaderEnd == INDEX_NONE)
+            {
+                return false;
+            }
+
+            FUTF8ToTCHAR HeaderConverter(reinterpret_cast<const ANSICHAR *>(Incoming.GetData()), HeaderEnd + 2);
+            const FString Headers(HeaderConverter.Length(), HeaderConverter.Get());
+
+            FString ContentLength;
+            if (!FParse::Value(*Headers, TEXT("Content-Length:"), ContentLength))
+            {
+                return false;
+            }
+
+            const int32 BodyStart = HeaderEnd + 4;
+            const int32 BodyLength = FCString::Atoi(*ContentLength);
+            if (Incoming.Num() - BodyStart < BodyLength)
+            {
+                return false;
+            }
+
+            OutResponse.Headers = Headers;
+            OutResponse.Body = TArray<uint8>(Incoming.GetData() + BodyStart, BodyLength);
+            OutResponse.Json.Reset();
+
+            FString ContentType;
+            FParse::Value(*Headers, TEXT("Content-Type:"), ContentType);
+            FTCHARToUTF8 ContentTypeConverter(*ContentType);
+            const EMCPWireFormat Format = FMCPBinaryCodec::FromMimeType(
+                FUtf8StringView(reinterpret_cast<const UTF8CHAR *>(ContentTypeConverter.Get()), ContentTypeConverter.Length()));
+            if (Format == EMCPWireFormat::Json)
+            {
+                TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(OutResponse.GetBodyString());
+                FJsonSerializer::Deserialize(Reader, OutResponse.Json);
+            }
+            else
+            {
+                FString Error;
+                const TSharedPtr<FJsonValue> Value = FMCPBinaryCodec::Decode(Format, OutResponse.Body.GetData(), BodyLength, Error);
+                if (Value.IsValid() && Value->Type == EJson::Object)
+                {
+                    OutResponse.Json = Value->AsObject();
+                }
+            }
+
+            Incoming.RemoveAt(0, BodyStart + BodyLength);
+            return true;
+        }
+
+        /** 接收缓冲区中尚未取出的字节数 */
+        int32 GetBufferedBytes() const { return Incoming.Num(); }
+
+    private:
+        FSocket *Socket = nullptr;
+        bool bConnected = false;
+        bool bPeerClosed = false;
+
+        TArray<uint8> Outgoing;
+        int32 SendOffset = 0;
+        TArray<uint8> Incoming;
+    };
+
+    /** 以 UTF-8 计算 Content-Length 的 HTTP POST 请求 */
+    FString MakeHttpRequest(const FString &Body, const FString &ExtraHeaders = FString())
+    {
+        FTCHARToUTF8 Converter(*Body);
+        return FString::Printf(TEXT("POST / HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: application/json\r\n%sContent-Length: %d\r\n\r\n%s"),
+                               *ExtraHeaders, Converter.Length(), *Body);
+    }
+
+    /** 请求体为二进制格式的 HTTP POST 请求,响应也使用同一格式 */
+    TArray<uint8> MakeBinaryHttpRequest(EMCPWireFormat Format, const TArray<uint8> &Body)
+    {
+        const FString Header = FString::Printf(TEXT("POST / HTTP/1.1\r\nHost: 127.0.0.1\r\nContent-Type: %s\r\nContent-Length: %d\r\n\r\n"),
+                                               FMCPBinaryCodec::GetMimeType(Format), Body.Num());
+        FTCHARToUTF8 Converter(*Header);
+        TArray<uint8> Request(reinterpret_cast<const uint8 *>(Converter.Get()), Converter.Length());
+        Request.Append(Body);
+        return Request;
+    }
+
+    /** 调用 test_echo 的 JSON-RPC 请求 */
+    FString MakeEchoCall(int32 Id, const FString &Value)
+    {
+        return FString::Printf(TEXT("{\"jsonrpc\":\"2.0\",\"id\":%d,\"method\":\"tools/call\",\"params\":{\"name\":\"test_echo\",\"arguments\":{\"value\":\"%s\"}}}"),
+                               Id, *Value);
+    }
+
+    int32 GetResponseId(const FMCPTestResponse &Response)
+    {
+        int32 Id = INDEX_NONE;
+        if (Response.Json.IsValid())
+        {
+            Response.Json->TryGetNumberField(TEXT("id"), Id);
+        }
+        return Id;
+    }
+
+    /** tools/call 响应中 structuredContent.value */
+    FString GetEchoValue(const FMCPTestResponse &Response)
+    {
+        const TSharedPtr<FJsonObject> *Result = nullptr;
+        const TSharedPtr<FJsonObject> *Structured = nullptr;
+        FString Value;
+        if (Response.Json.IsValid() && Response.Json->TryGetObjectField(TEXT("result"), Result) &&
+            (*Result)->TryGetObjectField(TEXT("structuredContent"), Structured))
+        {
+            (*Structured)->TryGetStringField(TEXT("value"), Value);
+        }
+        return Value;
+    }
+
+    /** tools/call 响应中 content[0].text */
+    FString GetContentText(const FMCPTestResponse &Response)
+    {
+        const TSharedPtr<FJsonObject> *Result = nullptr;
+        const TArray<TSharedPtr<FJsonValue>> *Content = nullptr;
+        FString Text;
+        if (Response.Json.IsValid() && Response.Json->TryGetObjectField(TEXT("result"), Result) &&
+            (*Result)->TryGetArrayField(TEXT("content"), Content) && Content->Num() > 0 && (*Content)[0]->AsObject().IsValid())
+        {
+            (*Content)[0]->AsObject()->TryGetStringField(TEXT("text"), Text);
+        }
+        return Text;
+    }
+
+    int32 GetErrorCode(const FMCPTestResponse &Response)
+    {
+        const TSharedPtr<FJsonObject> *Error = nullptr;
+        int32 Code = 0;
+        if (Response.Json.IsValid() && Response.Json->TryGetObjectField(TEXT("error"), Error))
+        {
+            (*Error)->TryGetNumberField(TEXT("code"), Code);
+        }
+        return Code;
+    }
+}
+
+BEGIN_DEFINE_SPEC(FMCPTCPServerSpec, "Unreal5MCP.TCPServer",
+                  EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+
+    TUniquePtr<FMCPTestServer> Server;
+    TArray<TUniquePtr<FMCPTestClient>> Clients;
+
+    /** 以系统分配的端口启动服务器并注册 test_echo */
+    bool StartServer(FMCPTCPServerConfig Config = FMCPTCPServerConfig());
+
+    /** 连接一个客户端并等待服务器接受 */
+    FMCPTestClient *Connect();
+
+    /**
+     * 驱动服务器、游戏线程任务和所有客户端,直到条件满足或超时
+     * @param TickSeconds 每次传给服务器 Tick 的帧时间,用于推进空闲超时
+     */
+    bool PumpUntil(TFunctionRef<bool()> Condition, double TimeoutSeconds = DEFAULT_WAIT_SECONDS, float TickSeconds = DEFAULT_TICK_SECONDS);
+
+    /** 等待客户端收到 Count 个响应 */
+    bool WaitForResponses(FMCPTestClient &Client, int32 Count, TArray<FMCPTestResponse> &OutResponses);
+
+    /** 等待一个响应 */
+    bool WaitForResponse(FMCPTestClient &Client, FMCPTestResponse &OutResponse);
+
+    /** 驱动若干次,确认期间没有收到响应 */
+    bool ExpectNoResponse(FMCPTestClient &Client, int32 PumpCount = 10);
+
+END_DEFINE_SPEC(FMCPTCPServerSpec)
+
+bool FMCPTCPServerSpec::StartServer(FMCPTCPServerConfig Config)
+{
+    Config.Port = 0;
+    Server = MakeUnique<FMCPTestServer>(Config);
+    Server->RegisterCommandHandler(MakeShared<FMCPTestEchoHandler>());
+    return Server->Start();
+}
+
+FMCPTestClient *FMCPTCPServerSpec::Connect()
+{
+    const int32 ExpectedClients = Server->GetClientEndpoints().Num() + 1;
+    FMCPTestClient *Client = Clients.Add_GetRef(MakeUnique<FMCPTestClient>(Server->GetListenPort())).Get();
+    if (!Client->IsConnected() || !PumpUntil([this, ExpectedClients]()
+                                             { return Server->GetClientEndpoints().Num() >= ExpectedClients; }))
+    {
+        AddError(TEXT("Client could not connect to the server"));
+        return nullptr;
+    }
+    return Client;
+}
+
+bool FMCPTCPServerSpec::PumpUntil(TFunctionRef<bool()> Condition, double TimeoutSeconds, float TickSeconds)
+{
+    const double Deadline = FPlatformTime::Seconds() + TimeoutSeconds;
+    while (FPlatformTime::Seconds() < Deadline)
+    {
+        for (const TUniquePtr<FMCPTestClient> &Client : Clients)
+        {
+            Client->Flush();
+        }
+
+        Server->Pump(TickSeconds);
+
+        // 压缩和转码在线程池完成后回到游戏线程发送
+        FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+
+        for (const TUniquePtr<FMCPTestClient> &Client : Clients)
+        {
+            Client->Receive();
+        }
+
+        if (Condition())
+        {
+            return true;
+        }
+        FPlatformProcess::Sleep(0.001f);
+    }
+    return false;
+}
+
+bool FMCPTCPServerSpec::WaitForResponses(FMCPTestClient &Client, int32 Count, TArray<FMCPTestResponse> &OutResponses)
+{
+    OutResponses.Reset();
+    const bool bReceived = PumpUntil([&Client, &OutResponses, Count]()
+                                     {
+        FMCPTestResponse Response;
+        while (OutResponses.Num() < Count && Client.PopResponse(Response))
+        {
+            OutResponses.Add(MoveTemp(Response));
+        }
+        return OutResponses.Num() >= Count; });
+
+    if (!bReceived)
+    {
+        AddError(FString::Printf(TEXT("Expected %d responses, received %d"), Count, OutResponses.Num()));
+    }
+    return bReceived;
+}
+
+bool FMCPTCPServerSpec::WaitForResponse(FMCPTestClient &Client, FMCPTestResponse &OutResponse)
+{
+    TArray<FMCPTestResponse> Responses;
+    if (!WaitForResponses(Client, 1, Responses))
+    {
+        return false;
+    }
+    OutResponse = MoveTemp(Responses[0]);
+    return true;
+}
+
+bool FMCPTCPServerSpec::ExpectNoResponse(FMCPTestClient &Client, int32 PumpCount)
+{
+    int32 Remaining = PumpCount;
+    PumpUntil([&Remaining]()
+              { return --Remaining <= 0; });
+    return Client.GetBufferedBytes() == 0;
+}
+
+void FMCPTCPServerSpec::Define()
+{
+    AfterEach([this]()
+              {
+        Clients.Reset();
+        if (Server.IsValid())
+        {
+            Server->Stop();
+            Server.Reset();
+        } });
+
+    Describe("Startup", [this]()
+             {
+        It("listens on an ephemeral port when the configured port is 0", [this]()
+           {
+            TestTrue(TEXT("Server started"), StartServer());
+            TestTrue(TEXT("Port assigned"), Server->GetListenPort() > 0);
+            TestNotNull(TEXT("Client connected"), Connect()); });
+
+        It("accepts clients that connect before the first tick", [this]()
+           {
+            TestTrue(TEXT("Server started"), StartServer());
+
+            // 监听线程可能在第一次 Tick 之前就接受连接
+            Clients.Add(MakeUnique<FMCPTestClient>(Server->GetListenPort()));
+            Clients.Add(MakeUnique<FMCPTestClient>(Server->GetListenPort()));
+            TestTrue(TEXT("Both clients accepted"), PumpUntil([this]()
+                                                              { return Server->GetClientEndpoints().Num() == 2; })); }); });
+
+    Describe("HTTP framing", [this]()
+             {
+        BeforeEach([this]()
+                   { TestTrue(TEXT("Server started"), StartServer()); });
+
+        It("answers initialize with the server info", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":7,\"method\":\"initialize\",\"params\":{}}")));
+
+            FMCPTestResponse Response;
+            if (!WaitForResponse(*Client, Response))
+            {
+                return;
+            }
+
+            TestTrue(TEXT("Status line"), Response.Headers.StartsWith(TEXT("HTTP/1.1 200 OK\r\n")));
+            TestTrue(TEXT("JSON content type"), Response.HasHeader(TEXT("Content-Type: application/json")));
+            TestEqual(TEXT("Response id"), GetResponseId(Response), 7);
+
+            const TSharedPtr<FJsonObject> *Result = nullptr;
+            const TSharedPtr<FJsonObject> *ServerInfo = nullptr;
+            TestTrue(TEXT("Has serverInfo"), Response.Json.IsValid() && Response.Json->TryGetObjectField(TEXT("result"), Result) &&
+                                                 (*Result)->TryGetObjectField(TEXT("serverInfo"), ServerInfo));
+            if (ServerInfo)
+            {
+                TestEqual(TEXT("Server name"), (*ServerInfo)->GetStringField(TEXT("name")), FString(TEXT("Unreal5MCP")));
+            } });
+
+        It("waits for a body that arrives in several fragments", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            const FString Request = MakeHttpRequest(MakeEchoCall(1, TEXT("fragmented")));
+            const int32 HeaderEnd = Request.Find(TEXT("\r\n\r\n")) + 4;
+            const int32 BodyMiddle = HeaderEnd + (Request.Len() - HeaderEnd) / 2;
+
+            Client->Send(Request.Left(HeaderEnd));
+            TestTrue(TEXT("No response to headers alone"), ExpectNoResponse(*Client));
+
+            Client->Send(Request.Mid(HeaderEnd, BodyMiddle - HeaderEnd));
+            TestTrue(TEXT("No response to a partial body"), ExpectNoResponse(*Client));
+
+            Client->Send(Request.Mid(BodyMiddle));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Echoed value"), GetEchoValue(Response), FString(TEXT("fragmented")));
+            } });
+
+        It("reassembles a request sent one byte at a time", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            const FString Request = MakeHttpRequest(MakeEchoCall(2, TEXT("bytes")));
+            for (int32 Index = 0; Index < Request.Len(); ++Index)
+            {
+                Client->Send(Request.Mid(Index, 1));
+                Client->Flush();
+                Server->Pump(DEFAULT_TICK_SECONDS);
+            }
+
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Response id"), GetResponseId(Response), 2);
+                TestEqual(TEXT("Echoed value"), GetEchoValue(Response), FString(TEXT("bytes")));
+            } });
+
+        It("answers pipelined requests in order", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            FString Pipeline;
+            for (int32 Id = 1; Id <= 5; ++Id)
+            {
+                Pipeline += MakeHttpRequest(MakeEchoCall(Id, FString::Printf(TEXT("value-%d"), Id)));
+            }
+            Client->Send(Pipeline);
+
+            TArray<FMCPTestResponse> Responses;
+            if (!WaitForResponses(*Client, 5, Responses))
+            {
+                return;
+            }
+            for (int32 Index = 0; Index < Responses.Num(); ++Index)
+            {
+                TestEqual(TEXT("Response order"), GetResponseId(Responses[Index]), Index + 1);
+                TestEqual(TEXT("Echoed value"), GetEchoValue(Responses[Index]), FString::Printf(TEXT("value-%d"), Index + 1));
+            } });
+
+        It("round-trips a multi-megabyte payload", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            // 请求和响应都远大于 Socket 缓冲区,双方都要分多次写入
+            const FString Value = FString::ChrN(4 * 1048576, TEXT('x'));
+            Client->Send(MakeHttpRequest(MakeEchoCall(3, Value)));
+
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Response id"), GetResponseId(Response), 3);
+                TestTrue(TEXT("Echoed value intact"), GetEchoValue(Response) == Value);
+            } });
+
+        It("compresses large responses without reordering the pipeline", [this]()
+           {
+            Server.Reset();
+            FMCPTCPServerConfig Config;
+            Config.bEnableCompression = true;
+            Config.CompressionThresholdBytes = 1024;
+            TestTrue(TEXT("Server restarted"), StartServer(Config));
+
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            // 第一个响应在线程池中压缩,第二个必须等它发送后才能发送
+            const FString LargeValue = FString::ChrN(65536, TEXT('z'));
+            Client->Send(MakeHttpRequest(MakeEchoCall(1, LargeValue), TEXT("Accept-Encoding: gzip\r\n")) +
+                         MakeHttpRequest(MakeEchoCall(2, TEXT("small")), TEXT("Accept-Encoding: gzip\r\n")));
+
+            TArray<FMCPTestResponse> Responses;
+            if (!WaitForResponses(*Client, 2, Responses))
+            {
+                return;
+            }
+
+            const FMCPTestResponse &Compressed = Responses[0];
+            TestTrue(TEXT("First response gzip encoded"), Compressed.HasHeader(TEXT("Content-Encoding: gzip")));
+            if (Compressed.Body.Num() > 4)
+            {
+                // gzip 尾部 4 字节为原始长度(小端)
+                const uint8 *Trailer = Compressed.Body.GetData() + Compressed.Body.Num() - 4;
+                const int32 UncompressedSize = Trailer[0] | (Trailer[1] << 8) | (Trailer[2] << 16) | (Trailer[3] << 24);
+
+                TArray<uint8> Uncompressed;
+                Uncompressed.SetNumUninitialized(UncompressedSize);
+                TestTrue(TEXT("Body decompresses"), FCompression::UncompressMemory(NAME_Gzip, Uncompressed.GetData(), UncompressedSize,
+                                                                                   Compressed.Body.GetData(), Compressed.Body.Num()));
+
+                FMCPTestResponse Decoded;
+                Decoded.Body = MoveTemp(Uncompressed);
+                TSharedRef<TJsonReader<>> Reader = TJsonReaderFactory<>::Create(Decoded.GetBodyString());
+                FJsonSerializer::Deserialize(Reader, Decoded.Json);
+                TestEqual(TEXT("First response id"), GetResponseId(Decoded), 1);
+                TestTrue(TEXT("First response value"), GetEchoValue(Decoded) == LargeValue);
+            }
+
+            TestFalse(TEXT("Small response not compressed"), Responses[1].HasHeader(TEXT("Content-Encoding: gzip")));
+            TestEqual(TEXT("Second response id"), GetResponseId(Responses[1]), 2); });
+
+        It("serves GET /metrics as Prometheus text", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(MakeEchoCall(1, TEXT("counted"))));
+            Client->Send(TEXT("GET /metrics HTTP/1.1\r\nHost: 127.0.0.1\r\n\r\n"));
+
+            TArray<FMCPTestResponse> Responses;
+            if (!WaitForResponses(*Client, 2, Responses))
+            {
+                return;
+            }
+
+            const FMCPTestResponse &Metrics = Responses[1];
+            TestTrue(TEXT("Prometheus content type"), Metrics.HasHeader(TEXT("Content-Type: text/plain; version=0.0.4; charset=utf-8")));
+            TestTrue(TEXT("Request counted"), Metrics.GetBodyString().Contains(TEXT("unreal_mcp_requests_total{tool=\"test_echo\"} 1")));
+        }); });
+
+    Describe("Newline framing", [this]()
+             {
+        BeforeEach([this]()
+                   { TestTrue(TEXT("Server started"), StartServer()); });
+
+        It("treats each line as one request", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeEchoCall(1, TEXT("first")) + TEXT("\n") + MakeEchoCall(2, TEXT("second")) + TEXT("\r\n"));
+
+            TArray<FMCPTestResponse> Responses;
+            if (WaitForResponses(*Client, 2, Responses))
+            {
+                TestEqual(TEXT("First value"), GetEchoValue(Responses[0]), FString(TEXT("first")));
+                TestEqual(TEXT("Second value"), GetEchoValue(Responses[1]), FString(TEXT("second")));
+            } });
+
+        It("waits for the rest of a line split across sends", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            const FString Request = MakeEchoCall(1, TEXT("split"));
+            Client->Send(Request.Left(Request.Len() / 2));
+            TestTrue(TEXT("No response to half a line"), ExpectNoResponse(*Client));
+
+            Client->Send(Request.Mid(Request.Len() / 2) + TEXT("\n"));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Echoed value"), GetEchoValue(Response), FString(TEXT("split")));
+            } });
+
+        It("finds the line break of a partial request that followed a complete one", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            // 第二条消息的前半部分已扫描过,剩余部分到达后只扫描新数据
+            const FString Second = MakeEchoCall(2, FString::ChrN(256 * 1024, TEXT('y')));
+            Client->Send(MakeEchoCall(1, TEXT("first")) + TEXT("\n") + Second.Left(Second.Len() / 2));
+            FMCPTestResponse First;
+            if (WaitForResponse(*Client, First))
+            {
+                TestEqual(TEXT("First response id"), GetResponseId(First), 1);
+            }
+
+            Client->Send(Second.Mid(Second.Len() / 2) + TEXT("\n"));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Second response id"), GetResponseId(Response), 2);
+            } });
+
+        It("accepts a final request without a line break once it is complete JSON", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeEchoCall(4, TEXT("unterminated")));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Response id"), GetResponseId(Response), 4);
+            } });
+
+        It("routes the legacy {type} format to the handler", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(TEXT("{\"type\":\"test_echo\",\"value\":\"legacy\"}\n"));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response) && TestTrue(TEXT("JSON response"), Response.Json.IsValid()))
+            {
+                TestEqual(TEXT("Status"), Response.Json->GetStringField(TEXT("status")), FString(TEXT("success")));
+                TestEqual(TEXT("Value"), Response.Json->GetStringField(TEXT("value")), FString(TEXT("legacy")));
+            } }); });
+
+    Describe("JSON-RPC routing", [this]()
+             {
+        BeforeEach([this]()
+                   { TestTrue(TEXT("Server started"), StartServer()); });
+
+        It("lists registered tools", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/list\"}")));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestTrue(TEXT("test_echo listed"), Response.GetBodyString().Contains(TEXT("\"name\":\"test_echo\"")));
+            } });
+
+        It("returns -32601 for an unknown method", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"no/such/method\"}")));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Error code"), GetErrorCode(Response), -32601);
+            } });
+
+        It("rejects resources/subscribe over HTTP", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"resources/subscribe\",\"params\":{\"uri\":\"unreal://camera\"}}")));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Error code"), GetErrorCode(Response), -32600);
+            } });
+
+        It("omits the text copy of a large result only for clients that declare structuredContent", [this]()
+           {
+            FMCPTestClient *LegacyClient = Connect();
+            FMCPTestClient *ModernClient = Connect();
+            if (!LegacyClient || !ModernClient)
+            {
+                return;
+            }
+
+            const FString Value = FString::ChrN(MCPConstants::MAX_TOOL_RESULT_TEXT_BYTES * 2, TEXT('x'));
+            LegacyClient->Send(MakeHttpRequest(MakeEchoCall(1, Value)));
+            ModernClient->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"initialize\",\"params\":{\"protocolVersion\":\"2025-06-18\"}}")) +
+                               MakeHttpRequest(MakeEchoCall(2, Value)));
+
+            FMCPTestResponse LegacyResponse;
+            if (WaitForResponse(*LegacyClient, LegacyResponse))
+            {
+                TestTrue(TEXT("Full text for a content-only client"), GetContentText(LegacyResponse).Contains(Value));
+            }
+
+            TArray<FMCPTestResponse> ModernResponses;
+            if (WaitForResponses(*ModernClient, 2, ModernResponses))
+            {
+                TestEqual(TEXT("Structured result intact"), GetEchoValue(ModernResponses[1]), Value);
+                TestTrue(TEXT("Summary text only"), GetContentText(ModernResponses[1]).StartsWith(TEXT("Result is")));
+            } });
+
+        It("returns -32601 for an unknown tool", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/call\",\"params\":{\"name\":\"no_such_tool\"}}")));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Error code"), GetErrorCode(Response), -32601);
+            } });
+
+        It("returns -32602 when params are missing", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/call\"}")));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Error code"), GetErrorCode(Response), -32602);
+            } });
+
+        It("rejects arguments that violate the tool schema with a JSON pointer", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/call\",\"params\":{\"name\":\"test_echo\",\"arguments\":{\"value\":5}}}")));
+            FMCPTestResponse Response;
+            if (!WaitForResponse(*Client, Response))
+            {
+                return;
+            }
+
+            TestEqual(TEXT("Error code"), GetErrorCode(Response), -32602);
+            const TSharedPtr<FJsonObject> *Error = nullptr;
+            const TSharedPtr<FJsonObject> *Data = nullptr;
+            if (Response.Json.IsValid() && Response.Json->TryGetObjectField(TEXT("error"), Error) && (*Error)->TryGetObjectField(TEXT("data"), Data))
+            {
+                TestEqual(TEXT("Pointer"), (*Data)->GetStringField(TEXT("pointer")), FString(TEXT("/value")));
+            }
+            else
+            {
+                AddError(TEXT("Missing error.data"));
+            } }); });
+
+    Describe("Binary encoding", [this]()
+             {
+        BeforeEach([this]()
+                   { TestTrue(TEXT("Server started"), StartServer()); });
+
+        It("answers a MessagePack request in MessagePack", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            FTCHARToUTF8 Converter(*MakeEchoCall(4, TEXT("packed")));
+            TArray<uint8> Body;
+            FString Error;
+            if (!TestTrue(TEXT("Request transcoded"), FMCPBinaryCodec::TranscodeJson(EMCPWireFormat::MessagePack, Converter.Get(), Converter.Length(), Body, Error)))
+            {
+                return;
+            }
+
+            Client->SendBytes(MakeBinaryHttpRequest(EMCPWireFormat::MessagePack, Body));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestTrue(TEXT("MessagePack content type"), Response.HasHeader(FString::Printf(TEXT("Content-Type: %s"), FMCPBinaryCodec::GetMimeType(EMCPWireFormat::MessagePack))));
+                TestEqual(TEXT("Response id"), GetResponseId(Response), 4);
+                TestEqual(TEXT("Echoed value"), GetEchoValue(Response), FString(TEXT("packed")));
+            } });
+
+        It("rejects a deeply tagged CBOR request and keeps serving the connection", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            // 4 MB 的标签头(0xC6 = 标签 6),递归解码会耗尽栈
+            TArray<uint8> Body;
+            Body.Init(0xC6, 4 * 1048576);
+            Client->SendBytes(MakeBinaryHttpRequest(EMCPWireFormat::Cbor, Body));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Parse error"), GetErrorCode(Response), -32700);
+            }
+
+            Client->Send(MakeHttpRequest(MakeEchoCall(5, TEXT("after"))));
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Next request answered"), GetResponseId(Response), 5);
+            }
+            TestFalse(TEXT("Connection still open"), Client->IsClosedByPeer()); }); });
+
+    Describe("Malformed input", [this]()
+             {
+        BeforeEach([this]()
+                   { TestTrue(TEXT("Server started"), StartServer()); });
+
+        It("ignores invalid JSON and keeps serving the connection", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(MakeHttpRequest(TEXT("{not json")) + MakeHttpRequest(TEXT("[1,2,3]")) + MakeHttpRequest(MakeEchoCall(9, TEXT("after"))));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Only the valid request answered"), GetResponseId(Response), 9);
+            }
+            TestTrue(TEXT("No further responses"), ExpectNoResponse(*Client));
+            TestFalse(TEXT("Connection still open"), Client->IsClosedByPeer()); });
+
+        It("ignores an invalid newline-framed request", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(TEXT("{\"unterminated\": \n") + MakeEchoCall(3, TEXT("next")) + TEXT("\n"));
+            FMCPTestResponse Response;
+            if (WaitForResponse(*Client, Response))
+            {
+                TestEqual(TEXT("Valid request answered"), GetResponseId(Response), 3);
+            } });
+
+        It("closes the connection on an invalid Content-Length", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(TEXT("POST / HTTP/1.1\r\nContent-Length: twelve\r\n\r\n{}"));
+            TestTrue(TEXT("Connection closed"), PumpUntil([Client]()
+                                                          { return Client->IsClosedByPeer(); }));
+            TestEqual(TEXT("Server dropped the client"), Server->GetClientEndpoints().Num(), 0); });
+
+        It("closes the connection on an oversized Content-Length", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(FString::Printf(TEXT("POST / HTTP/1.1\r\nContent-Length: %d\r\n\r\n"), MCPConstants::MAX_MESSAGE_SIZE + 1));
+            TestTrue(TEXT("Connection closed"), PumpUntil([Client]()
+                                                          { return Client->IsClosedByPeer(); })); });
+
+        It("closes the connection when the HTTP header never ends", [this]()
+           {
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(TEXT("POST / HTTP/1.1\r\nX-Filler: ") + FString::ChrN(MCPConstants::MAX_HTTP_HEADER_SIZE + 1, TEXT('a')));
+            TestTrue(TEXT("Connection closed"), PumpUntil([Client]()
+                                                          { return Client->IsClosedByPeer(); })); }); });
+
+    Describe("Connections", [this]()
+             {
+        It("keeps responses of concurrent clients separate", [this]()
+           {
+            TestTrue(TEXT("Server started"), StartServer());
+
+            constexpr int32 ClientCount = 8;
+            constexpr int32 RequestsPerClient = 5;
+
+            TArray<FMCPTestClient *> Connected;
+            for (int32 Index = 0; Index < ClientCount; ++Index)
+            {
+                if (FMCPTestClient *Client = Connect())
+                {
+                    Connected.Add(Client);
+                }
+            }
+            if (!TestEqual(TEXT("All clients connected"), Connected.Num(), ClientCount))
+            {
+                return;
+            }
+
+            // 交错发送,HTTP 和换行分帧混用
+            for (int32 Request = 0; Request < RequestsPerClient; ++Request)
+            {
+                for (int32 Index = 0; Index < ClientCount; ++Index)
+                {
+                    const int32 Id = Index * 100 + Request;
+                    const FString Call = MakeEchoCall(Id, FString::Printf(TEXT("client-%d"), Index));
+                    Connected[Index]->Send(Index % 2 == 0 ? MakeHttpRequest(Call) : Call + TEXT("\n"));
+                }
+                Server->Pump(DEFAULT_TICK_SECONDS);
+            }
+
+            for (int32 Index = 0; Index < ClientCount; ++Index)
+            {
+                TArray<FMCPTestResponse> Responses;
+                if (!WaitForResponses(*Connected[Index], RequestsPerClient, Responses))
+                {
+                    continue;
+                }
+                for (int32 Request = 0; Request < RequestsPerClient; ++Request)
+                {
+                    TestEqual(TEXT("Response id"), GetResponseId(Responses[Request]), Index * 100 + Request);
+                    TestEqual(TEXT("Response value"), GetEchoValue(Responses[Request]), FString::Printf(TEXT("client-%d"), Index));
+                }
+            } });
+
+        It("disconnects a client that stays idle past the timeout", [this]()
+           {
+            FMCPTCPServerConfig Config;
+            Config.ClientTimeoutSeconds = 2.0f;
+            TestTrue(TEXT("Server started"), StartServer(Config));
+
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            // 每次 Tick 推进 0.5 秒
+            TestTrue(TEXT("Idle client closed"), PumpUntil([Client]()
+                                                           { return Client->IsClosedByPeer(); },
+                                                           DEFAULT_WAIT_SECONDS, 0.5f));
+            TestEqual(TEXT("Server dropped the client"), Server->GetClientEndpoints().Num(), 0); });
+
+        It("keeps an active client connected", [this]()
+           {
+            FMCPTCPServerConfig Config;
+            Config.ClientTimeoutSeconds = 2.0f;
+            TestTrue(TEXT("Server started"), StartServer(Config));
+
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            // 总计 5 秒的 Tick,每 1.5 秒发一个请求
+            for (int32 Id = 0; Id < 3; ++Id)
+            {
+                Client->Send(MakeEchoCall(Id, TEXT("keepalive")) + TEXT("\n"));
+                FMCPTestResponse Response;
+                WaitForResponse(*Client, Response);
+
+                int32 Ticks = 3;
+                PumpUntil([&Ticks]()
+                          { return --Ticks <= 0; },
+                          DEFAULT_WAIT_SECONDS, 0.5f);
+            }
+
+            TestFalse(TEXT("Client still connected"), Client->IsClosedByPeer());
+            TestEqual(TEXT("Server keeps the client"), Server->GetClientEndpoints().Num(), 1); });
+
+        It("disconnects a client whose async request never completes", [this]()
+           {
+            FMCPTCPServerConfig Config;
+            Config.ClientTimeoutSeconds = 2.0f;
+            TestTrue(TEXT("Server started"), StartServer(Config));
+            Server->RegisterCommandHandler(MakeShared<FMCPTestStalledHandler>());
+
+            FMCPTestClient *Client = Connect();
+            if (!Client)
+            {
+                return;
+            }
+
+            Client->Send(TEXT("{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"tools/call\",\"params\":{\"name\":\"test_stall\",\"arguments\":{}}}\n"));
+
+            // 超过空闲超时仍保持连接,等待异步请求完成
+            int32 Ticks = 10;
+            PumpUntil([&Ticks]()
+                      { return --Ticks <= 0; },
+                      DEFAULT_WAIT_SECONDS, 0.5f);
+            TestFalse(TEXT("Connection kept past the idle timeout"), Client->IsClosedByPeer());
+
+            // 硬性期限为 ClientTimeoutSeconds 的 ASYNC_REQUEST_TIMEOUT_MULTIPLIER 倍
+            TestTrue(TEXT("Stalled client closed"), PumpUntil([Client]()
+                                                              { return Client->IsClosedByPeer(); },
+                                                              DEFAULT_WAIT_SECONDS, 1.0f));
+            TestEqual(TEXT("Server dropped the client"), Server->GetClientEndpoints().Num(), 0); }); });
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -4,6 +4,7 @@
 #include "MCPTCPServer.h"
 #include "MCPSettings.h"
 #include "MCPConstants.h"
+#include "SMCPDashboard.h"
 #include "LevelEditor.h"
 #include "Framework/MultiBox/MultiBoxBuilder.h"
 #include "Styling/SlateStyleRegistry.h"
@@ -15,6 +16,8 @@
 #include "Widgets/SWindow.h"
 #include "Widgets/Layout/SBox.h"
 #include "Widgets/Layout/SBorder.h"
+#include "Widgets/Layout/SScrollBox.h"
+#include "Widgets/Layout/SSeparator.h"
 #include "Widgets/Text/STextBlock.h"
 #include "Widgets/Input/SButton.h"
 #include "Framework/Application/SlateApplication.h"
@@ -98,6 +101,19 @@ void FUnreal5MCPModule::ExtendLevelEditorToolbar()
                 FSlateIcon(),
                 EUserInterfaceActionType::ToggleButton));
     }
+
+    // 窗口菜单中打开控制面板
+    UToolMenu *WindowMenu = ToolMenus->ExtendMenu("LevelEditor.MainMenu.Window");
+    if (WindowMenu)
+    {
+        FToolMenuSection &Section = WindowMenu->FindOrAddSection("PluginTools");
+        Section.AddMenuEntry(
+            "MCPControlPanel",
+            LOCTEXT("MCPControlPanelMenu", "MCP Control Panel"),
+            LOCTEXT("MCPControlPanelMenuTooltip", "打开 MCP 服务器控制面板和运行仪表盘"),
+            FSlateIcon(),
+            FUIAction(FExecuteAction::CreateRaw(this, &FUnreal5MCPModule::OpenMCPControlPanel)));
+    }
 }
 
 void FUnreal5MCPModule::AddToolbarButton(FToolBarBuilder &Builder)
@@ -124,7 +140,7 @@ void FUnreal5MCPModule::OpenMCPControlPanel()
 
     MCPControlPanelWindow = SNew(SWindow)
                                 .Title(LOCTEXT("MCPControlPanel", "MCP Control Panel"))
-                                .ClientSize(FVector2D(400, 300))
+                                .ClientSize(FVector2D(640, 760))
                                 .SupportsMaximize(false)
                                 .SupportsMinimize(false);
 
@@ -211,7 +227,18 @@ TSharedRef<SWidget> FUnreal5MCPModule::CreateMCPControlPanelContent()
                    .Padding(0, 20, 0, 0)
                        [SNew(STextBlock)
                             .Text(LOCTEXT("MCPInfo", "The MCP (Model Context Protocol) server allows AI tools like Claude to control Unreal Engine programmatically."))
-                            .AutoWrapText(true)]];
+                            .AutoWrapText(true)]
+
+             + SVerticalBox::Slot()
+                   .AutoHeight()
+                   .Padding(0, 16)
+                       [SNew(SSeparator)]
+
+             // 运行仪表盘
+             + SVerticalBox::Slot()
+                   .FillHeight(1.0f)
+                       [SNew(SScrollBox) + SScrollBox::Slot()[SNew(SMCPDashboard).GetServer([this]() -> const FMCPTCPServer *
+                                                                                             { return IsServerRunning() ? Server.Get() : nullptr; })]]];
 }
 
 FReply FUnreal5MCPModule::OnStartServerClicked()
@@ -256,11 +283,8 @@ void FUnreal5MCPModule::StartServer()
     MCP_LOG_INFO("Creating new server instance");
     const UMCPSettings *Settings = GetDefault<UMCPSettings>();
 
-    // 创建配置对象并从设置中设置端口
-    FMCPTCPServerConfig Config;
-    Config.Port = Settings->Port;
-    Config.bEnableVerboseLogging = Settings->bEnableVerboseLogging;
-    Config.ClientTimeoutSeconds = Settings->ClientTimeoutSeconds;
+    // 从设置创建完整的配置(压缩、请求日志等)
+    const FMCPTCPServerConfig Config = FMCPTCPServerConfig::FromSettings(Settings);
 
     // 使用配置创建服务器
     Server = MakeUnique<FMCPTCPServer>(Config);
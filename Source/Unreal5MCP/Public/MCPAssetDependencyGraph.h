@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+#include "AssetRegistry/AssetRegistryInterface.h"
+
+/**
+ * FMCPAssetDependencyGraph - 资源依赖图查询
+ *
+ * 在资源注册表的包依赖图上执行有限深度的广度优先遍历:
+ * - 每个包的邻接表(按方向和依赖类别)在首次访问时缓存
+ * - 资源注册表发生变化(添加、删除、重命名、更新)时清空缓存
+ *
+ * 所有访问都在游戏线程进行
+ */
+class FMCPAssetDependencyGraph
+{
+public:
+    /** 遍历方向 */
+    enum class EDirection : uint8
+    {
+        /** 该资源引用的资源 */
+        Dependencies,
+        /** 引用该资源的资源 */
+        Referencers
+    };
+
+    /** 遍历参数 */
+    struct FQuery
+    {
+        EDirection Direction = EDirection::Dependencies;
+        UE::AssetRegistry::EDependencyCategory Category = UE::AssetRegistry::EDependencyCategory::Package;
+        UE::AssetRegistry::EDependencyQuery Flags = UE::AssetRegistry::EDependencyQuery::NoRequirements;
+        int32 MaxDepth = 1;
+        int32 MaxResults = 500;
+
+        /** 只返回这些类的资源(需已展开子类),为空时不过滤;遍历仍会经过其他资源 */
+        TSet<FTopLevelAssetPath> ClassFilter;
+
+        /** 是否包含 /Script/ 原生包 */
+        bool bIncludeScriptPackages = false;
+    };
+
+    /** 单个结果节点 */
+    struct FNode
+    {
+        FName PackageName;
+        FTopLevelAssetPath AssetClass;
+        int32 Depth = 0;
+
+        /** 广度优先树中的上一个包(起点为 NAME_None) */
+        FName Via;
+    };
+
+    /** 遍历结果 */
+    struct FResult
+    {
+        TArray<FNode> Nodes;
+        int32 VisitedCount = 0;
+        bool bTruncated = false;
+    };
+
+    FMCPAssetDependencyGraph();
+    ~FMCPAssetDependencyGraph();
+
+    /** 注册资源注册表回调 */
+    void Initialize();
+
+    /** 注销回调并清空缓存 */
+    void Shutdown();
+
+    /**
+     * 从一个包开始遍历依赖图
+     * @param RootPackage 起点包名
+     */
+    void Traverse(FName RootPackage, const FQuery &Query, FResult &OutResult);
+
+    /** 缓存的邻接表数量 */
+    int32 GetNumCachedNodes() const { return Adjacency.Num(); }
+
+private:
+    /** 邻接表缓存键: 包名 + 方向 + 类别 + 查询标志 */
+    struct FAdjacencyKey
+    {
+        FName PackageName;
+        uint8 Direction;
+        uint8 Category;
+        uint32 Flags;
+
+        bool operator==(const FAdjacencyKey &Other) const
+        {
+            return PackageName == Other.PackageName && Direction == Other.Direction &&
+                   Category == Other.Category && Flags == Other.Flags;
+        }
+
+        friend uint32 GetTypeHash(const FAdjacencyKey &Key)
+        {
+            return HashCombine(GetTypeHash(Key.PackageName), (uint32(Key.Direction) << 24) ^ (uint32(Key.Category) << 16) ^ Key.Flags);
+        }
+    };
+
+    /** 获取(必要时查询并缓存)邻接表 */
+    const TArray<FName> &GetNeighbors(FName PackageName, const FQuery &Query);
+
+    /** 获取包中主资源的类(缓存) */
+    const FTopLevelAssetPath &GetPackageClass(FName PackageName);
+
+    /** 类是否满足过滤条件 */
+    bool MatchesClassFilter(const FTopLevelAssetPath &AssetClass, const FQuery &Query) const;
+
+    void InvalidateCache();
+
+    void HandleAssetAdded(const FAssetData &AssetData);
+    void HandleAssetRemoved(const FAssetData &AssetData);
+    void HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath);
+    void HandleAssetUpdated(const FAssetData &AssetData);
+
+    TMap<FAdjacencyKey, TArray<FName>> Adjacency;
+    TMap<FName, FTopLevelAssetPath> PackageClasses;
+
+    bool bInitialized;
+
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+    FDelegateHandle AssetUpdatedHandle;
+};
@@ -0,0 +1,130 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AssetRegistry/AssetData.h"
+
+/**
+ * FMCPAssetSearchIndex - 资源全文搜索索引
+ *
+ * 基于三元组(trigram)的内存索引,覆盖资源名称、包路径和选定的注册表标签:
+ * - 资源注册表扫描完成后在后台线程构建
+ * - 通过 OnAssetAdded / OnAssetRemoved / OnAssetRenamed 增量更新
+ * - 查询按三元组命中率和名称匹配排序,支持模糊匹配
+ *
+ * 除后台构建外,所有访问都在游戏线程进行
+ */
+class FMCPAssetSearchIndex : public TSharedFromThis<FMCPAssetSearchIndex>
+{
+public:
+    /** 单条搜索结果 */
+    struct FSearchResult
+    {
+        FString ObjectPath;
+        FString AssetName;
+        FString ClassName;
+        float Score = 0.0f;
+    };
+
+    FMCPAssetSearchIndex();
+    ~FMCPAssetSearchIndex();
+
+    /**
+     * 初始化索引
+     * 如果资源注册表已完成扫描则立即开始后台构建,否则等待 OnFilesLoaded
+     */
+    void Initialize();
+
+    /**
+     * 关闭索引并注销所有资源注册表回调
+     */
+    void Shutdown();
+
+    /** 索引是否已构建完成,可以查询 */
+    bool IsReady() const { return Data.IsValid(); }
+
+    /** 是否正在后台构建 */
+    bool IsBuilding() const { return bBuilding; }
+
+    /** 索引中的有效资源数量 */
+    int32 GetNumEntries() const;
+
+    /**
+     * 执行模糊搜索
+     * @param Query 查询文本,按空白、下划线和大小写边界分词
+     * @param MaxResults 返回的最大结果数
+     * @param ClassFilter 类短名称过滤(为空时不过滤)
+     * @param OutResults 按得分从高到低排序的结果
+     */
+    void Search(const FString &Query, int32 MaxResults, const FString &ClassFilter, TArray<FSearchResult> &OutResults) const;
+
+private:
+    /** 索引条目 */
+    struct FEntry
+    {
+        FString ObjectPath;
+        FString AssetName;
+        FString ClassName;
+
+        /** 规范化后的资源名称(用于排序加分) */
+        FString NormalizedName;
+
+        /** 规范化后的完整搜索文本(名称 + 路径 + 标签值) */
+        FString SearchText;
+
+        bool bAlive = true;
+    };
+
+    /** 索引数据 - 在后台线程构建完成后整体交换到游戏线程 */
+    struct FIndexData
+    {
+        TArray<FEntry> Entries;
+        TMap<FString, int32> PathToEntry;
+        TMap<uint64, TArray<int32>> Postings;
+        int32 NumDead = 0;
+
+        void AddEntry(FEntry &&Entry);
+        void RemoveEntry(const FString &ObjectPath);
+        void CompactIfNeeded();
+    };
+
+    /** 构建期间收到的增量更新 */
+    struct FPendingUpdate
+    {
+        FString RemovedPath;
+        FAssetData AddedAsset;
+    };
+
+    /** 从资源数据创建索引条目 */
+    static FEntry MakeEntry(const FAssetData &AssetData, const TArray<FName> &IndexedTags);
+
+    /** 规范化文本: 小写,拆分下划线/路径分隔符/驼峰边界,词首补空格 */
+    static FString NormalizeText(const FString &Text);
+
+    /** 对规范化文本中的每个三元组调用回调(可能重复) */
+    static void ForEachTrigram(const FString &NormalizedText, TFunctionRef<void(uint64)> Callback);
+
+    void StartBackgroundBuild();
+    void FinishBackgroundBuild(TUniquePtr<FIndexData> NewData);
+
+    void HandleFilesLoaded();
+    void HandleAssetAdded(const FAssetData &AssetData);
+    void HandleAssetRemoved(const FAssetData &AssetData);
+    void HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath);
+
+    /** 当前可查询的索引(构建完成前为空) */
+    TUniquePtr<FIndexData> Data;
+
+    /** 后台构建期间排队的更新 */
+    TArray<FPendingUpdate> PendingUpdates;
+
+    /** 需要纳入索引的注册表标签 */
+    TArray<FName> IndexedTags;
+
+    bool bBuilding;
+    bool bInitialized;
+
+    FDelegateHandle FilesLoadedHandle;
+    FDelegateHandle AssetAddedHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+};
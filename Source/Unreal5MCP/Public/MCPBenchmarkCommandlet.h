@@ -0,0 +1,31 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MCPBenchmarkCommandlet.generated.h"
+
+/**
+ * UMCPBenchmarkCommandlet - MCP 服务器压测
+ *
+ * 在进程内新建测试关卡并启动服务器,由多个回环连接回放请求日志或按合成的工具组合发送请求,
+ * 同时以固定帧率驱动编辑器。结束后输出吞吐量、各工具的延迟分位数和帧耗时 (JSON 和 CSV)。
+ * 可在 -nullrhi 下无界面运行:
+ *
+ *   UnrealEditor-Cmd Project.uproject -run=MCPBenchmark -nullrhi -unattended [-Trace=mcp_journal.jsonl]
+ *       [-Connections=4] [-Concurrency=1] [-Requests=1000] [-Actors=200] [-MaxFPS=60] [-Seed=0]
+ *       [-Output=Saved/MCPBenchmark/Result] [-MaxP99Ms=N] [-MaxErrorRate=F]
+ *
+ * 有请求未完成,或超过 -MaxP99Ms / -MaxErrorRate 给定的阈值时返回 1
+ */
+UCLASS()
+class UMCPBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+    UMCPBenchmarkCommandlet();
+
+    //~ Begin UCommandlet Interface
+    virtual int32 Main(const FString &Params) override;
+    //~ End UCommandlet Interface
+};
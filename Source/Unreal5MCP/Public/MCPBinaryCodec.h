@@ -0,0 +1,59 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonValue.h"
+
+/**
+ * 请求和响应的编码格式
+ */
+enum class EMCPWireFormat : uint8
+{
+    Json,
+    MessagePack,
+    Cbor
+};
+
+/**
+ * FMCPBinaryCodec - MessagePack / CBOR 编解码
+ *
+ * 处理器只面向 JSON 数据模型(FJsonValue 或 FMCPJsonStreamWriter 的输出),与线上格式无关。
+ * 二进制请求解码为 FJsonValue 后走与 JSON 请求相同的分发路径;
+ * 响应先按 JSON 序列化,再由 TranscodeJson 逐个记号转换为二进制格式,不构建 DOM。
+ *
+ * 数据模型的映射:
+ * - 整数值编码为整数,其余数字在 float32 能精确表示时编码为 float32,否则为 float64
+ * - 解码时 map 的键必须为字符串;二进制串和扩展类型不受支持
+ */
+class UNREAL5MCP_API FMCPBinaryCodec
+{
+public:
+    /**
+     * 从 Content-Type / Accept 中的媒体类型识别格式(忽略参数,不区分大小写)
+     * @return 无法识别时返回 Json
+     */
+    static EMCPWireFormat FromMimeType(FUtf8StringView MimeType);
+
+    /**
+     * 从 Accept 头中选择第一个受支持的二进制格式
+     * @return 未列出二进制格式时返回 false
+     */
+    static bool FindAcceptedFormat(FUtf8StringView Accept, EMCPWireFormat &OutFormat);
+
+    /** 响应的 Content-Type */
+    static const TCHAR *GetMimeType(EMCPWireFormat Format);
+
+    /** 日志用的格式名称 */
+    static const TCHAR *GetFormatName(EMCPWireFormat Format);
+
+    /**
+     * 解码一个完整的二进制值
+     * @return 出错或有多余数据时返回 nullptr,OutError 为原因
+     */
+    static TSharedPtr<FJsonValue> Decode(EMCPWireFormat Format, const uint8 *Data, int32 Length, FString &OutError);
+
+    /**
+     * 把 UTF-8 JSON 转换为二进制格式,追加到 OutData
+     * @return JSON 无法解析时返回 false
+     */
+    static bool TranscodeJson(EMCPWireFormat Format, const ANSICHAR *Json, int32 Length, TArray<uint8> &OutData, FString &OutError);
+};
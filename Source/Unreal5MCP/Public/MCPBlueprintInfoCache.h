@@ -0,0 +1,77 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IO/IoHash.h"
+#include "Dom/JsonObject.h"
+#include "UObject/ObjectSaveContext.h"
+
+class UBlueprint;
+class UPackage;
+struct FAssetData;
+
+/**
+ * FMCPBlueprintInfoCache - 蓝图详细信息缓存
+ *
+ * 按包名缓存 get_blueprint_info 生成的 JSON,命中时无需加载和遍历蓝图:
+ * - 条目记录生成时包的保存哈希,磁盘上的包被替换(如同步版本库)后自动失效
+ * - 包被修改、保存、删除、重命名或蓝图重新编译时立即失效
+ *
+ * 所有访问都在游戏线程进行
+ */
+class FMCPBlueprintInfoCache
+{
+public:
+    FMCPBlueprintInfoCache();
+    ~FMCPBlueprintInfoCache();
+
+    /** 注册失效回调 */
+    void Initialize();
+
+    /** 注销所有回调并清空缓存 */
+    void Shutdown();
+
+    /**
+     * 查找缓存的蓝图信息
+     * @return 缓存条目仍然有效时返回信息,否则返回 nullptr
+     */
+    TSharedPtr<FJsonObject> Find(FName PackageName) const;
+
+    /** 缓存蓝图信息,记录当前的包保存哈希 */
+    void Add(FName PackageName, const TSharedPtr<FJsonObject> &Info);
+
+    /** 使单个包的缓存失效 */
+    void Invalidate(FName PackageName);
+
+    /** 清空缓存 */
+    void InvalidateAll();
+
+    /** 缓存条目数量 */
+    int32 Num() const { return Entries.Num(); }
+
+private:
+    struct FEntry
+    {
+        FIoHash SavedHash;
+        TSharedPtr<FJsonObject> Info;
+    };
+
+    /** 从资源注册表获取包的保存哈希(未保存过的包为零哈希) */
+    static FIoHash GetPackageSavedHash(FName PackageName);
+
+    void HandleObjectModified(UObject *Object);
+    void HandlePackageSaved(const FString &PackageFileName, UPackage *Package, FObjectPostSaveContext SaveContext);
+    void HandleBlueprintPreCompile(UBlueprint *Blueprint);
+    void HandleAssetRemoved(const FAssetData &AssetData);
+    void HandleAssetRenamed(const FAssetData &AssetData, const FString &OldObjectPath);
+
+    TMap<FName, FEntry> Entries;
+
+    bool bInitialized;
+
+    FDelegateHandle ObjectModifiedHandle;
+    FDelegateHandle PackageSavedHandle;
+    FDelegateHandle BlueprintPreCompileHandle;
+    FDelegateHandle ReloadCompleteHandle;
+    FDelegateHandle AssetRemovedHandle;
+    FDelegateHandle AssetRenamedHandle;
+};
@@ -2,6 +2,17 @@
 
 #include "CoreMinimal.h"
 #include "MCPTCPServer.h"
+#include "MCPAssetDependencyGraph.h"
+#include "MCPParamBinding.h"
+#include "MCPCommandParams.h"
+
+class FMCPAssetSearchIndex;
+class FMCPImportJobManager;
+class FMCPSaveQueue;
+class FMCPServerMetrics;
+class FMCPBlueprintInfoCache;
+class UBlueprint;
+struct FEdGraphPinType;
 
 /**
  * FMCPCommandHandlerBase - 命令处理器基类
@@ -12,7 +23,7 @@
  * - 错误处理
  * - 日志记录
  */
-class FMCPCommandHandlerBase : public IMCPCommandHandler
+class FMCPCommandHandlerBase : public IMCPCommandHandler, public TSharedFromThis<FMCPCommandHandlerBase>
 {
 public:
     virtual ~FMCPCommandHandlerBase() {}
@@ -126,6 +137,119 @@ protected:
     AActor *FindActorByName(UWorld *World,
                             const FString &ActorName,
                             TSharedPtr<FJsonObject> &OutErrorResponse);
+
+    /**
+     * 按名称查找类
+     * 先按完整路径查找(如 /Script/Engine.StaticMeshActor),失败后按短名称查找
+     * @param ClassName 类名或类路径
+     * @return 类指针,失败返回nullptr
+     */
+    UClass *FindClassByName(const FString &ClassName) const;
+
+    /**
+     * 蓝图加载完成回调
+     * 结果数组与请求路径一一对应,加载失败的位置为 nullptr
+     */
+    using FOnBlueprintsLoaded = TFunction<void(const TArray<UBlueprint *> &)>;
+
+    /**
+     * 加载一组蓝图
+     * 已在内存中的蓝图直接返回;其余路径合并为一次 FStreamableManager 异步请求,
+     * 由加载器流水线化 I/O,加载期间服务器继续处理其他请求
+     * @param BlueprintPaths 蓝图资源路径(包路径或对象路径)
+     * @param bAsync 是否异步加载,false 时阻塞加载并立即回调
+     * @param OnLoaded 加载完成回调(游戏线程)
+     */
+    void LoadBlueprints(const TArray<FString> &BlueprintPaths, bool bAsync, FOnBlueprintsLoaded OnLoaded);
+
+    /**
+     * 将资源路径转换为对象路径
+     * /Game/BP/BP_Door -> /Game/BP/BP_Door.BP_Door
+     */
+    static FSoftObjectPath MakeAssetObjectPath(const FString &AssetPath);
+};
+
+/**
+ * FMCPBlueprintHandlerBase - 需要加载蓝图的命令处理器基类
+ *
+ * 从 path / paths 参数读取蓝图路径,加载完成后调用 ExecuteWithBlueprints:
+ * - 服务器分发(ExecuteAsync)时异步加载,在完成回调中返回结果
+ * - 直接调用 Execute 时阻塞加载,保持同步语义
+ */
+class FMCPBlueprintHandlerBase : public FMCPCommandHandlerBase
+{
+public:
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual void ExecuteAsync(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPCommandCallback OnComplete) override;
+
+protected:
+    /**
+     * 蓝图加载完成后执行命令
+     * @param Params 命令参数
+     * @param BlueprintPaths 请求的蓝图路径
+     * @param Blueprints 加载结果,与路径一一对应,失败为 nullptr
+     * @return JSON响应对象
+     */
+    virtual TSharedPtr<FJsonObject> ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                          const TArray<FString> &BlueprintPaths,
+                                                          const TArray<UBlueprint *> &Blueprints) = 0;
+
+    /** 是否接受 paths 数组参数 */
+    virtual bool SupportsMultiplePaths() const { return false; }
+
+    /**
+     * 从参数解析需要加载的蓝图路径,默认读取 path / paths
+     * @param OutPaths 蓝图路径,加载结果按此顺序传给 ExecuteWithBlueprints
+     * @param OutError 失败时的错误信息
+     * @return 是否解析成功
+     */
+    virtual bool ResolveBlueprintPaths(const TSharedPtr<FJsonObject> &Params, TArray<FString> &OutPaths, FString &OutError);
+
+    /**
+     * 加载蓝图前调用,可在无需加载时(如命中缓存)直接返回结果
+     * @return 非空时作为命令结果,不再加载蓝图
+     */
+    virtual TSharedPtr<FJsonObject> TryExecuteWithoutLoading(const TSharedPtr<FJsonObject> &Params, const TArray<FString> &BlueprintPaths) { return nullptr; }
+
+private:
+    /** 解析路径参数并加载蓝图 */
+    void Run(const TSharedPtr<FJsonObject> &Params, bool bAsyncLoad, FMCPCommandCallback OnComplete);
+};
+
+/**
+ * TMCPTypedHandler - 类型化参数的命令处理器基类
+ *
+ * 参数由 FMCPParamBinding 一次性解码到 USTRUCT TParams 后调用 ExecuteTyped,
+ * 工具的 inputSchema 由同一个结构体生成,与实际读取的字段保持一致
+ */
+template <typename TParams>
+class TMCPTypedHandler : public FMCPCommandHandlerBase
+{
+public:
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override
+    {
+        return FMCPParamBinding::GetSchema(TParams::StaticStruct());
+    }
+
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override final
+    {
+        TParams TypedParams;
+        FString Error;
+        if (!FMCPParamBinding::Decode(TParams::StaticStruct(), Params, &TypedParams, Error))
+        {
+            return CreateErrorResponse(Error);
+        }
+        return ExecuteTyped(TypedParams, ClientSocket);
+    }
+
+protected:
+    /**
+     * 执行命令
+     * @param Params 解码后的参数
+     * @param ClientSocket 客户端 Socket
+     * @return JSON响应对象
+     */
+    virtual TSharedPtr<FJsonObject> ExecuteTyped(const TParams &Params, FSocket *ClientSocket) = 0;
 };
 
 /**
@@ -135,17 +259,25 @@ class FMCPGetSceneInfoHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("get_scene_info"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+    /** 大场景的 Actor 列表直接写入响应缓冲区 */
+    virtual bool SupportsStreaming() const override { return true; }
+    virtual void ExecuteStreaming(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPJsonStreamWriter &Writer) override;
 };
 
 /**
  * 创建对象命令处理器
  */
-class FMCPCreateObjectHandler : public FMCPCommandHandlerBase
+class FMCPCreateObjectHandler : public TMCPTypedHandler<FMCPCreateObjectParams>
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("create_object"); }
-    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual FString GetDescription() const override;
+
+protected:
+    virtual TSharedPtr<FJsonObject> ExecuteTyped(const FMCPCreateObjectParams &Params, FSocket *ClientSocket) override;
 };
 
 /**
@@ -155,6 +287,7 @@ class FMCPModifyObjectHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("modify_object"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -165,6 +298,7 @@ class FMCPDeleteObjectHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("delete_object"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -178,38 +312,147 @@ public:
 class FMCPCreateBlueprintHandler : public FMCPCommandHandlerBase
 {
 public:
+    explicit FMCPCreateBlueprintHandler(TSharedPtr<FMCPSaveQueue> InSaveQueue) : SaveQueue(InSaveQueue) {}
+
     virtual FString GetCommandName() const override { return TEXT("create_blueprint"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
 };
 
 /**
  * 获取蓝图信息命令处理器
+ * 返回变量、函数签名、组件和接口,结果按包缓存
  */
-class FMCPGetBlueprintInfoHandler : public FMCPCommandHandlerBase
+class FMCPGetBlueprintInfoHandler : public FMCPBlueprintHandlerBase
 {
 public:
+    FMCPGetBlueprintInfoHandler();
+    virtual ~FMCPGetBlueprintInfoHandler();
+
     virtual FString GetCommandName() const override { return TEXT("get_blueprint_info"); }
-    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+
+protected:
+    virtual TSharedPtr<FJsonObject> TryExecuteWithoutLoading(const TSharedPtr<FJsonObject> &Params, const TArray<FString> &BlueprintPaths) override;
+    virtual TSharedPtr<FJsonObject> ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                          const TArray<FString> &BlueprintPaths,
+                                                          const TArray<UBlueprint *> &Blueprints) override;
+    virtual bool SupportsMultiplePaths() const override { return true; }
+
+private:
+    /** 组装响应: 单个路径返回信息对象,多个路径返回数组 */
+    TSharedPtr<FJsonObject> MakeInfoResponse(const TSharedPtr<FJsonObject> &Params,
+                                             const TArray<FString> &BlueprintPaths,
+                                             const TArray<TSharedPtr<FJsonObject>> &Infos,
+                                             int32 CachedCount);
+
+    /** 蓝图信息缓存 */
+    TSharedPtr<FMCPBlueprintInfoCache> InfoCache;
 };
 
 /**
  * 修改蓝图属性命令处理器
  */
-class FMCPModifyBlueprintHandler : public FMCPCommandHandlerBase
+class FMCPModifyBlueprintHandler : public FMCPBlueprintHandlerBase
 {
 public:
+    explicit FMCPModifyBlueprintHandler(TSharedPtr<FMCPSaveQueue> InSaveQueue) : SaveQueue(InSaveQueue) {}
+
     virtual FString GetCommandName() const override { return TEXT("modify_blueprint"); }
-    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+
+protected:
+    virtual TSharedPtr<FJsonObject> ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                          const TArray<FString> &BlueprintPaths,
+                                                          const TArray<UBlueprint *> &Blueprints) override;
+
+private:
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
+};
+
+/**
+ * 编辑蓝图命令处理器
+ *
+ * 在一次修改中依次应用操作列表(添加组件、添加成员变量、设置组件属性、设置类默认值),
+ * 结构性修改只标记一次,最后只编译一次
+ */
+class FMCPEditBlueprintHandler : public FMCPBlueprintHandlerBase
+{
+public:
+    explicit FMCPEditBlueprintHandler(TSharedPtr<FMCPSaveQueue> InSaveQueue) : SaveQueue(InSaveQueue) {}
+
+    virtual FString GetCommandName() const override { return TEXT("edit_blueprint"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+
+protected:
+    virtual TSharedPtr<FJsonObject> ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                          const TArray<FString> &BlueprintPaths,
+                                                          const TArray<UBlueprint *> &Blueprints) override;
+
+private:
+    /** 添加构造脚本组件 */
+    bool AddComponent(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const;
+
+    /** 添加成员变量 */
+    bool AddVariable(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const;
+
+    /** 设置构造脚本组件模板的属性 */
+    bool SetComponentProperty(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const;
+
+    /** 设置类默认对象的属性(编译后执行) */
+    bool SetClassDefault(UBlueprint *Blueprint, const TSharedPtr<FJsonObject> &Operation, FString &OutError) const;
+
+    /**
+     * 解析变量类型
+     * 支持 bool/int/int64/float/double/byte/string/name/text、常用结构体(vector/rotator/transform/color)、
+     * 类名(对象引用),后缀 [] 表示数组
+     */
+    bool ParsePinType(const FString &TypeName, FEdGraphPinType &OutPinType, FString &OutError) const;
+
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
 };
 
 /**
  * 编译蓝图命令处理器
  */
-class FMCPCompileBlueprintHandler : public FMCPCommandHandlerBase
+class FMCPCompileBlueprintHandler : public FMCPBlueprintHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("compile_blueprint"); }
-    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+
+protected:
+    virtual TSharedPtr<FJsonObject> ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                          const TArray<FString> &BlueprintPaths,
+                                                          const TArray<UBlueprint *> &Blueprints) override;
+};
+
+/**
+ * 批量编译蓝图命令处理器
+ *
+ * 接受路径列表或目录,按资源注册表中的依赖关系排序(被依赖的蓝图先编译),
+ * 跳过已是最新的蓝图,其余在一次批量编译中完成,最后只执行一次垃圾回收
+ */
+class FMCPCompileBlueprintsHandler : public FMCPBlueprintHandlerBase
+{
+public:
+    virtual FString GetCommandName() const override { return TEXT("compile_blueprints"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+
+protected:
+    virtual bool ResolveBlueprintPaths(const TSharedPtr<FJsonObject> &Params, TArray<FString> &OutPaths, FString &OutError) override;
+    virtual TSharedPtr<FJsonObject> ExecuteWithBlueprints(const TSharedPtr<FJsonObject> &Params,
+                                                          const TArray<FString> &BlueprintPaths,
+                                                          const TArray<UBlueprint *> &Blueprints) override;
 };
 
 // ============================================================================
@@ -219,11 +462,14 @@ public:
 /**
  * 设置摄像机位置命令处理器
  */
-class FMCPSetCameraHandler : public FMCPCommandHandlerBase
+class FMCPSetCameraHandler : public TMCPTypedHandler<FMCPSetCameraParams>
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("set_camera"); }
-    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual FString GetDescription() const override;
+
+protected:
+    virtual TSharedPtr<FJsonObject> ExecuteTyped(const FMCPSetCameraParams &Params, FSocket *ClientSocket) override;
 };
 
 /**
@@ -233,6 +479,7 @@ class FMCPGetCameraHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("get_camera"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -243,6 +490,7 @@ class FMCPCreateLightHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("create_light"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -253,6 +501,7 @@ class FMCPSelectActorHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("select_actor"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -263,6 +512,22 @@ class FMCPGetSelectedActorsHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("get_selected_actors"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+};
+
+/**
+ * 批量选择Actor命令处理器
+ *
+ * 按名称列表、类、标签或空间区域过滤Actor,
+ * 在一次批量选择操作中完成修改,只发送一次选择变更通知
+ */
+class FMCPSelectActorsHandler : public FMCPCommandHandlerBase
+{
+public:
+    virtual FString GetCommandName() const override { return TEXT("select_actors"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -272,12 +537,60 @@ public:
 
 /**
  * 导入资源命令处理器
+ *
+ * 将一个或多个源文件作为导入作业提交给 FMCPImportJobManager,
+ * wait 为 true 时在作业结束后返回结果,否则立即返回作业 ID
  */
 class FMCPImportAssetHandler : public FMCPCommandHandlerBase
 {
 public:
+    explicit FMCPImportAssetHandler(TSharedPtr<FMCPImportJobManager> InJobManager) : JobManager(InJobManager) {}
+
     virtual FString GetCommandName() const override { return TEXT("import_asset"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+    virtual void ExecuteAsync(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPCommandCallback OnComplete) override;
+
+private:
+    /** 解析参数并启动作业,失败时返回错误响应 */
+    TSharedPtr<FJsonObject> StartImportJob(const TSharedPtr<FJsonObject> &Params, int32 &OutJobId);
+
+    TSharedPtr<FMCPImportJobManager> JobManager;
+};
+
+/**
+ * 导入作业状态查询命令处理器
+ */
+class FMCPImportStatusHandler : public FMCPCommandHandlerBase
+{
+public:
+    explicit FMCPImportStatusHandler(TSharedPtr<FMCPImportJobManager> InJobManager) : JobManager(InJobManager) {}
+
+    virtual FString GetCommandName() const override { return TEXT("import_status"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPImportJobManager> JobManager;
+};
+
+/**
+ * 取消导入作业命令处理器
+ */
+class FMCPCancelImportHandler : public FMCPCommandHandlerBase
+{
+public:
+    explicit FMCPCancelImportHandler(TSharedPtr<FMCPImportJobManager> InJobManager) : JobManager(InJobManager) {}
+
+    virtual FString GetCommandName() const override { return TEXT("cancel_import"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPImportJobManager> JobManager;
 };
 
 /**
@@ -286,8 +599,31 @@ public:
 class FMCPCreateMaterialHandler : public FMCPCommandHandlerBase
 {
 public:
+    explicit FMCPCreateMaterialHandler(TSharedPtr<FMCPSaveQueue> InSaveQueue) : SaveQueue(InSaveQueue) {}
+
     virtual FString GetCommandName() const override { return TEXT("create_material"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
+};
+
+/**
+ * 保存命令处理器
+ * 立即刷新保存队列,可选同时保存编辑器中其他的脏资源包
+ */
+class FMCPSaveDirtyHandler : public FMCPCommandHandlerBase
+{
+public:
+    explicit FMCPSaveDirtyHandler(TSharedPtr<FMCPSaveQueue> InSaveQueue) : SaveQueue(InSaveQueue) {}
+
+    virtual FString GetCommandName() const override { return TEXT("save_dirty"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
 };
 
 /**
@@ -297,7 +633,71 @@ class FMCPListAssetsHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("list_assets"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+};
+
+/**
+ * 资源搜索命令处理器
+ * 使用三元组索引对资源名称、路径和标签进行模糊搜索
+ */
+class FMCPSearchAssetsHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPSearchAssetsHandler();
+    virtual ~FMCPSearchAssetsHandler();
+
+    virtual FString GetCommandName() const override { return TEXT("search_assets"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    /** 搜索索引 */
+    TSharedPtr<FMCPAssetSearchIndex> SearchIndex;
+};
+
+/**
+ * 资源依赖图查询命令处理器基类
+ * 从指定资源出发按方向进行有限深度的广度优先遍历,邻接表由共享的依赖图缓存
+ */
+class FMCPAssetGraphQueryHandler : public FMCPCommandHandlerBase
+{
+public:
+    FMCPAssetGraphQueryHandler(TSharedPtr<FMCPAssetDependencyGraph> InGraph, FMCPAssetDependencyGraph::EDirection InDirection)
+        : Graph(InGraph), Direction(InDirection) {}
+
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPAssetDependencyGraph> Graph;
+    FMCPAssetDependencyGraph::EDirection Direction;
+};
+
+/**
+ * 查询资源依赖命令处理器 - 该资源引用了哪些资源
+ */
+class FMCPGetDependenciesHandler : public FMCPAssetGraphQueryHandler
+{
+public:
+    explicit FMCPGetDependenciesHandler(TSharedPtr<FMCPAssetDependencyGraph> InGraph)
+        : FMCPAssetGraphQueryHandler(InGraph, FMCPAssetDependencyGraph::EDirection::Dependencies) {}
+
+    virtual FString GetCommandName() const override { return TEXT("get_dependencies"); }
+    virtual FString GetDescription() const override;
+};
+
+/**
+ * 查询资源引用者命令处理器 - 哪些资源引用了该资源
+ */
+class FMCPGetReferencersHandler : public FMCPAssetGraphQueryHandler
+{
+public:
+    explicit FMCPGetReferencersHandler(TSharedPtr<FMCPAssetDependencyGraph> InGraph)
+        : FMCPAssetGraphQueryHandler(InGraph, FMCPAssetDependencyGraph::EDirection::Referencers) {}
+
+    virtual FString GetCommandName() const override { return TEXT("get_referencers"); }
+    virtual FString GetDescription() const override;
 };
 
 // ============================================================================
@@ -311,7 +711,17 @@ class FMCPBatchCreateHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("batch_create"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+    /** actors 数组逐条解析、逐条生成 */
+    virtual FString GetStreamedArrayField() const override { return TEXT("actors"); }
+    virtual TSharedPtr<IMCPStreamedArrayConsumer> CreateArrayConsumer(FSocket *ClientSocket) override;
+
+private:
+    /** 逐条创建 Actor 并累积结果,Execute 和流式解析共用 */
+    class FActorCreator;
 };
 
 /**
@@ -321,6 +731,7 @@ class FMCPBatchModifyHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("batch_modify"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
 
@@ -331,5 +742,24 @@ class FMCPBatchDeleteHandler : public FMCPCommandHandlerBase
 {
 public:
     virtual FString GetCommandName() const override { return TEXT("batch_delete"); }
+    virtual FString GetDescription() const override;
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
 };
+
+/**
+ * 服务器统计命令处理器
+ * 返回各工具的请求数、错误数和分阶段延迟分位数,以及收发字节数和连接数
+ */
+class FMCPServerStatsHandler : public FMCPCommandHandlerBase
+{
+public:
+    explicit FMCPServerStatsHandler(TSharedPtr<FMCPServerMetrics> InMetrics) : Metrics(InMetrics) {}
+
+    virtual FString GetCommandName() const override { return TEXT("server_stats"); }
+    virtual FString GetDescription() const override;
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const override;
+    virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) override;
+
+private:
+    TSharedPtr<FMCPServerMetrics> Metrics;
+};
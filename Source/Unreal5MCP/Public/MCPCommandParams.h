@@ -0,0 +1,66 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MCPCommandParams.generated.h"
+
+/**
+ * 类型化命令参数结构体
+ *
+ * 供 TMCPTypedHandler 使用,字段由 FMCPParamBinding 按反射解码:
+ * - JSON 字段名为属性名的 snake_case 形式
+ * - ToolTip 作为 Schema 中的字段描述
+ * - MCPRequired 标记必需字段
+ */
+
+// ============================================================================
+// 对象命令参数
+// ============================================================================
+
+/**
+ * create_object 参数
+ */
+USTRUCT()
+struct FMCPCreateObjectParams
+{
+    GENERATED_BODY()
+
+    /** 要生成的 Actor 类 */
+    UPROPERTY(meta = (MCPRequired, ToolTip = "Full UE class name (e.g., 'ASkyAtmosphere', 'AStaticMeshActor')"))
+    FString ClassName;
+
+    /** Actor 名称,为空时自动生成 */
+    UPROPERTY(meta = (ToolTip = "Actor name (optional)"))
+    FString Name;
+
+    UPROPERTY(meta = (ToolTip = "Location as {x, y, z} (optional)"))
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(meta = (ToolTip = "Rotation as {pitch, yaw, roll} (optional)"))
+    FRotator Rotation = FRotator::ZeroRotator;
+
+    UPROPERTY(meta = (ToolTip = "Scale as {x, y, z} (optional)"))
+    FVector Scale = FVector::OneVector;
+
+    /** StaticMeshActor 使用的网格资源 */
+    UPROPERTY(meta = (ToolTip = "Asset path for StaticMeshActor (optional)"))
+    FString AssetPath;
+};
+
+// ============================================================================
+// 场景编辑命令参数
+// ============================================================================
+
+/**
+ * set_camera 参数
+ */
+USTRUCT()
+struct FMCPSetCameraParams
+{
+    GENERATED_BODY()
+
+    UPROPERTY(meta = (ToolTip = "Camera location as {x, y, z}"))
+    FVector Location = FVector::ZeroVector;
+
+    UPROPERTY(meta = (ToolTip = "Camera rotation as {pitch, yaw, roll}"))
+    FRotator Rotation = FRotator::ZeroRotator;
+};
@@ -33,8 +33,11 @@ namespace MCPConstants
     /** 发送缓冲区大小 (64KB) - 用于发送响应数据 */
     constexpr int32 DEFAULT_SEND_BUFFER_SIZE = DEFAULT_RECEIVE_BUFFER_SIZE;
 
-    /** 最大消息大小 (1MB) - 防止内存溢出 */
-    constexpr int32 MAX_MESSAGE_SIZE = 1048576;
+    /** 最大消息大小 (16MB) - 防止内存溢出,超过时断开连接 */
+    constexpr int32 MAX_MESSAGE_SIZE = 16 * 1048576;
+
+    /** HTTP 请求头的最大大小 (16KB) */
+    constexpr int32 MAX_HTTP_HEADER_SIZE = 16384;
 
     /** 客户端超时时间 (秒) - 无活动后断开连接 */
     constexpr float DEFAULT_CLIENT_TIMEOUT_SECONDS = 30.0f;
@@ -45,6 +48,9 @@ namespace MCPConstants
     /** 最大客户端超时时间 (秒) */
     constexpr float MAX_CLIENT_TIMEOUT_SECONDS = 300.0f;
 
+    /** 异步请求的硬性期限为客户端超时时间的倍数 - 期间没有任何异步请求完成则断开连接 */
+    constexpr float ASYNC_REQUEST_TIMEOUT_MULTIPLIER = 10.0f;
+
     /** 服务器Tick间隔 (秒) - 处理连接和数据的频率 */
     constexpr float DEFAULT_TICK_INTERVAL_SECONDS = 0.1f;
 
@@ -89,12 +95,81 @@ namespace MCPConstants
     /** 查询返回的最大结果数 */
     constexpr int32 MAX_QUERY_RESULTS = 100;
 
+    /** 资源列表单页最大结果数 - 超过此值需使用分页游标 */
+    constexpr int32 MAX_ASSET_PAGE_SIZE = 1000;
+
+    /** 资源搜索默认返回的结果数 */
+    constexpr int32 DEFAULT_SEARCH_RESULTS = 20;
+
     /** 命令执行的最大超时时间 (秒) */
     constexpr float MAX_COMMAND_EXECUTION_TIME = 10.0f;
 
     /** 批处理操作的最大数量 */
     constexpr int32 MAX_BATCH_OPERATIONS = 50;
 
+    /** 导入作业默认的并行导入数量 */
+    constexpr int32 DEFAULT_IMPORT_PARALLELISM = 8;
+
+    /** 导入作业允许的最大并行导入数量 */
+    constexpr int32 MAX_IMPORT_PARALLELISM = 32;
+
+    /** 单个导入作业的最大文件数量 */
+    constexpr int32 MAX_IMPORT_FILES_PER_JOB = 1000;
+
+    /** 导入进度轮询间隔 (秒) */
+    constexpr float IMPORT_POLL_INTERVAL_SECONDS = 0.1f;
+
+    /** 保留的已结束导入作业数量 - 供 import_status 查询 */
+    constexpr int32 MAX_RETAINED_IMPORT_JOBS = 32;
+
+    /** 保存队列空闲自动刷新的延迟 (秒) - 最后一次入队后经过此时间统一保存 */
+    constexpr float SAVE_QUEUE_IDLE_FLUSH_SECONDS = 2.0f;
+
+    /** 批量编译时每个蓝图返回的最大编译消息数 */
+    constexpr int32 MAX_COMPILER_MESSAGES_PER_BLUEPRINT = 50;
+
+    /** 蓝图信息缓存的最大条目数 */
+    constexpr int32 MAX_BLUEPRINT_INFO_CACHE_ENTRIES = 4096;
+
+    /** edit_blueprint 单次请求的最大操作数 */
+    constexpr int32 MAX_BLUEPRINT_EDIT_OPERATIONS = 200;
+
+    /** 依赖图查询的最大遍历深度 */
+    constexpr int32 MAX_DEPENDENCY_DEPTH = 10;
+
+    /** 依赖图查询默认返回的结果数 */
+    constexpr int32 DEFAULT_DEPENDENCY_RESULTS = 500;
+
+    /** 依赖图查询的最大结果数 */
+    constexpr int32 MAX_DEPENDENCY_RESULTS = 5000;
+
+    /** 参数 Schema 的最大嵌套深度 */
+    constexpr int32 MAX_SCHEMA_DEPTH = 16;
+
+    /** 请求 JSON 的最大嵌套深度 */
+    constexpr int32 MAX_JSON_NESTING_DEPTH = 64;
+
+    /**
+     * tools/call 结果总以文本形式放入 content 的最大字节数
+     * 更大的结果只有声明支持 structuredContent 的客户端才省略文本副本
+     */
+    constexpr int32 MAX_TOOL_RESULT_TEXT_BYTES = 65536;
+
+    /** 引入 structuredContent 的 MCP 协议版本,客户端 initialize 时声明的版本不早于它才视为支持 */
+    static const FString STRUCTURED_CONTENT_PROTOCOL_VERSION = TEXT("2025-06-18");
+
+    /** 默认是否压缩响应 */
+    constexpr bool DEFAULT_ENABLE_COMPRESSION = true;
+
+    /** 默认压缩阈值 (16KB) - 更小的响应压缩收益不及后台线程往返的开销 */
+    constexpr int32 DEFAULT_COMPRESSION_THRESHOLD_BYTES = 16384;
+
+    /** MessagePack / CBOR 响应达到该大小 (64KB) 时在后台线程转码 */
+    constexpr int32 MIN_BACKGROUND_ENCODE_BYTES = 65536;
+
+    /** 同一客户端同一资源的更新通知最小间隔(秒) */
+    constexpr float RESOURCE_NOTIFY_MIN_INTERVAL_SECONDS = 0.5f;
+
     // ============================================================================
     // 日志和调试常量
     // ============================================================================
@@ -108,6 +183,74 @@ namespace MCPConstants
     /** 是否记录完整的JSON消息 - 调试用 */
     constexpr bool LOG_FULL_JSON_MESSAGES = false;
 
+    /** 默认是否写请求日志 (JSONL) */
+    constexpr bool DEFAULT_ENABLE_REQUEST_JOURNAL = false;
+
+    /** 请求日志单个文件的默认大小上限 (MB) */
+    constexpr int32 DEFAULT_JOURNAL_MAX_FILE_SIZE_MB = 64;
+
+    /** 请求日志默认保留的文件数 */
+    constexpr int32 DEFAULT_JOURNAL_MAX_FILES = 5;
+
+    /** 请求日志默认写入请求体的比例 - 默认不写 */
+    constexpr float DEFAULT_JOURNAL_PAYLOAD_SAMPLE_RATE = 0.0f;
+
+    /** 请求日志环形缓冲区的容量(条目数,2 的幂) - 满时丢弃新条目 */
+    constexpr uint32 JOURNAL_QUEUE_CAPACITY = 8192;
+
+    /** 请求日志写入线程的刷新间隔 (秒) */
+    constexpr float JOURNAL_FLUSH_INTERVAL_SECONDS = 0.5f;
+
+    /** 请求日志中单个请求体的最大字节数 (64KB) */
+    constexpr int32 MAX_JOURNAL_PAYLOAD_BYTES = 65536;
+
+    /** 请求日志文件名(不含扩展名),位于 PluginLogsPath */
+    static const FString JOURNAL_FILE_BASENAME = TEXT("mcp_journal");
+
+    // ============================================================================
+    // 运行指标和控制面板常量
+    // ============================================================================
+
+    /** 保留的每帧游戏线程耗时样本数 (帧) */
+    constexpr int32 FRAME_HISTORY_LENGTH = 300;
+
+    /** 保留的最近完成请求数,最慢请求从中选出 */
+    constexpr int32 RECENT_CALLS_CAPACITY = 256;
+
+    /** 控制面板显示的最慢请求数 */
+    constexpr int32 DASHBOARD_SLOW_CALLS_SHOWN = 10;
+
+    /** 控制面板的刷新间隔 (秒) */
+    constexpr float DASHBOARD_REFRESH_INTERVAL_SECONDS = 0.25f;
+
+    // ============================================================================
+    // 压测命令行常量
+    // ============================================================================
+
+    /** 默认的客户端连接数 */
+    constexpr int32 DEFAULT_BENCHMARK_CONNECTIONS = 4;
+
+    /** 默认的每个连接同时未完成的请求数 */
+    constexpr int32 DEFAULT_BENCHMARK_CONCURRENCY = 1;
+
+    /** 合成负载默认的请求总数 */
+    constexpr int32 DEFAULT_BENCHMARK_REQUESTS = 1000;
+
+    /** 生成的测试关卡中的 Actor 数 */
+    constexpr int32 DEFAULT_BENCHMARK_ACTORS = 200;
+
+    /** 模拟编辑器帧率的上限 (0 为不限制) */
+    constexpr float DEFAULT_BENCHMARK_MAX_FPS = 60.0f;
+
+    /** 整个压测的时限 (秒),超时视为失败 */
+    constexpr float BENCHMARK_TIMEOUT_SECONDS = 600.0f;
+
+    /** 单个响应的等待时限 (秒) */
+    constexpr float BENCHMARK_RESPONSE_TIMEOUT_SECONDS = 30.0f;
+
+    /** 超时后等待客户端线程退出的时限 (秒) */
+    constexpr float BENCHMARK_STOP_TIMEOUT_SECONDS = 5.0f;
+
     // ============================================================================
     // 安全常量
     // ============================================================================
@@ -153,6 +296,19 @@ namespace MCPConstants
     /** 删除对象命令 */
     static const FString CMD_DELETE_OBJECT = TEXT("delete_object");
 
+    // ============================================================================
+    // 资源 URI 常量
+    // ============================================================================
+
+    /** 场景中的 Actor */
+    static const FString RESOURCE_URI_SCENE = TEXT("unreal://scene");
+
+    /** 当前选中的 Actor */
+    static const FString RESOURCE_URI_SELECTION = TEXT("unreal://selection");
+
+    /** 编辑器视口摄像机 */
+    static const FString RESOURCE_URI_CAMERA = TEXT("unreal://camera");
+
     // ============================================================================
     // 函数声明
     // ============================================================================
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/GCObject.h"
+#include "MCPTCPServer.h"
+
+class UAssetImportTask;
+class FMCPSaveQueue;
+
+/**
+ * 单个导入文件的请求
+ */
+struct FMCPImportFileRequest
+{
+    /** 源文件路径(磁盘) */
+    FString SourcePath;
+
+    /** 目标包目录(如 /Game/Imported) */
+    FString DestinationPath;
+
+    /** 目标资源名称(可选,为空时使用文件名) */
+    FString DestinationName;
+};
+
+/**
+ * FMCPImportJobManager - 资源批量导入作业管理器
+ *
+ * 通过 AssetTools 的自动导入任务(Interchange 启用时为异步导入)后台执行导入:
+ * - 每个作业包含多个源文件,按并行度分批提交,文件解析由导入器并行处理
+ * - 每次 Tick 轮询进度,可随时查询状态或取消尚未开始的文件
+ * - 作业结束后通过保存队列将所有生成的包合并为一次批量保存
+ */
+class FMCPImportJobManager : public FGCObject
+{
+public:
+    explicit FMCPImportJobManager(TSharedPtr<FMCPSaveQueue> InSaveQueue);
+    virtual ~FMCPImportJobManager();
+
+    /**
+     * 创建导入作业
+     * @param Files 要导入的文件
+     * @param bReplaceExisting 是否覆盖已存在的资源
+     * @param bSave 作业结束后是否批量保存生成的包
+     * @param MaxParallel 同时进行的导入任务数量
+     * @return 作业 ID
+     */
+    int32 StartJob(const TArray<FMCPImportFileRequest> &Files, bool bReplaceExisting, bool bSave, int32 MaxParallel);
+
+    /**
+     * 作业结束时回调(如已结束则立即回调)
+     * @return 作业不存在时返回 false
+     */
+    bool WaitForJob(int32 JobId, FMCPCommandCallback OnFinished);
+
+    /**
+     * 请求取消作业,尚未提交的文件将被标记为已取消
+     * @return 作业不存在时返回 false
+     */
+    bool CancelJob(int32 JobId);
+
+    /**
+     * 获取作业状态
+     * @return 作业不存在时返回 nullptr
+     */
+    TSharedPtr<FJsonObject> GetJobStatus(int32 JobId) const;
+
+    //~ Begin FGCObject Interface
+    virtual void AddReferencedObjects(FReferenceCollector &Collector) override;
+    virtual FString GetReferencerName() const override { return TEXT("FMCPImportJobManager"); }
+    //~ End FGCObject Interface
+
+private:
+    /** 单个文件的导入状态 */
+    enum class EFileState : uint8
+    {
+        Pending,
+        Importing,
+        Succeeded,
+        Failed,
+        Cancelled
+    };
+
+    struct FFileEntry
+    {
+        FMCPImportFileRequest Request;
+        EFileState State = EFileState::Pending;
+        TObjectPtr<UAssetImportTask> Task = nullptr;
+        TArray<FString> ImportedObjectPaths;
+        FString Error;
+    };
+
+    struct FJob
+    {
+        int32 JobId = 0;
+        TArray<FFileEntry> Files;
+        int32 NextFileIndex = 0;
+        int32 ActiveCount = 0;
+        int32 MaxParallel = 1;
+        bool bReplaceExisting = true;
+        bool bSave = true;
+        bool bCancelRequested = false;
+        bool bFinished = false;
+        int32 SavedPackageCount = 0;
+        double StartTime = 0.0;
+        double EndTime = 0.0;
+        TArray<FMCPCommandCallback> Waiters;
+    };
+
+    bool Tick(float DeltaTime);
+
+    /** 轮询进行中的任务并提交新任务,返回作业是否已结束 */
+    bool UpdateJob(FJob &Job);
+
+    /** 提交下一批文件 */
+    void SubmitPendingFiles(FJob &Job);
+
+    /** 作业结束: 批量保存并通知等待者 */
+    void FinishJob(FJob &Job);
+
+    /** 生成作业状态 JSON */
+    static TSharedPtr<FJsonObject> MakeJobStatus(const FJob &Job);
+
+    /** 删除最早的已结束作业 */
+    void PruneFinishedJobs();
+
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
+    TMap<int32, TSharedPtr<FJob>> Jobs;
+    int32 NextJobId;
+    FTSTicker::FDelegateHandle TickerHandle;
+};
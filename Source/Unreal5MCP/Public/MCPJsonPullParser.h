@@ -0,0 +1,110 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+/**
+ * 拉取式解析器返回的记号
+ */
+enum class EMCPJsonToken : uint8
+{
+    BeginObject,
+    EndObject,
+    BeginArray,
+    EndArray,
+    /** 对象的键,GetString() 为键名 */
+    Key,
+    String,
+    Number,
+    Boolean,
+    Null,
+    /** 根值已读完且没有多余数据 */
+    End,
+    /** 语法错误,GetError() 为原因 */
+    Error
+};
+
+/**
+ * FMCPJsonPullParser - 拉取式 JSON 解析器
+ *
+ * 直接在请求的 UTF-8 字节上逐个返回记号,不转换为 FString,也不构建完整的 FJsonObject 树。
+ * 调用方可以只为感兴趣的子值(如批量请求中的一个元素)调用 ReadValue 构建 DOM,
+ * 处理完再继续读取下一个,内存占用与单个元素相当。
+ *
+ * 只读取数据,不持有所有权;数据在解析期间必须保持有效
+ */
+class UNREAL5MCP_API FMCPJsonPullParser
+{
+public:
+    FMCPJsonPullParser(const UTF8CHAR *InData, int32 InLength);
+
+    /** 读取下一个记号 */
+    EMCPJsonToken Next();
+
+    /**
+     * 读取下一个完整的值并构建 DOM
+     * @return 出错时返回 nullptr;当前位置是对象或数组的结束时也返回 nullptr 且不报错
+     */
+    TSharedPtr<FJsonValue> ReadValue();
+
+    /** 跳过下一个完整的值,不构建 DOM */
+    bool SkipValue();
+
+    /** Key / String 记号的内容 */
+    const FString &GetString() const { return StringValue; }
+
+    /** Number 记号的值 */
+    double GetNumber() const { return NumberValue; }
+
+    /** Boolean 记号的值 */
+    bool GetBool() const { return bBoolValue; }
+
+    /** 出错原因 */
+    const FString &GetError() const { return ErrorMessage; }
+
+    /** 已读取的字节数 */
+    int32 GetOffset() const { return Position; }
+
+    /** 当前嵌套深度 */
+    int32 GetDepth() const { return Levels.Num(); }
+
+private:
+    /** 一层对象或数组 */
+    struct FLevel
+    {
+        bool bIsObject;
+        bool bHasElements;
+
+        /** 对象中刚读完键,下一个记号是值 */
+        bool bExpectValue;
+    };
+
+    /** 读取一个值的起始记号 */
+    EMCPJsonToken ParseValueToken();
+
+    /** 从已读取的记号构建 DOM */
+    TSharedPtr<FJsonValue> BuildValue(EMCPJsonToken Token);
+
+    bool ParseString();
+    bool ParseNumber();
+    bool ParseLiteral(const ANSICHAR *Literal, int32 LiteralLength);
+    bool PushLevel(bool bIsObject);
+    void SkipWhitespace();
+
+    EMCPJsonToken Fail(const TCHAR *Message);
+
+    const UTF8CHAR *Data;
+    int32 Length;
+    int32 Position;
+
+    TArray<FLevel, TInlineAllocator<16>> Levels;
+
+    /** 已开始读取根值 */
+    bool bRootStarted;
+
+    FString StringValue;
+    double NumberValue;
+    bool bBoolValue;
+    FString ErrorMessage;
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+/**
+ * FMCPJsonStreamWriter - 流式 JSON 写入器
+ *
+ * 按调用顺序把 JSON 直接以 UTF-8 追加到发送缓冲区,不构建 FJsonObject 树,
+ * 也不经过 FString 中转。大结果(如数万个 Actor 的场景信息)只在缓冲区中存在一份。
+ *
+ * 用法:
+ *   Writer.BeginObject();
+ *   Writer.WriteField(TEXT("count"), 3);
+ *   Writer.WriteKey(TEXT("items"));
+ *   Writer.BeginArray();
+ *   ...
+ *   Writer.EndArray();
+ *   Writer.EndObject();
+ *
+ * 逗号由写入器自动插入;对象内每个值之前必须先调用 WriteKey(WriteField 已包含)。
+ * 输出为紧凑格式,NaN/Inf 写为 null
+ */
+class UNREAL5MCP_API FMCPJsonStreamWriter
+{
+public:
+    /** @param InBuffer 输出缓冲区,内容追加在已有数据之后 */
+    explicit FMCPJsonStreamWriter(TArray<ANSICHAR> &InBuffer);
+
+    void BeginObject();
+    void EndObject();
+    void BeginArray();
+    void EndArray();
+
+    /** 写入对象的键,下一次写入的值属于该键 */
+    void WriteKey(FStringView Key);
+
+    void WriteString(FStringView Value);
+    void WriteNumber(double Value);
+    void WriteInteger(int64 Value);
+    void WriteBool(bool Value);
+    void WriteNull();
+
+    /** 写入已编码的 UTF-8 字符串内容(不含引号),按需转义 */
+    void WriteUtf8String(const ANSICHAR *Data, int32 Length);
+
+    /**
+     * 把缓冲区中已写出的 [Start, Start + Length) 再作为字符串写入
+     * 先按转义后的长度预留容量,再直接从原位置转义,不产生临时副本
+     */
+    void WriteBufferRangeAsString(int32 Start, int32 Length);
+
+    /** 写入 {x, y, z} */
+    void WriteVector(const FVector &Value);
+
+    /** 写入 {pitch, yaw, roll} */
+    void WriteRotator(const FRotator &Value);
+
+    /** 写入已有的 DOM,供尚未改为流式输出的结果使用 */
+    void WriteJsonObject(const TSharedPtr<FJsonObject> &Object);
+    void WriteJsonValue(const TSharedPtr<FJsonValue> &Value);
+
+    /** 写入已序列化的 JSON 值,调用方保证其为合法 JSON */
+    void WriteRawJson(const ANSICHAR *Json, int32 Length);
+
+    void WriteField(FStringView Key, FStringView Value) { WriteKey(Key); WriteString(Value); }
+    void WriteField(FStringView Key, const TCHAR *Value) { WriteKey(Key); WriteString(Value); }
+    void WriteField(FStringView Key, const FString &Value) { WriteKey(Key); WriteString(Value); }
+    void WriteField(FStringView Key, double Value) { WriteKey(Key); WriteNumber(Value); }
+    void WriteField(FStringView Key, int32 Value) { WriteKey(Key); WriteInteger(Value); }
+    void WriteField(FStringView Key, int64 Value) { WriteKey(Key); WriteInteger(Value); }
+    void WriteField(FStringView Key, bool Value) { WriteKey(Key); WriteBool(Value); }
+
+    /** 当前缓冲区长度(字节),可用于记录某个值的起止位置 */
+    int32 GetPosition() const { return Buffer.Num(); }
+
+    /** 所有对象和数组均已闭合 */
+    bool IsComplete() const { return Scopes.Num() == 0 && !bAfterKey; }
+
+private:
+    /** 一层对象或数组 */
+    struct FScope
+    {
+        bool bIsObject;
+        bool bHasElements;
+    };
+
+    /** 写入值之前调用,必要时插入逗号 */
+    void BeginValue();
+
+    void AppendLiteral(const ANSICHAR *Literal, int32 Length);
+
+    /** 写入带引号的字符串 */
+    void AppendQuotedString(FStringView Value);
+
+    /** 追加转义后的 UTF-8 内容;Data 可以指向 Buffer 自身,只要容量已预留 */
+    void AppendEscapedUtf8(const ANSICHAR *Data, int32 Length);
+
+    TArray<ANSICHAR> &Buffer;
+
+    /** 当前嵌套的对象和数组 */
+    TArray<FScope, TInlineAllocator<32>> Scopes;
+
+    /** 刚写完键,下一个值不需要逗号 */
+    bool bAfterKey;
+};
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * FMCPParamBinding - 基于反射的命令参数绑定
+ *
+ * 把 JSON 参数一次性解码到 USTRUCT,并从同一个结构体生成工具的 JSON Schema:
+ * - JSON 字段名由属性名转换为 snake_case(布尔属性去掉 b 前缀),如 ClassName -> class_name
+ * - UPROPERTY 元数据: ToolTip 作为字段描述,ClampMin/ClampMax 限制数值范围,
+ *   MCPRequired 标记必需字段
+ * - 每个结构体的字段表(JSON 名称、解码方式、范围)和 Schema 在首次使用时构建并缓存
+ *
+ * 所有访问都在游戏线程进行
+ */
+class UNREAL5MCP_API FMCPParamBinding
+{
+public:
+    /**
+     * 将参数解码到结构体实例
+     * 缺失的可选字段保持结构体默认值
+     * @param Struct 结构体类型
+     * @param Params 命令参数
+     * @param OutStruct 已构造的结构体实例
+     * @param OutError 失败时的错误消息
+     * @return 所有必需字段存在且类型正确时返回 true
+     */
+    static bool Decode(const UScriptStruct *Struct, const TSharedPtr<FJsonObject> &Params, void *OutStruct, FString &OutError);
+
+    /**
+     * 获取结构体对应的参数 Schema(缓存,调用方不应修改)
+     */
+    static TSharedPtr<FJsonObject> GetSchema(const UScriptStruct *Struct);
+
+private:
+    /** 字段解码方式 */
+    enum class EFieldKind : uint8
+    {
+        String,
+        Name,
+        Bool,
+        Number,
+        Vector,
+        Rotator,
+        /** 嵌套结构体,按其字段表递归解码 */
+        Struct,
+        /** 数组,元素按 InnerKind 解码 */
+        Array,
+        /** 其他类型(枚举、对象路径等)交给 FJsonObjectConverter */
+        Generic
+    };
+
+    /** 单个字段 */
+    struct FField
+    {
+        const FProperty *Property = nullptr;
+        FString JsonName;
+        EFieldKind Kind = EFieldKind::Generic;
+        EFieldKind InnerKind = EFieldKind::Generic;
+        bool bRequired = false;
+        TOptional<double> ClampMin;
+        TOptional<double> ClampMax;
+    };
+
+    /** 结构体的字段表 */
+    struct FFieldTable
+    {
+        TArray<FField> Fields;
+        TSharedPtr<FJsonObject> Schema;
+    };
+
+    static const FFieldTable &GetFieldTable(const UScriptStruct *Struct);
+
+    static EFieldKind ClassifyProperty(const FProperty *Property);
+
+    /**
+     * 解码单个值
+     * @param Property 值对应的属性(数组元素时为内部属性)
+     * @param ValuePtr 值的地址
+     */
+    static bool DecodeValue(const FField &Field, const FProperty *Property, EFieldKind Kind,
+                            const TSharedPtr<FJsonValue> &Value, void *ValuePtr, FString &OutError);
+
+    static TSharedPtr<FJsonObject> MakeStructSchema(const UScriptStruct *Struct, const TArray<FField> &Fields);
+    static TSharedPtr<FJsonObject> MakePropertySchema(const FProperty *Property);
+
+    /** 属性名转换为 JSON 字段名 */
+    static FString MakeJsonName(const FProperty *Property);
+
+    static TMap<const UScriptStruct *, TUniquePtr<FFieldTable>> FieldTables;
+};
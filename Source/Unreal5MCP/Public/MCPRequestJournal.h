@@ -0,0 +1,119 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "Containers/CircularQueue.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include <atomic>
+
+class FRunnableThread;
+class FEvent;
+class IFileHandle;
+
+/**
+ * 请求日志配置
+ */
+struct FMCPRequestJournalConfig
+{
+    /** 日志目录 */
+    FString Directory;
+
+    /** 单个文件的最大字节数,超过后轮转 */
+    int64 MaxFileBytes = 0;
+
+    /** 保留的文件数(含当前文件) */
+    int32 MaxFiles = 1;
+
+    /** 写入请求体的比例 0-1 */
+    float PayloadSampleRate = 0.0f;
+};
+
+/**
+ * FMCPRequestJournal - 请求/响应日志 (JSONL)
+ *
+ * 每个工具请求记录两行: 分发时的 request 和发送时的 response,按 client 和 id 关联。
+ * 游戏线程只把条目放入无锁环形缓冲区(单生产者单消费者),格式化和写文件都在写入线程进行;
+ * 缓冲区满时丢弃条目并计数,不阻塞游戏线程。
+ * 文件达到大小上限时轮转: mcp_journal.jsonl -> mcp_journal.1.jsonl -> ...
+ */
+class UNREAL5MCP_API FMCPRequestJournal : public FRunnable
+{
+public:
+    explicit FMCPRequestJournal(const FMCPRequestJournalConfig &InConfig);
+    virtual ~FMCPRequestJournal();
+
+    /** 打开日志文件并启动写入线程 */
+    bool Start();
+
+    /** 写完缓冲区中的条目后停止写入线程 */
+    void Shutdown();
+
+    /**
+     * 记录分发的请求,只在游戏线程调用
+     * @param RequestBytes 请求体大小
+     * @param JsonPayload JSON 请求体,按采样率写入;二进制请求传空
+     */
+    void RecordRequest(const FIPv4Endpoint &Client, const FString &Tool, int32 RequestId, int32 RequestBytes,
+                       FUtf8StringView JsonPayload);
+
+    /**
+     * 记录发送的响应,只在游戏线程调用
+     * @param LatencySeconds 从收到请求到发送完成的时间
+     */
+    void RecordResponse(const FIPv4Endpoint &Client, const FString &Tool, int32 RequestId, int32 ResponseBytes,
+                        double LatencySeconds, bool bError);
+
+    /** 因缓冲区满丢弃的条目数 */
+    uint64 GetDroppedCount() const { return DroppedCount.load(std::memory_order_relaxed); }
+
+    //~ Begin FRunnable Interface
+    virtual uint32 Run() override;
+    virtual void Stop() override;
+    //~ End FRunnable Interface
+
+private:
+    /** 缓冲区中的一条记录,字符串化推迟到写入线程 */
+    struct FEntry
+    {
+        bool bResponse = false;
+        bool bError = false;
+        bool bPayloadTruncated = false;
+        int32 RequestId = 0;
+        int32 Bytes = 0;
+        double LatencySeconds = 0.0;
+        FDateTime Timestamp;
+        FIPv4Endpoint Client;
+        FString Tool;
+
+        /** 采样到的请求体,未采样时为空 */
+        TArray<ANSICHAR> Payload;
+    };
+
+    void Enqueue(FEntry &&Entry);
+
+    /** 写出缓冲区中的所有条目 */
+    void DrainQueue();
+
+    void FormatEntry(const FEntry &Entry, TArray<ANSICHAR> &OutLine) const;
+    void WriteLine(const TArray<ANSICHAR> &Line);
+
+    bool OpenFile();
+    void RotateFiles();
+
+    /** 第 Index 个文件的路径,0 为当前文件 */
+    FString GetFilePath(int32 Index) const;
+
+    FMCPRequestJournalConfig Config;
+
+    TCircularQueue<FEntry> Queue;
+    FRunnableThread *Thread;
+    FEvent *WakeEvent;
+    std::atomic<bool> bStopRequested;
+    std::atomic<uint64> DroppedCount;
+
+    // 以下只在写入线程访问(Start 之前和 Shutdown 之后除外)
+    TUniquePtr<IFileHandle> File;
+    int64 FileBytes;
+    uint64 ReportedDroppedCount;
+    TArray<ANSICHAR> LineBuffer;
+};
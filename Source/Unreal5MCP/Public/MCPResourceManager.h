@@ -0,0 +1,127 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "Dom/JsonObject.h"
+
+class IMCPCommandHandler;
+class FMCPJsonStreamWriter;
+class FSocket;
+class AActor;
+class UObject;
+
+/**
+ * FMCPResourceManager - MCP 资源与订阅
+ *
+ * 以 MCP resources 的形式暴露编辑器状态(场景、选择、摄像机),内容由对应的命令处理器生成:
+ * - resources/read 时调用处理器读取当前状态
+ * - 编辑器委托(Actor 增删移动、地图切换、选择变化)把资源标记为已变化,
+ *   摄像机没有变化委托,有订阅者时每次 Tick 比较视口位置
+ * - 变化以 notifications/resources/updated 推送给订阅的客户端,
+ *   同一客户端同一资源的通知至少间隔 MCPConstants::RESOURCE_NOTIFY_MIN_INTERVAL_SECONDS,期间的变化合并为一次
+ *
+ * 所有访问都在游戏线程进行
+ */
+class FMCPResourceManager
+{
+public:
+    /** 发送通知的回调,客户端已断开时返回 false */
+    using FSendNotification = TFunction<bool(FSocket *, const TSharedPtr<FJsonObject> &)>;
+
+    explicit FMCPResourceManager(FSendNotification InSendNotification);
+    ~FMCPResourceManager();
+
+    /** 注册编辑器委托和 Ticker */
+    void Initialize();
+
+    /** 注销委托并清除所有订阅 */
+    void Shutdown();
+
+    /**
+     * 注册资源
+     * @param Uri 资源 URI,如 unreal://scene
+     * @param Handler 生成资源内容的命令处理器(无参数调用)
+     */
+    void RegisterResource(const FString &Uri, const FString &Name, const FString &Description, TSharedPtr<IMCPCommandHandler> Handler);
+
+    /** resources/list 的结果 */
+    TSharedPtr<FJsonObject> ListResources() const;
+
+    /**
+     * 写出 resources/read 的结果
+     * 处理器流式输出的 result 直接作为资源文本写入,不构建 DOM
+     * @return 资源不存在或读取失败时返回 false 并设置 OutError,此时不向 Writer 写入任何内容
+     */
+    bool ReadResource(const FString &Uri, FMCPJsonStreamWriter &Writer, FString &OutError) const;
+
+    /** 订阅资源,资源不存在时返回 false */
+    bool Subscribe(FSocket *ClientSocket, const FString &Uri);
+
+    /** 取消订阅 */
+    bool Unsubscribe(FSocket *ClientSocket, const FString &Uri);
+
+    /** 移除客户端的所有订阅(断开连接时调用) */
+    void RemoveClient(FSocket *ClientSocket);
+
+    /** 客户端是否有订阅 */
+    bool HasSubscriptions(FSocket *ClientSocket) const;
+
+    /** 标记资源已变化,在下一次 Tick 通知订阅者 */
+    void MarkChanged(const FString &Uri);
+
+private:
+    struct FResource
+    {
+        FString Uri;
+        FString Name;
+        FString Description;
+        TSharedPtr<IMCPCommandHandler> Handler;
+    };
+
+    struct FSubscription
+    {
+        FSocket *Socket = nullptr;
+
+        /** 上次发送通知的时间 */
+        double LastNotifyTime = 0.0;
+
+        /** 有未发送的变化 */
+        bool bPending = false;
+    };
+
+    const FResource *FindResource(const FString &Uri) const;
+
+    bool Tick(float DeltaTime);
+
+    /** 有摄像机订阅者时比较视口位置 */
+    void PollCamera();
+
+    void HandleActorAdded(AActor *Actor);
+    void HandleActorDeleted(AActor *Actor);
+    void HandleActorListChanged();
+    void HandleActorMoved(AActor *Actor);
+    void HandleMapChange(uint32 MapChangeFlags);
+    void HandleSelectionChanged(UObject *Selection);
+
+    FSendNotification SendNotification;
+
+    TArray<FResource> Resources;
+
+    /** URI -> 订阅者 */
+    TMap<FString, TArray<FSubscription>> Subscriptions;
+
+    /** 上次轮询的摄像机状态 */
+    FVector LastCameraLocation;
+    FRotator LastCameraRotation;
+    bool bHasCameraState;
+
+    bool bInitialized;
+
+    FTSTicker::FDelegateHandle TickerHandle;
+    FDelegateHandle ActorAddedHandle;
+    FDelegateHandle ActorDeletedHandle;
+    FDelegateHandle ActorListChangedHandle;
+    FDelegateHandle ActorMovedHandle;
+    FDelegateHandle MapChangeHandle;
+    FDelegateHandle SelectionChangedHandle;
+};
@@ -0,0 +1,78 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Ticker.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UPackage;
+
+/**
+ * FMCPSaveQueue - 延迟批量保存队列
+ *
+ * 收集 MCP 命令修改过的包,合并为一次保存,而不是每个资源单独写盘:
+ * - 显式调用 Flush(save_dirty 命令)
+ * - 批处理作用域(FScopedBatch)结束时
+ * - 最后一次入队后空闲一段时间(MCPConstants::SAVE_QUEUE_IDLE_FLUSH_SECONDS)
+ *
+ * 只保存仍为脏的包,不弹出签出/保存对话框。所有访问都在游戏线程进行
+ */
+class FMCPSaveQueue
+{
+public:
+    /** 一次刷新的结果 */
+    struct FFlushResult
+    {
+        TArray<FString> SavedPackages;
+        TArray<FString> FailedPackages;
+        double DurationSeconds = 0.0;
+    };
+
+    /**
+     * 批处理作用域
+     * 作用域存在期间不会触发空闲刷新,最外层作用域结束时统一刷新
+     */
+    class FScopedBatch
+    {
+    public:
+        explicit FScopedBatch(TSharedPtr<FMCPSaveQueue> InQueue);
+        ~FScopedBatch();
+
+    private:
+        TSharedPtr<FMCPSaveQueue> Queue;
+    };
+
+    FMCPSaveQueue();
+    ~FMCPSaveQueue();
+
+    /** 将包加入保存队列 */
+    void Enqueue(UPackage *Package);
+    void Enqueue(const TArray<UPackage *> &Packages);
+
+    /** 立即保存队列中的所有包 */
+    FFlushResult Flush();
+
+    /** 队列中等待保存的包数量 */
+    int32 GetNumPending() const { return PendingPackages.Num(); }
+
+    /** 已保存的包总数(统计用) */
+    int64 GetTotalSavedCount() const { return TotalSavedCount; }
+
+private:
+    void BeginBatch();
+    void EndBatch();
+
+    bool Tick(float DeltaTime);
+
+    /** 等待保存的包(弱引用,包被删除后自动失效) */
+    TArray<TWeakObjectPtr<UPackage>> PendingPackages;
+
+    /** 最后一次入队的时间 */
+    double LastEnqueueTime;
+
+    /** 嵌套的批处理作用域数量 */
+    int32 BatchDepth;
+
+    int64 TotalSavedCount;
+
+    FTSTicker::FDelegateHandle TickerHandle;
+};
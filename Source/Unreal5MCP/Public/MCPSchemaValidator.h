@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+#include "Dom/JsonValue.h"
+
+/**
+ * FMCPSchemaValidator - 预编译的 JSON Schema 校验器
+ *
+ * 处理器注册时把 inputSchema 编译为扁平的节点数组,每个请求分发前校验参数,
+ * 失败时给出指向出错字段的 JSON Pointer(如 /actors/2/class_name)。
+ *
+ * 支持工具 Schema 中使用的子集: type(字符串或数组)、properties、required、
+ * items、enum、minimum、maximum、minItems、maxItems、additionalProperties(布尔)。
+ * 未识别的关键字忽略,未声明的字段默认允许
+ */
+class UNREAL5MCP_API FMCPSchemaValidator
+{
+public:
+    /** 校验错误 */
+    struct FError
+    {
+        /** 出错位置的 JSON Pointer,根为空字符串 */
+        FString Pointer;
+        FString Message;
+    };
+
+    /**
+     * 编译 Schema
+     * @return 无效的 Schema 返回 nullptr
+     */
+    static TSharedPtr<FMCPSchemaValidator> Compile(const TSharedPtr<FJsonObject> &Schema);
+
+    /**
+     * 校验参数对象
+     * @return 通过返回 true,否则 OutError 为第一个错误
+     */
+    bool Validate(const TSharedPtr<FJsonObject> &Params, FError &OutError) const;
+
+    /**
+     * 校验顶层数组参数的单个元素(流式解析请求时逐个校验)
+     * @param FieldName 顶层数组参数名
+     * @param Index 元素下标,用于错误指针
+     * @return 通过或该参数未声明元素 Schema 时返回 true
+     */
+    bool ValidateArrayElement(const FString &FieldName, int32 Index, const TSharedPtr<FJsonValue> &Element, FError &OutError) const;
+
+    /** 编译后的节点数量 */
+    int32 GetNumNodes() const { return Nodes.Num(); }
+
+private:
+    /** JSON 类型位 */
+    enum ETypeBits : uint8
+    {
+        Type_Null = 1 << 0,
+        Type_Boolean = 1 << 1,
+        Type_Integer = 1 << 2,
+        Type_Number = 1 << 3,
+        Type_String = 1 << 4,
+        Type_Array = 1 << 5,
+        Type_Object = 1 << 6,
+        Type_Any = 0xFF
+    };
+
+    /** 编译后的 Schema 节点 */
+    struct FNode
+    {
+        uint8 TypeMask = Type_Any;
+
+        /** 对象: 声明的属性(名称 -> 节点索引) */
+        TMap<FString, int32> Properties;
+        TArray<FString> Required;
+        bool bAllowAdditionalProperties = true;
+
+        /** 数组: 元素节点索引 */
+        int32 Items = INDEX_NONE;
+        int32 MinItems = 0;
+        int32 MaxItems = MAX_int32;
+
+        /** 字符串枚举 */
+        TArray<FString> EnumValues;
+
+        TOptional<double> Minimum;
+        TOptional<double> Maximum;
+    };
+
+    /** 递归编译节点,返回节点索引 */
+    int32 CompileNode(const TSharedPtr<FJsonObject> &Schema, int32 Depth);
+
+    bool ValidateNode(int32 NodeIndex, const TSharedPtr<FJsonValue> &Value, FString &Pointer, FError &OutError) const;
+    bool ValidateObject(const FNode &Node, const TSharedPtr<FJsonObject> &Object, FString &Pointer, FError &OutError) const;
+
+    static uint8 ParseTypeName(const FString &TypeName);
+    static FString DescribeTypeMask(uint8 TypeMask);
+
+    /** 按 RFC 6901 转义指针片段 */
+    static FString EscapePointerToken(const FString &Token);
+
+    TArray<FNode> Nodes;
+};
@@ -0,0 +1,278 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Dom/JsonObject.h"
+
+/**
+ * 一次工具请求的处理阶段
+ */
+enum class EMCPLatencyPhase : uint8
+{
+    /** 消息收完到开始分发 */
+    QueueWait,
+    /** 处理器执行(异步处理器到完成回调为止) */
+    Execute,
+    /** 序列化响应 */
+    Serialize,
+    /** 编码、压缩并交给 Socket */
+    Send,
+    /** 消息收完到发送完成(端到端) */
+    Total,
+
+    Count
+};
+
+/**
+ * FMCPLatencyHistogram - 对数线性延迟直方图
+ *
+ * 按 HDR 直方图的方式分桶: 每个 2 的幂区间再等分为 32 个子桶,相对误差约 3%。
+ * 以微秒记录,上限约 19 小时;桶数组在第一次记录时分配(4KB)
+ */
+class UNREAL5MCP_API FMCPLatencyHistogram
+{
+public:
+    void Record(double Seconds);
+    void Reset();
+
+    uint64 GetCount() const { return Count; }
+    double GetSumSeconds() const { return SumSeconds; }
+    double GetMaxSeconds() const { return MaxSeconds; }
+
+    /**
+     * 百分位数(秒)
+     * @param Percentile 0-1
+     */
+    double GetPercentile(double Percentile) const;
+
+    /** 写入 {count, mean_ms, p50_ms, p90_ms, p99_ms, max_ms} */
+    TSharedPtr<FJsonObject> ToJson() const;
+
+private:
+    static int32 GetBucketIndex(uint64 Microseconds);
+
+    /** 桶内数值的中点(微秒) */
+    static double GetBucketMidpoint(int32 Index);
+
+    TArray<uint32> Buckets;
+    uint64 Count = 0;
+    double SumSeconds = 0.0;
+    double MaxSeconds = 0.0;
+};
+
+/**
+ * 一帧中 MCP 占用的游戏线程时间
+ */
+struct FMCPFrameSample
+{
+    /** 整帧耗时(毫秒) */
+    float FrameMilliseconds = 0.0f;
+
+    /** 其中 MCP 占用的游戏线程时间(毫秒) */
+    float MCPMilliseconds = 0.0f;
+};
+
+/**
+ * 一次已完成的工具请求
+ */
+struct FMCPCompletedCall
+{
+    FString Command;
+    int32 RequestId = -1;
+
+    /** 收到请求到发送完成的时间(秒) */
+    double LatencySeconds = 0.0;
+
+    bool bError = false;
+
+    /** 完成时间 */
+    FDateTime Time;
+};
+
+/**
+ * 单个工具的请求数和端到端延迟
+ */
+struct FMCPCommandSummary
+{
+    FString Command;
+    uint64 Requests = 0;
+    uint64 Errors = 0;
+    double P50Seconds = 0.0;
+    double P99Seconds = 0.0;
+};
+
+/**
+ * FMCPServerMetrics - 服务器运行指标
+ *
+ * 按工具记录请求数、错误数和各阶段延迟直方图,并记录收发字节数和连接数。
+ * 通过 server_stats 工具以 JSON 返回,通过 GET /metrics 以 Prometheus 文本格式返回。
+ * 只在游戏线程访问
+ */
+class UNREAL5MCP_API FMCPServerMetrics
+{
+public:
+    FMCPServerMetrics();
+
+    /** 收到一条完整消息 */
+    void RecordMessage() { ++MessagesTotal; }
+
+    void RecordRequest(const FString &Command);
+    void RecordError(const FString &Command);
+    void RecordLatency(const FString &Command, EMCPLatencyPhase Phase, double Seconds);
+
+    void AddBytesReceived(int64 Bytes) { BytesReceived += Bytes; }
+    void AddBytesSent(int64 Bytes) { BytesSent += Bytes; }
+
+    void RecordConnectionAccepted() { ++ConnectionsTotal; }
+    void SetActiveConnections(int32 Count) { ActiveConnections = Count; }
+
+    /** 请求发送完成,保留在最近请求中供控制面板挑出最慢的请求 */
+    void RecordCompletion(const FString &Command, int32 RequestId, double LatencySeconds, bool bError);
+
+    /**
+     * 开始/结束一段 MCP 占用的游戏线程工作,由 FMCPGameThreadScope 调用
+     * 可以嵌套,只有最外层计时
+     */
+    void BeginGameThreadWork();
+    void EndGameThreadWork();
+
+    /**
+     * 帧结束: 把本帧累计的 MCP 游戏线程时间存为一个样本
+     * @param FrameSeconds 本帧耗时
+     */
+    void EndFrame(double FrameSeconds);
+
+    uint64 GetRequestsTotal() const { return RequestsTotal; }
+
+    /** 已结束的帧中 MCP 占用的游戏线程时间总和(秒) */
+    double GetGameThreadSecondsTotal() const { return GameThreadSecondsTotal; }
+
+    /** 各工具的请求数和端到端 p50/p99,按工具名排序 */
+    void GetCommandSummaries(TArray<FMCPCommandSummary> &OutSummaries) const;
+
+    /** 最近完成的请求中最慢的 Count 个,按延迟降序 */
+    void GetSlowestRecentCalls(int32 Count, TArray<FMCPCompletedCall> &OutCalls) const;
+
+    /** 最近 FRAME_HISTORY_LENGTH 帧的样本,从旧到新 */
+    void GetFrameHistory(TArray<FMCPFrameSample> &OutSamples) const;
+
+    /**
+     * 生成 JSON 快照
+     * @param CommandFilter 非空时只包含该工具
+     */
+    TSharedPtr<FJsonObject> CreateSnapshot(const FString &CommandFilter = FString()) const;
+
+    /** Prometheus 文本格式 (text/plain; version=0.0.4) */
+    FString FormatPrometheus() const;
+
+    /** 清空所有计数和直方图,连接数除外 */
+    void Reset();
+
+    static const TCHAR *GetPhaseName(EMCPLatencyPhase Phase);
+
+private:
+    /** 单个工具的指标 */
+    struct FCommandMetrics
+    {
+        uint64 Requests = 0;
+        uint64 Errors = 0;
+        FMCPLatencyHistogram Phases[static_cast<int32>(EMCPLatencyPhase::Count)];
+    };
+
+    TMap<FString, FCommandMetrics> Commands;
+
+    /** 最近完成的请求(环形缓冲区) */
+    TArray<FMCPCompletedCall> RecentCalls;
+    int32 RecentCallsHead;
+
+    /** 每帧样本(环形缓冲区) */
+    TArray<FMCPFrameSample> FrameHistory;
+    int32 FrameHistoryHead;
+
+    /** 游戏线程工作的嵌套深度和最外层的开始时间 */
+    int32 GameThreadWorkDepth;
+    double GameThreadWorkStart;
+
+    /** 本帧已累计的 MCP 游戏线程时间 */
+    double FrameGameThreadSeconds;
+
+    /** 累计的 MCP 游戏线程时间 */
+    double GameThreadSecondsTotal;
+
+    uint64 RequestsTotal;
+    uint64 MessagesTotal;
+    uint64 BytesReceived;
+    uint64 BytesSent;
+    uint64 ConnectionsTotal;
+    int32 ActiveConnections;
+
+    /** 开始统计的时间 */
+    double StartTime;
+};
+
+/**
+ * FMCPRequestTimer - 一次工具请求的阶段计时
+ *
+ * 分发时创建,随异步回调传递;每个 Mark 记录从上一个标记到现在的时间
+ */
+class UNREAL5MCP_API FMCPRequestTimer
+{
+public:
+    /**
+     * 记录请求数和排队时间
+     * @param InReceiveTime 消息收完的时间
+     * @param DispatchTime 开始分发的时间
+     */
+    FMCPRequestTimer(const TSharedPtr<FMCPServerMetrics> &InMetrics, const FString &InCommand, double InReceiveTime,
+                     double DispatchTime = FPlatformTime::Seconds());
+
+    void MarkExecuted() { MarkPhase(EMCPLatencyPhase::Execute); }
+    void MarkSerialized() { MarkPhase(EMCPLatencyPhase::Serialize); }
+
+    /** 记录发送阶段和端到端延迟,请求计入最近完成的请求 */
+    void MarkSent();
+
+    /** 请求以错误结束(每个请求只计一次) */
+    void MarkError();
+
+    const FString &GetCommand() const { return Command; }
+    double GetReceiveTime() const { return ReceiveTime; }
+    bool HasError() const { return bErrorRecorded; }
+
+    /** JSON-RPC 请求 id,供 Insights 追踪关联请求 */
+    void SetRequestId(int32 InRequestId) { RequestId = InRequestId; }
+    int32 GetRequestId() const { return RequestId; }
+
+private:
+    void MarkPhase(EMCPLatencyPhase Phase);
+
+    TSharedPtr<FMCPServerMetrics> Metrics;
+    FString Command;
+    double ReceiveTime;
+    double LastMarkTime;
+    int32 RequestId;
+    bool bErrorRecorded;
+};
+
+/**
+ * FMCPGameThreadScope - 把作用域内的游戏线程时间计入当前帧的 MCP 耗时
+ *
+ * 包在 Tick 和游戏线程上的完成回调外;异步处理器在调用完成回调之前的游戏线程工作不计入
+ */
+class FMCPGameThreadScope
+{
+public:
+    explicit FMCPGameThreadScope(const TSharedPtr<FMCPServerMetrics> &InMetrics)
+        : Metrics(InMetrics)
+    {
+        Metrics->BeginGameThreadWork();
+    }
+
+    ~FMCPGameThreadScope()
+    {
+        Metrics->EndGameThreadWork();
+    }
+
+private:
+    /** 持有引用,作用域内服务器被销毁时指标仍然有效 */
+    TSharedPtr<FMCPServerMetrics> Metrics;
+};
@@ -104,6 +104,55 @@ public:
                       ToolTip = "Log complete JSON request and response messages. For debugging only."))
     bool bLogFullJsonMessages;
 
+    /**
+     * 启用请求日志
+     * 在插件 Logs 目录下以 JSONL 记录每个工具请求和响应(时间、客户端、工具、大小、耗时、状态)
+     * 由后台线程写入,不占用游戏线程
+     * 默认: false
+     */
+    UPROPERTY(config, EditAnywhere, Category = "Server|Logging",
+              meta = (DisplayName = "Enable Request Journal",
+                      ToolTip = "Append every tool request and response to Logs/mcp_journal.jsonl in the plugin directory. Written on a background thread."))
+    bool bEnableRequestJournal;
+
+    /**
+     * 请求日志单个文件大小上限（MB）
+     * 超过后轮转到 mcp_journal.1.jsonl
+     * 范围: 1-1024
+     * 默认: 64
+     */
+    UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Server|Logging",
+              meta = (ClampMin = "1", ClampMax = "1024",
+                      EditCondition = "bEnableRequestJournal",
+                      DisplayName = "Journal Max File Size (MB)",
+                      ToolTip = "Size at which the request journal is rotated"))
+    int32 JournalMaxFileSizeMB;
+
+    /**
+     * 请求日志保留的文件数（含当前文件）
+     * 范围: 1-100
+     * 默认: 5
+     */
+    UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Server|Logging",
+              meta = (ClampMin = "1", ClampMax = "100",
+                      EditCondition = "bEnableRequestJournal",
+                      DisplayName = "Journal Max Files",
+                      ToolTip = "Number of journal files kept, including the current one"))
+    int32 JournalMaxFiles;
+
+    /**
+     * 请求体采样率
+     * 按此比例把 JSON 请求体写入请求日志,0 表示不写
+     * 范围: 0.0-1.0
+     * 默认: 0.0
+     */
+    UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Server|Logging",
+              meta = (ClampMin = "0.0", ClampMax = "1.0",
+                      EditCondition = "bEnableRequestJournal",
+                      DisplayName = "Journal Payload Sample Rate",
+                      ToolTip = "Fraction of JSON request bodies written to the journal. 0 records metadata only."))
+    float JournalPayloadSampleRate;
+
     // ============================================================================
     // 性能配置
     // ============================================================================
@@ -147,6 +196,44 @@ public:
                       ToolTip = "Maximum time allowed for a single command execution"))
     float CommandExecutionTimeout;
 
+    /**
+     * 启用响应压缩
+     * 客户端在 Accept-Encoding 中声明 gzip 或 deflate 时压缩较大的响应
+     * 压缩在后台线程进行,不占用游戏线程
+     * 默认: true
+     */
+    UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Server|Performance",
+              meta = (DisplayName = "Enable Response Compression",
+                      ToolTip = "Compress large responses with gzip or deflate when the client sends a matching Accept-Encoding header"))
+    bool bEnableCompression;
+
+    /**
+     * 压缩阈值（字节）
+     * 响应体达到该大小才压缩
+     * 范围: 256-1048576
+     * 默认: 16384 (16KB)
+     */
+    UPROPERTY(config, EditAnywhere, AdvancedDisplay, Category = "Server|Performance",
+              meta = (ClampMin = "256", ClampMax = "1048576",
+                      EditCondition = "bEnableCompression",
+                      DisplayName = "Compression Threshold (Bytes)",
+                      ToolTip = "Minimum response body size before compression is applied"))
+    int32 CompressionThresholdBytes;
+
+    // ============================================================================
+    // 资源搜索配置
+    // ============================================================================
+
+    /**
+     * 纳入资源搜索索引的注册表标签
+     * 这些标签的值会与资源名称和路径一起被 search_assets 检索
+     * 注意: 修改此项需要重启服务器
+     */
+    UPROPERTY(config, EditAnywhere, Category = "Server|Search",
+              meta = (DisplayName = "Search Indexed Tags",
+                      ToolTip = "Asset registry tags whose values are included in the search_assets index. Requires server restart to take effect."))
+    TArray<FName> SearchIndexedTags;
+
     // ============================================================================
     // 自动启动配置
     // ============================================================================
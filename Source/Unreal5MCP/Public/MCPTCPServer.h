@@ -7,7 +7,17 @@
 #include "Common/TcpListener.h"
 #include "Sockets.h"
 #include "SocketSubsystem.h"
+#include "Containers/Queue.h"
 #include "MCPConstants.h"
+#include "MCPJsonStreamWriter.h"
+#include "MCPBinaryCodec.h"
+#include "MCPServerMetrics.h"
+#include "MCPRequestJournal.h"
+
+class FMCPSaveQueue;
+class FMCPResourceManager;
+class FMCPSchemaValidator;
+class FMCPJsonPullParser;
 
 /**
  * FMCPTCPServerConfig - TCP 服务器配置结构
@@ -49,6 +59,24 @@ struct FMCPTCPServerConfig
     /** 场景信息最大Actor数量 */
     int32 MaxActorsInSceneInfo = MCPConstants::MAX_ACTORS_IN_SCENE_INFO;
 
+    /** 是否按客户端的 Accept-Encoding 压缩响应 */
+    bool bEnableCompression = MCPConstants::DEFAULT_ENABLE_COMPRESSION;
+
+    /** 响应体达到该大小(字节)才压缩 */
+    int32 CompressionThresholdBytes = MCPConstants::DEFAULT_COMPRESSION_THRESHOLD_BYTES;
+
+    /** 是否写请求日志 */
+    bool bEnableRequestJournal = MCPConstants::DEFAULT_ENABLE_REQUEST_JOURNAL;
+
+    /** 请求日志单个文件的大小上限（MB） */
+    int32 JournalMaxFileSizeMB = MCPConstants::DEFAULT_JOURNAL_MAX_FILE_SIZE_MB;
+
+    /** 请求日志保留的文件数 */
+    int32 JournalMaxFiles = MCPConstants::DEFAULT_JOURNAL_MAX_FILES;
+
+    /** 请求日志写入请求体的比例 */
+    float JournalPayloadSampleRate = MCPConstants::DEFAULT_JOURNAL_PAYLOAD_SAMPLE_RATE;
+
     /**
      * 从设置对象创建配置
      */
@@ -60,33 +88,130 @@ struct FMCPTCPServerConfig
     bool Validate(FString &OutErrorMessage) const;
 };
 
+/**
+ * 响应的 HTTP 内容编码
+ */
+enum class EMCPContentEncoding : uint8
+{
+    Identity,
+    Gzip,
+    Deflate
+};
+
+/**
+ * 等待发送的响应
+ * 压缩在后台线程进行,完成前排在其后的响应也不能发送,以保证响应顺序与请求一致;
+ * Socket 发送缓冲区已满时,未写完的响应留在队首,在之后的 Tick 中继续发送
+ */
+struct FMCPPendingResponse
+{
+    /** 完整的 HTTP 响应(响应头和响应体) */
+    TArray<uint8> Data;
+
+    /** 已写入 Socket 的字节数 */
+    int32 Offset = 0;
+
+    /** 已可发送 */
+    bool bReady = false;
+
+    /** 所属工具请求的计时,发送后记录发送阶段 */
+    TSharedPtr<FMCPRequestTimer> Timer;
+};
+
 /**
  * 客户端连接信息结构
  */
 struct FMCPClientConnection
 {
+    /**
+     * 连接 ID,单调递增且不会复用
+     * 延迟发送的响应按 ID 查找连接: 断开后新连接的 Socket 可能复用同一地址
+     */
+    uint64 Id;
+
     /** 客户端 Socket */
     FSocket *Socket;
 
     /** 端点信息 */
     FIPv4Endpoint Endpoint;
 
-    /** 上次活动时间（用于超时跟踪） */
+    /** 上次活动时间（用于超时跟踪）,收到数据或排队的响应有发送进展时清零 */
     float TimeSinceLastActivity;
 
-    /** 接收缓冲区 */
+    /** 已分发但尚未完成的异步请求数,大于 0 时不按空闲超时断开 */
+    int32 PendingAsyncRequests;
+
+    /** 有未完成的异步请求以来,距上次异步请求完成的时间,超过硬性期限时断开连接 */
+    float TimeSinceAsyncProgress;
+
+    /** 接收缓冲区 - 已接收但尚未组成完整消息的 UTF-8 字节 */
     TArray<uint8> ReceiveBuffer;
 
+    /** 每次 Recv 读取的最大字节数 */
+    int32 ReceiveChunkSize;
+
+    /** 最近一次收到数据的时间,作为其中消息的接收时间 */
+    double LastReceiveTime;
+
+    /**
+     * 接收缓冲区开头尚未收到换行的原始 TCP 消息中,已确认不含换行的字节数
+     * 大消息分多次到达时只扫描新收到的数据,不重复扫描整个缓冲区
+     */
+    int32 LineScanOffset;
+
+    /** 发送队列 - 仅在有编码中或未写完的响应时非空 */
+    TArray<TSharedRef<FMCPPendingResponse>> SendQueue;
+
+    /**
+     * 连接上收到过 HTTP 请求
+     * HTTP 的每个响应都对应一个请求,服务器不能在这类连接上主动推送通知,因此不接受资源订阅
+     */
+    bool bHttp;
+
+    /** 客户端在 initialize 中声明的协议版本支持 structuredContent,大结果可省略 content 中的文本副本 */
+    bool bStructuredContent;
+
     /**
      * 构造函数
      */
-    FMCPClientConnection(FSocket *InSocket, const FIPv4Endpoint &InEndpoint, int32 BufferSize = MCPConstants::DEFAULT_RECEIVE_BUFFER_SIZE)
-        : Socket(InSocket), Endpoint(InEndpoint), TimeSinceLastActivity(0.0f)
+    FMCPClientConnection(uint64 InId, FSocket *InSocket, const FIPv4Endpoint &InEndpoint, int32 BufferSize = MCPConstants::DEFAULT_RECEIVE_BUFFER_SIZE)
+        : Id(InId), Socket(InSocket), Endpoint(InEndpoint), TimeSinceLastActivity(0.0f), PendingAsyncRequests(0), TimeSinceAsyncProgress(0.0f), ReceiveChunkSize(BufferSize), LastReceiveTime(0.0), LineScanOffset(0), bHttp(false),
+          bStructuredContent(false)
     {
-        ReceiveBuffer.SetNumUninitialized(BufferSize);
+        ReceiveBuffer.Reserve(BufferSize);
     }
 };
 
+/**
+ * 命令完成回调
+ * 异步命令在完成时(可能在之后的帧)调用,传入响应对象
+ */
+using FMCPCommandCallback = TFunction<void(const TSharedPtr<FJsonObject> &)>;
+
+/**
+ * 流式数组参数的消费者
+ * 处理器为每个请求创建一个,服务器每解码出数组参数的一个元素就调用一次 Consume,
+ * 不等待整个请求解析完成
+ */
+class IMCPStreamedArrayConsumer
+{
+public:
+    virtual ~IMCPStreamedArrayConsumer() {}
+
+    /** 处理一个已通过 schema 校验的元素 */
+    virtual void Consume(int32 Index, const TSharedPtr<FJsonValue> &Element) = 0;
+
+    /** 记录无法处理的元素(校验失败或请求在该元素处无法解析) */
+    virtual void Reject(int32 Index, const FString &Error) = 0;
+
+    /**
+     * 所有元素处理完成后生成响应
+     * @param OtherParams 请求中除该数组外的参数
+     * @return JSON 响应对象,与 Execute 的返回值结构相同
+     */
+    virtual TSharedPtr<FJsonObject> Finish(const TSharedPtr<FJsonObject> &OtherParams) = 0;
+};
+
 /**
  * 命令处理器接口
  * 允许轻松添加新命令而无需修改服务器
@@ -101,6 +226,25 @@ public:
      */
     virtual FString GetCommandName() const = 0;
 
+    /**
+     * 获取工具描述(tools/list 中显示)
+     */
+    virtual FString GetDescription() const
+    {
+        return FString::Printf(TEXT("Execute %s command"), *GetCommandName());
+    }
+
+    /**
+     * 获取工具参数的 JSON Schema
+     * 默认返回不限制字段的 object schema
+     */
+    virtual TSharedPtr<FJsonObject> GetInputSchema() const
+    {
+        TSharedPtr<FJsonObject> Schema = MakeShared<FJsonObject>();
+        Schema->SetStringField("type", TEXT("object"));
+        return Schema;
+    }
+
     /**
      * 执行命令
      * @param Params - 命令参数
@@ -108,6 +252,51 @@ public:
      * @return JSON 响应对象
      */
     virtual TSharedPtr<FJsonObject> Execute(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket) = 0;
+
+    /**
+     * 异步执行命令
+     * 服务器通过此入口分发命令。默认实现同步调用 Execute;
+     * 需要等待资源加载等操作的处理器可以重写此函数,在完成时调用 OnComplete,
+     * 期间服务器继续处理其他请求
+     * @param Params - 命令参数
+     * @param ClientSocket - 客户端 Socket
+     * @param OnComplete - 完成回调,必须在游戏线程上恰好调用一次
+     */
+    virtual void ExecuteAsync(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPCommandCallback OnComplete)
+    {
+        OnComplete(Execute(Params, ClientSocket));
+    }
+
+    /**
+     * 是否支持流式输出
+     * 返回 true 时服务器改为同步调用 ExecuteStreaming,结果直接写入发送缓冲区
+     */
+    virtual bool SupportsStreaming() const { return false; }
+
+    /**
+     * 流式执行命令
+     * 写出与 Execute 返回值结构相同的响应对象,默认实现序列化 Execute 的结果
+     * @param Params - 命令参数
+     * @param ClientSocket - 客户端 Socket
+     * @param Writer - 写入器,当前位置等待一个值
+     */
+    virtual void ExecuteStreaming(const TSharedPtr<FJsonObject> &Params, FSocket *ClientSocket, FMCPJsonStreamWriter &Writer)
+    {
+        Writer.WriteJsonObject(Execute(Params, ClientSocket));
+    }
+
+    /**
+     * 可流式读取的数组参数名
+     * 非空时服务器直接在请求字节上解析,该数组的元素逐个交给 CreateArrayConsumer 返回的消费者,
+     * 不构建整个参数树;为空表示总是以完整参数调用 Execute
+     */
+    virtual FString GetStreamedArrayField() const { return FString(); }
+
+    /**
+     * 为一次请求创建数组元素消费者
+     * @return 返回 nullptr 时服务器改为以完整参数调用 Execute
+     */
+    virtual TSharedPtr<IMCPStreamedArrayConsumer> CreateArrayConsumer(FSocket *ClientSocket) { return nullptr; }
 };
 
 /**
@@ -167,19 +356,59 @@ public:
      */
     void SendResponse(FSocket *Client, const TSharedPtr<FJsonObject> &Response);
 
+    /**
+     * 发送已序列化的 UTF-8 JSON 响应体
+     * 响应体达到压缩阈值且客户端接受 gzip/deflate 时,在后台线程压缩后再发送;
+     * 客户端请求 MessagePack / CBOR 时转码后发送
+     * @param ExtraHeaders 附加的 HTTP 头(每行以 \r\n 结尾)
+     */
+    void SendRawResponse(FSocket *Client, const ANSICHAR *Body, int32 BodyLength, const FString &ExtraHeaders = FString());
+
+    /**
+     * 检查客户端是否仍然连接
+     * 异步命令完成时用于确认客户端未在等待期间断开
+     */
+    bool IsClientConnected(FSocket *Client) const;
+
     /**
      * 获取命令处理器映射（用于测试）
      */
     const TMap<FString, TSharedPtr<IMCPCommandHandler>> &GetCommandHandlers() const { return CommandHandlers; }
 
+    /**
+     * 获取实际监听的端口（配置端口为 0 时由系统分配）
+     */
+    int32 GetListenPort() const;
+
+    /**
+     * 获取运行指标（控制面板读取）
+     */
+    const TSharedPtr<FMCPServerMetrics> &GetMetrics() const { return Metrics; }
+
+    /**
+     * 获取已连接客户端的端点
+     */
+    TArray<FIPv4Endpoint> GetClientEndpoints() const;
+
+    /**
+     * 获取所有连接发送队列中等待的响应数
+     */
+    int32 GetSendQueueDepth() const;
+
 protected:
     /**
      * Ticker 调用的 Tick 函数
      */
     bool Tick(float DeltaTime);
 
+    /**
+     * 帧结束时记录本帧 MCP 占用的游戏线程时间
+     */
+    void HandleEndFrame();
+
     /**
      * 处理待处理的连接
+     * 把监听线程接受的连接加入连接列表
      */
     virtual void ProcessPendingConnections();
 
@@ -188,10 +417,154 @@ protected:
      */
     virtual void ProcessClientData();
 
+    /**
+     * 从接收缓冲区中取出所有完整的消息并处理
+     * HTTP 请求按 Content-Length 分帧,原始 TCP 按行分帧;不完整的消息留在缓冲区等待后续数据
+     * @return 数据无法分帧(超过最大消息大小)时返回 false,调用方应关闭连接
+     */
+    bool ProcessReceivedData(FMCPClientConnection &ClientConnection);
+
+    /**
+     * 处理一条完整的消息(UTF-8 JSON)
+     */
+    void ProcessMessage(FUtf8StringView Message, FSocket *ClientSocket);
+
     /**
      * 处理命令
+     * @param CommandJson 请求的 UTF-8 JSON,直接由 UTF-8 读取器解析,不转换为 FString
+     */
+    virtual void ProcessCommand(FUtf8StringView CommandJson, FSocket *ClientSocket);
+
+    /**
+     * 处理一条 MessagePack / CBOR 请求
+     * 解码为 JSON 数据模型后与 JSON 请求走相同的分发路径
+     */
+    void ProcessBinaryMessage(FUtf8StringView Message, EMCPWireFormat Format, FSocket *ClientSocket);
+
+    /**
+     * 分发已解析的请求对象(JSON-RPC 或旧的 {type} 格式)
+     */
+    virtual void ProcessCommandObject(const TSharedPtr<FJsonObject> &JsonObject, FSocket *ClientSocket);
+
+    /**
+     * 尝试流式处理请求
+     * 命令名出现在参数之前且处理器声明了流式数组参数时,在请求字节上边解析边分发数组元素
+     * @return 请求已处理返回 true;返回 false 时尚未执行任何操作,调用方应改用 ProcessCommand
+     */
+    bool TryProcessStreamedCommand(const UTF8CHAR *Data, int32 Length, FSocket *ClientSocket);
+
+    /**
+     * 读取当前对象的其余成员作为命令参数,数组参数的元素逐个交给消费者
+     * @param OtherParams 输入已读取的参数,输出除数组外的全部参数
+     * @param bOutStarted 是否已有元素交给消费者(之后不能再回退到 ProcessCommand)
+     * @return 消费者生成的响应;未开始流式处理时返回 nullptr
+     */
+    TSharedPtr<FJsonObject> StreamCommandParams(FMCPJsonPullParser &Parser, const FString &CommandName,
+                                                const TSharedPtr<IMCPCommandHandler> &Handler, FSocket *ClientSocket,
+                                                const TSharedPtr<FJsonObject> &OtherParams, bool &bOutStarted);
+
+    /**
+     * 编译处理器的参数 schema 并缓存校验器
+     */
+    void CompileValidator(const TSharedPtr<IMCPCommandHandler> &Handler);
+
+    /**
+     * 分发前按处理器的 schema 校验参数
+     * @param OutPointer 出错字段的 JSON Pointer
+     * @param OutMessage 错误描述
+     * @return 通过或没有校验器时返回 true
+     */
+    bool ValidateCommandParams(const FString &CommandName, const TSharedPtr<FJsonObject> &Params,
+                               FString &OutPointer, FString &OutMessage) const;
+
+    /**
+     * 序列化所有处理器的描述和 schema,缓存 tools/list 结果
+     */
+    void RebuildToolsListCache();
+
+    /**
+     * 使用缓存的结果发送 tools/list 响应
+     * @param RequestId JSON-RPC 请求 ID,通知请求为 nullptr
+     */
+    void SendToolsListResponse(FSocket *ClientSocket, const int32 *RequestId);
+
+    /**
+     * 发送 tools/call 响应
+     * 工具结果写入 structuredContent;content 中的文本副本直接从缓冲区中的结果转义,
+     * 只有结果超过 MAX_TOOL_RESULT_TEXT_BYTES 且客户端声明支持 structuredContent 时才以说明代替
+     * @param RequestId JSON-RPC 请求 ID,通知请求为 nullptr
+     * @param WriteToolResult 写出工具结果对象
+     */
+    void SendToolCallResponse(FSocket *ClientSocket, const int32 *RequestId, TFunctionRef<void(FMCPJsonStreamWriter &)> WriteToolResult);
+
+    /**
+     * 查找客户端连接,不存在时返回 nullptr
+     */
+    FMCPClientConnection *FindClientConnection(FSocket *Client);
+
+    /**
+     * 按连接 ID 查找客户端连接,连接已断开时返回 nullptr
+     * 异步完成的回调必须用此函数,不能保存 FSocket 指针
      */
-    virtual void ProcessCommand(const FString &CommandJson, FSocket *ClientSocket);
+    FMCPClientConnection *FindClientConnectionById(uint64 ConnectionId);
+
+    /**
+     * 连接上是否收到过 HTTP 请求(这类连接不能推送通知)
+     */
+    bool IsHttpConnection(FSocket *Client) const;
+
+    /**
+     * 分发异步请求前调用: 连接的未完成请求数加一
+     * @return 连接 ID,回调中用于查找连接;连接不存在时返回 0
+     */
+    uint64 BeginAsyncRequest(FSocket *Client);
+
+    /**
+     * 异步请求完成时调用: 未完成请求数减一并刷新活动时间
+     * @return 连接已断开时返回 nullptr
+     */
+    FMCPClientConnection *EndAsyncRequest(uint64 ConnectionId);
+
+    /**
+     * 按顺序发送队列前端已完成的响应
+     * 遇到发送缓冲区已满时停止,剩余部分在之后的 Tick 中继续发送
+     */
+    void FlushSendQueue(FMCPClientConnection &Connection);
+
+    /**
+     * 继续发送所有连接中未写完的响应
+     */
+    void FlushAllSendQueues();
+
+    /**
+     * 发送完整的 HTTP 响应;前面有编码中的响应时排队
+     */
+    void SendHttpResponse(FSocket *Client, TArray<uint8> &&Response);
+
+    /**
+     * 在原始 TCP 连接上推送通知: 一行 JSON,不带 HTTP 响应头
+     * 与响应共用发送队列,不会插入未写完的响应中间
+     */
+    void SendNotificationLine(FSocket *Client, const TSharedPtr<FJsonObject> &Notification);
+
+    /**
+     * 从 InOutOffset 开始把字节写入 Socket,记录发送字节数;整个响应写完后记录计时和请求日志
+     * @param InOutOffset 已写入的字节数,返回时更新
+     * @return 响应已写完(或因连接错误放弃)返回 true;发送缓冲区已满返回 false
+     */
+    bool SendHttpBytes(FSocket *Client, const TArray<uint8> &Buffer, int32 &InOutOffset, const TSharedPtr<FMCPRequestTimer> &Timer);
+
+    /**
+     * 以 Prometheus 文本格式发送运行指标(GET /metrics)
+     */
+    void SendMetricsResponse(FSocket *Client);
+
+    /**
+     * 开始处理一个工具请求: 创建计时器并写入请求日志
+     * 必须在处理当前消息期间调用(请求日志读取当前消息的请求体)
+     */
+    TSharedPtr<FMCPRequestTimer> BeginToolRequest(FSocket *ClientSocket, const FString &Command, int32 RequestId,
+                                                  double DispatchTime = FPlatformTime::Seconds());
 
     /**
      * 检查客户端超时
@@ -212,6 +585,7 @@ protected:
 
     /**
      * 连接处理器
+     * 在监听线程上调用,只把连接放入队列,由游戏线程的 ProcessPendingConnections 取出
      */
     virtual bool HandleConnectionAccepted(FSocket *InSocket, const FIPv4Endpoint &Endpoint);
 
@@ -224,15 +598,69 @@ protected:
     /** 客户端连接列表 */
     TArray<FMCPClientConnection> ClientConnections;
 
+    /** 下一个连接的 ID,0 表示无效 */
+    uint64 NextConnectionId;
+
+    /** 监听线程已接受、尚未加入连接列表的连接 */
+    TQueue<TPair<FSocket *, FIPv4Endpoint>, EQueueMode::Spsc> AcceptedConnections;
+
     /** 运行标志 */
     bool bRunning;
 
     /** Ticker 句柄 */
     FTSTicker::FDelegateHandle TickerHandle;
 
+    /** 帧结束回调句柄 */
+    FDelegateHandle EndFrameHandle;
+
     /** 命令处理器映射 */
     TMap<FString, TSharedPtr<IMCPCommandHandler>> CommandHandlers;
 
+    /** 各命令的参数校验器,处理器注册时编译 */
+    TMap<FString, TSharedPtr<FMCPSchemaValidator>> Validators;
+
+    /** 缓存的 tools/list 结果对象(UTF-8 JSON),处理器注册或注销时清空 */
+    TArray<ANSICHAR> ToolsListCache;
+
+    /** 缓存结果的 ETag */
+    FString ToolsListETag;
+
+    /** 生命周期令牌 - 异步命令回调持有其弱引用,服务器销毁后回调不再访问服务器 */
+    TSharedRef<bool> LifetimeToken;
+
+    /** 保存队列 - 由修改资源的命令处理器共享 */
+    TSharedPtr<FMCPSaveQueue> SaveQueue;
+
+    /** 资源管理器 - 提供 resources/* 方法并向订阅的客户端推送变化 */
+    TSharedPtr<FMCPResourceManager> ResourceManager;
+
+    /** 运行指标 - 由 server_stats 和 GET /metrics 读取 */
+    TSharedPtr<FMCPServerMetrics> Metrics;
+
+    /** 正在发送响应的工具请求,SendResponse / SendRawResponse 据此记录序列化和发送阶段 */
+    TSharedPtr<FMCPRequestTimer> ActiveTimer;
+
+    /** 正在处理的消息的接收时间 */
+    double CurrentMessageReceiveTime;
+
+    /** 正在处理的消息的请求体,指向连接的接收缓冲区,只在处理该消息期间有效 */
+    FUtf8StringView CurrentMessageBody;
+
+    /** 正在处理的消息的格式 */
+    EMCPWireFormat CurrentMessageFormat;
+
+    /**
+     * 正在处理的消息协商的响应编码(原始 TCP 消息不压缩)
+     * 同一连接上的后续请求可能协商不同的编码,延迟发送的响应在回调中捕获并在发送时恢复
+     */
+    EMCPContentEncoding CurrentResponseEncoding;
+
+    /** 正在处理的消息协商的响应格式(原始 TCP 消息总是 JSON),延迟发送时与编码一样由回调恢复 */
+    EMCPWireFormat CurrentResponseFormat;
+
+    /** 请求日志 - 未启用时为空 */
+    TUniquePtr<FMCPRequestJournal> Journal;
+
 private:
     // 禁用拷贝和赋值
     FMCPTCPServer(const FMCPTCPServer &) = delete;
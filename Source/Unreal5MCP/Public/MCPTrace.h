@@ -0,0 +1,64 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Trace/Trace.h"
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+
+/**
+ * MCP 的 Unreal Insights 追踪
+ *
+ * 以 -trace=default,mcp 启动或在控制台执行 Trace.Enable MCP 后记录:
+ * - CPU 作用域: MCP.Receive / MCP.Parse / MCP.Dispatch / MCP.Execute(<工具>) / MCP.Serialize / MCP.Send
+ * - MCP.Request 事件: 执行、序列化、发送开始时的工具名和请求 id,按线程和时间与作用域对应
+ * - 计数器: MCP/PendingMessages、MCP/SendQueueDepth、MCP/BytesReceived、MCP/BytesSent
+ *
+ * 通道关闭时作用域和事件只有一次通道检查的开销
+ */
+UE_TRACE_CHANNEL_EXTERN(MCPChannel, UNREAL5MCP_API);
+
+class FMCPRequestTimer;
+
+namespace MCPTrace
+{
+    /** MCP.Request 事件的阶段字段 */
+    enum class EPhase : uint8
+    {
+        Execute,
+        Serialize,
+        Send
+    };
+
+    /** 请求没有 JSON-RPC id 时使用的值 */
+    constexpr int32 NO_REQUEST_ID = -1;
+
+    /** 记录一次 MCP.Request 事件,通道关闭时直接返回 */
+    UNREAL5MCP_API void OutputRequest(EPhase Phase, const FString &Tool, int32 RequestId);
+
+    /** 从请求计时器取工具名和请求 id,Timer 为空时不记录 */
+    UNREAL5MCP_API void OutputRequest(EPhase Phase, const FMCPRequestTimer *Timer);
+
+    /**
+     * 工具执行作用域的名称 "MCP.Execute(<工具>)"
+     * 按工具名缓存,只在游戏线程调用
+     */
+    UNREAL5MCP_API const TCHAR *GetExecuteScopeName(const FString &Tool);
+
+    UNREAL5MCP_API void SetPendingMessages(int32 Count);
+    UNREAL5MCP_API void SetSendQueueDepth(int32 Depth);
+    UNREAL5MCP_API void AddBytesReceived(int64 Bytes);
+    UNREAL5MCP_API void AddBytesSent(int64 Bytes);
+}
+
+/** 固定名称的 CPU 作用域 */
+#define MCP_TRACE_SCOPE(Name) TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, MCPChannel)
+
+/** 带请求计时器中工具名和请求 id 的阶段作用域 */
+#define MCP_TRACE_REQUEST_SCOPE(Phase, Name, Timer)                   \
+    MCPTrace::OutputRequest(MCPTrace::EPhase::Phase, Timer);         \
+    TRACE_CPUPROFILER_EVENT_SCOPE_ON_CHANNEL_STR(Name, MCPChannel)
+
+/** 工具执行作用域,名称包含工具名 */
+#define MCP_TRACE_EXECUTE_SCOPE(Tool, RequestId)                                         \
+    MCPTrace::OutputRequest(MCPTrace::EPhase::Execute, Tool, RequestId);                \
+    TRACE_CPUPROFILER_EVENT_SCOPE_TEXT_ON_CHANNEL(                                      \
+        UE_TRACE_CHANNELEXPR_IS_ENABLED(MCPChannel) ? MCPTrace::GetExecuteScopeName(Tool) : TEXT(""), MCPChannel)
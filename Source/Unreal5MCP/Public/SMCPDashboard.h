@@ -0,0 +1,100 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Widgets/SCompoundWidget.h"
+#include "Widgets/SLeafWidget.h"
+#include "Interfaces/IPv4/IPv4Endpoint.h"
+#include "MCPServerMetrics.h"
+
+class FMCPTCPServer;
+class SVerticalBox;
+class SGridPanel;
+
+/**
+ * SMCPFrameGraph - 每帧游戏线程耗时的滚动曲线
+ *
+ * 灰线为帧时间,橙线为其中 MCP 占用的时间,暗线标出 60 FPS 的帧预算;最新的帧在最右侧
+ */
+class SMCPFrameGraph : public SLeafWidget
+{
+public:
+    SLATE_BEGIN_ARGS(SMCPFrameGraph) {}
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments &InArgs);
+
+    /** 设置要绘制的样本,从旧到新 */
+    void SetSamples(TArray<FMCPFrameSample> &&InSamples) { Samples = MoveTemp(InSamples); }
+
+    //~ Begin SWidget Interface
+    virtual int32 OnPaint(const FPaintArgs &Args, const FGeometry &AllottedGeometry, const FSlateRect &MyCullingRect,
+                          FSlateWindowElementList &OutDrawElements, int32 LayerId, const FWidgetStyle &InWidgetStyle,
+                          bool bParentEnabled) const override;
+    virtual FVector2D ComputeDesiredSize(float LayoutScaleMultiplier) const override;
+    //~ End SWidget Interface
+
+private:
+    TArray<FMCPFrameSample> Samples;
+};
+
+/**
+ * SMCPDashboard - 控制面板中的运行仪表盘
+ *
+ * 定时从服务器读取: 已连接的客户端、每秒请求数、发送队列深度、每帧 MCP 占用的游戏线程时间(含滚动曲线)、
+ * 各工具的端到端 p50/p99 延迟和最近最慢的请求。只在游戏线程使用
+ */
+class SMCPDashboard : public SCompoundWidget
+{
+public:
+    /** 返回当前服务器,未运行时返回 nullptr */
+    using FGetServer = TFunction<const FMCPTCPServer *()>;
+
+    SLATE_BEGIN_ARGS(SMCPDashboard) {}
+        SLATE_ARGUMENT(FGetServer, GetServer)
+    SLATE_END_ARGS()
+
+    void Construct(const FArguments &InArgs);
+
+private:
+    /** 读取服务器状态并更新显示 */
+    EActiveTimerReturnType Refresh(double InCurrentTime, float InDeltaTime);
+
+    /** 按最近一秒的请求数计算速率 */
+    void UpdateRequestRate(const FMCPTCPServer *Server, double CurrentTime);
+
+    /** 由最近一秒的帧样本计算 MCP 每帧耗时和占比 */
+    void UpdateFrameStats(const TArray<FMCPFrameSample> &Samples);
+
+    void RebuildClients(const TArray<FIPv4Endpoint> &Endpoints);
+    void RebuildTools(const TArray<FMCPCommandSummary> &Summaries);
+    void RebuildSlowCalls(const TArray<FMCPCompletedCall> &Calls);
+
+    FText GetSummaryText() const;
+    FText GetFrameText() const;
+
+    FGetServer GetServer;
+
+    /** 上次刷新时的服务器,服务器重建后清空速率采样 */
+    const FMCPTCPServer *LastServer = nullptr;
+
+    /** 最近一秒内各次刷新的 (时间, 累计请求数) */
+    TArray<TPair<double, uint64>> RequestSamples;
+
+    float RequestsPerSecond = 0.0f;
+    int32 ClientCount = 0;
+    int32 SendQueueDepth = 0;
+
+    /** 最近一秒内 MCP 平均每帧耗时(毫秒) */
+    float AverageMCPMilliseconds = 0.0f;
+
+    /** 曲线范围内 MCP 单帧最大耗时(毫秒) */
+    float MaxMCPMilliseconds = 0.0f;
+
+    /** 最近一秒内 MCP 时间占帧时间的比例 */
+    float MCPFrameShare = 0.0f;
+
+    TSharedPtr<SMCPFrameGraph> FrameGraph;
+    TSharedPtr<SVerticalBox> ClientsBox;
+    TSharedPtr<SGridPanel> ToolsGrid;
+    TSharedPtr<SGridPanel> SlowCallsGrid;
+};
@@ -52,6 +52,10 @@ public class Unreal5MCP : ModuleRules
                 "SlateCore",         // Slate核心
                 "LevelEditor",       // 关卡编辑器
                 "DeveloperSettings", // 开发者设置系统
+                "AssetTools",        // 资源导入与创建
+                "AssetRegistry",     // 资源注册表
+                "BlueprintGraph",    // 蓝图变量类型(K2 Schema)
+                "Kismet",            // 蓝图编译管理器
             }
         );
 